@@ -34,11 +34,13 @@
  * at the sole discretion of Silicon Labs.
  ******************************************************************************/
 
+#include <string.h>
 #include "em_device.h"
 #include "em_cmu.h"
 #include "em_chip.h"
 #include "em_emu.h"
 #include "em_aes.h"
+#include "aes_key_cache.h"
 
 // Note: change this to change the number of bytes to encrypt
 //       (must be a multiple of 16)
@@ -79,14 +81,81 @@ const static uint8_t initVector[KEY_SIZE] = {
   0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
 };
 
-// A buffer to hold the generated decryption key
-static uint8_t decryptionKey[KEY_SIZE];
+// Note: change this to change the number of decryption keys kept in the cache
+#define KEY_CACHE_SIZE 4
+
+// Define to measure the per-packet decrypt latency with the DWT cycle counter
+// #define DECRYPT_BENCHMARK
+
+// Cache of decryption keys and its storage
+static AesKeyCacheEntry_t keyCacheEntries[KEY_CACHE_SIZE];
+static AesKeyCache_t keyCache;
+
+// The decryption key of encryptionKey, held by the cache
+static const uint8_t *decryptionKey;
 
 // A flag indicating whether the encryption/decryption process succeeded
 // Note: This is only volatile to ensure that it doesn't get optimized out by
 // the compiler before the user checks its value. It's not actually necessary.
 static volatile bool isError;
 
+#if defined(DECRYPT_BENCHMARK)
+#if !defined(DWT)
+#error "DECRYPT_BENCHMARK needs the DWT cycle counter (Cortex-M3/M4 devices)"
+#endif
+
+// Number of peers with distinct keys, packets arrive from them in turn
+#define BENCHMARK_PEERS   KEY_CACHE_SIZE
+#define BENCHMARK_PACKETS 32
+
+// Average cycles to decrypt one packet, view in the Expressions window
+uint32_t cyclesUncached;
+uint32_t cyclesCached;
+
+/**************************************************************************//**
+ * @brief
+ *    Time the decryption of packets from several peers, deriving the
+ *    decryption key for every packet and looking it up in the cache
+ *****************************************************************************/
+void benchmarkDecrypt(void)
+{
+  static uint8_t peerKeys[BENCHMARK_PEERS][KEY_SIZE];
+  static uint8_t decryptKey[KEY_SIZE];
+  const uint8_t *key;
+  uint32_t start;
+  uint32_t i;
+
+  // Give each peer its own key
+  for (i = 0; i < BENCHMARK_PEERS; i++) {
+    memcpy(peerKeys[i], encryptionKey, KEY_SIZE);
+    peerKeys[i][0] ^= i;
+  }
+
+  // Enable the cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  for (i = 0; i < BENCHMARK_PACKETS; i++) {
+    AES_DecryptKey128(decryptKey, peerKeys[i % BENCHMARK_PEERS]);
+    AES_CBC128(decryptedData, encryptedData, DATA_SIZE, decryptKey, initVector, false);
+  }
+  cyclesUncached = (DWT->CYCCNT - start) / BENCHMARK_PACKETS;
+
+  // The first packet of each peer fills the cache
+  aesKeyCacheFlush(&keyCache);
+  start = DWT->CYCCNT;
+  for (i = 0; i < BENCHMARK_PACKETS; i++) {
+    key = aesKeyCacheGet(&keyCache, peerKeys[i % BENCHMARK_PEERS], 128);
+    AES_CBC128(decryptedData, encryptedData, DATA_SIZE, key, initVector, false);
+  }
+  cyclesCached = (DWT->CYCCNT - start) / BENCHMARK_PACKETS;
+
+  aesKeyCacheFlush(&keyCache);
+}
+#endif
+
 /**************************************************************************//**
  * @brief
  *    Main function
@@ -99,8 +168,16 @@ int main(void)
   // Enable AES clock
   CMU_ClockEnable(cmuClock_AES, true);
 
-  // Calculate decryption key from original key. Only needs to be done once for each key
-  AES_DecryptKey128(decryptionKey, encryptionKey);
+  // Keep the decryption keys of the most recently used keys
+  aesKeyCacheInit(&keyCache, keyCacheEntries, KEY_CACHE_SIZE);
+
+#if defined(DECRYPT_BENCHMARK)
+  benchmarkDecrypt();
+#endif
+
+  // Get the decryption key from the cache. It is only calculated the first
+  // time a key is used, later lookups (keyCache.hits) return the cached key
+  decryptionKey = aesKeyCacheGet(&keyCache, encryptionKey, 128);
 
   // Encrypt data using AES-128 CBC
   AES_CBC128(encryptedData, // Pointer to buffer where encrypted/decrypted data will be put
@@ -0,0 +1,88 @@
+/***************************************************************************//**
+ * @file aes_ctr_stream.h
+ * @brief Streaming AES-CTR encryption and decryption of arbitrary length data.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef AES_CTR_STREAM_H
+#define AES_CTR_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AES_CTR_STREAM_BLOCK_SIZE   16
+
+// Counter blocks encrypted per keystream refill
+#ifndef AES_CTR_STREAM_BATCH
+#define AES_CTR_STREAM_BATCH        4
+#endif
+
+/*
+ * The counter block is incremented with AES_CTRUpdate32Bit() (the last 32
+ * bits, big-endian), so a stream produces the same output as AES_CTR128()
+ * or AES_CTR256() called once over the whole message.
+ *
+ * Whole blocks are passed straight to the AES in a single call. Bytes that
+ * do not fill a block are XORed with keystream that is generated
+ * AES_CTR_STREAM_BATCH blocks at a time and carried over to the next
+ * update, so short chunks do not start the AES for every call.
+ */
+typedef struct
+{
+  uint8_t  key[32];                                 // 128 or 256-bit key
+  uint8_t  counter[AES_CTR_STREAM_BLOCK_SIZE];      // Next counter block
+  uint8_t  keystream[AES_CTR_STREAM_BATCH * AES_CTR_STREAM_BLOCK_SIZE];
+  uint16_t keyBits;                                 // 128 or 256
+  uint16_t keystreamUsed;                           // Keystream bytes used
+  uint32_t length;                                  // Bytes processed
+} AesCtrStream_t;
+
+void aesCtrStreamInit(AesCtrStream_t *ctx,
+                      const uint8_t *key,
+                      unsigned int keyBits,
+                      const uint8_t *counter);
+void aesCtrStreamUpdate(AesCtrStream_t *ctx,
+                        uint8_t *out,
+                        const uint8_t *in,
+                        size_t length);
+uint32_t aesCtrStreamFinal(AesCtrStream_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AES_CTR_STREAM_H
@@ -0,0 +1,178 @@
+/***************************************************************************//**
+ * @file aes_ctr_stream.c
+ * @brief Streaming AES-CTR encryption and decryption of arbitrary length data.
+ * See aes_ctr_stream.h for details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <string.h>
+#include "em_device.h"
+#include "em_assert.h"
+#include "em_aes.h"
+#include "aes_ctr_stream.h"
+
+// Input for keystream generation, CTR encryption of zeros is the keystream
+static const uint8_t zeroBlocks[sizeof(((AesCtrStream_t *)0)->keystream)];
+
+/***************************************************************************//**
+ * @brief
+ *   Run the AES in CTR mode over whole blocks and advance the counter.
+ ******************************************************************************/
+static void ctrBlocks(AesCtrStream_t *ctx,
+                      uint8_t *out,
+                      const uint8_t *in,
+                      unsigned int length)
+{
+#if defined(AES_CTRL_AES256)
+  if (ctx->keyBits == 256)
+  {
+    AES_CTR256(out, in, length, ctx->key, ctx->counter, AES_CTRUpdate32Bit);
+    return;
+  }
+#endif
+  AES_CTR128(out, in, length, ctx->key, ctx->counter, AES_CTRUpdate32Bit);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start a stream.
+ *
+ * @param[out] ctx
+ *   Stream context.
+ *
+ * @param[in] key
+ *   Encryption key, also used for decryption. Copied into the context.
+ *
+ * @param[in] keyBits
+ *   128, or 256 on devices with AES-256 support.
+ *
+ * @param[in] counter
+ *   Initial 128-bit counter block, e.g. a 96-bit nonce followed by a 32-bit
+ *   block counter. Copied into the context.
+ ******************************************************************************/
+void aesCtrStreamInit(AesCtrStream_t *ctx,
+                      const uint8_t *key,
+                      unsigned int keyBits,
+                      const uint8_t *counter)
+{
+#if defined(AES_CTRL_AES256)
+  EFM_ASSERT((keyBits == 128) || (keyBits == 256));
+#else
+  EFM_ASSERT(keyBits == 128);
+#endif
+
+  memcpy(ctx->key, key, keyBits / 8);
+  memcpy(ctx->counter, counter, AES_CTR_STREAM_BLOCK_SIZE);
+  ctx->keyBits = keyBits;
+  ctx->keystreamUsed = sizeof(ctx->keystream);
+  ctx->length = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Encrypt or decrypt the next chunk of a stream.
+ *
+ * @details
+ *   Chunks can have any length; the concatenated output is the same as
+ *   encrypting the concatenated input in one go.
+ *
+ * @param[in] ctx
+ *   Stream context.
+ *
+ * @param[out] out
+ *   Output, length bytes. May be equal to in.
+ *
+ * @param[in] in
+ *   Input, length bytes.
+ *
+ * @param[in] length
+ *   Bytes in this chunk.
+ ******************************************************************************/
+void aesCtrStreamUpdate(AesCtrStream_t *ctx,
+                        uint8_t *out,
+                        const uint8_t *in,
+                        size_t length)
+{
+  size_t n;
+
+  ctx->length += length;
+
+  while (length)
+  {
+    // Use up the keystream left over from earlier chunks first
+    if (ctx->keystreamUsed < sizeof(ctx->keystream))
+    {
+      n = sizeof(ctx->keystream) - ctx->keystreamUsed;
+      if (n > length)
+      {
+        n = length;
+      }
+      for (size_t i = 0; i < n; i++)
+      {
+        out[i] = in[i] ^ ctx->keystream[ctx->keystreamUsed + i];
+      }
+      ctx->keystreamUsed += n;
+    }
+    // Whole blocks go straight through the AES
+    else if (length >= AES_CTR_STREAM_BLOCK_SIZE)
+    {
+      n = length & ~(size_t)(AES_CTR_STREAM_BLOCK_SIZE - 1);
+      ctrBlocks(ctx, out, in, n);
+    }
+    // A partial block needs keystream, generate a batch of it
+    else
+    {
+      ctrBlocks(ctx, ctx->keystream, zeroBlocks, sizeof(ctx->keystream));
+      ctx->keystreamUsed = 0;
+      n = 0;
+    }
+
+    out += n;
+    in += n;
+    length -= n;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   End a stream and clear the key and keystream from the context.
+ *
+ * @return
+ *   Total number of bytes processed.
+ ******************************************************************************/
+uint32_t aesCtrStreamFinal(AesCtrStream_t *ctx)
+{
+  uint32_t length = ctx->length;
+
+  memset(ctx, 0, sizeof(*ctx));
+  return length;
+}
@@ -39,9 +39,10 @@
 #include "em_chip.h"
 #include "em_emu.h"
 #include "em_aes.h"
+#include "aes_ctr_stream.h"
 
 // Note: change this to change the number of bytes to encrypt
-//       (must be a multiple of 16)
+//       (must be a multiple of 16 for the AES_CTR128() decryption)
 #define DATA_SIZE 64
 
 // Note: change this to change the data to encrypt
@@ -86,6 +87,13 @@ const uint8_t initialCounter[COUNTER_SIZE] = {
 // A buffer to hold the counter value that will be updated after each AES block encoding
 uint8_t counterBuffer[COUNTER_SIZE];
 
+// Note: change this to change how the data is split up for encryption,
+//       e.g. as it arrives from a UART. Chunks can have any length.
+static const uint8_t chunkSizes[] = { 1, 7, 16, 3, 29, 8 };
+
+// Stream context for encryption
+static AesCtrStream_t ctrStream;
+
 // A flag indicating whether the encryption/decryption process succeeded
 // Note: This is only volatile to ensure that it doesn't get optimized out by
 // the compiler before the user checks its value. It's not actually necessary.
@@ -103,26 +111,25 @@ int main(void)
   // Enable AES clock
   CMU_ClockEnable(cmuClock_AES, true);
 
-  // Copy the initialCounter into the counterBuffer
-  for (uint32_t i = 0; i < COUNTER_SIZE; i++) {
-    counterBuffer[i] = initialCounter[i];
-  }
-
-  // Encrypt data using AES-128 CTR
+  // Encrypt data using AES-128 CTR, one chunk at a time
   // Note: the encryption and decryption operations are identical in CTR mode
-  AES_CTR128(encryptedData,       // Pointer to buffer where encrypted/decrypted data will be put
-             originalData,        // Pointer to buffer holding data to encrypt/decrypt
-             DATA_SIZE,           // Number of bytes to encrypt (must be a multiple of 16)
-             key,                 // A 128 bit encryption/decryption key
-             counterBuffer,       // Pointer to buffer with initial counter value
-             AES_CTRUpdate32Bit); // Pointer to a function that will update the counter value
+  aesCtrStreamInit(&ctrStream, key, 128, initialCounter);
+  for (uint32_t i = 0, offset = 0; i < sizeof(chunkSizes); i++) {
+    aesCtrStreamUpdate(&ctrStream,
+                       &encryptedData[offset],  // Where the encrypted chunk will be put
+                       &originalData[offset],   // Chunk to encrypt
+                       chunkSizes[i]);          // Any number of bytes
+    offset += chunkSizes[i];
+  }
+  aesCtrStreamFinal(&ctrStream);
 
-  // Reinitialize the counterBuffer for decryption
+  // Initialize the counterBuffer for decryption
   for (uint32_t i = 0; i < COUNTER_SIZE; i++) {
     counterBuffer[i] = initialCounter[i];
   }
 
-  // Decrypt data using AES-128 CTR
+  // Decrypt data using AES-128 CTR in one go, which gives the same result as
+  // the stream above
   // Note: the encryption and decryption operations are identical in CTR mode
   AES_CTR128(decryptedData,       // Pointer to buffer where encrypted/decrypted data will be put
              encryptedData,       // Pointer to buffer holding data to encrypt/decrypt
@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ * @file aes_key_cache.h
+ * @brief Cache of AES decryption keys for a small set of encryption keys.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef AES_KEY_CACHE_H
+#define AES_KEY_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * AES decryption on the AES module needs the last round key of the key
+ * schedule, which AES_DecryptKey128()/AES_DecryptKey256() derive by running
+ * the key expansion. The cache keeps the decryption keys of the most
+ * recently used encryption keys, so decrypting with a known key skips the
+ * expansion. When the cache is full the least recently used key is
+ * replaced.
+ */
+typedef struct
+{
+  uint8_t  key[32];             // Encryption key
+  uint8_t  decryptKey[32];      // Decryption key derived from key
+  uint16_t keyBits;             // 128 or 256, 0 if the entry is unused
+  uint32_t lastUse;             // Value of useCount at the last lookup
+} AesKeyCacheEntry_t;
+
+typedef struct
+{
+  AesKeyCacheEntry_t *entries;  // Cache storage
+  uint32_t           numEntries;
+  uint32_t           useCount;  // Lookups so far, orders the entries
+  uint32_t           hits;      // Lookups that found the key
+  uint32_t           misses;    // Lookups that derived the key
+} AesKeyCache_t;
+
+void aesKeyCacheInit(AesKeyCache_t *cache,
+                     AesKeyCacheEntry_t *entries,
+                     uint32_t numEntries);
+const uint8_t *aesKeyCacheGet(AesKeyCache_t *cache,
+                              const uint8_t *key,
+                              unsigned int keyBits);
+void aesKeyCacheFlush(AesKeyCache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AES_KEY_CACHE_H
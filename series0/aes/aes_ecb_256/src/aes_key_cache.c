@@ -0,0 +1,155 @@
+/***************************************************************************//**
+ * @file aes_key_cache.c
+ * @brief Cache of AES decryption keys for a small set of encryption keys.
+ * See aes_key_cache.h for details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <string.h>
+#include "em_device.h"
+#include "em_assert.h"
+#include "em_aes.h"
+#include "aes_key_cache.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize an empty cache.
+ *
+ * @param[out] cache
+ *   Cache context.
+ *
+ * @param[in] entries
+ *   Storage for numEntries keys.
+ *
+ * @param[in] numEntries
+ *   Number of keys kept, at least 1. Choose the number of peers
+ *   communicated with regularly.
+ ******************************************************************************/
+void aesKeyCacheInit(AesKeyCache_t *cache,
+                     AesKeyCacheEntry_t *entries,
+                     uint32_t numEntries)
+{
+  EFM_ASSERT(numEntries >= 1);
+
+  cache->entries = entries;
+  cache->numEntries = numEntries;
+  aesKeyCacheFlush(cache);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get the decryption key for an encryption key.
+ *
+ * @details
+ *   The decryption key is derived with AES_DecryptKey128() or
+ *   AES_DecryptKey256() only if the key is not cached, replacing the least
+ *   recently used entry.
+ *
+ * @param[in] cache
+ *   Cache context.
+ *
+ * @param[in] key
+ *   Encryption key.
+ *
+ * @param[in] keyBits
+ *   128, or 256 on devices with AES-256 support.
+ *
+ * @return
+ *   Decryption key to pass to the AES decrypt functions. Valid until the
+ *   entry is replaced, i.e. until numEntries other keys have been looked up.
+ ******************************************************************************/
+const uint8_t *aesKeyCacheGet(AesKeyCache_t *cache,
+                              const uint8_t *key,
+                              unsigned int keyBits)
+{
+  AesKeyCacheEntry_t *entry;
+  AesKeyCacheEntry_t *oldest = &cache->entries[0];
+  uint32_t i;
+
+#if defined(AES_CTRL_AES256)
+  EFM_ASSERT((keyBits == 128) || (keyBits == 256));
+#else
+  EFM_ASSERT(keyBits == 128);
+#endif
+
+  cache->useCount++;
+
+  for (i = 0; i < cache->numEntries; i++)
+  {
+    entry = &cache->entries[i];
+    if ((entry->keyBits == keyBits)
+        && (memcmp(entry->key, key, keyBits / 8) == 0))
+    {
+      entry->lastUse = cache->useCount;
+      cache->hits++;
+      return entry->decryptKey;
+    }
+
+    // Unused entries have lastUse 0 and are taken first
+    if ((cache->useCount - entry->lastUse)
+        > (cache->useCount - oldest->lastUse))
+    {
+      oldest = entry;
+    }
+  }
+
+  // Derive the decryption key into the least recently used entry
+  entry = oldest;
+  memcpy(entry->key, key, keyBits / 8);
+#if defined(AES_CTRL_AES256)
+  if (keyBits == 256)
+  {
+    AES_DecryptKey256(entry->decryptKey, key);
+  }
+  else
+#endif
+  {
+    AES_DecryptKey128(entry->decryptKey, key);
+  }
+  entry->keyBits = keyBits;
+  entry->lastUse = cache->useCount;
+  cache->misses++;
+
+  return entry->decryptKey;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Remove all keys from the cache, e.g. after a key change.
+ ******************************************************************************/
+void aesKeyCacheFlush(AesKeyCache_t *cache)
+{
+  memset(cache->entries, 0, cache->numEntries * sizeof(AesKeyCacheEntry_t));
+  cache->useCount = 0;
+  cache->hits = 0;
+  cache->misses = 0;
+}
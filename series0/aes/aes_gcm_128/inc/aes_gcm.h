@@ -0,0 +1,81 @@
+/***************************************************************************//**
+ * @file aes_gcm.h
+ * @brief AES-GCM authenticated encryption using the AES peripheral for the
+ * counter mode and a 4-bit table GHASH in software.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef AES_GCM_H
+#define AES_GCM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AES_GCM_BLOCK_SIZE    16
+#define AES_GCM_TAG_SIZE      16
+
+/*
+ * The hash subkey H is expanded into 16 multiples of H (Shoup's 4-bit
+ * tables, 256 bytes) when the key is set, so GHASH processes a block with
+ * 32 table lookups instead of 128 shift and XOR steps. The tables depend
+ * only on the key, so a context can be reused for any number of packets.
+ */
+typedef struct
+{
+  uint8_t  key[32];           // 128 or 256-bit key
+  uint16_t keyBits;           // 128 or 256
+  uint64_t hl[16];            // Low halves of the multiples of H
+  uint64_t hh[16];            // High halves of the multiples of H
+} AesGcm_t;
+
+void aesGcmSetKey(AesGcm_t *ctx, const uint8_t *key, unsigned int keyBits);
+void aesGcmEncrypt(const AesGcm_t *ctx,
+                   const uint8_t *iv, size_t ivLength,
+                   const uint8_t *aad, size_t aadLength,
+                   const uint8_t *in, uint8_t *out, size_t length,
+                   uint8_t *tag, size_t tagLength);
+bool aesGcmDecrypt(const AesGcm_t *ctx,
+                   const uint8_t *iv, size_t ivLength,
+                   const uint8_t *aad, size_t aadLength,
+                   const uint8_t *in, uint8_t *out, size_t length,
+                   const uint8_t *tag, size_t tagLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AES_GCM_H
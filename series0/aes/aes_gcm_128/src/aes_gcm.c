@@ -0,0 +1,427 @@
+/***************************************************************************//**
+ * @file aes_gcm.c
+ * @brief AES-GCM authenticated encryption using the AES peripheral for the
+ * counter mode and a 4-bit table GHASH in software. See aes_gcm.h for
+ * details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <string.h>
+#include "em_device.h"
+#include "em_assert.h"
+#include "em_aes.h"
+#include "aes_gcm.h"
+
+// Reduction of the 4 bits shifted out of the low end of the GHASH state,
+// placed in the top 16 bits of the high half
+static const uint16_t last4[16] =
+{
+  0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+  0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0
+};
+
+static uint64_t getU64(const uint8_t *p)
+{
+  uint64_t v = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+  {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+static void putU64(uint8_t *p, uint64_t v)
+{
+  int i;
+
+  for (i = 7; i >= 0; i--)
+  {
+    p[i] = (uint8_t)v;
+    v >>= 8;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Encrypt whole blocks with the AES peripheral.
+ ******************************************************************************/
+static void ecbEncrypt(const AesGcm_t *ctx, uint8_t *out, const uint8_t *in)
+{
+#if defined(AES_CTRL_AES256)
+  if (ctx->keyBits == 256)
+  {
+    AES_ECB256(out, in, AES_GCM_BLOCK_SIZE, ctx->key, true);
+    return;
+  }
+#endif
+  AES_ECB128(out, in, AES_GCM_BLOCK_SIZE, ctx->key, true);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Counter mode over length bytes starting at counter block ctr.
+ *
+ * @details
+ *   Whole blocks are encrypted by one AES_CTR128()/AES_CTR256() call. A
+ *   trailing partial block goes through a padded copy.
+ ******************************************************************************/
+static void ctrCrypt(const AesGcm_t *ctx,
+                     uint8_t *ctr,
+                     const uint8_t *in,
+                     uint8_t *out,
+                     size_t length)
+{
+  size_t whole = length & ~(size_t)(AES_GCM_BLOCK_SIZE - 1);
+  uint8_t block[AES_GCM_BLOCK_SIZE];
+
+  if (whole)
+  {
+#if defined(AES_CTRL_AES256)
+    if (ctx->keyBits == 256)
+    {
+      AES_CTR256(out, in, whole, ctx->key, ctr, AES_CTRUpdate32Bit);
+    }
+    else
+#endif
+    {
+      AES_CTR128(out, in, whole, ctx->key, ctr, AES_CTRUpdate32Bit);
+    }
+  }
+
+  if (length > whole)
+  {
+    memset(block, 0, sizeof(block));
+    memcpy(block, in + whole, length - whole);
+#if defined(AES_CTRL_AES256)
+    if (ctx->keyBits == 256)
+    {
+      AES_CTR256(block, block, sizeof(block), ctx->key, ctr,
+                 AES_CTRUpdate32Bit);
+    }
+    else
+#endif
+    {
+      AES_CTR128(block, block, sizeof(block), ctx->key, ctr,
+                 AES_CTRUpdate32Bit);
+    }
+    memcpy(out + whole, block, length - whole);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Multiply the GHASH state x by H in GF(2^128), using the 4-bit tables.
+ ******************************************************************************/
+static void ghashMult(const AesGcm_t *ctx, uint8_t *x)
+{
+  uint64_t zh, zl;
+  uint8_t rem, nibble;
+  int i;
+
+  nibble = x[15] & 0xF;
+  zh = ctx->hh[nibble];
+  zl = ctx->hl[nibble];
+
+  // Horner's rule over the 32 nibbles, last nibble first
+  for (i = 31; i > 0; i--)
+  {
+    nibble = (i & 1) ? (x[(i - 1) / 2] >> 4) : (x[(i - 1) / 2] & 0xF);
+
+    rem = (uint8_t)(zl & 0xF);
+    zl = (zh << 60) | (zl >> 4);
+    zh = (zh >> 4) ^ ((uint64_t)last4[rem] << 48);
+    zh ^= ctx->hh[nibble];
+    zl ^= ctx->hl[nibble];
+  }
+
+  putU64(x, zh);
+  putU64(x + 8, zl);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Absorb data into the GHASH state, zero padding the last block.
+ ******************************************************************************/
+static void ghashUpdate(const AesGcm_t *ctx,
+                        uint8_t *x,
+                        const uint8_t *data,
+                        size_t length)
+{
+  size_t n;
+  size_t i;
+
+  while (length)
+  {
+    n = (length < AES_GCM_BLOCK_SIZE) ? length : AES_GCM_BLOCK_SIZE;
+    for (i = 0; i < n; i++)
+    {
+      x[i] ^= data[i];
+    }
+    ghashMult(ctx, x);
+    data += n;
+    length -= n;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Absorb the bit lengths of the two hashed inputs.
+ ******************************************************************************/
+static void ghashLengths(const AesGcm_t *ctx,
+                         uint8_t *x,
+                         uint64_t firstLength,
+                         uint64_t secondLength)
+{
+  uint8_t block[AES_GCM_BLOCK_SIZE];
+
+  putU64(block, firstLength * 8);
+  putU64(block + 8, secondLength * 8);
+  ghashUpdate(ctx, x, block, sizeof(block));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Derive the pre-counter block J0 from the IV.
+ ******************************************************************************/
+static void computeJ0(const AesGcm_t *ctx,
+                      uint8_t *j0,
+                      const uint8_t *iv,
+                      size_t ivLength)
+{
+  memset(j0, 0, AES_GCM_BLOCK_SIZE);
+
+  // The recommended 96-bit IV is used directly with a 32-bit counter of 1
+  if (ivLength == 12)
+  {
+    memcpy(j0, iv, 12);
+    j0[15] = 1;
+  }
+  else
+  {
+    ghashUpdate(ctx, j0, iv, ivLength);
+    ghashLengths(ctx, j0, 0, ivLength);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   GHASH of the AAD and ciphertext, encrypted with J0 into a full tag.
+ ******************************************************************************/
+static void computeTag(const AesGcm_t *ctx,
+                       const uint8_t *j0,
+                       const uint8_t *aad, size_t aadLength,
+                       const uint8_t *ciphertext, size_t length,
+                       uint8_t *tag)
+{
+  uint8_t x[AES_GCM_BLOCK_SIZE];
+  uint8_t ekj0[AES_GCM_BLOCK_SIZE];
+  int i;
+
+  memset(x, 0, sizeof(x));
+  ghashUpdate(ctx, x, aad, aadLength);
+  ghashUpdate(ctx, x, ciphertext, length);
+  ghashLengths(ctx, x, aadLength, length);
+
+  ecbEncrypt(ctx, ekj0, j0);
+  for (i = 0; i < AES_GCM_BLOCK_SIZE; i++)
+  {
+    tag[i] = x[i] ^ ekj0[i];
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set the key and precompute the GHASH tables.
+ *
+ * @param[out] ctx
+ *   GCM context.
+ *
+ * @param[in] key
+ *   AES key. Copied into the context.
+ *
+ * @param[in] keyBits
+ *   128, or 256 on devices with AES-256 support.
+ ******************************************************************************/
+void aesGcmSetKey(AesGcm_t *ctx, const uint8_t *key, unsigned int keyBits)
+{
+  uint8_t h[AES_GCM_BLOCK_SIZE];
+  uint64_t vh, vl;
+  int i, j;
+
+#if defined(AES_CTRL_AES256)
+  EFM_ASSERT((keyBits == 128) || (keyBits == 256));
+#else
+  EFM_ASSERT(keyBits == 128);
+#endif
+
+  memcpy(ctx->key, key, keyBits / 8);
+  ctx->keyBits = keyBits;
+
+  // Hash subkey H is the encryption of the zero block
+  memset(h, 0, sizeof(h));
+  ecbEncrypt(ctx, h, h);
+  vh = getU64(h);
+  vl = getU64(h + 8);
+
+  // Entry 8 is H (the bit order of GHASH is reflected), entries 4, 2 and 1
+  // are H times x, x^2 and x^3
+  ctx->hh[0] = 0;
+  ctx->hl[0] = 0;
+  ctx->hh[8] = vh;
+  ctx->hl[8] = vl;
+  for (i = 4; i > 0; i >>= 1)
+  {
+    uint64_t reduce = (vl & 1) ? ((uint64_t)0xE1000000UL << 32) : 0;
+
+    vl = (vh << 63) | (vl >> 1);
+    vh = (vh >> 1) ^ reduce;
+    ctx->hh[i] = vh;
+    ctx->hl[i] = vl;
+  }
+
+  // The remaining entries are sums of those four
+  for (i = 2; i <= 8; i *= 2)
+  {
+    for (j = 1; j < i; j++)
+    {
+      ctx->hh[i + j] = ctx->hh[i] ^ ctx->hh[j];
+      ctx->hl[i + j] = ctx->hl[i] ^ ctx->hl[j];
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Encrypt and authenticate a packet.
+ *
+ * @param[in] ctx
+ *   GCM context with the key set.
+ *
+ * @param[in] iv
+ *   Initialization vector, 12 bytes recommended. Never reuse an IV with the
+ *   same key.
+ *
+ * @param[in] ivLength
+ *   IV length in bytes, at least 1.
+ *
+ * @param[in] aad
+ *   Additional data authenticated but not encrypted, may be NULL if
+ *   aadLength is 0.
+ *
+ * @param[in] aadLength
+ *   AAD length in bytes.
+ *
+ * @param[in] in
+ *   Plaintext.
+ *
+ * @param[out] out
+ *   Ciphertext, length bytes. May be equal to in.
+ *
+ * @param[in] length
+ *   Plaintext length in bytes.
+ *
+ * @param[out] tag
+ *   Authentication tag.
+ *
+ * @param[in] tagLength
+ *   Tag length in bytes, 4 to 16.
+ ******************************************************************************/
+void aesGcmEncrypt(const AesGcm_t *ctx,
+                   const uint8_t *iv, size_t ivLength,
+                   const uint8_t *aad, size_t aadLength,
+                   const uint8_t *in, uint8_t *out, size_t length,
+                   uint8_t *tag, size_t tagLength)
+{
+  uint8_t j0[AES_GCM_BLOCK_SIZE];
+  uint8_t ctr[AES_GCM_BLOCK_SIZE];
+  uint8_t fullTag[AES_GCM_TAG_SIZE];
+
+  EFM_ASSERT((ivLength > 0) && (tagLength >= 4)
+             && (tagLength <= AES_GCM_TAG_SIZE));
+
+  computeJ0(ctx, j0, iv, ivLength);
+
+  // The data is encrypted from inc32(J0) onwards
+  memcpy(ctr, j0, sizeof(ctr));
+  AES_CTRUpdate32Bit(ctr);
+  ctrCrypt(ctx, ctr, in, out, length);
+
+  computeTag(ctx, j0, aad, aadLength, out, length, fullTag);
+  memcpy(tag, fullTag, tagLength);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Authenticate and decrypt a packet.
+ *
+ * @details
+ *   The tag is checked before anything is decrypted, so out is not written
+ *   if authentication fails. Parameters are as for aesGcmEncrypt().
+ *
+ * @return
+ *   True if the tag matched and out holds the plaintext.
+ ******************************************************************************/
+bool aesGcmDecrypt(const AesGcm_t *ctx,
+                   const uint8_t *iv, size_t ivLength,
+                   const uint8_t *aad, size_t aadLength,
+                   const uint8_t *in, uint8_t *out, size_t length,
+                   const uint8_t *tag, size_t tagLength)
+{
+  uint8_t j0[AES_GCM_BLOCK_SIZE];
+  uint8_t ctr[AES_GCM_BLOCK_SIZE];
+  uint8_t fullTag[AES_GCM_TAG_SIZE];
+  uint8_t diff = 0;
+  size_t i;
+
+  EFM_ASSERT((ivLength > 0) && (tagLength >= 4)
+             && (tagLength <= AES_GCM_TAG_SIZE));
+
+  computeJ0(ctx, j0, iv, ivLength);
+  computeTag(ctx, j0, aad, aadLength, in, length, fullTag);
+
+  // Compare in constant time
+  for (i = 0; i < tagLength; i++)
+  {
+    diff |= fullTag[i] ^ tag[i];
+  }
+  if (diff)
+  {
+    return false;
+  }
+
+  memcpy(ctr, j0, sizeof(ctr));
+  AES_CTRUpdate32Bit(ctr);
+  ctrCrypt(ctx, ctr, in, out, length);
+  return true;
+}
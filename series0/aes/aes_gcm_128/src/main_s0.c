@@ -0,0 +1,187 @@
+/***************************************************************************//**
+ * @file main_s0.c
+ * @brief This project uses the GCM (Galois/Counter) mode of AES to encrypt and
+ * authenticate the user's input data and then check and decrypt it.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable 
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <string.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_chip.h"
+#include "em_emu.h"
+#include "em_aes.h"
+#include "aes_gcm.h"
+
+// Note: the data, key, IV and additional data below are test case 4 of the
+// GCM specification, so encryptedData and tag can be checked against it
+
+// Note: change this to change the number of bytes to encrypt
+//       (any length)
+#define DATA_SIZE 60
+
+// Note: change this to change the data to encrypt
+const static uint8_t originalData[DATA_SIZE] = {
+  0xD9, 0x31, 0x32, 0x25, 0xF8, 0x84, 0x06, 0xE5,
+  0xA5, 0x59, 0x09, 0xC5, 0xAF, 0xF5, 0x26, 0x9A,
+  0x86, 0xA7, 0xA9, 0x53, 0x15, 0x34, 0xF7, 0xDA,
+  0x2E, 0x4C, 0x30, 0x3D, 0x8A, 0x31, 0x8A, 0x72,
+  0x1C, 0x3C, 0x0C, 0x95, 0x95, 0x68, 0x09, 0x53,
+  0x2F, 0xCF, 0x0E, 0x24, 0x49, 0xA6, 0xB5, 0x25,
+  0xB1, 0x6A, 0xED, 0xF5, 0xAA, 0x0D, 0xE6, 0x57,
+  0xBA, 0x63, 0x7B, 0x39,
+};
+
+// Number of bytes of additional data, authenticated but not encrypted
+#define AAD_SIZE 20
+
+// Note: change this to change the additional data, e.g. a packet header
+const static uint8_t additionalData[AAD_SIZE] = {
+  0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+  0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+  0xAB, 0xAD, 0xDA, 0xD2,
+};
+
+// Expected results of test case 4
+const static uint8_t expectedData[DATA_SIZE] = {
+  0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24,
+  0x4B, 0x72, 0x21, 0xB7, 0x84, 0xD0, 0xD4, 0x9C,
+  0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0,
+  0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E,
+  0x21, 0xD5, 0x14, 0xB2, 0x54, 0x66, 0x93, 0x1C,
+  0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+  0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97,
+  0x3D, 0x58, 0xE0, 0x91,
+};
+
+const static uint8_t expectedTag[AES_GCM_TAG_SIZE] = {
+  0x5B, 0xC9, 0x4F, 0xBC, 0x32, 0x21, 0xA5, 0xDB,
+  0x94, 0xFA, 0xE9, 0x5A, 0xE7, 0x12, 0x1A, 0x47,
+};
+
+// A buffer to hold the encrypted data
+static uint8_t encryptedData[DATA_SIZE];
+
+// A buffer to hold the decrypted data
+static uint8_t decryptedData[DATA_SIZE];
+
+// A buffer to hold the authentication tag
+static uint8_t tag[AES_GCM_TAG_SIZE];
+
+// Number of bytes to make up a 128 bit key (16 * 8 = 128)
+#define KEY_SIZE 16
+
+// Note: change this to change the key
+// Note: must be 128 bits
+// Note: the same key is used for encryption and decryption in GCM mode
+const static uint8_t key[KEY_SIZE] = {
+  0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C,
+  0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08,
+};
+
+// Number of bytes in the recommended 96 bit IV
+#define IV_SIZE 12
+
+// Note: change this to change the IV
+// Note: never use the same IV twice with the same key
+const static uint8_t iv[IV_SIZE] = {
+  0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD,
+  0xDE, 0xCA, 0xF8, 0x88,
+};
+
+// GCM context, holds the key and the GHASH tables computed from it
+static AesGcm_t gcm;
+
+// A flag indicating whether the encryption/decryption process succeeded
+// Note: This is only volatile to ensure that it doesn't get optimized out by
+// the compiler before the user checks its value. It's not actually necessary.
+static volatile bool isError;
+
+/**************************************************************************//**
+ * @brief
+ *    Main function
+ *****************************************************************************/
+int main(void)
+{
+  // Chip errata
+  CHIP_Init();
+
+  // Enable AES clock
+  CMU_ClockEnable(cmuClock_AES, true);
+
+  // Set the key and precompute the GHASH tables, once per key
+  aesGcmSetKey(&gcm, key, 128);
+
+  // Encrypt and authenticate data using AES-128 GCM
+  aesGcmEncrypt(&gcm,
+                iv, IV_SIZE,                    // IV, unique per packet
+                additionalData, AAD_SIZE,       // Authenticated only
+                originalData, encryptedData,    // Encrypted and authenticated
+                DATA_SIZE,
+                tag, AES_GCM_TAG_SIZE);         // Tag to send with the data
+
+  isError = (memcmp(encryptedData, expectedData, DATA_SIZE) != 0)
+            || (memcmp(tag, expectedTag, AES_GCM_TAG_SIZE) != 0);
+
+  // Check the tag and decrypt data using AES-128 GCM
+  if (!aesGcmDecrypt(&gcm,
+                     iv, IV_SIZE,
+                     additionalData, AAD_SIZE,
+                     encryptedData, decryptedData,
+                     DATA_SIZE,
+                     tag, AES_GCM_TAG_SIZE)) {
+    isError = true;
+  }
+
+  // Check whether decrypted result is identical to the original data
+  for (uint32_t i = 0; i < DATA_SIZE; i++) {
+    if (decryptedData[i] != originalData[i]) {
+      isError = true;
+    }
+  }
+
+  // A modified packet must be rejected
+  encryptedData[0] ^= 0x01;
+  if (aesGcmDecrypt(&gcm,
+                    iv, IV_SIZE,
+                    additionalData, AAD_SIZE,
+                    encryptedData, decryptedData,
+                    DATA_SIZE,
+                    tag, AES_GCM_TAG_SIZE)) {
+    isError = true;
+  }
+
+  // Pause the debugger here to check if the isError variable is true/false
+  while (1) {
+    EMU_EnterEM1();
+  }
+}
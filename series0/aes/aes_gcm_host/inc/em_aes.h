@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * @file em_aes.h
+ * @brief Host build replacement for the emlib AES API, backed by the software
+ * AES in src/aes_sw.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_AES_H
+#define EM_AES_H
+
+#include "em_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*AES_CtrFuncPtr_TypeDef)(uint8_t *ctr);
+
+void AES_CTRUpdate32Bit(uint8_t *ctr);
+
+// Only encryption is implemented, which is all CTR and GCM need
+void AES_ECB128(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, bool encrypt);
+void AES_ECB256(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, bool encrypt);
+void AES_CTR128(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, uint8_t *ctr,
+                AES_CtrFuncPtr_TypeDef ctrFunc);
+void AES_CTR256(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, uint8_t *ctr,
+                AES_CtrFuncPtr_TypeDef ctrFunc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM_AES_H
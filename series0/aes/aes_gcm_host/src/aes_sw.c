@@ -0,0 +1,255 @@
+/***************************************************************************//**
+ * @file aes_sw.c
+ * @brief Software AES encryption (FIPS-197) standing in for the AES peripheral
+ * in host builds.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <string.h>
+#include "em_aes.h"
+#include "em_assert.h"
+
+#define AES_BLOCK_SIZE      16
+
+static const uint8_t sbox[256] =
+{
+  0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5,
+  0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+  0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,
+  0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+  0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC,
+  0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+  0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A,
+  0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+  0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0,
+  0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+  0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B,
+  0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+  0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85,
+  0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+  0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5,
+  0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+  0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17,
+  0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+  0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88,
+  0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+  0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C,
+  0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+  0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9,
+  0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+  0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6,
+  0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+  0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E,
+  0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+  0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94,
+  0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+  0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68,
+  0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+};
+
+static uint8_t xtime(uint8_t x)
+{
+  return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Expand a 128 or 256-bit key into (rounds + 1) round keys.
+ ******************************************************************************/
+static void expandKey(uint8_t *roundKeys, const uint8_t *key, int keyWords,
+                      int rounds)
+{
+  uint8_t rcon = 0x01;
+  uint8_t t[4];
+  int i, j;
+
+  memcpy(roundKeys, key, keyWords * 4);
+  for (i = keyWords; i < 4 * (rounds + 1); i++)
+  {
+    memcpy(t, &roundKeys[4 * (i - 1)], 4);
+    if ((i % keyWords) == 0)
+    {
+      uint8_t first = t[0];
+
+      t[0] = sbox[t[1]] ^ rcon;
+      t[1] = sbox[t[2]];
+      t[2] = sbox[t[3]];
+      t[3] = sbox[first];
+      rcon = xtime(rcon);
+    }
+    else if ((keyWords > 6) && ((i % keyWords) == 4))
+    {
+      for (j = 0; j < 4; j++)
+      {
+        t[j] = sbox[t[j]];
+      }
+    }
+    for (j = 0; j < 4; j++)
+    {
+      roundKeys[4 * i + j] = roundKeys[4 * (i - keyWords) + j] ^ t[j];
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Encrypt one block with expanded round keys.
+ ******************************************************************************/
+static void encryptBlock(uint8_t *out, const uint8_t *in,
+                         const uint8_t *roundKeys, int rounds)
+{
+  uint8_t s[AES_BLOCK_SIZE];
+  uint8_t t[AES_BLOCK_SIZE];
+  int round, c, i;
+
+  for (i = 0; i < AES_BLOCK_SIZE; i++)
+  {
+    s[i] = in[i] ^ roundKeys[i];
+  }
+
+  for (round = 1; round <= rounds; round++)
+  {
+    // SubBytes and ShiftRows, the state is stored column by column
+    for (c = 0; c < 4; c++)
+    {
+      for (i = 0; i < 4; i++)
+      {
+        t[4 * c + i] = sbox[s[4 * ((c + i) % 4) + i]];
+      }
+    }
+
+    // MixColumns, skipped in the last round
+    if (round != rounds)
+    {
+      for (c = 0; c < 4; c++)
+      {
+        uint8_t *col = &t[4 * c];
+        uint8_t all = col[0] ^ col[1] ^ col[2] ^ col[3];
+        uint8_t first = col[0];
+
+        col[0] ^= all ^ xtime(col[0] ^ col[1]);
+        col[1] ^= all ^ xtime(col[1] ^ col[2]);
+        col[2] ^= all ^ xtime(col[2] ^ col[3]);
+        col[3] ^= all ^ xtime(col[3] ^ first);
+      }
+    }
+
+    for (i = 0; i < AES_BLOCK_SIZE; i++)
+    {
+      s[i] = t[i] ^ roundKeys[AES_BLOCK_SIZE * round + i];
+    }
+  }
+
+  memcpy(out, s, AES_BLOCK_SIZE);
+}
+
+static void ecb(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, int keyWords)
+{
+  uint8_t roundKeys[AES_BLOCK_SIZE * 15];
+  int rounds = keyWords + 6;
+  unsigned int i;
+
+  EFM_ASSERT((len % AES_BLOCK_SIZE) == 0);
+  expandKey(roundKeys, key, keyWords, rounds);
+  for (i = 0; i < len; i += AES_BLOCK_SIZE)
+  {
+    encryptBlock(&out[i], &in[i], roundKeys, rounds);
+  }
+}
+
+static void ctrCrypt(uint8_t *out, const uint8_t *in, unsigned int len,
+                     const uint8_t *key, int keyWords, uint8_t *counter,
+                     AES_CtrFuncPtr_TypeDef ctrFunc)
+{
+  uint8_t roundKeys[AES_BLOCK_SIZE * 15];
+  uint8_t keystream[AES_BLOCK_SIZE];
+  int rounds = keyWords + 6;
+  unsigned int i, j;
+
+  EFM_ASSERT((len % AES_BLOCK_SIZE) == 0);
+  expandKey(roundKeys, key, keyWords, rounds);
+  for (i = 0; i < len; i += AES_BLOCK_SIZE)
+  {
+    encryptBlock(keystream, counter, roundKeys, rounds);
+    for (j = 0; j < AES_BLOCK_SIZE; j++)
+    {
+      out[i + j] = in[i + j] ^ keystream[j];
+    }
+    ctrFunc(counter);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Increment the last 32 bits of a counter block, big-endian, as emlib.
+ ******************************************************************************/
+void AES_CTRUpdate32Bit(uint8_t *ctr)
+{
+  int i;
+
+  for (i = AES_BLOCK_SIZE - 1; i >= AES_BLOCK_SIZE - 4; i--)
+  {
+    if (++ctr[i])
+    {
+      break;
+    }
+  }
+}
+
+void AES_ECB128(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, bool encrypt)
+{
+  EFM_ASSERT(encrypt);
+  ecb(out, in, len, key, 4);
+}
+
+void AES_ECB256(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, bool encrypt)
+{
+  EFM_ASSERT(encrypt);
+  ecb(out, in, len, key, 8);
+}
+
+void AES_CTR128(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, uint8_t *ctr,
+                AES_CtrFuncPtr_TypeDef ctrFunc)
+{
+  ctrCrypt(out, in, len, key, 4, ctr, ctrFunc);
+}
+
+void AES_CTR256(uint8_t *out, const uint8_t *in, unsigned int len,
+                const uint8_t *key, uint8_t *ctr,
+                AES_CtrFuncPtr_TypeDef ctrFunc)
+{
+  ctrCrypt(out, in, len, key, 8, ctr, ctrFunc);
+}
@@ -0,0 +1,429 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Runs the AES-GCM test vectors against src/aes_gcm.c of aes_gcm_128 on
+ * a host.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "aes_gcm.h"
+
+/*
+ * Test cases from "The Galois/Counter Mode of Operation (GCM)", McGrew and
+ * Viega, as used by NIST for the GCM validation. Cases 7 to 12 use 192-bit
+ * keys, which the AES peripheral does not support.
+ */
+
+// Zero key, IV and plaintext of test cases 1, 2, 13 and 14
+static const uint8_t zeros[32];
+
+// Key of test cases 3 to 6
+static const uint8_t key128[16] =
+{
+  0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C,
+  0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+
+// Key of test cases 15 to 18
+static const uint8_t key256[32] =
+{
+  0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C,
+  0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08,
+  0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C,
+  0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+
+// Plaintext of test cases 3 and 15, the first 60 bytes for 4 to 6 and
+// 16 to 18
+static const uint8_t plaintext[64] =
+{
+  0xD9, 0x31, 0x32, 0x25, 0xF8, 0x84, 0x06, 0xE5,
+  0xA5, 0x59, 0x09, 0xC5, 0xAF, 0xF5, 0x26, 0x9A,
+  0x86, 0xA7, 0xA9, 0x53, 0x15, 0x34, 0xF7, 0xDA,
+  0x2E, 0x4C, 0x30, 0x3D, 0x8A, 0x31, 0x8A, 0x72,
+  0x1C, 0x3C, 0x0C, 0x95, 0x95, 0x68, 0x09, 0x53,
+  0x2F, 0xCF, 0x0E, 0x24, 0x49, 0xA6, 0xB5, 0x25,
+  0xB1, 0x6A, 0xED, 0xF5, 0xAA, 0x0D, 0xE6, 0x57,
+  0xBA, 0x63, 0x7B, 0x39, 0x1A, 0xAF, 0xD2, 0x55
+};
+
+// AAD of test cases 4 to 6 and 16 to 18
+static const uint8_t aad[20] =
+{
+  0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+  0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+  0xAB, 0xAD, 0xDA, 0xD2
+};
+
+// 96-bit IV
+static const uint8_t iv96[12] =
+{
+  0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD,
+  0xDE, 0xCA, 0xF8, 0x88
+};
+
+// 64-bit IV, test cases 5 and 17
+static const uint8_t iv64[8] =
+{
+  0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD
+};
+
+// 480-bit IV, test cases 6 and 18
+static const uint8_t iv480[60] =
+{
+  0x93, 0x13, 0x22, 0x5D, 0xF8, 0x84, 0x06, 0xE5,
+  0x55, 0x90, 0x9C, 0x5A, 0xFF, 0x52, 0x69, 0xAA,
+  0x6A, 0x7A, 0x95, 0x38, 0x53, 0x4F, 0x7D, 0xA1,
+  0xE4, 0xC3, 0x03, 0xD2, 0xA3, 0x18, 0xA7, 0x28,
+  0xC3, 0xC0, 0xC9, 0x51, 0x56, 0x80, 0x95, 0x39,
+  0xFC, 0xF0, 0xE2, 0x42, 0x9A, 0x6B, 0x52, 0x54,
+  0x16, 0xAE, 0xDB, 0xF5, 0xA0, 0xDE, 0x6A, 0x57,
+  0xA6, 0x37, 0xB3, 0x9B
+};
+
+// Test case 1
+static const uint8_t tag1[16] =
+{
+  0x58, 0xE2, 0xFC, 0xCE, 0xFA, 0x7E, 0x30, 0x61,
+  0x36, 0x7F, 0x1D, 0x57, 0xA4, 0xE7, 0x45, 0x5A
+};
+
+// Test case 2
+static const uint8_t cipher2[16] =
+{
+  0x03, 0x88, 0xDA, 0xCE, 0x60, 0xB6, 0xA3, 0x92,
+  0xF3, 0x28, 0xC2, 0xB9, 0x71, 0xB2, 0xFE, 0x78
+};
+
+// Test case 2
+static const uint8_t tag2[16] =
+{
+  0xAB, 0x6E, 0x47, 0xD4, 0x2C, 0xEC, 0x13, 0xBD,
+  0xF5, 0x3A, 0x67, 0xB2, 0x12, 0x57, 0xBD, 0xDF
+};
+
+// Test case 3
+static const uint8_t cipher3[64] =
+{
+  0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24,
+  0x4B, 0x72, 0x21, 0xB7, 0x84, 0xD0, 0xD4, 0x9C,
+  0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0,
+  0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E,
+  0x21, 0xD5, 0x14, 0xB2, 0x54, 0x66, 0x93, 0x1C,
+  0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+  0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97,
+  0x3D, 0x58, 0xE0, 0x91, 0x47, 0x3F, 0x59, 0x85
+};
+
+// Test case 3
+static const uint8_t tag3[16] =
+{
+  0x4D, 0x5C, 0x2A, 0xF3, 0x27, 0xCD, 0x64, 0xA6,
+  0x2C, 0xF3, 0x5A, 0xBD, 0x2B, 0xA6, 0xFA, 0xB4
+};
+
+// Test case 4
+static const uint8_t cipher4[60] =
+{
+  0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24,
+  0x4B, 0x72, 0x21, 0xB7, 0x84, 0xD0, 0xD4, 0x9C,
+  0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0,
+  0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E,
+  0x21, 0xD5, 0x14, 0xB2, 0x54, 0x66, 0x93, 0x1C,
+  0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+  0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97,
+  0x3D, 0x58, 0xE0, 0x91
+};
+
+// Test case 4
+static const uint8_t tag4[16] =
+{
+  0x5B, 0xC9, 0x4F, 0xBC, 0x32, 0x21, 0xA5, 0xDB,
+  0x94, 0xFA, 0xE9, 0x5A, 0xE7, 0x12, 0x1A, 0x47
+};
+
+// Test case 5
+static const uint8_t cipher5[60] =
+{
+  0x61, 0x35, 0x3B, 0x4C, 0x28, 0x06, 0x93, 0x4A,
+  0x77, 0x7F, 0xF5, 0x1F, 0xA2, 0x2A, 0x47, 0x55,
+  0x69, 0x9B, 0x2A, 0x71, 0x4F, 0xCD, 0xC6, 0xF8,
+  0x37, 0x66, 0xE5, 0xF9, 0x7B, 0x6C, 0x74, 0x23,
+  0x73, 0x80, 0x69, 0x00, 0xE4, 0x9F, 0x24, 0xB2,
+  0x2B, 0x09, 0x75, 0x44, 0xD4, 0x89, 0x6B, 0x42,
+  0x49, 0x89, 0xB5, 0xE1, 0xEB, 0xAC, 0x0F, 0x07,
+  0xC2, 0x3F, 0x45, 0x98
+};
+
+// Test case 5
+static const uint8_t tag5[16] =
+{
+  0x36, 0x12, 0xD2, 0xE7, 0x9E, 0x3B, 0x07, 0x85,
+  0x56, 0x1B, 0xE1, 0x4A, 0xAC, 0xA2, 0xFC, 0xCB
+};
+
+// Test case 6
+static const uint8_t cipher6[60] =
+{
+  0x8C, 0xE2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xB6,
+  0x03, 0xA0, 0x33, 0xAC, 0xA1, 0x3F, 0xB8, 0x94,
+  0xBE, 0x91, 0x12, 0xA5, 0xC3, 0xA2, 0x11, 0xA8,
+  0xBA, 0x26, 0x2A, 0x3C, 0xCA, 0x7E, 0x2C, 0xA7,
+  0x01, 0xE4, 0xA9, 0xA4, 0xFB, 0xA4, 0x3C, 0x90,
+  0xCC, 0xDC, 0xB2, 0x81, 0xD4, 0x8C, 0x7C, 0x6F,
+  0xD6, 0x28, 0x75, 0xD2, 0xAC, 0xA4, 0x17, 0x03,
+  0x4C, 0x34, 0xAE, 0xE5
+};
+
+// Test case 6
+static const uint8_t tag6[16] =
+{
+  0x61, 0x9C, 0xC5, 0xAE, 0xFF, 0xFE, 0x0B, 0xFA,
+  0x46, 0x2A, 0xF4, 0x3C, 0x16, 0x99, 0xD0, 0x50
+};
+
+// Test case 13
+static const uint8_t tag13[16] =
+{
+  0x53, 0x0F, 0x8A, 0xFB, 0xC7, 0x45, 0x36, 0xB9,
+  0xA9, 0x63, 0xB4, 0xF1, 0xC4, 0xCB, 0x73, 0x8B
+};
+
+// Test case 14
+static const uint8_t cipher14[16] =
+{
+  0xCE, 0xA7, 0x40, 0x3D, 0x4D, 0x60, 0x6B, 0x6E,
+  0x07, 0x4E, 0xC5, 0xD3, 0xBA, 0xF3, 0x9D, 0x18
+};
+
+// Test case 14
+static const uint8_t tag14[16] =
+{
+  0xD0, 0xD1, 0xC8, 0xA7, 0x99, 0x99, 0x6B, 0xF0,
+  0x26, 0x5B, 0x98, 0xB5, 0xD4, 0x8A, 0xB9, 0x19
+};
+
+// Test case 15
+static const uint8_t cipher15[64] =
+{
+  0x52, 0x2D, 0xC1, 0xF0, 0x99, 0x56, 0x7D, 0x07,
+  0xF4, 0x7F, 0x37, 0xA3, 0x2A, 0x84, 0x42, 0x7D,
+  0x64, 0x3A, 0x8C, 0xDC, 0xBF, 0xE5, 0xC0, 0xC9,
+  0x75, 0x98, 0xA2, 0xBD, 0x25, 0x55, 0xD1, 0xAA,
+  0x8C, 0xB0, 0x8E, 0x48, 0x59, 0x0D, 0xBB, 0x3D,
+  0xA7, 0xB0, 0x8B, 0x10, 0x56, 0x82, 0x88, 0x38,
+  0xC5, 0xF6, 0x1E, 0x63, 0x93, 0xBA, 0x7A, 0x0A,
+  0xBC, 0xC9, 0xF6, 0x62, 0x89, 0x80, 0x15, 0xAD
+};
+
+// Test case 15
+static const uint8_t tag15[16] =
+{
+  0xB0, 0x94, 0xDA, 0xC5, 0xD9, 0x34, 0x71, 0xBD,
+  0xEC, 0x1A, 0x50, 0x22, 0x70, 0xE3, 0xCC, 0x6C
+};
+
+// Test case 16
+static const uint8_t cipher16[60] =
+{
+  0x52, 0x2D, 0xC1, 0xF0, 0x99, 0x56, 0x7D, 0x07,
+  0xF4, 0x7F, 0x37, 0xA3, 0x2A, 0x84, 0x42, 0x7D,
+  0x64, 0x3A, 0x8C, 0xDC, 0xBF, 0xE5, 0xC0, 0xC9,
+  0x75, 0x98, 0xA2, 0xBD, 0x25, 0x55, 0xD1, 0xAA,
+  0x8C, 0xB0, 0x8E, 0x48, 0x59, 0x0D, 0xBB, 0x3D,
+  0xA7, 0xB0, 0x8B, 0x10, 0x56, 0x82, 0x88, 0x38,
+  0xC5, 0xF6, 0x1E, 0x63, 0x93, 0xBA, 0x7A, 0x0A,
+  0xBC, 0xC9, 0xF6, 0x62
+};
+
+// Test case 16
+static const uint8_t tag16[16] =
+{
+  0x76, 0xFC, 0x6E, 0xCE, 0x0F, 0x4E, 0x17, 0x68,
+  0xCD, 0xDF, 0x88, 0x53, 0xBB, 0x2D, 0x55, 0x1B
+};
+
+// Test case 17
+static const uint8_t cipher17[60] =
+{
+  0xC3, 0x76, 0x2D, 0xF1, 0xCA, 0x78, 0x7D, 0x32,
+  0xAE, 0x47, 0xC1, 0x3B, 0xF1, 0x98, 0x44, 0xCB,
+  0xAF, 0x1A, 0xE1, 0x4D, 0x0B, 0x97, 0x6A, 0xFA,
+  0xC5, 0x2F, 0xF7, 0xD7, 0x9B, 0xBA, 0x9D, 0xE0,
+  0xFE, 0xB5, 0x82, 0xD3, 0x39, 0x34, 0xA4, 0xF0,
+  0x95, 0x4C, 0xC2, 0x36, 0x3B, 0xC7, 0x3F, 0x78,
+  0x62, 0xAC, 0x43, 0x0E, 0x64, 0xAB, 0xE4, 0x99,
+  0xF4, 0x7C, 0x9B, 0x1F
+};
+
+// Test case 17
+static const uint8_t tag17[16] =
+{
+  0x3A, 0x33, 0x7D, 0xBF, 0x46, 0xA7, 0x92, 0xC4,
+  0x5E, 0x45, 0x49, 0x13, 0xFE, 0x2E, 0xA8, 0xF2
+};
+
+// Test case 18
+static const uint8_t cipher18[60] =
+{
+  0x5A, 0x8D, 0xEF, 0x2F, 0x0C, 0x9E, 0x53, 0xF1,
+  0xF7, 0x5D, 0x78, 0x53, 0x65, 0x9E, 0x2A, 0x20,
+  0xEE, 0xB2, 0xB2, 0x2A, 0xAF, 0xDE, 0x64, 0x19,
+  0xA0, 0x58, 0xAB, 0x4F, 0x6F, 0x74, 0x6B, 0xF4,
+  0x0F, 0xC0, 0xC3, 0xB7, 0x80, 0xF2, 0x44, 0x45,
+  0x2D, 0xA3, 0xEB, 0xF1, 0xC5, 0xD8, 0x2C, 0xDE,
+  0xA2, 0x41, 0x89, 0x97, 0x20, 0x0E, 0xF8, 0x2E,
+  0x44, 0xAE, 0x7E, 0x3F
+};
+
+// Test case 18
+static const uint8_t tag18[16] =
+{
+  0xA4, 0x4A, 0x82, 0x66, 0xEE, 0x1C, 0x8E, 0xB0,
+  0xC8, 0xB5, 0xD4, 0xCF, 0x5A, 0xE9, 0xF1, 0x9A
+};
+
+typedef struct
+{
+  int           testCase;
+  const uint8_t *key;
+  unsigned int  keyBits;
+  const uint8_t *iv;
+  size_t        ivLength;
+  const uint8_t *aad;
+  size_t        aadLength;
+  const uint8_t *plaintext;
+  size_t        length;
+  const uint8_t *ciphertext;
+  const uint8_t *tag;
+} GcmVector_t;
+
+static const GcmVector_t vectors[] =
+{
+  { 1, zeros, 128, zeros, 12, NULL, 0,
+    NULL, 0, NULL, tag1 },
+  { 2, zeros, 128, zeros, 12, NULL, 0,
+    zeros, 16, cipher2, tag2 },
+  { 3, key128, 128, iv96, 12, NULL, 0,
+    plaintext, 64, cipher3, tag3 },
+  { 4, key128, 128, iv96, 12, aad, 20,
+    plaintext, 60, cipher4, tag4 },
+  { 5, key128, 128, iv64, 8, aad, 20,
+    plaintext, 60, cipher5, tag5 },
+  { 6, key128, 128, iv480, 60, aad, 20,
+    plaintext, 60, cipher6, tag6 },
+  { 13, zeros, 256, zeros, 12, NULL, 0,
+    NULL, 0, NULL, tag13 },
+  { 14, zeros, 256, zeros, 12, NULL, 0,
+    zeros, 16, cipher14, tag14 },
+  { 15, key256, 256, iv96, 12, NULL, 0,
+    plaintext, 64, cipher15, tag15 },
+  { 16, key256, 256, iv96, 12, aad, 20,
+    plaintext, 60, cipher16, tag16 },
+  { 17, key256, 256, iv64, 8, aad, 20,
+    plaintext, 60, cipher17, tag17 },
+  { 18, key256, 256, iv480, 60, aad, 20,
+    plaintext, 60, cipher18, tag18 },
+};
+
+/***************************************************************************//**
+ * @brief
+ *   Run one test vector through encryption, decryption and a forged tag.
+ ******************************************************************************/
+static bool checkVector(const GcmVector_t *v)
+{
+  AesGcm_t ctx;
+  uint8_t out[64];
+  uint8_t back[64];
+  uint8_t tag[AES_GCM_TAG_SIZE];
+  bool passed = true;
+
+  aesGcmSetKey(&ctx, v->key, v->keyBits);
+
+  aesGcmEncrypt(&ctx, v->iv, v->ivLength, v->aad, v->aadLength,
+                v->plaintext, out, v->length, tag, sizeof(tag));
+  if ((v->length && memcmp(out, v->ciphertext, v->length))
+      || memcmp(tag, v->tag, sizeof(tag)))
+  {
+    printf("test case %d: encryption mismatch\n", v->testCase);
+    passed = false;
+  }
+
+  if (!aesGcmDecrypt(&ctx, v->iv, v->ivLength, v->aad, v->aadLength,
+                     out, back, v->length, v->tag, sizeof(tag))
+      || (v->length && memcmp(back, v->plaintext, v->length)))
+  {
+    printf("test case %d: decryption failed\n", v->testCase);
+    passed = false;
+  }
+
+  // Truncated tags are checked over their length only
+  if (!aesGcmDecrypt(&ctx, v->iv, v->ivLength, v->aad, v->aadLength,
+                     out, back, v->length, v->tag, 12))
+  {
+    printf("test case %d: 96-bit tag rejected\n", v->testCase);
+    passed = false;
+  }
+
+  // A forged tag must be rejected without writing any plaintext
+  memcpy(tag, v->tag, sizeof(tag));
+  tag[sizeof(tag) - 1] ^= 0x01;
+  memset(back, 0xA5, sizeof(back));
+  if (aesGcmDecrypt(&ctx, v->iv, v->ivLength, v->aad, v->aadLength,
+                    out, back, v->length, tag, sizeof(tag))
+      || (back[0] != 0xA5))
+  {
+    printf("test case %d: forged tag accepted\n", v->testCase);
+    passed = false;
+  }
+
+  return passed;
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main(void)
+{
+  bool passed = true;
+  size_t i;
+
+  for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+  {
+    passed = checkVector(&vectors[i]) && passed;
+  }
+
+  printf("%u test cases: %s\n", (unsigned int)i,
+         passed ? "PASSED" : "FAILED");
+  return passed ? 0 : 1;
+}
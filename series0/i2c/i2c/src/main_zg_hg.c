@@ -49,6 +49,7 @@
 #define CORE_FREQUENCY              14000000
 #define RTC_MIN_TIMEOUT                32000
 #define I2C_ADDRESS                     0xE2
+#define I2C_ADDRESS_MASK                0xFE // Must match exact I2C_ADDRESS
 #define I2C_RXBUFFER_SIZE                 10
 
 // Buffers++
@@ -142,6 +143,7 @@ void initI2C(void)
 
   // Setting up to enable slave mode
   I2C0->SADDR = I2C_ADDRESS;
+  I2C0->SADDRMASK = I2C_ADDRESS_MASK;
   I2C0->CTRL |= I2C_CTRL_SLAVE | I2C_CTRL_AUTOACK | I2C_CTRL_AUTOSN;
   enableI2cSlaveInterrupts();
 }
@@ -197,6 +199,7 @@ void receiveI2CData(void)
 void I2C0_IRQHandler(void)
 {
   int status;
+  uint8_t rxData;
 
   status = I2C0->IF;
 
@@ -212,9 +215,13 @@ void I2C0_IRQHandler(void)
 
   } else if (status & I2C_IF_RXDATAV)
   {
-    // Data received
-    i2c_rxBuffer[i2c_rxBufferIndex] = I2C0->RXDATA;
-    i2c_rxBufferIndex++;
+    // Data received, bytes past the end of the buffer are dropped
+    rxData = I2C0->RXDATA;
+    if (i2c_rxBufferIndex < I2C_RXBUFFER_SIZE)
+    {
+      i2c_rxBuffer[i2c_rxBufferIndex] = rxData;
+      i2c_rxBufferIndex++;
+    }
   }
 
   if(status & I2C_IEN_SSTOP){
@@ -0,0 +1,76 @@
+/***************************************************************************//**
+ * @file leuart_ring.h
+ * @brief Circular DMA receive ring for the LEUART
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef LEUART_RING_H
+#define LEUART_RING_H
+
+#include <stdint.h>
+#include "em_device.h"
+#include "em_dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Series 0 has no LDMA, so this is the DMA (PL230) version of the stream
+ * functions of ldma_ring.c in series2/pdm/pdm_stereo_ldma. The halves of the
+ * ring are written in ping-pong mode by the primary and alternate
+ * descriptors of the channel, and the write position is taken from their
+ * remaining transfer counts. The DMA interrupt must be served before the
+ * DMA has filled another half of the ring.
+ */
+typedef struct {
+  uint8_t *buffer;            // Ring storage, size bytes
+  uint32_t size;              // Power of two, at most 2 * 1024 bytes
+  uint32_t channel;           // DMA channel
+  volatile uint32_t halves;   // Halves completed, counted by the DMA IRQ
+  uint32_t readTotal;         // Bytes consumed since leuartRingInit()
+  uint32_t overruns;          // Times unread data was overwritten
+  DMA_CB_TypeDef callback;
+} LeuartRing_t;
+
+void leuartRingInit(LeuartRing_t *ring, LEUART_TypeDef *leuart,
+                    uint8_t *buffer, uint32_t size,
+                    uint32_t channel, uint32_t dmaReq);
+uint32_t leuartRingAvailable(LeuartRing_t *ring);
+uint32_t leuartRingSpan(LeuartRing_t *ring, const uint8_t **data);
+void leuartRingConsume(LeuartRing_t *ring, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEUART_RING_H
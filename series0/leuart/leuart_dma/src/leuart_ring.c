@@ -0,0 +1,247 @@
+/***************************************************************************//**
+ * @file leuart_ring.c
+ * @brief Circular DMA receive ring for the LEUART
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "em_assert.h"
+#include "em_common.h"
+#include "em_core.h"
+#include "em_dma.h"
+#include "leuart_ring.h"
+
+// Largest transfer count of one DMA descriptor
+#define DMA_MAX_XFER_COUNT  ((_DMA_CTRL_N_MINUS_1_MASK                         \
+                              >> _DMA_CTRL_N_MINUS_1_SHIFT) + 1)
+
+/**************************************************************************//**
+ * @brief
+ *    DMA callback, a half of the ring has been filled
+ *
+ * @details
+ *    The DMA has already switched to the other descriptor. The descriptor
+ *    that completed is refreshed with the same addresses, it takes over
+ *    again once the other half has been filled.
+ *****************************************************************************/
+static void ringHalfDone(unsigned int channel, bool primary, void *user)
+{
+  LeuartRing_t *ring = (LeuartRing_t *) user;
+
+  ring->halves++;
+  DMA_RefreshPingPong(channel, primary, false, NULL, NULL,
+                      ring->size / 2 - 1, false);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Bytes written by a descriptor of the ring
+ *
+ * @details
+ *    The DMA writes the remaining transfer count back to the descriptor
+ *    after every byte, and marks the descriptor invalid once its half is
+ *    complete, until the callback refreshes it.
+ *****************************************************************************/
+static uint32_t descriptorFilled(uint32_t ctrl, uint32_t half)
+{
+  if ((ctrl & _DMA_CTRL_CYCLE_CTRL_MASK) == DMA_CTRL_CYCLE_CTRL_INVALID) {
+    return half;
+  }
+
+  return half - ((ctrl & _DMA_CTRL_N_MINUS_1_MASK)
+                 >> _DMA_CTRL_N_MINUS_1_SHIFT) - 1;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Bytes written into the ring by the DMA since leuartRingInit()
+ *
+ * @details
+ *    Even halves are written by the primary descriptor and odd halves by
+ *    the alternate one.
+ *****************************************************************************/
+static uint32_t ringWritten(LeuartRing_t *ring)
+{
+  DMA_DESCRIPTOR_TypeDef *primary = (DMA_DESCRIPTOR_TypeDef *) DMA->CTRLBASE;
+  DMA_DESCRIPTOR_TypeDef *alternate = (DMA_DESCRIPTOR_TypeDef *) DMA->ALTCTRLBASE;
+  uint32_t half = ring->size / 2;
+  uint32_t halves;
+  uint32_t ctrl;
+  uint32_t next;
+  uint32_t filled;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  halves = ring->halves;
+  if (halves & 1) {
+    ctrl = alternate[ring->channel].CTRL;
+    next = primary[ring->channel].CTRL;
+  } else {
+    ctrl = primary[ring->channel].CTRL;
+    next = alternate[ring->channel].CTRL;
+  }
+  CORE_EXIT_ATOMIC();
+
+  filled = descriptorFilled(ctrl, half);
+  if (filled == half) {
+    // The callback of this half is still pending, the DMA has moved on to
+    // the other descriptor
+    filled += descriptorFilled(next, half);
+  }
+
+  return halves * half + filled;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start receiving into the ring
+ *
+ * @param[in] ring
+ *    Ring state
+ *
+ * @param[in] leuart
+ *    LEUART the data is received by
+ *
+ * @param[in] buffer
+ *    Ring storage
+ *
+ * @param[in] size
+ *    Size of the ring in bytes, a power of two
+ *
+ * @param[in] channel
+ *    DMA channel, must not be used by anything else
+ *
+ * @param[in] dmaReq
+ *    DMA request signal of the LEUART receive buffer, e.g.
+ *    DMAREQ_LEUART0_RXDATAV
+ *
+ * @note
+ *    DMA_Init() must have been called. The ring is never stopped, so the
+ *    DMA, the LEUART and the ring state must stay valid from here on.
+ *****************************************************************************/
+void leuartRingInit(LeuartRing_t *ring, LEUART_TypeDef *leuart,
+                    uint8_t *buffer, uint32_t size,
+                    uint32_t channel, uint32_t dmaReq)
+{
+  uint32_t half = size / 2;
+
+  // Power of two so that the byte counts can wrap, each half is one
+  // descriptor
+  EFM_ASSERT((size >= 2) && ((size & (size - 1)) == 0));
+  EFM_ASSERT(half <= DMA_MAX_XFER_COUNT);
+
+  ring->buffer = buffer;
+  ring->size = size;
+  ring->channel = channel;
+  ring->halves = 0;
+  ring->readTotal = 0;
+  ring->overruns = 0;
+
+  // Channel configuration, the callback refreshes the completed half
+  ring->callback.cbFunc = ringHalfDone;
+  ring->callback.userPtr = ring;
+
+  DMA_CfgChannel_TypeDef channelConfig;
+  channelConfig.highPri   = false;
+  channelConfig.enableInt = true;
+  channelConfig.select    = dmaReq;
+  channelConfig.cb        = &ring->callback;
+  DMA_CfgChannel(channel, &channelConfig);
+
+  // Both descriptors read bytes from RXDATA into consecutive addresses
+  DMA_CfgDescr_TypeDef descriptorConfig;
+  descriptorConfig.dstInc  = dmaDataInc1;
+  descriptorConfig.srcInc  = dmaDataIncNone;
+  descriptorConfig.size    = dmaDataSize1;
+  descriptorConfig.arbRate = dmaArbitrate1;
+  descriptorConfig.hprot   = 0;
+  DMA_CfgDescr(channel, true, &descriptorConfig);
+  DMA_CfgDescr(channel, false, &descriptorConfig);
+
+  DMA_ActivatePingPong(channel,
+                       false,
+                       buffer,                          // First half
+                       (void *) &leuart->RXDATA,
+                       half - 1,
+                       buffer + half,                   // Second half
+                       (void *) &leuart->RXDATA,
+                       half - 1);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Number of received bytes not consumed yet
+ *
+ * @details
+ *    Once the DMA has lapped the reader, everything written so far is
+ *    skipped and the overrun counted.
+ *****************************************************************************/
+uint32_t leuartRingAvailable(LeuartRing_t *ring)
+{
+  uint32_t available = ringWritten(ring) - ring->readTotal;
+
+  if (available > ring->size) {
+    ring->readTotal += available;
+    ring->overruns++;
+    available = 0;
+  }
+
+  return available;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Get the oldest received bytes without copying them
+ *
+ * @param[out] data
+ *    Set to the first byte not consumed yet
+ *
+ * @return
+ *    Number of bytes from data up to the end of the received bytes or of
+ *    the ring, whichever comes first.
+ *****************************************************************************/
+uint32_t leuartRingSpan(LeuartRing_t *ring, const uint8_t **data)
+{
+  uint32_t available = leuartRingAvailable(ring);
+  uint32_t start = ring->readTotal & (ring->size - 1);
+
+  *data = &ring->buffer[start];
+  return SL_MIN(available, ring->size - start);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Release bytes returned by leuartRingSpan()
+ *****************************************************************************/
+void leuartRingConsume(LeuartRing_t *ring, uint32_t count)
+{
+  ring->readTotal += count;
+}
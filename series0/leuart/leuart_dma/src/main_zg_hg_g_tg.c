@@ -1,10 +1,10 @@
 /***************************************************************************//**
  * @file main_zg_hg_g_tg.c
  * @brief This project shows how to configure the LEUART for using DMA to write
- * and read to the LEUART transmit/receive registers while remaining in EM2 (for
- * the most part). The board will be woken up from EM2 to service the DMA
- * interrupt. This example receives input from the serial terminal device and
- * echoes it back. See the readme.txt for details.
+ * and read to the LEUART transmit/receive registers while remaining in EM2
+ * between frames. This example receives input into a circular DMA buffer and
+ * echoes it back when a carriage return is received. See the readme.txt for
+ * details.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -39,45 +39,35 @@
 
 #include "em_device.h"
 #include "em_cmu.h"
+#include "em_core.h"
 #include "em_emu.h"
 #include "em_gpio.h"
 #include "em_leuart.h"
 #include "em_chip.h"
 #include "em_dma.h"
 #include "dmactrl.h"
+#include "leuart_ring.h"
 
-// Number of DMA transfers before triggering interrupt. Making this number
-// smaller will trigger the interrupt more often. This number effectively
-// represents the number of input characters the board can receive before having
-// to trigger an interrupt to refresh the DMA transfer cycle.
-#define NUM_TRANSFER 128
+// Size of the receive ring, a power of two
+#define RX_RING_SIZE  128
 
-/***************************************************************************//**
-* @brief  DMA callback function
-*
-* @details This function gets called after the DMA transfer finishes. It then
-*          refreshes the DMA transfer by activating another basic DMA cycle.
-*
-* @notes The userPtr parameter is not used because we don't need a user defined
-*        pointer to be passed into the interrupt handler for a simple echo
-*        program. However, the function definition needs to have all three of
-*        these parameters because the default handler provided in em_dma.c calls
-*        the user's callback function this way. Alternatively, one could write
-*        their own interrupt handler by defining the following macro:
-*        EXCLUDE_DEFAULT_DMA_IRQ_HANDLER.
-******************************************************************************/
-void refreshTransfer(uint32_t channelNum,
-                     bool isPrimaryDescriptor,
-                     void *userPtr)
-{
-  bool isUseBurst = false;
-  DMA_ActivateBasic(channelNum,
-                    isPrimaryDescriptor,
-                    isUseBurst,
-                    (void *) &LEUART0->TXDATA, // Destination address to transfer to
-                    (void *) &LEUART0->RXDATA, // Source address to transfer from
-                    NUM_TRANSFER);             // Number of DMA transfers minus 1
-}
+// DMA channels
+#define RX_DMA_CHANNEL  0
+#define TX_DMA_CHANNEL  1
+
+// Character that ends a frame
+#define FRAME_END  '\r'
+
+// Receive ring, written by the DMA
+uint8_t rxBuffer[RX_RING_SIZE];
+LeuartRing_t rxRing;
+
+// Set by the LEUART interrupt when FRAME_END has been received
+volatile bool rxFrame = false;
+
+// Bytes of the ring being echoed by the Tx channel
+uint32_t txLength = 0;
+volatile bool txBusy = false;
 
 /**************************************************************************//**
  * @brief
@@ -96,6 +86,11 @@ void initGpio(void)
 /**************************************************************************//**
  * @brief
  *    Initialize the LEUART module
+ *
+ * @details
+ *    The LEUART has no receive timeout, so the end of a frame is detected
+ *    with the signal frame, which raises the SIGF interrupt when FRAME_END
+ *    is received.
  *****************************************************************************/
 void initLeuart(void)
 {
@@ -111,24 +106,43 @@ void initLeuart(void)
   LEUART_Init_TypeDef init = LEUART_INIT_DEFAULT;
   LEUART_Init(LEUART0, &init);
 
-  // Auto wake up DMA when data is received
+  // Auto wake up DMA when data is received or can be sent
   LEUART_RxDmaInEM2Enable(LEUART0, true);
+  LEUART_TxDmaInEM2Enable(LEUART0, true);
+
+  // Wake up the CPU at the end of a frame
+  LEUART0->SIGFRAME = FRAME_END;
+  LEUART_IntClear(LEUART0, LEUART_IF_SIGF);
+  LEUART_IntEnable(LEUART0, LEUART_IEN_SIGF);
+  NVIC_ClearPendingIRQ(LEUART0_IRQn);
+  NVIC_EnableIRQ(LEUART0_IRQn);
 
   // Enable LEUART0 RX/TX pins on PD[5:4] (see readme.txt for details)
   LEUART0->ROUTE = LEUART_ROUTE_LOCATION_LOC0 | LEUART_ROUTE_RXPEN | LEUART_ROUTE_TXPEN;
 }
 
+/**************************************************************************//**
+ * @brief
+ *    DMA callback of the Tx channel, the echo has been sent
+ *****************************************************************************/
+void echoDone(unsigned int channel, bool primary, void *user)
+{
+  (void) channel;
+  (void) primary;
+  (void) user;
+
+  txBusy = false;
+}
+
 /**************************************************************************//**
  * @brief
  *    Initialize the DMA module
  *
  * @details
  *    Always use dmaControlBlock to make sure that the control block is properly
- *    aligned. Tell the DMA module to trigger when there is data in the LEUART
- *    RX buffer. Need to trigger an interrupt upon transfer completion so that
- *    we can refresh the DMA transfer. The Zero Gecko, Happy Gecko, Gecko
- *    devices don't support loop mode with the DMA module. This example chose to
- *    use channel 0.
+ *    aligned. The Rx channel writes every received byte into rxRing and never
+ *    stops. The Tx channel is started by startEcho() for each block that is
+ *    echoed. This example chose to use channels 0 and 1.
  *
  * @note
  *    The callback object needs to at least have static scope persistence so
@@ -145,38 +159,57 @@ void initDma(void)
   init.controlBlock = dmaControlBlock; // Make sure control block is properly aligned
   DMA_Init(&init);
 
+  // Start receiving into the ring
+  leuartRingInit(&rxRing, LEUART0, rxBuffer, RX_RING_SIZE, RX_DMA_CHANNEL,
+                 DMAREQ_LEUART0_RXDATAV);
+
   // Callback configuration
   static DMA_CB_TypeDef callback;
-  callback.cbFunc = (DMA_FuncPtr_TypeDef) refreshTransfer;
+  callback.cbFunc = echoDone;
   callback.userPtr = NULL;
 
-  // Channel configuration
+  // Tx channel configuration
   DMA_CfgChannel_TypeDef channelConfig;
-  channelConfig.highPri   = false; // Set high priority for the channel
-  channelConfig.enableInt = true; // Interrupt needed because no support for loop mode
-  channelConfig.select    = DMAREQ_LEUART0_RXDATAV; // Select DMA trigger
-  channelConfig.cb        = &callback; // Need callback to refresh the DMA transfer
-  uint32_t channelNum     = 0;
-  DMA_CfgChannel(channelNum, &channelConfig);
-
-  // Channel descriptor configuration
+  channelConfig.highPri   = false;
+  channelConfig.enableInt = true;
+  channelConfig.select    = DMAREQ_LEUART0_TXBL;
+  channelConfig.cb        = &callback;
+  DMA_CfgChannel(TX_DMA_CHANNEL, &channelConfig);
+
+  // Tx channel descriptor configuration
   DMA_CfgDescr_TypeDef descriptorConfig;
   descriptorConfig.dstInc  = dmaDataIncNone; // Destination doesn't move
-  descriptorConfig.srcInc  = dmaDataIncNone; // Source doesn't move
+  descriptorConfig.srcInc  = dmaDataInc1;    // Source walks through the ring
   descriptorConfig.size    = dmaDataSize1;   // Transfer 8 bits each time
   descriptorConfig.arbRate = dmaArbitrate1;  // Arbitrate after every DMA transfer
   descriptorConfig.hprot   = 0;              // Access level/protection not an issue
-  bool isPrimaryDescriptor = true;
-  DMA_CfgDescr(channelNum, isPrimaryDescriptor, &descriptorConfig);
-
-  // Activate basic DMA cycle (used for memory-peripheral transfers)
-  bool isUseBurst = false;
-  DMA_ActivateBasic(channelNum,
-                    isPrimaryDescriptor,
-                    isUseBurst,
+  DMA_CfgDescr(TX_DMA_CHANNEL, true, &descriptorConfig);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Echo bytes straight from the ring, without copying them
+ *****************************************************************************/
+void startEcho(const uint8_t *data, uint32_t length)
+{
+  txLength = length;
+  txBusy = true;
+  DMA_ActivateBasic(TX_DMA_CHANNEL,
+                    true,
+                    false,
                     (void *) &LEUART0->TXDATA, // Destination address to transfer to
-                    (void *) &LEUART0->RXDATA, // Source address to transfer from
-                    NUM_TRANSFER);             // Number of DMA transfers minus 1
+                    (void *) data,             // Source address to transfer from
+                    length - 1);               // Number of DMA transfers minus 1
+}
+
+/**************************************************************************//**
+ * @brief
+ *    LEUART0 interrupt handler, FRAME_END has been received
+ *****************************************************************************/
+void LEUART0_IRQHandler(void)
+{
+  LEUART_IntClear(LEUART0, LEUART_IF_SIGF);
+  rxFrame = true;
 }
 
 /**************************************************************************//**
@@ -184,11 +217,18 @@ void initDma(void)
  *    Main function
  *
  * @details
- *    Initialize the GPIO, LEUART, and DMA modules. Go into EM2 forever and let
- *    the DMA take care of the data receiving/sending.
+ *    Initialize the GPIO, LEUART, and DMA modules. Sleep in EM2 and let the
+ *    DMA receive into the ring. Echo each frame once it is complete, or once
+ *    half of the ring has filled up so that long frames don't overrun it.
  *****************************************************************************/
 int main(void)
 {
+  const uint8_t *data;
+  uint32_t available;
+  uint32_t length;
+  bool frame;
+  CORE_DECLARE_IRQ_STATE;
+
   // Chip errata
   CHIP_Init();
 
@@ -198,8 +238,35 @@ int main(void)
   initDma();
 
   while (1) {
-    EMU_EnterEM2(false); // Only exit EM2 to service the DMA interrupt that
-                         // refreshes the DMA transfer cycle
+    if (!txBusy) {
+      // Release the bytes that have been echoed
+      leuartRingConsume(&rxRing, txLength);
+      txLength = 0;
+
+      CORE_ENTER_ATOMIC();
+      frame = rxFrame;
+      rxFrame = false;
+      CORE_EXIT_ATOMIC();
+
+      // Data that wraps around the end of the ring is sent in two blocks
+      available = leuartRingAvailable(&rxRing);
+      if ((frame || (available >= RX_RING_SIZE / 2)) && available) {
+        length = leuartRingSpan(&rxRing, &data);
+        if (length < available) {
+          rxFrame = true;
+        }
+        startEcho(data, length);
+      }
+    }
+
+    // Stay in EM2 until a frame ends, half of the ring fills up or the echo
+    // is done. The DMA interrupts at the end of each half of the ring wake
+    // the device up briefly.
+    CORE_ENTER_ATOMIC();
+    if (txBusy || (!rxFrame
+                   && leuartRingAvailable(&rxRing) < RX_RING_SIZE / 2)) {
+      EMU_EnterEM2(false);
+    }
+    CORE_EXIT_ATOMIC();
   }
 }
-
@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ * @file servo_sequencer.h
+ * @brief Servo sequencer: every Compare/Capture channel of the TIMERs is fed a
+ * table of compare values by its own DMA channel, one value per PWM period.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef SERVO_SEQUENCER_H
+#define SERVO_SEQUENCER_H
+
+#include <stdint.h>
+#include "em_device.h"
+#include "em_dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest table, each half is one DMA cycle of at most 1024 transfers
+#define SERVO_SEQUENCE_MAX_LENGTH  2048
+
+// Profile from the pulse width of the previous keyframe to that of the next
+typedef enum
+{
+  servoRampStep,    // Jump to the new pulse width and hold it
+  servoRampLinear,  // Constant speed
+  servoRampEase     // Accelerate, then decelerate (smoothstep)
+} ServoRamp_t;
+
+typedef struct
+{
+  uint16_t    pulseUs;  // Pulse width reached at the end of the segment
+  uint16_t    periods;  // Length of the segment in PWM periods
+  ServoRamp_t ramp;     // Profile of the segment
+} ServoKeyframe_t;
+
+/*
+ * One servo: a Compare/Capture channel in PWM mode and the DMA channel
+ * that writes its CCVB. The compare event of the channel requests the
+ * DMA, which writes the compare value of the next period to CCVB, and
+ * writing CCVB clears the request. The table is sent in two halves with
+ * the primary and alternate descriptors of the channel, so the CPU is
+ * only interrupted to rearm a descriptor once per half of the table.
+ */
+typedef struct
+{
+  TIMER_TypeDef  *timer;       // TIMER of the output
+  unsigned int    cc;          // Compare/Capture channel of the output
+  unsigned int    dmaChannel;  // DMA channel writing CCVB
+  uint32_t        dmaRequest;  // DMAREQ_TIMERn_CCx of the output
+  uint16_t       *table;       // Compare values, one per PWM period
+  uint32_t        length;      // Values in the table, even
+  DMA_CB_TypeDef  callback;    // Set by servoSequencerStart()
+} ServoChannel_t;
+
+void servoSequencerBuild(uint16_t *table, uint32_t length,
+                         const ServoKeyframe_t *keyframes, uint32_t count,
+                         uint32_t phase, uint32_t timerFreq);
+void servoSequencerStart(ServoChannel_t *servo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERVO_SEQUENCER_H
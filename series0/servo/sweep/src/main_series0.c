@@ -1,10 +1,10 @@
 /***************************************************************************//**
  * @file main_series0.c
  * @brief This project demonstrates controlling servo motors using pulse width
- * modulation generated by the TIMER module. The GPIO pin specified in the
- * readme.txt is configured for output and outputs a 1kHz, 30% duty cycle
- * signal. The duty cycle can be adjusted by writing to the CCVB or changing the
- * global dutyCyclePercent variable.
+ * modulation generated by the TIMER module. Up to eight outputs, one per DMA
+ * channel of the device and listed in the readme.txt, output a 50 Hz signal
+ * whose pulse width follows a table of compare values built from keyframes.
+ * The DMA writes the values to the CCVB registers, so the CPU stays in EM1.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -43,35 +43,63 @@
 #include "em_chip.h"
 #include "em_gpio.h"
 #include "em_timer.h"
-#include "bsp.h"
+#include "em_dma.h"
+#include "dmactrl.h"
+#include "servo_sequencer.h"
 
- // Note: change this to set the desired output frequency in Hz
+// Note: change this to set the desired output frequency in Hz
 #define PWM_FREQ 50
 
-// Note: change this to set the desired duty cycle (used to update CCVB value)
-static volatile int dutyCyclePercent = 30;
-
-// stores 1 msTicks from the SysTick timer
-volatile uint32_t msTicks = 0;
-
-/**************************************************************************//**
- * @brief
- *    Interrupt handler for TIMER1 that changes the duty cycle
- *
- * @note
- *    This handler doesn't actually dynamically change the duty cycle. Instead,
- *    it acts as a template for doing so. Simply change the dutyCyclePercent
- *    global variable here to dynamically change the duty cycle.
- *****************************************************************************/
-void TIMER1_IRQHandler(void)
-{
-  // Acknowledge the interrupt
-  uint32_t flags = TIMER_IntGet(TIMER1);
-  TIMER_IntClear(TIMER1, flags);
-
-  // Update CCVB to alter duty cycle starting next period
-  TIMER_CompareBufSet(TIMER1, 0, (TIMER_TopGet(TIMER1) * dutyCyclePercent) / 100);
-}
+// TIMER prescaler, the TOP value has to fit in 16 bits
+#define PWM_PRESCALE 8
+
+// TIMER1 drives two servos on every device, TIMER0 three more on devices
+// with 8 DMA channels or more and TIMER2 three more on those that have it
+#if (DMA_CHAN_COUNT >= 8)
+#define SERVO_TIMER0
+#if defined(TIMER2)
+#define SERVO_TIMER2
+#endif
+#endif
+
+#if defined(SERVO_TIMER2)
+#define SERVO_COUNT 8
+#elif defined(SERVO_TIMER0)
+#define SERVO_COUNT 5
+#else
+#define SERVO_COUNT 2
+#endif
+
+// PWM periods in the sequence (2 seconds), must be even
+#define SEQUENCE_LENGTH 100
+
+// Note: change this to set the sequence, the periods must add up to
+// SEQUENCE_LENGTH
+static const ServoKeyframe_t sweep[] = {
+  { 1000, 25, servoRampEase },    // Ease to 1 ms
+  { 1000, 10, servoRampStep },    // Hold
+  { 2000, 50, servoRampLinear },  // Sweep to 2 ms at constant speed
+  { 2000, 15, servoRampStep },    // Hold
+};
+
+// Compare values streamed by the DMA
+static uint16_t tables[SERVO_COUNT][SEQUENCE_LENGTH];
+
+// Servo outputs, routed by initTimer()
+static ServoChannel_t servos[SERVO_COUNT] = {
+  { .timer = TIMER1, .cc = 0, .dmaRequest = DMAREQ_TIMER1_CC0 },  // PD6
+  { .timer = TIMER1, .cc = 1, .dmaRequest = DMAREQ_TIMER1_CC1 },  // PD7
+#if defined(SERVO_TIMER0)
+  { .timer = TIMER0, .cc = 0, .dmaRequest = DMAREQ_TIMER0_CC0 },  // PD1
+  { .timer = TIMER0, .cc = 1, .dmaRequest = DMAREQ_TIMER0_CC1 },  // PD2
+  { .timer = TIMER0, .cc = 2, .dmaRequest = DMAREQ_TIMER0_CC2 },  // PD3
+#endif
+#if defined(SERVO_TIMER2)
+  { .timer = TIMER2, .cc = 0, .dmaRequest = DMAREQ_TIMER2_CC0 },  // PA8
+  { .timer = TIMER2, .cc = 1, .dmaRequest = DMAREQ_TIMER2_CC1 },  // PA9
+  { .timer = TIMER2, .cc = 2, .dmaRequest = DMAREQ_TIMER2_CC2 },  // PA10
+#endif
+};
 
 /**************************************************************************//**
  * @brief GPIO initialization
@@ -81,8 +109,19 @@ void initGpio(void)
   // Enable GPIO and clock
   CMU_ClockEnable(cmuClock_GPIO, true);
 
-  // Configure PD6 (See readme for Exp. pin out) as output
+  // Configure the servo outputs (See readme for Exp. pin out)
   GPIO_PinModeSet(gpioPortD, 6, gpioModePushPull, 0);
+  GPIO_PinModeSet(gpioPortD, 7, gpioModePushPull, 0);
+#if defined(SERVO_TIMER0)
+  GPIO_PinModeSet(gpioPortD, 1, gpioModePushPull, 0);
+  GPIO_PinModeSet(gpioPortD, 2, gpioModePushPull, 0);
+  GPIO_PinModeSet(gpioPortD, 3, gpioModePushPull, 0);
+#endif
+#if defined(SERVO_TIMER2)
+  GPIO_PinModeSet(gpioPortA, 8, gpioModePushPull, 0);
+  GPIO_PinModeSet(gpioPortA, 9, gpioModePushPull, 0);
+  GPIO_PinModeSet(gpioPortA, 10, gpioModePushPull, 0);
+#endif
 }
 
 /**************************************************************************//**
@@ -91,54 +130,56 @@ void initGpio(void)
  *****************************************************************************/
 void initTimer(void)
 {
-  // Enable clock for TIMER1 module
+  // TIM1_CC0-1 #4 are PD6-PD7
   CMU_ClockEnable(cmuClock_TIMER1, true);
-
-  // Configure TIMER1 Compare/Capture for output compare
-  // Use PWM mode, which sets output on overflow and clears on compare events
-  TIMER_InitCC_TypeDef timerCCInit = TIMER_INITCC_DEFAULT;
-  timerCCInit.mode = timerCCModePWM;
-  TIMER_InitCC(TIMER1, 0, &timerCCInit);
-
-  // Route TIMER1 CC0 to location 4 and enable CC0 route pin
-  // TIM1_CC0 #4 is GPIO Pin PD6
-  TIMER1->ROUTE |= (TIMER_ROUTE_CC0PEN | TIMER_ROUTE_LOCATION_LOC4);
-
-  // Set top value to overflow at the desired PWM_FREQ frequency
-  TIMER_TopSet(TIMER1, CMU_ClockFreqGet(cmuClock_TIMER1) / (8 * PWM_FREQ));
-
-  // Set compare value for initial duty cycle
-  TIMER_CompareSet(TIMER1, 0, (TIMER_TopGet(TIMER1) * dutyCyclePercent) / 100);
-
-  // Initialize the timer
-  TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
-  timerInit.prescale = timerPrescale8;
-  TIMER_Init(TIMER1, &timerInit);
-
-  // Enable TIMER1 compare event interrupts to update the duty cycle
-  TIMER_IntEnable(TIMER1, TIMER_IEN_CC0);
-  NVIC_EnableIRQ(TIMER1_IRQn);
-}
-
-/**************************************************************************//**
- * @brief SysTick_Handler
- * Interrupt Service Routine for system tick counter
- *****************************************************************************/
-void SysTick_Handler(void)
-{
-  msTicks++;       // increment counter necessary in Delay()
+  TIMER1->ROUTE = TIMER_ROUTE_CC0PEN | TIMER_ROUTE_CC1PEN
+                  | TIMER_ROUTE_LOCATION_LOC4;
+  TIMER_TopSet(TIMER1, CMU_ClockFreqGet(cmuClock_TIMER1) / (PWM_PRESCALE * PWM_FREQ));
+
+#if defined(SERVO_TIMER0)
+  // TIM0_CC0-2 #3 are PD1-PD3
+  CMU_ClockEnable(cmuClock_TIMER0, true);
+  TIMER0->ROUTE = TIMER_ROUTE_CC0PEN | TIMER_ROUTE_CC1PEN | TIMER_ROUTE_CC2PEN
+                  | TIMER_ROUTE_LOCATION_LOC3;
+  TIMER_TopSet(TIMER0, CMU_ClockFreqGet(cmuClock_TIMER0) / (PWM_PRESCALE * PWM_FREQ));
+#endif
+
+#if defined(SERVO_TIMER2)
+  // TIM2_CC0-2 #0 are PA8-PA10
+  CMU_ClockEnable(cmuClock_TIMER2, true);
+  TIMER2->ROUTE = TIMER_ROUTE_CC0PEN | TIMER_ROUTE_CC1PEN | TIMER_ROUTE_CC2PEN
+                  | TIMER_ROUTE_LOCATION_LOC0;
+  TIMER_TopSet(TIMER2, CMU_ClockFreqGet(cmuClock_TIMER2) / (PWM_PRESCALE * PWM_FREQ));
+#endif
 }
 
 /**************************************************************************//**
- * @brief Delays number of msTick Systicks (typically 1 ms)
- * @param dlyTicks Number of ticks to delay
+ * @brief
+ *    Build the tables and start streaming them to the servos
+ *
+ * @details
+ *    Every servo runs the same sequence, each one a fraction of it later
+ *    than the one before.
  *****************************************************************************/
-void Delay(uint32_t dlyTicks)
+void initSequencer(void)
 {
-  uint32_t curTicks;
-
-  curTicks = msTicks;
-  while ((msTicks - curTicks) < dlyTicks) ;
+  uint32_t timerFreq = CMU_ClockFreqGet(cmuClock_TIMER1) / PWM_PRESCALE;
+
+  DMA_Init_TypeDef init;
+  init.hprot = 0;                      // Access level/protection not an issue
+  init.controlBlock = dmaControlBlock; // Make sure control block is properly aligned
+  DMA_Init(&init);
+
+  for (uint32_t i = 0; i < SERVO_COUNT; i++) {
+    servoSequencerBuild(tables[i], SEQUENCE_LENGTH,
+                        sweep, sizeof(sweep) / sizeof(sweep[0]),
+                        i * SEQUENCE_LENGTH / SERVO_COUNT, timerFreq);
+
+    servos[i].dmaChannel = i;
+    servos[i].table = tables[i];
+    servos[i].length = SEQUENCE_LENGTH;
+    servoSequencerStart(&servos[i]);
+  }
 }
 
 /**************************************************************************//**
@@ -153,24 +194,21 @@ int main(void)
   // Initializations
   initGpio();
   initTimer();
+  initSequencer();
 
-  // Setup SysTick Timer for 1 msec interrupts
-  if (SysTick_Config(CMU_ClockFreqGet(cmuClock_CORE) / 1000)) while (1) ;
-
-  while (1)
-  {
-
-    for(int i = 0; i < 20; i++)
-    {
-    	dutyCyclePercent = i;
-    	Delay(60);
-    }
-
-    for(int i = 20; i >= 0; i--)
-    {
-    	dutyCyclePercent = i;
-    	Delay(60);
-    }
+  // Start the timers once their channels and the DMA are ready
+  TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
+  timerInit.prescale = timerPrescale8; // PWM_PRESCALE
+  TIMER_Init(TIMER1, &timerInit);
+#if defined(SERVO_TIMER0)
+  TIMER_Init(TIMER0, &timerInit);
+#endif
+#if defined(SERVO_TIMER2)
+  TIMER_Init(TIMER2, &timerInit);
+#endif
+
+  while (1) {
+    EMU_EnterEM1(); // Enter EM1 (will only exit to rearm a DMA descriptor
+                    // once per half of a table)
   }
 }
-
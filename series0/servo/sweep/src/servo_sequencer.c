@@ -0,0 +1,223 @@
+/***************************************************************************//**
+ * @file servo_sequencer.c
+ * @brief Servo sequencer: every Compare/Capture channel of the TIMERs is fed a
+ * table of compare values by its own DMA channel, one value per PWM period.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "em_device.h"
+#include "em_assert.h"
+#include "em_dma.h"
+#include "em_timer.h"
+#include "servo_sequencer.h"
+
+// Fraction of a segment in Q15
+#define RAMP_ONE  (1UL << 15)
+
+/**************************************************************************//**
+ * @brief
+ *    Fraction of the way from one pulse width to the next, in Q15, after
+ *    period k of a segment of n periods
+ *****************************************************************************/
+static uint32_t rampFraction(ServoRamp_t ramp, uint32_t k, uint32_t n)
+{
+  uint32_t x = (k * RAMP_ONE) / n;
+
+  switch (ramp) {
+    case servoRampLinear:
+      return x;
+
+    case servoRampEase:
+      // 3x^2 - 2x^3, ordered so that no product exceeds 32 bits
+      return (((x * x) >> 15) * (3 * RAMP_ONE - 2 * x)) >> 15;
+
+    default:
+      return RAMP_ONE;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Fill a table with the compare values of a looped sequence of keyframes
+ *
+ * @details
+ *    Each keyframe ends a segment that starts from the pulse width of the
+ *    keyframe before it, the first one from that of the last keyframe, so
+ *    the table can be sent over and over. The pulse widths are interpolated
+ *    in microseconds and converted to TIMER ticks.
+ *
+ *    The DMA reads the table while it runs, so a table can be rebuilt at
+ *    any time; the new values are output as the DMA reaches them.
+ *
+ * @param[out] table
+ *    Compare values, one per PWM period
+ *
+ * @param[in] length
+ *    Values in the table, the sum of the periods of the keyframes
+ *
+ * @param[in] keyframes
+ *    Segments of the sequence
+ *
+ * @param[in] count
+ *    Number of keyframes
+ *
+ * @param[in] phase
+ *    Period of the sequence the table starts with, to run the same
+ *    sequence on several servos one after another
+ *
+ * @param[in] timerFreq
+ *    Frequency of the TIMER counter after prescaling in Hz
+ *****************************************************************************/
+void servoSequencerBuild(uint16_t *table, uint32_t length,
+                         const ServoKeyframe_t *keyframes, uint32_t count,
+                         uint32_t phase, uint32_t timerFreq)
+{
+  uint32_t ticksPerMs = timerFreq / 1000;
+  uint32_t index = (length - (phase % length)) % length;
+  int32_t from = keyframes[count - 1].pulseUs;
+  int32_t pulse;
+  uint32_t total = 0;
+  uint32_t ticks;
+  uint32_t i, k;
+
+  EFM_ASSERT((length % 2) == 0 && length <= SERVO_SEQUENCE_MAX_LENGTH);
+
+  for (i = 0; i < count; i++) {
+    int32_t delta = (int32_t) keyframes[i].pulseUs - from;
+    uint32_t n = keyframes[i].periods;
+
+    total += n;
+    EFM_ASSERT(total <= length);
+
+    for (k = 1; k <= n; k++) {
+      // Signed division, which rounds towards zero both ways
+      pulse = from + (delta * (int32_t) rampFraction(keyframes[i].ramp, k, n))
+                     / (int32_t) RAMP_ONE;
+      ticks = ((uint32_t) pulse * ticksPerMs) / 1000;
+
+      // A compare value of 0 would never clear the output
+      EFM_ASSERT(ticks > 0 && ticks <= 0xFFFF);
+      table[index] = (uint16_t) ticks;
+
+      if (++index == length)
+        index = 0;
+    }
+
+    from = keyframes[i].pulseUs;
+  }
+
+  EFM_ASSERT(total == length);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    DMA callback, rearms the descriptor that has just sent its half of the
+ *    table while the other one sends the other half
+ *
+ * @note
+ *    The default DMA interrupt handler of em_dma.c toggles the descriptor
+ *    to refresh, primary is the one that has completed.
+ *****************************************************************************/
+static void servoRefresh(unsigned int channel, bool primary, void *user)
+{
+  ServoChannel_t *servo = (ServoChannel_t *) user;
+  uint32_t half = servo->length / 2;
+
+  DMA_RefreshPingPong(channel,
+                      primary,
+                      false,                                    // No burst
+                      (void *) &servo->timer->CC[servo->cc].CCVB,
+                      primary ? servo->table : servo->table + half,
+                      half - 1,                                 // Transfers minus 1
+                      false);                                   // Don't stop
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Configure a Compare/Capture channel for PWM and start its DMA channel
+ *
+ * @details
+ *    DMA_Init() must have been called. The TIMER can be running or be
+ *    started afterwards; in both cases the first compare value is held for
+ *    a period more than the others.
+ *
+ *    The Compare/Capture channel requests the DMA on its compare event.
+ *    The TIMER is left with DMACLRACT cleared, so the request stays set
+ *    until the DMA writes CCVB, one value per period, and CCVB is loaded
+ *    into CCV on the next overflow.
+ *****************************************************************************/
+void servoSequencerStart(ServoChannel_t *servo)
+{
+  uint32_t half = servo->length / 2;
+  volatile uint32_t *ccvb = &servo->timer->CC[servo->cc].CCVB;
+
+  EFM_ASSERT(servo->dmaChannel < DMA_CHAN_COUNT);
+  EFM_ASSERT(half > 0 && half <= SERVO_SEQUENCE_MAX_LENGTH / 2);
+
+  // Use PWM mode, which sets output on overflow and clears on compare events
+  TIMER_InitCC_TypeDef timerCCInit = TIMER_INITCC_DEFAULT;
+  timerCCInit.mode = timerCCModePWM;
+  TIMER_InitCC(servo->timer, servo->cc, &timerCCInit);
+  TIMER_CompareSet(servo->timer, servo->cc, servo->table[0]);
+
+  // Callback to rearm the descriptors, once per half of the table
+  servo->callback.cbFunc  = servoRefresh;
+  servo->callback.userPtr = servo;
+
+  DMA_CfgChannel_TypeDef channelConfig;
+  channelConfig.highPri   = false;
+  channelConfig.enableInt = true;
+  channelConfig.select    = servo->dmaRequest;
+  channelConfig.cb        = &servo->callback;
+  DMA_CfgChannel(servo->dmaChannel, &channelConfig);
+
+  // Half-words from the table to the fixed CCVB register
+  DMA_CfgDescr_TypeDef descriptorConfig;
+  descriptorConfig.dstInc  = dmaDataIncNone;
+  descriptorConfig.srcInc  = dmaDataInc2;
+  descriptorConfig.size    = dmaDataSize2;
+  descriptorConfig.arbRate = dmaArbitrate1;
+  descriptorConfig.hprot   = 0;
+  DMA_CfgDescr(servo->dmaChannel, true, &descriptorConfig);  // Primary descriptor
+  DMA_CfgDescr(servo->dmaChannel, false, &descriptorConfig); // Alternate descriptor
+
+  DMA_ActivatePingPong(servo->dmaChannel,
+                       false,                       // No burst
+                       (void *) ccvb,               // Primary: first half
+                       servo->table,
+                       half - 1,
+                       (void *) ccvb,               // Alternate: second half
+                       servo->table + half,
+                       half - 1);
+}
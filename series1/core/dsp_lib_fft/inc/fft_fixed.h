@@ -0,0 +1,89 @@
+/***************************************************************************//**
+ * @file fft_fixed.h
+ * @brief Fixed-point (Q15 and Q31) real FFT with fused windowing.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef FFT_FIXED_H
+#define FFT_FIXED_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Real FFT of any power of two length from FFT_FIXED_MIN_LENGTH to
+ * FFT_FIXED_MAX_LENGTH in Q15 or Q31, for devices without an FPU. The
+ * code is plain C and needs neither an FPU nor the CMSIS DSP library.
+ *
+ * The length N input is packed into an N/2 point complex FFT, which is
+ * followed by a split step. The window is applied while the input is
+ * loaded in bit-reversed order, so it costs no extra pass. Windows are
+ * symmetric and only their first length / 2 samples are stored. Every radix-2
+ * stage halves its outputs, so the result cannot overflow: the output is
+ * the DFT of the windowed input divided by N.
+ *
+ * The output holds N values packed like the CMSIS real FFT:
+ * out[0] = X[0], out[1] = X[N/2] (both real) and out[2k], out[2k+1] =
+ * real and imaginary part of X[k] for k = 1..N/2-1.
+ */
+
+#define FFT_FIXED_MIN_LENGTH    32
+#define FFT_FIXED_MAX_LENGTH    4096
+
+typedef struct
+{
+  uint32_t      length;         // Number of real input samples
+  const int16_t *window;        // Q15 half window, or NULL
+} FftQ15_t;
+
+typedef struct
+{
+  uint32_t      length;         // Number of real input samples
+  const int32_t *window;        // Q31 half window, or NULL
+} FftQ31_t;
+
+void fftQ15Init(FftQ15_t *fft, uint32_t length, const int16_t *window);
+void fftQ15Real(const FftQ15_t *fft, const int16_t *in, int16_t *out);
+void fftQ15Magnitude(const int16_t *freq, int16_t *mag, uint32_t bins);
+
+void fftQ31Init(FftQ31_t *fft, uint32_t length, const int32_t *window);
+void fftQ31Real(const FftQ31_t *fft, const int32_t *in, int32_t *out);
+void fftQ31Magnitude(const int32_t *freq, int32_t *mag, uint32_t bins);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FFT_FIXED_H
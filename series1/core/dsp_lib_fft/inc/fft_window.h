@@ -0,0 +1,174 @@
+/***************************************************************************//**
+ * @file fft_window.h
+ * @brief Window tables evaluated by the compiler for FFT lengths 32 to 4096.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef FFT_WINDOW_H
+#define FFT_WINDOW_H
+
+/*
+ * The macros below expand to the initializer of a window table for a given
+ * FFT length, evaluated by the compiler, so tables can be const and placed
+ * in flash and follow the FFT length without regenerating data by hand:
+ *
+ *   const float32_t window[FFTSIZE / 2] =
+ *   {
+ *     FFT_WINDOW_F32(FFT_WINDOW_HAMMING, FFTSIZE)
+ *   };
+ *
+ * The windows are symmetric, w[n] = w[length - 1 - n], so the tables only
+ * hold the first length / 2 samples. The length must be a power of two from
+ * 32 to 4096 written as a decimal constant, or a macro defined as one.
+ *
+ * w[n] is evaluated in double precision from x = 2 * pi * n / (length - 1),
+ * with cos(x) from its Taylor series (accurate to 1e-15 on 0..pi), and
+ * rounded once to the table type. The Q15 and Q31 tables are saturated, as
+ * the center samples of long windows round to 1.0.
+ */
+
+/***************************************************************************//**
+ * @name Window functions
+ * @brief w as a function of c = cos(x), written in powers of c with
+ *        cos(2x) = 2c^2 - 1, cos(3x) = 4c^3 - 3c and cos(4x) = 8c^4 - 8c^2 + 1
+ * @{
+ ******************************************************************************/
+#define FFT_WINDOW_HAMMING(c)           (0.54 - 0.46 * (c))
+
+#define FFT_WINDOW_HANN(c)              (0.5 - 0.5 * (c))
+
+// 4-term Blackman-Harris, a0 - a1 cos(x) + a2 cos(2x) - a3 cos(3x)
+#define FFT_WINDOW_BH_A0                0.35875
+#define FFT_WINDOW_BH_A1                0.48829
+#define FFT_WINDOW_BH_A2                0.14128
+#define FFT_WINDOW_BH_A3                0.01168
+#define FFT_WINDOW_BLACKMAN_HARRIS(c)                                    \
+  ((FFT_WINDOW_BH_A0 - FFT_WINDOW_BH_A2)                                 \
+   + (c) * ((3.0 * FFT_WINDOW_BH_A3 - FFT_WINDOW_BH_A1)                  \
+   + (c) * ((2.0 * FFT_WINDOW_BH_A2)                                     \
+   + (c) * (-4.0 * FFT_WINDOW_BH_A3))))
+
+// Flat-top, a0 - a1 cos(x) + a2 cos(2x) - a3 cos(3x) + a4 cos(4x)
+#define FFT_WINDOW_FT_A0                0.21557895
+#define FFT_WINDOW_FT_A1                0.41663158
+#define FFT_WINDOW_FT_A2                0.277263158
+#define FFT_WINDOW_FT_A3                0.083578947
+#define FFT_WINDOW_FT_A4                0.006947368
+#define FFT_WINDOW_FLAT_TOP(c)                                           \
+  ((FFT_WINDOW_FT_A0 - FFT_WINDOW_FT_A2 + FFT_WINDOW_FT_A4)              \
+   + (c) * ((3.0 * FFT_WINDOW_FT_A3 - FFT_WINDOW_FT_A1)                  \
+   + (c) * ((2.0 * FFT_WINDOW_FT_A2 - 8.0 * FFT_WINDOW_FT_A4)            \
+   + (c) * ((-4.0 * FFT_WINDOW_FT_A3)                                    \
+   + (c) * (8.0 * FFT_WINDOW_FT_A4)))))
+/** @} */
+
+/***************************************************************************//**
+ * @name Table initializers
+ * @brief Expand to the first length / 2 samples of window as float, Q15 or
+ *        Q31 values
+ * @{
+ ******************************************************************************/
+#define FFT_WINDOW_F32(window, length) \
+  FFT_WINDOW_ENTRIES(FFT_WINDOW_ENTRY_F32, window, length)
+#define FFT_WINDOW_Q15(window, length) \
+  FFT_WINDOW_ENTRIES(FFT_WINDOW_ENTRY_Q15, window, length)
+#define FFT_WINDOW_Q31(window, length) \
+  FFT_WINDOW_ENTRIES(FFT_WINDOW_ENTRY_Q31, window, length)
+/** @} */
+
+// cos(2 * pi * n / (length - 1)) for 0 <= n < length / 2
+#define FFT_WINDOW_X2(n, length)                                         \
+  ((n) * (n) * (39.478417604357434 / (((length) - 1.0) * ((length) - 1.0))))
+#define FFT_WINDOW_COS(n, length)                                        \
+  FFT_WINDOW_COS_P(FFT_WINDOW_X2(n, length))
+#define FFT_WINDOW_COS_P(x2)                                             \
+  (1.0 - (x2) / 2.0 * (1.0 - (x2) / 12.0 * (1.0 - (x2) / 30.0           \
+  * (1.0 - (x2) / 56.0 * (1.0 - (x2) / 90.0 * (1.0 - (x2) / 132.0       \
+  * (1.0 - (x2) / 182.0 * (1.0 - (x2) / 240.0 * (1.0 - (x2) / 306.0     \
+  * (1.0 - (x2) / 380.0 * (1.0 - (x2) / 462.0 * (1.0 - (x2) / 552.0     \
+  * (1.0 - (x2) / 650.0)))))))))))))
+
+#define FFT_WINDOW_ENTRY_F32(window, length, n)                          \
+  (float)(window(FFT_WINDOW_COS(n, length))),
+#define FFT_WINDOW_ENTRY_Q15(window, length, n)                          \
+  ((window(FFT_WINDOW_COS(n, length))) >= 32767.0 / 32768.0 ? 0x7FFF     \
+   : (int16_t)((int32_t)((window(FFT_WINDOW_COS(n, length))) * 32768.0  \
+                         + 32768.5) - 32768)),
+#define FFT_WINDOW_ENTRY_Q31(window, length, n)                          \
+  ((window(FFT_WINDOW_COS(n, length))) >= 2147483647.0 / 2147483648.0   \
+   ? 0x7FFFFFFF                                                          \
+   : (int32_t)((int64_t)((window(FFT_WINDOW_COS(n, length)))            \
+                         * 2147483648.0 + 2147483648.5) - 2147483648LL)),
+
+// Expand entry(window, length, n) for n = 0 to length / 2 - 1, with n
+// written as an octal constant
+#define FFT_WINDOW_ENTRIES(entry, window, length) \
+  FFT_WINDOW_ENTRIES_(entry, window, length)
+#define FFT_WINDOW_ENTRIES_(entry, window, length) \
+  FFT_WINDOW_ENTRIES_##length(entry, window, length)
+
+#define FFT_WINDOW_8(e, w, l, a, b, c)                                   \
+  e(w, l, 0##a##b##c##0) e(w, l, 0##a##b##c##1) e(w, l, 0##a##b##c##2)   \
+  e(w, l, 0##a##b##c##3) e(w, l, 0##a##b##c##4) e(w, l, 0##a##b##c##5)   \
+  e(w, l, 0##a##b##c##6) e(w, l, 0##a##b##c##7)
+#define FFT_WINDOW_64(e, w, l, a, b)                                     \
+  FFT_WINDOW_8(e, w, l, a, b, 0) FFT_WINDOW_8(e, w, l, a, b, 1)          \
+  FFT_WINDOW_8(e, w, l, a, b, 2) FFT_WINDOW_8(e, w, l, a, b, 3)          \
+  FFT_WINDOW_8(e, w, l, a, b, 4) FFT_WINDOW_8(e, w, l, a, b, 5)          \
+  FFT_WINDOW_8(e, w, l, a, b, 6) FFT_WINDOW_8(e, w, l, a, b, 7)
+#define FFT_WINDOW_512(e, w, l, a)                                       \
+  FFT_WINDOW_64(e, w, l, a, 0) FFT_WINDOW_64(e, w, l, a, 1)              \
+  FFT_WINDOW_64(e, w, l, a, 2) FFT_WINDOW_64(e, w, l, a, 3)              \
+  FFT_WINDOW_64(e, w, l, a, 4) FFT_WINDOW_64(e, w, l, a, 5)              \
+  FFT_WINDOW_64(e, w, l, a, 6) FFT_WINDOW_64(e, w, l, a, 7)
+
+#define FFT_WINDOW_ENTRIES_32(e, w, l)                                   \
+  FFT_WINDOW_8(e, w, l, 0, 0, 0) FFT_WINDOW_8(e, w, l, 0, 0, 1)
+#define FFT_WINDOW_ENTRIES_64(e, w, l)                                   \
+  FFT_WINDOW_8(e, w, l, 0, 0, 0) FFT_WINDOW_8(e, w, l, 0, 0, 1)          \
+  FFT_WINDOW_8(e, w, l, 0, 0, 2) FFT_WINDOW_8(e, w, l, 0, 0, 3)
+#define FFT_WINDOW_ENTRIES_128(e, w, l)                                  \
+  FFT_WINDOW_64(e, w, l, 0, 0)
+#define FFT_WINDOW_ENTRIES_256(e, w, l)                                  \
+  FFT_WINDOW_64(e, w, l, 0, 0) FFT_WINDOW_64(e, w, l, 0, 1)
+#define FFT_WINDOW_ENTRIES_512(e, w, l)                                  \
+  FFT_WINDOW_64(e, w, l, 0, 0) FFT_WINDOW_64(e, w, l, 0, 1)              \
+  FFT_WINDOW_64(e, w, l, 0, 2) FFT_WINDOW_64(e, w, l, 0, 3)
+#define FFT_WINDOW_ENTRIES_1024(e, w, l)                                 \
+  FFT_WINDOW_512(e, w, l, 0)
+#define FFT_WINDOW_ENTRIES_2048(e, w, l)                                 \
+  FFT_WINDOW_512(e, w, l, 0) FFT_WINDOW_512(e, w, l, 1)
+#define FFT_WINDOW_ENTRIES_4096(e, w, l)                                 \
+  FFT_WINDOW_512(e, w, l, 0) FFT_WINDOW_512(e, w, l, 1)                  \
+  FFT_WINDOW_512(e, w, l, 2) FFT_WINDOW_512(e, w, l, 3)
+
+#endif // FFT_WINDOW_H
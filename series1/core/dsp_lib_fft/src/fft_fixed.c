@@ -0,0 +1,479 @@
+/***************************************************************************//**
+ * @file fft_fixed.c
+ * @brief Fixed-point (Q15 and Q31) real FFT with fused windowing. See
+ * fft_fixed.h for details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "em_assert.h"
+#include "fft_fixed.h"
+
+// Entries of the quarter wave sine tables
+#define QUARTER_WAVE (FFT_FIXED_MAX_LENGTH / 4)
+
+// Alpha-max plus beta-min magnitude coefficients, largest error 3.96%
+#define MAG_ALPHA 0.96043387
+#define MAG_BETA  0.39782473
+
+/*
+ * The twiddle factors are read from quarter wave sine tables,
+ * sin(2 * pi * i / FFT_FIXED_MAX_LENGTH) for i = 0..QUARTER_WAVE. Shorter
+ * FFTs step through the table with a stride. The tables are evaluated by
+ * the compiler from a Taylor series of sin(x), which is accurate to 1e-13
+ * on 0..pi/2, and placed in flash.
+ */
+#define SIN_X(i)       ((i) * (3.14159265358979323846 / (2.0 * QUARTER_WAVE)))
+#define SIN_P(x2)                                                   \
+  (1.0 - (x2) / 6.0 * (1.0 - (x2) / 20.0 * (1.0 - (x2) / 42.0     \
+  * (1.0 - (x2) / 72.0 * (1.0 - (x2) / 110.0 * (1.0 - (x2) / 156.0 \
+  * (1.0 - (x2) / 210.0 * (1.0 - (x2) / 272.0))))))))
+#define SIN(i)         (SIN_X(i) * SIN_P(SIN_X(i) * SIN_X(i)))
+
+#define SIN_Q15(i)     ((i) == QUARTER_WAVE ? 0x7FFF \
+                        : (int16_t)(SIN(i) * 32768.0 + 0.5)),
+#define SIN_Q31(i)     ((i) == QUARTER_WAVE ? 0x7FFFFFFF \
+                        : (int32_t)(SIN(i) * 2147483648.0 + 0.5)),
+
+// Expand m(i) for the octal indices 0 to 01777
+#define TABLE_8(m, a, b, c)                                         \
+  m(0##a##b##c##0) m(0##a##b##c##1) m(0##a##b##c##2) m(0##a##b##c##3) \
+  m(0##a##b##c##4) m(0##a##b##c##5) m(0##a##b##c##6) m(0##a##b##c##7)
+#define TABLE_64(m, a, b)                                           \
+  TABLE_8(m, a, b, 0) TABLE_8(m, a, b, 1) TABLE_8(m, a, b, 2)       \
+  TABLE_8(m, a, b, 3) TABLE_8(m, a, b, 4) TABLE_8(m, a, b, 5)       \
+  TABLE_8(m, a, b, 6) TABLE_8(m, a, b, 7)
+#define TABLE_512(m, a)                                             \
+  TABLE_64(m, a, 0) TABLE_64(m, a, 1) TABLE_64(m, a, 2)             \
+  TABLE_64(m, a, 3) TABLE_64(m, a, 4) TABLE_64(m, a, 5)             \
+  TABLE_64(m, a, 6) TABLE_64(m, a, 7)
+
+#if QUARTER_WAVE != 02000
+#error "The sine tables are generated for FFT_FIXED_MAX_LENGTH 4096"
+#endif
+
+static const int16_t sinQ15[QUARTER_WAVE + 1] =
+{
+  TABLE_512(SIN_Q15, 0) TABLE_512(SIN_Q15, 1) SIN_Q15(02000)
+};
+
+static const int32_t sinQ31[QUARTER_WAVE + 1] =
+{
+  TABLE_512(SIN_Q31, 0) TABLE_512(SIN_Q31, 1) SIN_Q31(02000)
+};
+
+/***************************************************************************//**
+ * @brief
+ *   Saturate to the Q15 range.
+ ******************************************************************************/
+static inline int16_t saturateQ15(int32_t value)
+{
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  } else if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)value;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Saturate to the Q31 range.
+ ******************************************************************************/
+static inline int32_t saturateQ31(int64_t value)
+{
+  if (value > INT32_MAX) {
+    return INT32_MAX;
+  } else if (value < INT32_MIN) {
+    return INT32_MIN;
+  }
+  return (int32_t)value;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get cos and sin of 2 * pi * index / FFT_FIXED_MAX_LENGTH in Q15, for
+ *   0 <= index < FFT_FIXED_MAX_LENGTH / 2.
+ ******************************************************************************/
+static inline void twiddleQ15(uint32_t index, int32_t *c, int32_t *s)
+{
+  if (index <= QUARTER_WAVE) {
+    *c = sinQ15[QUARTER_WAVE - index];
+    *s = sinQ15[index];
+  } else {
+    *c = -sinQ15[index - QUARTER_WAVE];
+    *s = sinQ15[2 * QUARTER_WAVE - index];
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get cos and sin of 2 * pi * index / FFT_FIXED_MAX_LENGTH in Q31, for
+ *   0 <= index < FFT_FIXED_MAX_LENGTH / 2.
+ ******************************************************************************/
+static inline void twiddleQ31(uint32_t index, int64_t *c, int64_t *s)
+{
+  if (index <= QUARTER_WAVE) {
+    *c = sinQ31[QUARTER_WAVE - index];
+    *s = sinQ31[index];
+  } else {
+    *c = -(int64_t)sinQ31[index - QUARTER_WAVE];
+    *s = sinQ31[2 * QUARTER_WAVE - index];
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check that length is a supported power of two.
+ ******************************************************************************/
+static inline void checkLength(uint32_t length)
+{
+  EFM_ASSERT((length >= FFT_FIXED_MIN_LENGTH)
+             && (length <= FFT_FIXED_MAX_LENGTH)
+             && ((length & (length - 1)) == 0));
+  (void)length;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize a Q15 real FFT.
+ *
+ * @param[out] fft
+ *   FFT instance.
+ *
+ * @param[in] length
+ *   Number of real input samples, a power of two from FFT_FIXED_MIN_LENGTH
+ *   to FFT_FIXED_MAX_LENGTH.
+ *
+ * @param[in] window
+ *   First length / 2 samples of a symmetric Q15 window applied to the
+ *   input, or NULL for none. See fft_window.h.
+ ******************************************************************************/
+void fftQ15Init(FftQ15_t *fft, uint32_t length, const int16_t *window)
+{
+  checkLength(length);
+
+  fft->length = length;
+  fft->window = window;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Window a block of Q15 samples and compute its spectrum.
+ *
+ * @param[in] fft
+ *   FFT instance.
+ *
+ * @param[in] in
+ *   fft->length real samples, not modified.
+ *
+ * @param[out] out
+ *   fft->length values, the DFT of the windowed input divided by
+ *   fft->length. See fft_fixed.h for the packing.
+ ******************************************************************************/
+void fftQ15Real(const FftQ15_t *fft, const int16_t *in, int16_t *out)
+{
+  uint32_t points = fft->length / 2;
+  uint32_t last = fft->length - 1;
+  uint32_t size, half, stride, i, j, k;
+  int32_t ar, ai, tr, ti, c, s, w0, w1;
+  int32_t evenRe, evenIm, oddRe, oddIm;
+
+  // Load the windowed and halved input as complex samples in bit-reversed
+  // order, even samples to the real and odd samples to the imaginary part
+  j = 0;
+  for (i = 0; i < points; i++) {
+    if (fft->window != NULL) {
+      // Only the first half of the symmetric window is stored
+      if (2 * i < points) {
+        w0 = fft->window[2 * i];
+        w1 = fft->window[2 * i + 1];
+      } else {
+        w0 = fft->window[last - 2 * i];
+        w1 = fft->window[last - 2 * i - 1];
+      }
+      out[2 * j] = (in[2 * i] * w0 + 0x8000) >> 16;
+      out[2 * j + 1] = (in[2 * i + 1] * w1 + 0x8000) >> 16;
+    } else {
+      out[2 * j] = (in[2 * i] + 1) >> 1;
+      out[2 * j + 1] = (in[2 * i + 1] + 1) >> 1;
+    }
+
+    // Increment j in bit-reversed order
+    k = points >> 1;
+    while (j & k) {
+      j ^= k;
+      k >>= 1;
+    }
+    j |= k;
+  }
+
+  // Radix-2 decimation in time stages, halving every output
+  for (size = 2; size <= points; size <<= 1) {
+    half = size / 2;
+    stride = FFT_FIXED_MAX_LENGTH / size;
+    for (k = 0; k < half; k++) {
+      twiddleQ15(k * stride, &c, &s);
+      for (i = 2 * k; i < 2 * points; i += 2 * size) {
+        j = i + size;
+        tr = (c * out[j] + s * out[j + 1] + 0x4000) >> 15;
+        ti = (c * out[j + 1] - s * out[j] + 0x4000) >> 15;
+        ar = out[i];
+        ai = out[i + 1];
+        out[i] = (ar + tr + 1) >> 1;
+        out[i + 1] = (ai + ti + 1) >> 1;
+        out[j] = (ar - tr + 1) >> 1;
+        out[j + 1] = (ai - ti + 1) >> 1;
+      }
+    }
+  }
+
+  // Split the spectra of the even and odd samples into the real spectrum
+  ar = out[0];
+  ai = out[1];
+  out[0] = saturateQ15(ar + ai);
+  out[1] = saturateQ15(ar - ai);
+
+  stride = FFT_FIXED_MAX_LENGTH / fft->length;
+  for (k = 1; k <= points / 2; k++) {
+    i = 2 * k;
+    j = 2 * (points - k);
+    evenRe = (out[i] + out[j] + 1) >> 1;
+    evenIm = (out[i + 1] - out[j + 1] + 1) >> 1;
+    oddRe = (out[i + 1] + out[j + 1] + 1) >> 1;
+    oddIm = (out[j] - out[i] + 1) >> 1;
+
+    twiddleQ15(k * stride, &c, &s);
+    tr = (c * oddRe + s * oddIm + 0x4000) >> 15;
+    ti = (c * oddIm - s * oddRe + 0x4000) >> 15;
+
+    out[j] = saturateQ15(evenRe - tr);
+    out[j + 1] = saturateQ15(ti - evenIm);
+    out[i] = saturateQ15(evenRe + tr);
+    out[i + 1] = saturateQ15(evenIm + ti);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Approximate the magnitude of a Q15 spectrum.
+ *
+ * @details
+ *   |X| is approximated by alpha * max(|re|, |im|) + beta * min(|re|, |im|),
+ *   which needs no square root and is at most 3.96% off.
+ *
+ * @param[in] freq
+ *   Output of fftQ15Real().
+ *
+ * @param[out] mag
+ *   Magnitude of bins 0 to bins - 1.
+ *
+ * @param[in] bins
+ *   Number of bins, the FFT length / 2.
+ ******************************************************************************/
+void fftQ15Magnitude(const int16_t *freq, int16_t *mag, uint32_t bins)
+{
+  int32_t re, im, max, min;
+  uint32_t k;
+
+  // Bin 0 only holds X[0], X[N/2] is stored in its imaginary part
+  mag[0] = saturateQ15(freq[0] < 0 ? -freq[0] : freq[0]);
+
+  for (k = 1; k < bins; k++) {
+    re = freq[2 * k] < 0 ? -freq[2 * k] : freq[2 * k];
+    im = freq[2 * k + 1] < 0 ? -freq[2 * k + 1] : freq[2 * k + 1];
+    max = re > im ? re : im;
+    min = re > im ? im : re;
+    mag[k] = saturateQ15((max * (int32_t)(MAG_ALPHA * 32768.0 + 0.5)
+                          + min * (int32_t)(MAG_BETA * 32768.0 + 0.5)
+                          + 0x4000) >> 15);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize a Q31 real FFT.
+ *
+ * @param[out] fft
+ *   FFT instance.
+ *
+ * @param[in] length
+ *   Number of real input samples, a power of two from FFT_FIXED_MIN_LENGTH
+ *   to FFT_FIXED_MAX_LENGTH.
+ *
+ * @param[in] window
+ *   First length / 2 samples of a symmetric Q31 window applied to the
+ *   input, or NULL for none. See fft_window.h.
+ ******************************************************************************/
+void fftQ31Init(FftQ31_t *fft, uint32_t length, const int32_t *window)
+{
+  checkLength(length);
+
+  fft->length = length;
+  fft->window = window;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Window a block of Q31 samples and compute its spectrum.
+ *
+ * @param[in] fft
+ *   FFT instance.
+ *
+ * @param[in] in
+ *   fft->length real samples, not modified.
+ *
+ * @param[out] out
+ *   fft->length values, the DFT of the windowed input divided by
+ *   fft->length. See fft_fixed.h for the packing.
+ ******************************************************************************/
+void fftQ31Real(const FftQ31_t *fft, const int32_t *in, int32_t *out)
+{
+  uint32_t points = fft->length / 2;
+  uint32_t last = fft->length - 1;
+  uint32_t size, half, stride, i, j, k;
+  int64_t ar, ai, tr, ti, c, s, w0, w1;
+  int64_t evenRe, evenIm, oddRe, oddIm;
+
+  // Load the windowed and halved input as complex samples in bit-reversed
+  // order, even samples to the real and odd samples to the imaginary part
+  j = 0;
+  for (i = 0; i < points; i++) {
+    if (fft->window != NULL) {
+      // Only the first half of the symmetric window is stored
+      if (2 * i < points) {
+        w0 = fft->window[2 * i];
+        w1 = fft->window[2 * i + 1];
+      } else {
+        w0 = fft->window[last - 2 * i];
+        w1 = fft->window[last - 2 * i - 1];
+      }
+      out[2 * j] = (in[2 * i] * w0 + 0x80000000LL) >> 32;
+      out[2 * j + 1] = (in[2 * i + 1] * w1 + 0x80000000LL) >> 32;
+    } else {
+      out[2 * j] = ((int64_t)in[2 * i] + 1) >> 1;
+      out[2 * j + 1] = ((int64_t)in[2 * i + 1] + 1) >> 1;
+    }
+
+    // Increment j in bit-reversed order
+    k = points >> 1;
+    while (j & k) {
+      j ^= k;
+      k >>= 1;
+    }
+    j |= k;
+  }
+
+  // Radix-2 decimation in time stages, halving every output
+  for (size = 2; size <= points; size <<= 1) {
+    half = size / 2;
+    stride = FFT_FIXED_MAX_LENGTH / size;
+    for (k = 0; k < half; k++) {
+      twiddleQ31(k * stride, &c, &s);
+      for (i = 2 * k; i < 2 * points; i += 2 * size) {
+        j = i + size;
+        tr = (c * out[j] + s * out[j + 1] + 0x40000000LL) >> 31;
+        ti = (c * out[j + 1] - s * out[j] + 0x40000000LL) >> 31;
+        ar = out[i];
+        ai = out[i + 1];
+        out[i] = (ar + tr + 1) >> 1;
+        out[i + 1] = (ai + ti + 1) >> 1;
+        out[j] = (ar - tr + 1) >> 1;
+        out[j + 1] = (ai - ti + 1) >> 1;
+      }
+    }
+  }
+
+  // Split the spectra of the even and odd samples into the real spectrum
+  ar = out[0];
+  ai = out[1];
+  out[0] = saturateQ31(ar + ai);
+  out[1] = saturateQ31(ar - ai);
+
+  stride = FFT_FIXED_MAX_LENGTH / fft->length;
+  for (k = 1; k <= points / 2; k++) {
+    i = 2 * k;
+    j = 2 * (points - k);
+    evenRe = ((int64_t)out[i] + out[j] + 1) >> 1;
+    evenIm = ((int64_t)out[i + 1] - out[j + 1] + 1) >> 1;
+    oddRe = ((int64_t)out[i + 1] + out[j + 1] + 1) >> 1;
+    oddIm = ((int64_t)out[j] - out[i] + 1) >> 1;
+
+    twiddleQ31(k * stride, &c, &s);
+    tr = (c * oddRe + s * oddIm + 0x40000000LL) >> 31;
+    ti = (c * oddIm - s * oddRe + 0x40000000LL) >> 31;
+
+    out[j] = saturateQ31(evenRe - tr);
+    out[j + 1] = saturateQ31(ti - evenIm);
+    out[i] = saturateQ31(evenRe + tr);
+    out[i + 1] = saturateQ31(evenIm + ti);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Approximate the magnitude of a Q31 spectrum.
+ *
+ * @details
+ *   |X| is approximated by alpha * max(|re|, |im|) + beta * min(|re|, |im|),
+ *   which needs no square root and is at most 3.96% off.
+ *
+ * @param[in] freq
+ *   Output of fftQ31Real().
+ *
+ * @param[out] mag
+ *   Magnitude of bins 0 to bins - 1.
+ *
+ * @param[in] bins
+ *   Number of bins, the FFT length / 2.
+ ******************************************************************************/
+void fftQ31Magnitude(const int32_t *freq, int32_t *mag, uint32_t bins)
+{
+  int64_t re, im, max, min;
+  uint32_t k;
+
+  // Bin 0 only holds X[0], X[N/2] is stored in its imaginary part
+  re = freq[0];
+  mag[0] = saturateQ31(re < 0 ? -re : re);
+
+  for (k = 1; k < bins; k++) {
+    re = freq[2 * k];
+    im = freq[2 * k + 1];
+    re = re < 0 ? -re : re;
+    im = im < 0 ? -im : im;
+    max = re > im ? re : im;
+    min = re > im ? im : re;
+    mag[k] = saturateQ31((max * (int64_t)(MAG_ALPHA * 2147483648.0 + 0.5)
+                          + min * (int64_t)(MAG_BETA * 2147483648.0 + 0.5)
+                          + 0x40000000LL) >> 31);
+  }
+}
@@ -41,16 +41,34 @@
 #include "em_emu.h"
 #include "arm_math.h"
 #include <math.h>
+#include "fft_fixed.h"
+#include "fft_window.h"
 
-// Defines size of FFT, test data is 128 samples
+// Defines size of FFT
 // Supported arm_fft_f32 lengths are 128, 512, 2048
+// Note: must be a decimal constant, the window tables are generated for it
 #define FFTSIZE 128
 
+#if (FFTSIZE != 128) && (FFTSIZE != 512) && (FFTSIZE != 2048)
+#error "FFTSIZE must be 128, 512 or 2048"
+#endif
+
 // Defines sample frequency of input data
 // Use for calculating FFT resolution:
 // Resolution = SAMPLEFREQ / FFTSIZE
 #define SAMPLEFREQ 48000
 
+// Frequency and amplitude of the test tone
+#define TEST_FREQ 10000
+#define TEST_AMPLITUDE 10
+
+// The fixed-point inputs are testData / TEST_DATA_SCALE, which keeps them
+// in the Q15/Q31 range of -1 to 1
+#define TEST_DATA_SCALE 16
+
+// Define to measure the float, Q15 and Q31 paths with the DWT cycle counter
+// #define FFT_BENCHMARK
+
 // Instance structures for float32_t RFFT
 static arm_rfft_instance_f32 rfft_instance;
 // Instance structure for float32_t CFFT used by the RFFT
@@ -60,53 +78,95 @@ static arm_cfft_radix4_instance_f32 cfft_instance;
 float32_t freqBuffer[FFTSIZE * 2];
 float32_t magnitudeResponse[FFTSIZE];
 
-// 128 point Hamming window
-// To window real time data, Hamming function is:
+// Fixed-point FFT instances
+static FftQ15_t fftQ15;
+static FftQ31_t fftQ31;
+
+// Fixed-point inputs, complex frequency and magnitude response data
+int16_t testDataQ15[FFTSIZE];
+int32_t testDataQ31[FFTSIZE];
+int16_t freqBufferQ15[FFTSIZE];
+int32_t freqBufferQ31[FFTSIZE];
+int16_t magnitudeResponseQ15[FFTSIZE / 2];
+int32_t magnitudeResponseQ31[FFTSIZE / 2];
+
+// FFTSIZE point Hamming window, generated by the compiler and kept in flash
+// Hamming function is:
 // w = .54 - (1 - .54)*cos(2*pi*SAMPLEINDEX /(FFTSIZE - 1))
-float32_t hammingWindow[128] =
+// The window is symmetric, the tables hold its first FFTSIZE / 2 samples
+const float32_t hammingWindow[FFTSIZE / 2] =
 {
-    0.0800,    0.0806,    0.0823,    0.0851,    0.0890,    0.0940,    0.1001,
-    0.1073,    0.1156,    0.1249,    0.1352,    0.1465,    0.1587,    0.1719,
-    0.1860,    0.2010,    0.2167,    0.2333,    0.2507,    0.2687,    0.2874,
-    0.3067,    0.3266,    0.3470,    0.3679,    0.3892,    0.4109,    0.4329,
-    0.4551,    0.4776,    0.5002,    0.5229,    0.5457,    0.5684,    0.5911,
-    0.6136,    0.6360,    0.6581,    0.6800,    0.7015,    0.7226,    0.7432,
-    0.7634,    0.7830,    0.8020,    0.8204,    0.8381,    0.8551,    0.8712,
-    0.8866,    0.9012,    0.9148,    0.9275,    0.9393,    0.9501,    0.9599,
-    0.9687,    0.9764,    0.9831,    0.9886,    0.9931,    0.9965,    0.9987,
-    0.9999,    0.9999,    0.9987,    0.9965,    0.9931,    0.9886,    0.9831,
-    0.9764,    0.9687,    0.9599,    0.9501,    0.9393,    0.9275,    0.9148,
-    0.9012,    0.8866,    0.8712,    0.8551,    0.8381,    0.8204,    0.8020,
-    0.7830,    0.7634,    0.7432,    0.7226,    0.7015,    0.6800,    0.6581,
-    0.6360,    0.6136,    0.5911,    0.5684,    0.5457,    0.5229,    0.5002,
-    0.4776,    0.4551,    0.4329,    0.4109,    0.3892,    0.3679,    0.3470,
-    0.3266,    0.3067,    0.2874,    0.2687,    0.2507,    0.2333,    0.2167,
-    0.2010,    0.1860,    0.1719,    0.1587,    0.1465,    0.1352,    0.1249,
-    0.1156,    0.1073,    0.1001,    0.0940,    0.0890,    0.0851,    0.0823,
-    0.0806,    0.0800
+  FFT_WINDOW_F32(FFT_WINDOW_HAMMING, FFTSIZE)
 };
-
-// Test data of a 10kHz cosine wave
-float32_t testData[128] =
+const int16_t hammingWindowQ15[FFTSIZE / 2] =
+{
+  FFT_WINDOW_Q15(FFT_WINDOW_HAMMING, FFTSIZE)
+};
+const int32_t hammingWindowQ31[FFTSIZE / 2] =
 {
-  0,9.6592579,5,-7.0710678,-8.6602535,2.5881906,10,2.5881906,-8.6602535,
-  -7.0710678,5,9.6592579,6.1232342e-15,-9.6592579,-5,7.0710678,8.6602535,
-  -2.5881906,-10,-2.5881906,8.6602535,7.0710678,-5,-9.6592579,-1.2246468e-14,
-  9.6592579,5,-7.0710678,-8.6602535,2.5881906,10,2.5881906,-8.6602535,
-  -7.0710678,5,9.6592579,-1.7157435e-14,-9.6592579,-5,7.0710678,8.6602535,
-  -2.5881906,-10,-2.5881906,8.6602535,7.0710678,-5,-9.6592579,-2.4492937e-14,
-  9.6592579,5,-7.0710678,-8.6602535,2.5881906,10,2.5881906,-8.6602535,
-  -7.0710678,5,9.6592579,-4.9109666e-15,-9.6592579,-5,7.0710678,8.6602535,
-  -2.5881906,-10,-2.5881906,8.6602535,7.0710678,-5,-9.6592579,3.4314870e-14,
-  9.6592579,5,-7.0710678,-8.6602535,2.5881906,10,2.5881906,-8.6602535,
-  -7.0710678,5,9.6592579,-6.3718772e-14,-9.6592579,-5,7.0710678,8.6602535,
-  -2.5881906,-10,-2.5881906,8.6602535,7.0710678,-5,-9.6592579,-4.8985874e-14,
-  9.6592579,5,-7.0710678,-8.6602535,2.5881906,10,2.5881906,-8.6602535,
-  -7.0710678,5,9.6592579,-2.6463513e-13,-9.6592579,-5,7.0710678,8.6602535,
-  -2.5881906,-10,-2.5881906,8.6602535,7.0710678,-5,-9.6592579,9.8219332e-15,
-  9.6592579,5,-7.0710678,-8.6602535,2.5881906,10,2.5881906
+  FFT_WINDOW_Q31(FFT_WINDOW_HAMMING, FFTSIZE)
 };
 
+// Test data of a TEST_FREQ tone, filled in by main
+float32_t testData[FFTSIZE];
+
+#if defined(FFT_BENCHMARK)
+// Cycles to window, transform and take the magnitude of FFTSIZE samples,
+// view in the Expressions window
+uint32_t cyclesFloat;
+uint32_t cyclesQ15;
+uint32_t cyclesQ31;
+
+// Bytes of RAM used by the instances and buffers of each path, the windows
+// are in flash
+uint32_t ramFloat;
+uint32_t ramQ15;
+uint32_t ramQ31;
+
+/**************************************************************************//**
+ * @brief Time the float, Q15 and Q31 paths with the DWT cycle counter
+ *****************************************************************************/
+void benchmarkFft(void)
+{
+  // arm_rfft_f32() modifies its input, keep testData for main
+  static float32_t benchmarkData[FFTSIZE];
+  uint32_t start;
+
+  ramFloat = sizeof(rfft_instance) + sizeof(cfft_instance)
+             + sizeof(testData) + sizeof(freqBuffer)
+             + sizeof(magnitudeResponse);
+  ramQ15 = sizeof(fftQ15) + sizeof(testDataQ15)
+           + sizeof(freqBufferQ15) + sizeof(magnitudeResponseQ15);
+  ramQ31 = sizeof(fftQ31) + sizeof(testDataQ31)
+           + sizeof(freqBufferQ31) + sizeof(magnitudeResponseQ31);
+
+  // Enable the cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  for(int i = 0; i < FFTSIZE / 2; i++)
+  {
+    benchmarkData[i] = testData[i] * hammingWindow[i];
+    benchmarkData[FFTSIZE - 1 - i] = testData[FFTSIZE - 1 - i] * hammingWindow[i];
+  }
+  arm_rfft_f32(&rfft_instance, benchmarkData, freqBuffer);
+  arm_cmplx_mag_f32(freqBuffer, magnitudeResponse, FFTSIZE);
+  cyclesFloat = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  fftQ15Real(&fftQ15, testDataQ15, freqBufferQ15);
+  fftQ15Magnitude(freqBufferQ15, magnitudeResponseQ15, FFTSIZE / 2);
+  cyclesQ15 = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  fftQ31Real(&fftQ31, testDataQ31, freqBufferQ31);
+  fftQ31Magnitude(freqBufferQ31, magnitudeResponseQ31, FFTSIZE / 2);
+  cyclesQ31 = DWT->CYCCNT - start;
+}
+#endif
+
 /**************************************************************************//**
  * @brief Perform FFT and extract signal frequency content
  *****************************************************************************/
@@ -116,12 +176,32 @@ int main()
   // Note valid FFTSIZE values are 128, 512, and 2048
   arm_rfft_init_f32(&rfft_instance, &cfft_instance, FFTSIZE, 0, 1);
 
+  // Generate the test data, and convert it to Q15 and Q31 for the
+  // fixed-point FFTs, which apply the window while loading the samples
+  for(int i = 0; i < FFTSIZE; i++)
+  {
+    testData[i] = TEST_AMPLITUDE
+                  * sinf(2 * PI * ((TEST_FREQ * i) % SAMPLEFREQ) / SAMPLEFREQ);
+    testDataQ15[i] = (int16_t)roundf(testData[i]
+                                     * (32768.0f / TEST_DATA_SCALE));
+    testDataQ31[i] = (int32_t)roundf(testData[i]
+                                     * (2147483648.0f / TEST_DATA_SCALE));
+  }
+  fftQ15Init(&fftQ15, FFTSIZE, hammingWindowQ15);
+  fftQ31Init(&fftQ31, FFTSIZE, hammingWindowQ31);
+
+#if defined(FFT_BENCHMARK)
+  benchmarkFft();
+#endif
+
   // Window time domain data
   // Windowing removes discontinuities between first and last time-domain sample
   // The Hamming window function also reduces spectral leakage
-  for(int i = 0; i < FFTSIZE; i++)
+  // Only the first half of the symmetric window is stored
+  for(int i = 0; i < FFTSIZE / 2; i++)
   {
     testData[i] = testData[i] * hammingWindow[i];
+    testData[FFTSIZE - 1 - i] = testData[FFTSIZE - 1 - i] * hammingWindow[i];
   }
 
   // Perform FFT and calculate magnitude
@@ -129,6 +209,13 @@ int main()
   arm_rfft_f32(&rfft_instance, testData, freqBuffer);
   arm_cmplx_mag_f32(freqBuffer, magnitudeResponse, FFTSIZE);
 
+  // Same in Q15 and Q31, without an FPU
+  // The outputs are divided by FFTSIZE and TEST_DATA_SCALE
+  fftQ15Real(&fftQ15, testDataQ15, freqBufferQ15);
+  fftQ15Magnitude(freqBufferQ15, magnitudeResponseQ15, FFTSIZE / 2);
+  fftQ31Real(&fftQ31, testDataQ31, freqBufferQ31);
+  fftQ31Magnitude(freqBufferQ31, magnitudeResponseQ31, FFTSIZE / 2);
+
   while(1)
   {
     EMU_EnterEM1();
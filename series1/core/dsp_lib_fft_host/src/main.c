@@ -0,0 +1,343 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Host test of the fixed-point real FFT of dsp_lib_fft against a double
+ * precision DFT.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "fft_fixed.h"
+#include "fft_window.h"
+
+// Largest output error allowed, in LSBs per log2(length)
+#define MAX_ERROR_Q15     1.0
+#define MAX_ERROR_Q31     1.0
+
+// Largest relative error of the alpha-max plus beta-min magnitude
+#define MAX_MAG_ERROR     0.0397
+
+// Window tables generated by fft_window.h, at the shortest length and 512
+#define WINDOW_TABLES(name, window, length)                                \
+  static const float name##F32_##length[length / 2] =                     \
+  { FFT_WINDOW_F32(window, length) };                                      \
+  static const int16_t name##Q15_##length[length / 2] =                   \
+  { FFT_WINDOW_Q15(window, length) };                                      \
+  static const int32_t name##Q31_##length[length / 2] =                   \
+  { FFT_WINDOW_Q31(window, length) };
+
+WINDOW_TABLES(hamming, FFT_WINDOW_HAMMING, 32)
+WINDOW_TABLES(hamming, FFT_WINDOW_HAMMING, 512)
+WINDOW_TABLES(hann, FFT_WINDOW_HANN, 32)
+WINDOW_TABLES(hann, FFT_WINDOW_HANN, 512)
+WINDOW_TABLES(blackmanHarris, FFT_WINDOW_BLACKMAN_HARRIS, 32)
+WINDOW_TABLES(blackmanHarris, FFT_WINDOW_BLACKMAN_HARRIS, 512)
+WINDOW_TABLES(flatTop, FFT_WINDOW_FLAT_TOP, 32)
+WINDOW_TABLES(flatTop, FFT_WINDOW_FLAT_TOP, 512)
+
+// Reference window functions of x = 2 * pi * n / (length - 1)
+static double hamming(double x)
+{
+  return 0.54 - 0.46 * cos(x);
+}
+
+static double hann(double x)
+{
+  return 0.5 - 0.5 * cos(x);
+}
+
+static double blackmanHarris(double x)
+{
+  return 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x)
+         - 0.01168 * cos(3 * x);
+}
+
+static double flatTop(double x)
+{
+  return 0.21557895 - 0.41663158 * cos(x) + 0.277263158 * cos(2 * x)
+         - 0.083578947 * cos(3 * x) + 0.006947368 * cos(4 * x);
+}
+
+// Test signals
+typedef enum
+{
+  SIGNAL_TONES,       // Two tones and noise at 90% of full scale
+  SIGNAL_EXTREMES,    // Random full scale positive and negative samples
+  SIGNAL_DC           // Full scale constant
+} Signal_t;
+
+static int16_t inQ15[FFT_FIXED_MAX_LENGTH];
+static int32_t inQ31[FFT_FIXED_MAX_LENGTH];
+static int16_t windowQ15[FFT_FIXED_MAX_LENGTH];
+static int32_t windowQ31[FFT_FIXED_MAX_LENGTH];
+static int16_t outQ15[FFT_FIXED_MAX_LENGTH];
+static int32_t outQ31[FFT_FIXED_MAX_LENGTH];
+static int16_t magQ15[FFT_FIXED_MAX_LENGTH / 2];
+static int32_t magQ31[FFT_FIXED_MAX_LENGTH / 2];
+
+// Windowed input and DFT / length of the reference, in full scale units
+static double x[FFT_FIXED_MAX_LENGTH];
+static double refRe[FFT_FIXED_MAX_LENGTH / 2 + 1];
+static double refIm[FFT_FIXED_MAX_LENGTH / 2 + 1];
+static double cosTable[FFT_FIXED_MAX_LENGTH];
+
+static uint32_t seed = 1;
+
+/***************************************************************************//**
+ * @brief
+ *   Uniform random number in [-1, 1).
+ ******************************************************************************/
+static double randomUniform(void)
+{
+  // xorshift32
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return (double)(int32_t)seed / 2147483648.0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Sample value i of a test signal in [-1, 1].
+ ******************************************************************************/
+static double signalValue(Signal_t signal, uint32_t i, uint32_t length)
+{
+  const double pi = 3.14159265358979323846;
+
+  switch (signal) {
+    case SIGNAL_TONES:
+      return 0.5 * cos(2 * pi * i * (length / 8 + 0.3) / length)
+             + 0.3 * sin(2 * pi * i * (length / 5 + 0.7) / length)
+             + 0.1 * randomUniform();
+    case SIGNAL_EXTREMES:
+      return randomUniform() < 0 ? -1.0 : 1.0;
+    default:
+      return 1.0;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   DFT of x divided by length, for bins 0 to length / 2.
+ ******************************************************************************/
+static void referenceDft(uint32_t length)
+{
+  uint32_t n, k;
+
+  for (n = 0; n < length; n++) {
+    cosTable[n] = cos(2 * 3.14159265358979323846 * n / length);
+  }
+  for (k = 0; k <= length / 2; k++) {
+    double re = 0.0, im = 0.0;
+    for (n = 0; n < length; n++) {
+      uint32_t index = (uint32_t)(((uint64_t)k * n) % length);
+      re += x[n] * cosTable[index];
+      im -= x[n] * cosTable[(index + length - length / 4) % length];
+    }
+    refRe[k] = re / length;
+    refIm[k] = im / length;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Compare a packed FFT output and its magnitude with the reference.
+ *
+ * @return
+ *   Largest output error in LSBs, or a negative value if a magnitude is
+ *   out of bounds.
+ ******************************************************************************/
+static double compare(const double *out, const double *mag, uint32_t length,
+                      double lsb)
+{
+  double error = 0.0;
+  double e, ref;
+  uint32_t k;
+
+  // Bin 0 holds X[0] and X[N/2]
+  error = fmax(fabs(out[0] - refRe[0]), fabs(out[1] - refRe[length / 2]));
+  for (k = 1; k < length / 2; k++) {
+    e = fmax(fabs(out[2 * k] - refRe[k]), fabs(out[2 * k + 1] - refIm[k]));
+    error = fmax(error, e);
+  }
+
+  for (k = 0; k < length / 2; k++) {
+    ref = hypot(refRe[k], refIm[k]);
+    if ((mag[k] < ref * (1 - MAX_MAG_ERROR) - 4 * error - lsb)
+        || (mag[k] > ref * (1 + MAX_MAG_ERROR) + 4 * error + lsb)) {
+      printf("  bin %u magnitude %g, expected %g\n", (unsigned int)k,
+             mag[k], ref);
+      return -1.0;
+    }
+  }
+
+  return error / lsb;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Test both formats with one length, signal and window.
+ ******************************************************************************/
+static bool checkLength(uint32_t length, Signal_t signal, bool windowed)
+{
+  static double out[FFT_FIXED_MAX_LENGTH];
+  static double mag[FFT_FIXED_MAX_LENGTH / 2];
+  const double pi = 3.14159265358979323846;
+  uint32_t log2Length = 0;
+  double value, w, errorQ15, errorQ31;
+  FftQ15_t fftQ15;
+  FftQ31_t fftQ31;
+  bool passed;
+  uint32_t i;
+
+  while ((1UL << log2Length) < length) {
+    log2Length++;
+  }
+
+  // Hamming window
+  for (i = 0; i < length; i++) {
+    w = 0.54 - 0.46 * cos(2 * pi * i / (length - 1));
+    windowQ15[i] = (int16_t)lround(fmin(w * 32768.0, 32767.0));
+    windowQ31[i] = (int32_t)llround(fmin(w * 2147483648.0, 2147483647.0));
+  }
+
+  for (i = 0; i < length; i++) {
+    value = signalValue(signal, i, length);
+    inQ15[i] = (int16_t)lround(fmax(fmin(value * 32768.0, 32767.0), -32768.0));
+    inQ31[i] = (int32_t)llround(fmax(fmin(value * 2147483648.0,
+                                          2147483647.0), -2147483648.0));
+  }
+
+  // Q15
+  fftQ15Init(&fftQ15, length, windowed ? windowQ15 : NULL);
+  fftQ15Real(&fftQ15, inQ15, outQ15);
+  fftQ15Magnitude(outQ15, magQ15, length / 2);
+  for (i = 0; i < length; i++) {
+    x[i] = inQ15[i] / 32768.0 * (windowed ? windowQ15[i] / 32768.0 : 1.0);
+    out[i] = outQ15[i] / 32768.0;
+  }
+  for (i = 0; i < length / 2; i++) {
+    mag[i] = magQ15[i] / 32768.0;
+  }
+  referenceDft(length);
+  errorQ15 = compare(out, mag, length, 1.0 / 32768.0);
+
+  // Q31
+  fftQ31Init(&fftQ31, length, windowed ? windowQ31 : NULL);
+  fftQ31Real(&fftQ31, inQ31, outQ31);
+  fftQ31Magnitude(outQ31, magQ31, length / 2);
+  for (i = 0; i < length; i++) {
+    x[i] = inQ31[i] / 2147483648.0
+           * (windowed ? windowQ31[i] / 2147483648.0 : 1.0);
+    out[i] = outQ31[i] / 2147483648.0;
+  }
+  for (i = 0; i < length / 2; i++) {
+    mag[i] = magQ31[i] / 2147483648.0;
+  }
+  referenceDft(length);
+  errorQ31 = compare(out, mag, length, 1.0 / 2147483648.0);
+
+  passed = (errorQ15 >= 0.0) && (errorQ15 <= MAX_ERROR_Q15 * log2Length)
+           && (errorQ31 >= 0.0) && (errorQ31 <= MAX_ERROR_Q31 * log2Length);
+  printf("%4u %-8s %-9s Q15 %5.2f LSB  Q31 %5.2f LSB  %s\n",
+         (unsigned int)length,
+         signal == SIGNAL_TONES ? "tones"
+         : signal == SIGNAL_EXTREMES ? "extremes" : "dc",
+         windowed ? "hamming" : "no window", errorQ15, errorQ31,
+         passed ? "ok" : "FAILED");
+  return passed;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check that a generated window table holds the correctly rounded window.
+ ******************************************************************************/
+static bool checkWindow(const char *name, double (*window)(double),
+                        uint32_t length, const float *tableF32,
+                        const int16_t *tableQ15, const int32_t *tableQ31)
+{
+  double errorF32 = 0.0, errorQ15 = 0.0, errorQ31 = 0.0;
+  double w;
+  bool passed;
+  uint32_t n;
+
+  for (n = 0; n < length / 2; n++) {
+    w = window(2 * 3.14159265358979323846 * n / (length - 1));
+    errorF32 = fmax(errorF32, fabs(tableF32[n] - w) / fmax(fabs(w), 1e-3));
+    errorQ15 = fmax(errorQ15, fabs(tableQ15[n] - fmin(w * 32768.0, 32767.0)));
+    errorQ31 = fmax(errorQ31, fabs(tableQ31[n]
+                                   - fmin(w * 2147483648.0, 2147483647.0)));
+  }
+
+  // The float tables are rounded once, the fixed-point tables to nearest
+  passed = (errorF32 <= 6e-8) && (errorQ15 <= 0.5) && (errorQ31 <= 0.5);
+  printf("%4u %-15s window  F32 %.1e  Q15 %4.2f LSB  Q31 %4.2f LSB  %s\n",
+         (unsigned int)length, name, errorF32, errorQ15, errorQ31,
+         passed ? "ok" : "FAILED");
+  return passed;
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main(void)
+{
+  bool passed = true;
+  uint32_t length;
+  int signal;
+
+#define CHECK_WINDOW(name, length)                                       \
+  checkWindow(#name, name, length, name##F32_##length,                     \
+              name##Q15_##length, name##Q31_##length)
+
+  passed = CHECK_WINDOW(hamming, 32) && passed;
+  passed = CHECK_WINDOW(hamming, 512) && passed;
+  passed = CHECK_WINDOW(hann, 32) && passed;
+  passed = CHECK_WINDOW(hann, 512) && passed;
+  passed = CHECK_WINDOW(blackmanHarris, 32) && passed;
+  passed = CHECK_WINDOW(blackmanHarris, 512) && passed;
+  passed = CHECK_WINDOW(flatTop, 32) && passed;
+  passed = CHECK_WINDOW(flatTop, 512) && passed;
+
+  for (length = FFT_FIXED_MIN_LENGTH; length <= FFT_FIXED_MAX_LENGTH;
+       length *= 2) {
+    for (signal = SIGNAL_TONES; signal <= SIGNAL_DC; signal++) {
+      passed = checkLength(length, (Signal_t)signal, true) && passed;
+      passed = checkLength(length, (Signal_t)signal, false) && passed;
+    }
+  }
+
+  printf("%s\n", passed ? "PASSED" : "FAILED");
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+/***************************************************************************//**
+ * @file gpcrc_ldma.h
+ * @brief Checksum a memory buffer with the GPCRC fed by a single LDMA descriptor
+ * chain.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef GPCRC_LDMA_H
+#define GPCRC_LDMA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "em_ldma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A buffer is fed to the GPCRC by up to four descriptors: bytes up to the
+ * first word boundary, a first block of words, a looping descriptor that
+ * repeats full blocks of GPCRC_LDMA_BLOCK_WORDS words, and the remaining
+ * bytes. Only the last descriptor raises DONE, so a buffer of any length
+ * costs one interrupt.
+ */
+#define GPCRC_LDMA_NUM_DESC       4
+
+// Words per descriptor, limited by the 11-bit XFERCNT field
+#define GPCRC_LDMA_BLOCK_WORDS    2048
+
+// Longest buffer in bytes: the first block and 256 loops of words
+#define GPCRC_LDMA_MAX_LENGTH     (4UL * GPCRC_LDMA_BLOCK_WORDS * 257)
+
+typedef struct
+{
+  LDMA_Descriptor_t desc[GPCRC_LDMA_NUM_DESC];
+  int               channel;      // LDMA channel
+  volatile bool     busy;         // Checksum in progress
+} GpcrcLdma_t;
+
+void gpcrcLdmaInit(GpcrcLdma_t *crc, int channel);
+void gpcrcLdmaStart(GpcrcLdma_t *crc, const void *buffer, size_t length);
+bool gpcrcLdmaIrqHandler(GpcrcLdma_t *crc, uint32_t pending);
+bool gpcrcLdmaBusy(const GpcrcLdma_t *crc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPCRC_LDMA_H
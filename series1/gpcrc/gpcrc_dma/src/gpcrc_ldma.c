@@ -0,0 +1,196 @@
+/***************************************************************************//**
+ * @file gpcrc_ldma.c
+ * @brief Checksum a memory buffer with the GPCRC fed by a single LDMA descriptor
+ * chain. See gpcrc_ldma.h for details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "em_device.h"
+#include "em_assert.h"
+#include "em_gpcrc.h"
+#include "gpcrc_ldma.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize a checksum context.
+ *
+ * @param[out] crc
+ *   Checksum context. Holds the descriptors, so it must stay valid while a
+ *   checksum runs.
+ *
+ * @param[in] channel
+ *   LDMA channel used to feed the GPCRC.
+ ******************************************************************************/
+void gpcrcLdmaInit(GpcrcLdma_t *crc, int channel)
+{
+  crc->channel = channel;
+  crc->busy = false;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start checksumming a buffer.
+ *
+ * @details
+ *   GPCRC_DATA is reset to the initial value and every byte of the buffer
+ *   is fed to the GPCRC in memory order, so the result is the same as
+ *   feeding the buffer one byte at a time with GPCRC_InputU8(). The GPCRC
+ *   must be configured with reverseByteOrder and enableByteMode cleared.
+ *   Read the result once gpcrcLdmaBusy() returns false.
+ *
+ * @param[in] crc
+ *   Checksum context.
+ *
+ * @param[in] buffer
+ *   Data to checksum, any alignment. Must not change until done.
+ *
+ * @param[in] length
+ *   Length in bytes, at most GPCRC_LDMA_MAX_LENGTH.
+ ******************************************************************************/
+void gpcrcLdmaStart(GpcrcLdma_t *crc, const void *buffer, size_t length)
+{
+  LDMA_TransferCfg_t transfer = LDMA_TRANSFER_CFG_MEMORY();
+  const uint8_t *src = (const uint8_t *)buffer;
+  LDMA_Descriptor_t *desc = crc->desc;
+  uint32_t head, words, tail, loops, last;
+  int n = 0;
+
+  EFM_ASSERT(length <= GPCRC_LDMA_MAX_LENGTH);
+  EFM_ASSERT(!(GPCRC->CTRL & (GPCRC_CTRL_BYTEREVERSE | GPCRC_CTRL_BYTEMODE)));
+
+  GPCRC_Start(GPCRC);
+  if (length == 0)
+  {
+    return;
+  }
+
+  // Split into bytes up to a word boundary, whole words and trailing bytes
+  head = (uint32_t)(-(uintptr_t)src & 3);
+  if (head > length)
+  {
+    head = length;
+  }
+  words = (length - head) / 4;
+  tail = (length - head) % 4;
+
+  if (head)
+  {
+    desc[n++] = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_M2M_BYTE(src, &GPCRC->INPUTDATABYTE, head, 1);
+    src += head;
+  }
+
+  if (words)
+  {
+    // Full blocks after the first one are repeated by a looping descriptor
+    loops = (words - 1) / GPCRC_LDMA_BLOCK_WORDS;
+
+    desc[n++] = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_M2M_WORD(src, &GPCRC->INPUTDATA,
+                                       words - loops * GPCRC_LDMA_BLOCK_WORDS,
+                                       1);
+    src += 4 * words;
+
+    // A looping descriptor raises DONE on every pass, so it cannot end the
+    // chain; move its last block into a descriptor of its own
+    last = (loops && !tail) ? 1 : 0;
+    loops -= last;
+
+    if (loops)
+    {
+      // Continue from the current source address and link to itself
+      desc[n] = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_M2M_WORD(0, &GPCRC->INPUTDATA,
+                                         GPCRC_LDMA_BLOCK_WORDS, 0);
+      desc[n].xfer.srcAddrMode = ldmaCtrlSrcAddrModeRel;
+      desc[n].xfer.decLoopCnt = 1;
+      transfer.ldmaLoopCnt = loops - 1;
+      n++;
+    }
+
+    if (last)
+    {
+      desc[n] = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_M2M_WORD(0, &GPCRC->INPUTDATA,
+                                         GPCRC_LDMA_BLOCK_WORDS, 1);
+      desc[n].xfer.srcAddrMode = ldmaCtrlSrcAddrModeRel;
+      n++;
+    }
+  }
+
+  if (tail)
+  {
+    desc[n++] = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_M2M_BYTE(src, &GPCRC->INPUTDATABYTE, tail, 1);
+  }
+
+  // Every descriptor writes to the same GPCRC register and only the last
+  // one ends the chain with an interrupt
+  for (int i = 0; i < n; i++)
+  {
+    desc[i].xfer.dstInc = ldmaCtrlDstIncNone;
+    desc[i].xfer.doneIfs = 0;
+  }
+  desc[n - 1].xfer.link = 0;
+  desc[n - 1].xfer.doneIfs = 1;
+
+  crc->busy = true;
+  LDMA_StartTransfer(crc->channel, (void*)&transfer, (void*)desc);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Handle the completion interrupt. Call from LDMA_IRQHandler() with the
+ *   pending interrupt flags.
+ *
+ * @return
+ *   True if the checksum finished.
+ ******************************************************************************/
+bool gpcrcLdmaIrqHandler(GpcrcLdma_t *crc, uint32_t pending)
+{
+  if (!(pending & (1UL << crc->channel)))
+  {
+    return false;
+  }
+
+  crc->busy = false;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check whether a checksum is still running.
+ ******************************************************************************/
+bool gpcrcLdmaBusy(const GpcrcLdma_t *crc)
+{
+  return crc->busy;
+}
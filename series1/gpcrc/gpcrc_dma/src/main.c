@@ -40,87 +40,24 @@
 #include "em_gpcrc.h"
 #include "em_ldma.h"
 #include "em_emu.h"
+#include "gpcrc_ldma.h"
 
-
-/* The width of the CRC calculation and result.
- * Modify the typedef for a 16 or 32-bit CRC standard. */
-typedef uint32_t crc_t;
-
-
-#define WIDTH       (8 * sizeof(crc_t))
-#define TOPBIT      (1 << (WIDTH - 1))
-#define POLYNOMIAL  0x04C11DB7
 #define PRESET      0xFFFFFFFF
 
 // DMA channel used
 #define LDMA_CHANNEL        0
-#define LDMA_CH_MASK        1 << LDMA_CHANNEL
-
-// Descriptor linked list for LDMA transfer
-LDMA_Descriptor_t descLink[2];
-
-// Arbitrary values to cycle through
-uint32_t data[4] = {0, 1, 2, 3};
-
-volatile uint32_t   source;
-volatile uint32_t   result;
-volatile uint32_t   i;
-
-volatile crc_t      crcTable[256];
-
-
-/***************************************************************************//**
- * @brief
- *   Initialize software ctcTable array for fast translations.
- ******************************************************************************/
-void initSoft(void)
-{
-  crc_t  remainder;
-
-  // Compute the remainder of each possible dividend
-  for (int i = 0; i < 256; ++i)
-  {
-    // Start with the dividend followed by zeros
-    remainder = i << (WIDTH - 8);
-
-    // Perform modulo-2 division, a bit at a time
-    for (uint8_t bit = 8; bit > 0; --bit)
-    {
-      // XOR with polynomial if top bit is 1
-      if (remainder & (uint32_t)TOPBIT)
-        remainder = (remainder << 1) ^ POLYNOMIAL;
-      else
-        remainder = (remainder << 1);
-    }
-    // Store the result into the table
-    crcTable[i] = remainder;
-  }
-}
 
-/***************************************************************************//**
- * @brief
- *   Software CRC calculation function
- ******************************************************************************/
-crc_t softCrc(crc_t message, crc_t preset)
-{
-  uint8_t data, thisByte;
-  crc_t remainder = preset;
+// Buffer checksummed, an odd length starting off a word boundary uses all
+// of the head, body and tail descriptors
+#define BUFFER_SIZE         4099
+#define BUFFER_OFFSET       1
 
-  // Divide the message by the polynomial, a byte at a time
-  for (int byte = 0; byte < sizeof(crc_t); ++byte)
-  {
-    // Separate out one byte of the message
-    thisByte = (message >> (8*byte)) & 0x0FF;
+uint8_t buffer[BUFFER_SIZE + BUFFER_OFFSET];
 
-    // XOR this byte with the current remainder
-    data = thisByte ^ (remainder >> (WIDTH - 8));
+// Checksum context, holds the LDMA descriptors
+GpcrcLdma_t crcDma;
 
-    // Set new remainder
-    remainder = crcTable[data] ^ (remainder << 8);
-  }
-  // The final remainder is the CRC
-  return (remainder);
-}
+volatile uint32_t   result;
 
 /***************************************************************************//**
  * @brief
@@ -143,39 +80,23 @@ void LDMA_IRQHandler( void )
   // Clear interrupts
   LDMA_IntClear(pending);
 
-  source = data[(++i)%4];
-
-  // Request next transfer
-  LDMA->SWREQ |= LDMA_CH_MASK;
-
+  // Read the checksum once the whole buffer has been fed to the GPCRC
+  if (gpcrcLdmaIrqHandler(&crcDma, pending))
+  {
+    result = GPCRC_DataRead(GPCRC);
+  }
 }
 
 /***************************************************************************//**
  * @brief
- *   Initialize the LDMA controller for descriptor list with looping
+ *   Initialize the LDMA controller
  ******************************************************************************/
 void initLdma(void)
 {
-
   LDMA_Init_t init = LDMA_INIT_DEFAULT;
   LDMA_Init( &init );
 
-  // Use looped peripheral transfer configuration macro
-  LDMA_TransferCfg_t transferConfig = LDMA_TRANSFER_CFG_MEMORY();
-
-  // LINK descriptor macros for looping, SINGLE descriptor macro for single transfer
-  // See README for explanation of why a "M2M" (Memory to memory) transfer is used here instead
-  // of a M2P (Memory to Peripheral) or P2M (Peripheral to Memory)
-  descLink[0] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2M_WORD(&source, &(GPCRC->INPUTDATA), 1, 1);
-  descLink[1] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2M_WORD(&(GPCRC->DATA), &result, 1, -1);
-
-  // Enable interrupt after second descriptor
-  descLink[1].xfer.doneIfs = true;
-
-  // Disable automatic triggers for first descriptor
-  descLink[0].xfer.structReq = false;
-
-  LDMA_StartTransfer(LDMA_CHANNEL, (void*)&transferConfig, (void*)&descLink);
+  gpcrcLdmaInit(&crcDma, LDMA_CHANNEL);
 }
 
 /**************************************************************************//**
@@ -209,21 +130,20 @@ int main(void)
 {
   CHIP_Init();
 
+  // Fill buffer with arbitrary values
+  for (int i = 0; i < BUFFER_SIZE + BUFFER_OFFSET; i++)
+  {
+    buffer[i] = (uint8_t)(i * 7 + 3);
+  }
+
   // Initialize GPCRC
   initGpcrc();
 
   // Initialize LDMA
   initLdma();
 
-  // Initialize array for software method
-  initSoft();
-
-  // Set up global variables
-  i = 0;
-  source = data[i++];
-
-  // Request first transfer
-  LDMA->SWREQ |= LDMA_CH_MASK;
+  // Checksum the buffer with a single descriptor chain
+  gpcrcLdmaStart(&crcDma, &buffer[BUFFER_OFFSET], BUFFER_SIZE);
 
   // Infinite loop
   while(1){
@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * @file crc32.h
+ * @brief Table-driven software CRC32 with GPCRC compatible bit ordering.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Software equivalent of the GPCRC configured for the IEEE 802.3
+ * polynomial (0x04C11DB7), for devices without a GPCRC and for checksumming
+ * whole buffers. The configuration fields and read functions mirror
+ * GPCRC_Init_TypeDef and the GPCRC_DataRead*() functions, so a CRC32
+ * context configured like the GPCRC returns the same values.
+ *
+ * Like the GPCRC, the CRC is reflected (bytes LSB first) by default, e.g.
+ * the standard CRC-32 of a buffer is the inverted CRC32_DataRead() with an
+ * initValue of 0xFFFFFFFF. With reverseBits set the bits of each byte are
+ * reversed first, so CRC32_DataReadBitReversed() returns the MSB first CRC.
+ *
+ * Buffers are processed with slicing-by-8 (or slicing-by-4) lookup tables
+ * that are generated from the polynomial by the preprocessor and placed in
+ * flash. Each bit order (reverseBits set or cleared) uses
+ * CRC32_SLICES * 1 KB of tables.
+ */
+
+// Number of lookup tables used per bit order, 4 or 8
+#ifndef CRC32_SLICES
+#define CRC32_SLICES        8
+#endif
+
+typedef struct
+{
+  uint32_t initValue;         // Value loaded into the CRC register on start
+  bool     reverseByteOrder;  // Process 16/32-bit inputs MSB first
+  bool     reverseBits;       // Reverse the bits of each input byte
+  bool     autoInit;          // Reload initValue after every read
+} CRC32_Init_TypeDef;
+
+// Same defaults as GPCRC_INIT_DEFAULT
+#define CRC32_INIT_DEFAULT                                                  \
+  {                                                                         \
+    0x00000000,   /* Initial value 0 */                                     \
+    false,        /* Input bytes LSB first */                               \
+    false,        /* No bit reversal */                                     \
+    false,        /* No automatic reload */                                 \
+  }
+
+typedef struct
+{
+  uint32_t data;              // GPCRC DATA, bit reversed if reverseBits
+  uint32_t initValue;
+  bool     reverseByteOrder;
+  bool     reverseBits;
+  bool     autoInit;
+} CRC32_TypeDef;
+
+void CRC32_Init(CRC32_TypeDef *crc, const CRC32_Init_TypeDef *init);
+void CRC32_Start(CRC32_TypeDef *crc);
+void CRC32_Update(CRC32_TypeDef *crc, const void *buffer, size_t length);
+void CRC32_InputU8(CRC32_TypeDef *crc, uint8_t data);
+void CRC32_InputU16(CRC32_TypeDef *crc, uint16_t data);
+void CRC32_InputU32(CRC32_TypeDef *crc, uint32_t data);
+uint32_t CRC32_DataRead(CRC32_TypeDef *crc);
+uint32_t CRC32_DataReadBitReversed(CRC32_TypeDef *crc);
+uint32_t CRC32_DataReadByteReversed(CRC32_TypeDef *crc);
+void CRC32_Combine(CRC32_TypeDef *crc, const CRC32_TypeDef *next,
+                   size_t nextLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC32_H
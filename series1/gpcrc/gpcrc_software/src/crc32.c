@@ -0,0 +1,559 @@
+/***************************************************************************//**
+ * @file crc32.c
+ * @brief Table-driven software CRC32 with GPCRC compatible bit ordering. See
+ * crc32.h for details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "crc32.h"
+
+// IEEE 802.3 polynomial, MSB first and reflected
+#define CRC32_POLY          0x04C11DB7UL
+#define CRC32_POLY_REV      0xEDB88320UL
+
+/*
+ * Compile-time table generation
+ *
+ * CRC division is linear, so a table entry is the XOR of the remainders of
+ * the set bits of its index. Those remainders are the top bit of the CRC
+ * register shifted through 1 to 64 single-bit division steps. They are
+ * generated as enum constants, split into 16-bit halves to stay within int
+ * range, so each step only expands its predecessor once.
+ */
+
+// One single-bit division step, MSB first and reflected
+#define CRC32_STEP(c)                                                       \
+  ((((c) << 1) & 0xFFFFFFFFUL) ^ ((0UL - ((c) >> 31)) & CRC32_POLY))
+#define CRC32_STEP_REV(c)                                                   \
+  (((c) >> 1) ^ ((0UL - ((c) & 1UL)) & CRC32_POLY_REV))
+
+// Remainder of the top register bit after n steps
+#define CRC32_NRM(n)                                                        \
+  (((uint32_t)CRC32_N##n##_H << 16) | (uint32_t)CRC32_N##n##_L)
+#define CRC32_REV(n)                                                        \
+  (((uint32_t)CRC32_R##n##_H << 16) | (uint32_t)CRC32_R##n##_L)
+
+#define CRC32_REMAINDERS(n, prev)                                           \
+  CRC32_N##n##_L = (int)(CRC32_STEP(CRC32_NRM(prev)) & 0xFFFF),             \
+  CRC32_N##n##_H = (int)(CRC32_STEP(CRC32_NRM(prev)) >> 16),                \
+  CRC32_R##n##_L = (int)(CRC32_STEP_REV(CRC32_REV(prev)) & 0xFFFF),         \
+  CRC32_R##n##_H = (int)(CRC32_STEP_REV(CRC32_REV(prev)) >> 16)
+
+enum
+{
+  // The top bit is bit 31 MSB first and bit 0 reflected
+  CRC32_N0_L = 0x0000, CRC32_N0_H = 0x8000,
+  CRC32_R0_L = 0x0001, CRC32_R0_H = 0x0000,
+  CRC32_REMAINDERS(1, 0),
+  CRC32_REMAINDERS(2, 1),
+  CRC32_REMAINDERS(3, 2),
+  CRC32_REMAINDERS(4, 3),
+  CRC32_REMAINDERS(5, 4),
+  CRC32_REMAINDERS(6, 5),
+  CRC32_REMAINDERS(7, 6),
+  CRC32_REMAINDERS(8, 7),
+  CRC32_REMAINDERS(9, 8),
+  CRC32_REMAINDERS(10, 9),
+  CRC32_REMAINDERS(11, 10),
+  CRC32_REMAINDERS(12, 11),
+  CRC32_REMAINDERS(13, 12),
+  CRC32_REMAINDERS(14, 13),
+  CRC32_REMAINDERS(15, 14),
+  CRC32_REMAINDERS(16, 15),
+  CRC32_REMAINDERS(17, 16),
+  CRC32_REMAINDERS(18, 17),
+  CRC32_REMAINDERS(19, 18),
+  CRC32_REMAINDERS(20, 19),
+  CRC32_REMAINDERS(21, 20),
+  CRC32_REMAINDERS(22, 21),
+  CRC32_REMAINDERS(23, 22),
+  CRC32_REMAINDERS(24, 23),
+  CRC32_REMAINDERS(25, 24),
+  CRC32_REMAINDERS(26, 25),
+  CRC32_REMAINDERS(27, 26),
+  CRC32_REMAINDERS(28, 27),
+  CRC32_REMAINDERS(29, 28),
+  CRC32_REMAINDERS(30, 29),
+  CRC32_REMAINDERS(31, 30),
+  CRC32_REMAINDERS(32, 31),
+  CRC32_REMAINDERS(33, 32),
+  CRC32_REMAINDERS(34, 33),
+  CRC32_REMAINDERS(35, 34),
+  CRC32_REMAINDERS(36, 35),
+  CRC32_REMAINDERS(37, 36),
+  CRC32_REMAINDERS(38, 37),
+  CRC32_REMAINDERS(39, 38),
+  CRC32_REMAINDERS(40, 39),
+  CRC32_REMAINDERS(41, 40),
+  CRC32_REMAINDERS(42, 41),
+  CRC32_REMAINDERS(43, 42),
+  CRC32_REMAINDERS(44, 43),
+  CRC32_REMAINDERS(45, 44),
+  CRC32_REMAINDERS(46, 45),
+  CRC32_REMAINDERS(47, 46),
+  CRC32_REMAINDERS(48, 47),
+  CRC32_REMAINDERS(49, 48),
+  CRC32_REMAINDERS(50, 49),
+  CRC32_REMAINDERS(51, 50),
+  CRC32_REMAINDERS(52, 51),
+  CRC32_REMAINDERS(53, 52),
+  CRC32_REMAINDERS(54, 53),
+  CRC32_REMAINDERS(55, 54),
+  CRC32_REMAINDERS(56, 55),
+  CRC32_REMAINDERS(57, 56),
+  CRC32_REMAINDERS(58, 57),
+  CRC32_REMAINDERS(59, 58),
+  CRC32_REMAINDERS(60, 59),
+  CRC32_REMAINDERS(61, 60),
+  CRC32_REMAINDERS(62, 61),
+  CRC32_REMAINDERS(63, 62),
+  CRC32_REMAINDERS(64, 63)
+};
+
+// Table entry for index i from the remainders of bits 0 to 7
+#define CRC32_ENTRY(i, b0, b1, b2, b3, b4, b5, b6, b7)                      \
+  ((((i) & 0x01) ? (b0) : 0) ^ (((i) & 0x02) ? (b1) : 0)                    \
+   ^ (((i) & 0x04) ? (b2) : 0) ^ (((i) & 0x08) ? (b3) : 0)                  \
+   ^ (((i) & 0x10) ? (b4) : 0) ^ (((i) & 0x20) ? (b5) : 0)                  \
+   ^ (((i) & 0x40) ? (b6) : 0) ^ (((i) & 0x80) ? (b7) : 0))
+
+// MSB first tables, slice k is byte i followed by k zero bytes
+#define CRC32_NRM_T0(i) \
+  CRC32_ENTRY((i), CRC32_NRM(1), CRC32_NRM(2), CRC32_NRM(3), CRC32_NRM(4), \
+                   CRC32_NRM(5), CRC32_NRM(6), CRC32_NRM(7), CRC32_NRM(8))
+#define CRC32_NRM_T1(i) \
+  CRC32_ENTRY((i), CRC32_NRM(9), CRC32_NRM(10), CRC32_NRM(11), CRC32_NRM(12), \
+                   CRC32_NRM(13), CRC32_NRM(14), CRC32_NRM(15), CRC32_NRM(16))
+#define CRC32_NRM_T2(i) \
+  CRC32_ENTRY((i), CRC32_NRM(17), CRC32_NRM(18), CRC32_NRM(19), CRC32_NRM(20), \
+                   CRC32_NRM(21), CRC32_NRM(22), CRC32_NRM(23), CRC32_NRM(24))
+#define CRC32_NRM_T3(i) \
+  CRC32_ENTRY((i), CRC32_NRM(25), CRC32_NRM(26), CRC32_NRM(27), CRC32_NRM(28), \
+                   CRC32_NRM(29), CRC32_NRM(30), CRC32_NRM(31), CRC32_NRM(32))
+#define CRC32_NRM_T4(i) \
+  CRC32_ENTRY((i), CRC32_NRM(33), CRC32_NRM(34), CRC32_NRM(35), CRC32_NRM(36), \
+                   CRC32_NRM(37), CRC32_NRM(38), CRC32_NRM(39), CRC32_NRM(40))
+#define CRC32_NRM_T5(i) \
+  CRC32_ENTRY((i), CRC32_NRM(41), CRC32_NRM(42), CRC32_NRM(43), CRC32_NRM(44), \
+                   CRC32_NRM(45), CRC32_NRM(46), CRC32_NRM(47), CRC32_NRM(48))
+#define CRC32_NRM_T6(i) \
+  CRC32_ENTRY((i), CRC32_NRM(49), CRC32_NRM(50), CRC32_NRM(51), CRC32_NRM(52), \
+                   CRC32_NRM(53), CRC32_NRM(54), CRC32_NRM(55), CRC32_NRM(56))
+#define CRC32_NRM_T7(i) \
+  CRC32_ENTRY((i), CRC32_NRM(57), CRC32_NRM(58), CRC32_NRM(59), CRC32_NRM(60), \
+                   CRC32_NRM(61), CRC32_NRM(62), CRC32_NRM(63), CRC32_NRM(64))
+
+// Reflected tables, slice k is byte i followed by k zero bytes
+#define CRC32_REV_T0(i) \
+  CRC32_ENTRY((i), CRC32_REV(8), CRC32_REV(7), CRC32_REV(6), CRC32_REV(5), \
+                   CRC32_REV(4), CRC32_REV(3), CRC32_REV(2), CRC32_REV(1))
+#define CRC32_REV_T1(i) \
+  CRC32_ENTRY((i), CRC32_REV(16), CRC32_REV(15), CRC32_REV(14), CRC32_REV(13), \
+                   CRC32_REV(12), CRC32_REV(11), CRC32_REV(10), CRC32_REV(9))
+#define CRC32_REV_T2(i) \
+  CRC32_ENTRY((i), CRC32_REV(24), CRC32_REV(23), CRC32_REV(22), CRC32_REV(21), \
+                   CRC32_REV(20), CRC32_REV(19), CRC32_REV(18), CRC32_REV(17))
+#define CRC32_REV_T3(i) \
+  CRC32_ENTRY((i), CRC32_REV(32), CRC32_REV(31), CRC32_REV(30), CRC32_REV(29), \
+                   CRC32_REV(28), CRC32_REV(27), CRC32_REV(26), CRC32_REV(25))
+#define CRC32_REV_T4(i) \
+  CRC32_ENTRY((i), CRC32_REV(40), CRC32_REV(39), CRC32_REV(38), CRC32_REV(37), \
+                   CRC32_REV(36), CRC32_REV(35), CRC32_REV(34), CRC32_REV(33))
+#define CRC32_REV_T5(i) \
+  CRC32_ENTRY((i), CRC32_REV(48), CRC32_REV(47), CRC32_REV(46), CRC32_REV(45), \
+                   CRC32_REV(44), CRC32_REV(43), CRC32_REV(42), CRC32_REV(41))
+#define CRC32_REV_T6(i) \
+  CRC32_ENTRY((i), CRC32_REV(56), CRC32_REV(55), CRC32_REV(54), CRC32_REV(53), \
+                   CRC32_REV(52), CRC32_REV(51), CRC32_REV(50), CRC32_REV(49))
+#define CRC32_REV_T7(i) \
+  CRC32_ENTRY((i), CRC32_REV(64), CRC32_REV(63), CRC32_REV(62), CRC32_REV(61), \
+                   CRC32_REV(60), CRC32_REV(59), CRC32_REV(58), CRC32_REV(57))
+
+// 256 entries of a table
+#define CRC32_ROW16(t, i)                                                   \
+  t((i) + 0x0), t((i) + 0x1), t((i) + 0x2), t((i) + 0x3),                   \
+  t((i) + 0x4), t((i) + 0x5), t((i) + 0x6), t((i) + 0x7),                   \
+  t((i) + 0x8), t((i) + 0x9), t((i) + 0xA), t((i) + 0xB),                   \
+  t((i) + 0xC), t((i) + 0xD), t((i) + 0xE), t((i) + 0xF)
+#define CRC32_TABLE(t)                                                      \
+  {                                                                         \
+    CRC32_ROW16(t, 0x00), CRC32_ROW16(t, 0x10), CRC32_ROW16(t, 0x20),       \
+    CRC32_ROW16(t, 0x30), CRC32_ROW16(t, 0x40), CRC32_ROW16(t, 0x50),       \
+    CRC32_ROW16(t, 0x60), CRC32_ROW16(t, 0x70), CRC32_ROW16(t, 0x80),       \
+    CRC32_ROW16(t, 0x90), CRC32_ROW16(t, 0xA0), CRC32_ROW16(t, 0xB0),       \
+    CRC32_ROW16(t, 0xC0), CRC32_ROW16(t, 0xD0), CRC32_ROW16(t, 0xE0),       \
+    CRC32_ROW16(t, 0xF0)                                                    \
+  }
+
+#if (CRC32_SLICES != 4) && (CRC32_SLICES != 8)
+#error "CRC32_SLICES must be 4 or 8"
+#endif
+
+// Lookup tables in flash
+static const uint32_t crcTable[CRC32_SLICES][256] =
+{
+  CRC32_TABLE(CRC32_NRM_T0), CRC32_TABLE(CRC32_NRM_T1),
+  CRC32_TABLE(CRC32_NRM_T2), CRC32_TABLE(CRC32_NRM_T3),
+#if CRC32_SLICES == 8
+  CRC32_TABLE(CRC32_NRM_T4), CRC32_TABLE(CRC32_NRM_T5),
+  CRC32_TABLE(CRC32_NRM_T6), CRC32_TABLE(CRC32_NRM_T7),
+#endif
+};
+
+static const uint32_t crcTableRev[CRC32_SLICES][256] =
+{
+  CRC32_TABLE(CRC32_REV_T0), CRC32_TABLE(CRC32_REV_T1),
+  CRC32_TABLE(CRC32_REV_T2), CRC32_TABLE(CRC32_REV_T3),
+#if CRC32_SLICES == 8
+  CRC32_TABLE(CRC32_REV_T4), CRC32_TABLE(CRC32_REV_T5),
+  CRC32_TABLE(CRC32_REV_T6), CRC32_TABLE(CRC32_REV_T7),
+#endif
+};
+
+/***************************************************************************//**
+ * @brief
+ *   Reverse the bit order of a word.
+ ******************************************************************************/
+static uint32_t reverseBits32(uint32_t x)
+{
+  x = ((x >> 1) & 0x55555555UL) | ((x & 0x55555555UL) << 1);
+  x = ((x >> 2) & 0x33333333UL) | ((x & 0x33333333UL) << 2);
+  x = ((x >> 4) & 0x0F0F0F0FUL) | ((x & 0x0F0F0F0FUL) << 4);
+  x = ((x >> 8) & 0x00FF00FFUL) | ((x & 0x00FF00FFUL) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+static uint32_t reverseBytes32(uint32_t x)
+{
+  return (x >> 24) | ((x >> 8) & 0xFF00UL) | ((x << 8) & 0xFF0000UL)
+         | (x << 24);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   MSB first CRC over a buffer, used when reverseBits is set.
+ ******************************************************************************/
+static uint32_t crcBuffer(uint32_t crc, const uint8_t *p, size_t length)
+{
+  const uint32_t (*t)[256] = crcTable;
+  uint32_t one;
+
+  // Align to a word boundary for the word loads below
+  while (length && ((uintptr_t)p & 3))
+  {
+    crc = (crc << 8) ^ t[0][(crc >> 24) ^ *p++];
+    length--;
+  }
+
+  // Words are loaded little-endian, the first byte in bits 7:0
+#if CRC32_SLICES == 8
+  while (length >= 8)
+  {
+    uint32_t two;
+
+    one = reverseBytes32(*(const uint32_t *)p) ^ crc;
+    two = reverseBytes32(*(const uint32_t *)(p + 4));
+    crc = t[7][one >> 24] ^ t[6][(one >> 16) & 0xFF]
+          ^ t[5][(one >> 8) & 0xFF] ^ t[4][one & 0xFF]
+          ^ t[3][two >> 24] ^ t[2][(two >> 16) & 0xFF]
+          ^ t[1][(two >> 8) & 0xFF] ^ t[0][two & 0xFF];
+    p += 8;
+    length -= 8;
+  }
+#endif
+  while (length >= 4)
+  {
+    one = reverseBytes32(*(const uint32_t *)p) ^ crc;
+    crc = t[3][one >> 24] ^ t[2][(one >> 16) & 0xFF]
+          ^ t[1][(one >> 8) & 0xFF] ^ t[0][one & 0xFF];
+    p += 4;
+    length -= 4;
+  }
+
+  while (length--)
+  {
+    crc = (crc << 8) ^ t[0][(crc >> 24) ^ *p++];
+  }
+  return crc;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reflected CRC over a buffer, used when reverseBits is cleared, as the
+ *   GPCRC is reflected natively.
+ ******************************************************************************/
+static uint32_t crcBufferRev(uint32_t crc, const uint8_t *p, size_t length)
+{
+  const uint32_t (*t)[256] = crcTableRev;
+  uint32_t one;
+
+  // Align to a word boundary for the word loads below
+  while (length && ((uintptr_t)p & 3))
+  {
+    crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    length--;
+  }
+
+  // Words are loaded little-endian, the first byte in bits 7:0
+#if CRC32_SLICES == 8
+  while (length >= 8)
+  {
+    uint32_t two;
+
+    one = *(const uint32_t *)p ^ crc;
+    two = *(const uint32_t *)(p + 4);
+    crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF]
+          ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+          ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF]
+          ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+    p += 8;
+    length -= 8;
+  }
+#endif
+  while (length >= 4)
+  {
+    one = *(const uint32_t *)p ^ crc;
+    crc = t[3][one & 0xFF] ^ t[2][(one >> 8) & 0xFF]
+          ^ t[1][(one >> 16) & 0xFF] ^ t[0][one >> 24];
+    p += 4;
+    length -= 4;
+  }
+
+  while (length--)
+  {
+    crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+  }
+  return crc;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Multiply two reflected polynomials modulo the CRC polynomial.
+ ******************************************************************************/
+static uint32_t multModPoly(uint32_t a, uint32_t b)
+{
+  uint32_t m = 1UL << 31;
+  uint32_t p = 0;
+
+  while (m)
+  {
+    if (a & m)
+    {
+      p ^= b;
+    }
+    m >>= 1;
+    b = CRC32_STEP_REV(b);
+  }
+  return p;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Advance a reflected CRC register over length zero bytes.
+ ******************************************************************************/
+static uint32_t shiftZeros(uint32_t crc, size_t length)
+{
+  uint32_t xPow = 1UL << 23;   // x^8, one byte
+  uint32_t p = 1UL << 31;      // x^0
+
+  while (length)
+  {
+    if (length & 1)
+    {
+      p = multModPoly(xPow, p);
+    }
+    xPow = multModPoly(xPow, xPow);
+    length >>= 1;
+  }
+  return multModPoly(p, crc);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize a software CRC context.
+ *
+ * @param[out] crc
+ *   CRC context.
+ *
+ * @param[in] init
+ *   Configuration, same meaning as the GPCRC_Init_TypeDef fields.
+ ******************************************************************************/
+void CRC32_Init(CRC32_TypeDef *crc, const CRC32_Init_TypeDef *init)
+{
+  crc->initValue = init->initValue;
+  crc->reverseByteOrder = init->reverseByteOrder;
+  crc->reverseBits = init->reverseBits;
+  crc->autoInit = init->autoInit;
+  CRC32_Start(crc);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Load the initial value into the CRC register, like GPCRC_Start().
+ ******************************************************************************/
+void CRC32_Start(CRC32_TypeDef *crc)
+{
+  crc->data = crc->reverseBits ? reverseBits32(crc->initValue)
+                               : crc->initValue;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add a buffer to the CRC, bytes in memory order.
+ *
+ * @details
+ *   Can be called repeatedly to checksum data as it arrives.
+ ******************************************************************************/
+void CRC32_Update(CRC32_TypeDef *crc, const void *buffer, size_t length)
+{
+  if (crc->reverseBits)
+  {
+    crc->data = crcBuffer(crc->data, (const uint8_t *)buffer, length);
+  }
+  else
+  {
+    crc->data = crcBufferRev(crc->data, (const uint8_t *)buffer, length);
+  }
+}
+
+void CRC32_InputU8(CRC32_TypeDef *crc, uint8_t data)
+{
+  CRC32_Update(crc, &data, 1);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add a halfword to the CRC, LSB first unless reverseByteOrder is set.
+ ******************************************************************************/
+void CRC32_InputU16(CRC32_TypeDef *crc, uint16_t data)
+{
+  uint8_t bytes[2];
+
+  if (crc->reverseByteOrder)
+  {
+    data = (uint16_t)((data >> 8) | (data << 8));
+  }
+  bytes[0] = (uint8_t)data;
+  bytes[1] = (uint8_t)(data >> 8);
+  CRC32_Update(crc, bytes, sizeof(bytes));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add a word to the CRC, LSB first unless reverseByteOrder is set.
+ ******************************************************************************/
+void CRC32_InputU32(CRC32_TypeDef *crc, uint32_t data)
+{
+  uint8_t bytes[4];
+
+  if (crc->reverseByteOrder)
+  {
+    data = reverseBytes32(data);
+  }
+  bytes[0] = (uint8_t)data;
+  bytes[1] = (uint8_t)(data >> 8);
+  bytes[2] = (uint8_t)(data >> 16);
+  bytes[3] = (uint8_t)(data >> 24);
+  CRC32_Update(crc, bytes, sizeof(bytes));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read the CRC register, like GPCRC_DataRead().
+ ******************************************************************************/
+uint32_t CRC32_DataRead(CRC32_TypeDef *crc)
+{
+  uint32_t data = crc->reverseBits ? reverseBits32(crc->data) : crc->data;
+
+  if (crc->autoInit)
+  {
+    CRC32_Start(crc);
+  }
+  return data;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read the bit reversed CRC register, like GPCRC_DataReadBitReversed().
+ ******************************************************************************/
+uint32_t CRC32_DataReadBitReversed(CRC32_TypeDef *crc)
+{
+  return reverseBits32(CRC32_DataRead(crc));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read the byte reversed CRC register, like GPCRC_DataReadByteReversed().
+ ******************************************************************************/
+uint32_t CRC32_DataReadByteReversed(CRC32_TypeDef *crc)
+{
+  return reverseBytes32(CRC32_DataRead(crc));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Append the CRC of a following block to a CRC.
+ *
+ * @details
+ *   Both contexts must have the same configuration and have been started
+ *   from initValue. Afterwards crc holds the CRC of its own data followed by
+ *   the nextLength bytes covered by next, so partial CRCs computed
+ *   separately (or on different devices) can be merged without the data.
+ *
+ * @param[in,out] crc
+ *   CRC of the first block.
+ *
+ * @param[in] next
+ *   CRC of the following block.
+ *
+ * @param[in] nextLength
+ *   Length of the following block in bytes.
+ ******************************************************************************/
+void CRC32_Combine(CRC32_TypeDef *crc, const CRC32_TypeDef *next,
+                   size_t nextLength)
+{
+  uint32_t init = crc->initValue;
+  uint32_t first = crc->data;
+  uint32_t second = next->data;
+
+  // Combine in the reflected domain, the one of the GPCRC DATA register
+  if (crc->reverseBits)
+  {
+    first = reverseBits32(first);
+    second = reverseBits32(second);
+  }
+
+  // The initial value contributes to both CRCs, cancel one of them
+  first = shiftZeros(first ^ init, nextLength) ^ second;
+
+  crc->data = crc->reverseBits ? reverseBits32(first) : first;
+}
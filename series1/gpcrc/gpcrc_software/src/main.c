@@ -38,69 +38,80 @@
 #include "em_chip.h"
 #include "em_cmu.h"
 #include "em_gpcrc.h"
+#include "crc32.h"
 
-/* The width of the CRC calculation and result.
- * Modify the typedef for a 16 or 32-bit CRC standard. */
-typedef uint32_t crc_t;
-
-#define WIDTH       (8 * sizeof(crc_t))
-#define TOPBIT      (1 << (WIDTH - 1))
-#define POLYNOMIAL  0x04C11DB7
 #define PRESET      0xFFFFFFFF
 
 #define ARRAY_SIZE  16
 #define STRIDE      0xABCD
 
-volatile crc_t      crcTable[256];
-
 volatile uint32_t   source[ARRAY_SIZE];
 volatile uint32_t   results[ARRAY_SIZE];
 volatile uint32_t   softResults[ARRAY_SIZE];
 
+// CRC of the whole source array computed in hardware, in software with one
+// call, and in software from two halves combined afterwards
+volatile uint32_t   bufferResult;
+volatile uint32_t   softBufferResult;
+volatile uint32_t   softCombinedResult;
+
+CRC32_TypeDef       softCrc;
+
+// Standard CRC-32 of one byte, the example of the emlib GPCRC documentation:
+// default configuration with an initValue of 0xFFFFFFFF, result inverted
+#define EMLIB_EXAMPLE_BYTE  0xC5
+#define EMLIB_EXAMPLE_CRC   0x390CD9B2
 
+// MSB first CRC of each source word from PRESET, as computed bit by bit by
+// the table-less division this example used before crc32.c
+static const uint32_t expectedResults[ARRAY_SIZE] =
+{
+  0x326C7C5A, 0x6FB512EF, 0x42E79E32, 0xDA7394EE,
+  0x0E8F601E, 0xC803465E, 0x83378416, 0xF39E153A,
+  0x92C3E20B, 0x50D2BA06, 0x2EB0758F, 0x91DE203B,
+  0x96E5999F, 0x09C3FFC0, 0x919BD6BF, 0xAE314DF9
+};
+
+// Set if the software CRC gives the known values above
+volatile bool       softChecksPassed;
+
+/**************************************************************************//**
+ * @brief  Software CRC Initializer
+ *****************************************************************************/
 void initSoft(void)
 {
-  crc_t  remainder;
+  // Same configuration as the GPCRC below
+  CRC32_Init_TypeDef init = CRC32_INIT_DEFAULT;
 
-  // Compute the remainder of each possible dividend
-  for (int i = 0; i < 256; ++i)
-  {
-    // Start with the dividend followed by zeros
-    remainder = i << (WIDTH - 8);
-
-    // Perform modulo-2 division, a bit at a time
-    for (uint8_t bit = 8; bit > 0; --bit)
-    {
-      // XOR with polynomial if top bit is 1
-      if (remainder & (uint32_t)TOPBIT)
-        remainder = (remainder << 1) ^ POLYNOMIAL;
-      else
-        remainder = (remainder << 1);
-    }
-    // Store the result into the table
-    crcTable[i] = remainder;
-  }
+  init.initValue = PRESET;
+  init.autoInit = true;
+  init.reverseBits = true;
+
+  CRC32_Init(&softCrc, &init);
 }
 
-crc_t softCrc(crc_t message, crc_t preset)
+/**************************************************************************//**
+ * @brief  Check the software CRC against known values
+ *****************************************************************************/
+bool checkSoft(void)
 {
-  uint8_t data, thisByte;
-  crc_t remainder = preset;
-
-  // Divide the message by the polynomial, a byte at a time
-  for (int byte = 0; byte < sizeof(crc_t); ++byte)
-  {
-    // Separate out one byte of the message
-    thisByte = (message >> (8*byte)) & 0x0FF;
+  CRC32_Init_TypeDef init = CRC32_INIT_DEFAULT;
+  CRC32_TypeDef crc;
+  bool passed;
 
-    // XOR this byte with the current remainder
-    data = thisByte ^ (remainder >> (WIDTH - 8));
+  // Reflected CRC, the default bit order of the GPCRC
+  init.initValue = PRESET;
+  CRC32_Init(&crc, &init);
+  CRC32_InputU8(&crc, EMLIB_EXAMPLE_BYTE);
+  passed = (~CRC32_DataRead(&crc) == EMLIB_EXAMPLE_CRC);
 
-    // Set new remainder
-    remainder = crcTable[data] ^ (remainder << 8);
+  // MSB first CRC, with reverseBits set
+  for (int i = 0; i < ARRAY_SIZE; i++)
+  {
+    passed = passed && (softResults[i] == expectedResults[i]);
   }
-  // The final remainder is the CRC
-  return (remainder);
+
+  return passed && (softBufferResult == softCombinedResult);
 }
 
 /**************************************************************************//**
@@ -146,7 +157,8 @@ int main(void)
   for (int i = 0; i < ARRAY_SIZE; i++)
   {
     // Get software CRC result
-    softResults[i] = softCrc(source[i], PRESET);
+    CRC32_InputU32(&softCrc, source[i]);
+    softResults[i] = CRC32_DataReadBitReversed(&softCrc);
 
     // Feed in source
     GPCRC_InputU32(GPCRC, source[i]);
@@ -155,6 +167,29 @@ int main(void)
     results[i] = GPCRC_DataReadBitReversed(GPCRC);
   }
 
+  // Calculate the CRC of the whole source array
+  for (int i = 0; i < ARRAY_SIZE; i++)
+  {
+    GPCRC_InputU32(GPCRC, source[i]);
+  }
+  bufferResult = GPCRC_DataReadBitReversed(GPCRC);
+
+  CRC32_Update(&softCrc, (const void *)source, sizeof(source));
+  softBufferResult = CRC32_DataReadBitReversed(&softCrc);
+
+  // Same CRC from two halves, e.g. computed as the data arrived
+  {
+    CRC32_TypeDef second = softCrc;
+
+    CRC32_Update(&softCrc, (const void *)source, sizeof(source) / 2);
+    CRC32_Update(&second, (const void *)&source[ARRAY_SIZE / 2],
+                 sizeof(source) / 2);
+    CRC32_Combine(&softCrc, &second, sizeof(source) / 2);
+    softCombinedResult = CRC32_DataReadBitReversed(&softCrc);
+  }
+
+  softChecksPassed = checkSoft();
+
   // Infinite loop
   while(1);
 }
@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ * @file i2c_master_queue.h
+ * @brief Interrupt driven queue of I2C master transactions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef I2C_MASTER_QUEUE_H
+#define I2C_MASTER_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+#include "em_i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of transactions that can be queued, including the one running
+#if !defined(I2C_MASTER_QUEUE_SIZE)
+#define I2C_MASTER_QUEUE_SIZE  8
+#endif
+
+typedef struct I2cTransaction I2cTransaction_t;
+
+// Called from the I2C interrupt once the transaction has ended, result
+// holds i2cTransferDone or the error that ended it
+typedef void (*I2cTransactionDone_t)(I2cTransaction_t *transaction);
+
+// One transaction with a device. txLength bytes are written, then rxLength
+// bytes are read after a repeated start; either length may be 0, giving a
+// write or a read only.
+struct I2cTransaction {
+  uint16_t address;             // Slave address, in bits 7:1
+  const uint8_t *tx;
+  uint16_t txLength;
+  uint8_t *rx;
+  uint16_t rxLength;
+  I2cTransactionDone_t done;
+  void *user;
+  I2C_TransferReturn_TypeDef result;
+};
+
+/*
+ * Queued transactions run back to back from the I2C interrupt, which drives
+ * the emlib I2C_Transfer() state machine one bus event at a time. The
+ * master interrupts are only enabled while the queue is not empty, so the
+ * I2C interrupt can be shared with slave mode handling.
+ */
+typedef struct {
+  I2C_TypeDef *i2c;
+  I2C_TransferSeq_TypeDef seq;  // Transfer running
+  I2cTransaction_t *queue[I2C_MASTER_QUEUE_SIZE];
+  uint32_t head;                // Next free slot
+  uint32_t tail;                // Transaction running
+  volatile uint32_t count;
+} I2cMasterQueue_t;
+
+void i2cMasterQueueInit(I2cMasterQueue_t *queue, I2C_TypeDef *i2c);
+bool i2cMasterQueueSubmit(I2cMasterQueue_t *queue,
+                          I2cTransaction_t *transaction);
+void i2cMasterQueueIrq(I2cMasterQueue_t *queue);
+bool i2cMasterQueueIdle(I2cMasterQueue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_MASTER_QUEUE_H
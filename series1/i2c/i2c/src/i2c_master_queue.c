@@ -0,0 +1,201 @@
+/***************************************************************************//**
+ * @file i2c_master_queue.c
+ * @brief Interrupt driven queue of I2C master transactions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "em_assert.h"
+#include "em_core.h"
+#include "i2c_master_queue.h"
+
+// Interrupts used by I2C_Transfer() in master mode
+#define I2C_MASTER_IEN  (I2C_IEN_ACK | I2C_IEN_NACK | I2C_IEN_RXDATAV         \
+                         | I2C_IEN_MSTOP | I2C_IEN_ARBLOST | I2C_IEN_BUSERR)
+
+/**************************************************************************//**
+ * @brief
+ *    Start the transaction at the tail of the queue
+ *
+ * @return
+ *    false if it ended right away, its result is set
+ *****************************************************************************/
+static bool startTransaction(I2cMasterQueue_t *queue)
+{
+  I2cTransaction_t *transaction = queue->queue[queue->tail];
+  I2C_TransferSeq_TypeDef *seq = &queue->seq;
+
+  seq->addr = transaction->address;
+  if (transaction->txLength == 0) {
+    seq->flags = I2C_FLAG_READ;
+    seq->buf[0].data = transaction->rx;
+    seq->buf[0].len = transaction->rxLength;
+  } else {
+    seq->flags = (transaction->rxLength == 0) ? I2C_FLAG_WRITE
+                 : I2C_FLAG_WRITE_READ;
+    seq->buf[0].data = (uint8_t *)transaction->tx;
+    seq->buf[0].len = transaction->txLength;
+    seq->buf[1].data = transaction->rx;
+    seq->buf[1].len = transaction->rxLength;
+  }
+
+  transaction->result = I2C_TransferInit(queue->i2c, seq);
+
+  return transaction->result == i2cTransferInProgress;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Complete the transaction running, and the ones after it that end as
+ *    they start
+ *
+ * @details
+ *    The next transaction is started before the callback is called, so the
+ *    bus is kept busy while it runs.
+ *****************************************************************************/
+static void completeTransactions(I2cMasterQueue_t *queue)
+{
+  I2cTransaction_t *transaction;
+  bool ended;
+
+  do {
+    transaction = queue->queue[queue->tail];
+    queue->tail = (queue->tail + 1) % I2C_MASTER_QUEUE_SIZE;
+    queue->count--;
+
+    // A transaction submitted from the callback once the queue is empty
+    // starts on its own
+    if (queue->count == 0) {
+      I2C_IntDisable(queue->i2c, I2C_MASTER_IEN);
+      ended = false;
+    } else {
+      ended = !startTransaction(queue);
+    }
+
+    if (transaction->done != NULL) {
+      transaction->done(transaction);
+    }
+  } while (ended);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Initialize an empty queue
+ *
+ * @param[in] i2c
+ *    I2C initialized as a master. Its IRQ handler must call
+ *    i2cMasterQueueIrq() and be enabled in the NVIC.
+ *****************************************************************************/
+void i2cMasterQueueInit(I2cMasterQueue_t *queue, I2C_TypeDef *i2c)
+{
+  queue->i2c = i2c;
+  queue->head = 0;
+  queue->tail = 0;
+  queue->count = 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Queue a transaction
+ *
+ * @details
+ *    The transaction starts right away if the queue is empty, otherwise
+ *    once the transactions queued before it are done. Can be called from
+ *    interrupt handlers, including the callbacks of transactions.
+ *
+ * @param[in] transaction
+ *    Transaction to run, must stay valid until its callback has been called
+ *
+ * @return
+ *    false if I2C_MASTER_QUEUE_SIZE transactions are already queued, the
+ *    transaction is not queued
+ *****************************************************************************/
+bool i2cMasterQueueSubmit(I2cMasterQueue_t *queue,
+                          I2cTransaction_t *transaction)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  EFM_ASSERT((transaction->txLength > 0) || (transaction->rxLength > 0));
+
+  CORE_ENTER_ATOMIC();
+
+  if (queue->count == I2C_MASTER_QUEUE_SIZE) {
+    CORE_EXIT_ATOMIC();
+    return false;
+  }
+
+  queue->queue[queue->head] = transaction;
+  queue->head = (queue->head + 1) % I2C_MASTER_QUEUE_SIZE;
+  queue->count++;
+
+  if (queue->count == 1) {
+    I2C_IntEnable(queue->i2c, I2C_MASTER_IEN);
+    if (!startTransaction(queue)) {
+      completeTransactions(queue);
+    }
+  }
+
+  CORE_EXIT_ATOMIC();
+
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Advance the transaction running, call from the I2C IRQ handler
+ *
+ * @details
+ *    Once the transaction has ended its callback is called and the next
+ *    transaction is started, without waiting for the main loop.
+ *****************************************************************************/
+void i2cMasterQueueIrq(I2cMasterQueue_t *queue)
+{
+  I2cTransaction_t *transaction;
+
+  if (queue->count == 0) {
+    return;
+  }
+
+  transaction = queue->queue[queue->tail];
+  transaction->result = I2C_Transfer(queue->i2c);
+  if (transaction->result != i2cTransferInProgress) {
+    completeTransactions(queue);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    true when all queued transactions are done
+ *****************************************************************************/
+bool i2cMasterQueueIdle(I2cMasterQueue_t *queue)
+{
+  return queue->count == 0;
+}
@@ -3,7 +3,8 @@
  * @brief This project demonstrates both master and slave configurations of the
  * EFM32 I2C peripheral. Two EFM32 I2C modules are connected and set up to both
  * transmit (master mode) and receive (slave mode) between each other using a
- * common I2C bus.
+ * common I2C bus. The master transfer is run by the I2C interrupt handler
+ * (src/i2c_master_queue.c) while the sender waits in EM1.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -44,6 +45,7 @@
 #include "em_emu.h"
 #include "em_gpio.h"
 #include "bsp.h"
+#include "i2c_master_queue.h"
 
 // Defines
 #define I2C_ADDRESS                     0xE2
@@ -60,6 +62,10 @@ uint8_t i2c_rxBufferIndex;
 volatile bool i2c_rxInProgress;
 volatile bool i2c_startTx;
 
+// Transfer sent as master, run by the I2C interrupt
+I2cMasterQueue_t i2c_queue;
+I2cTransaction_t i2c_transaction;
+
 /**************************************************************************//**
  * @brief  Starting oscillators and enabling clocks
  *****************************************************************************/
@@ -103,11 +109,11 @@ void enableI2cSlaveInterrupts(void)
 }
 
 /**************************************************************************//**
- * @brief  disables I2C interrupts
+ * @brief  disables I2C slave interrupts, the I2C interrupt stays enabled for
+ *         the master transfer
  *****************************************************************************/
 void disableI2cInterrupts(void)
 {
-  NVIC_DisableIRQ(I2C0_IRQn);
   I2C_IntDisable(I2C0, I2C_IEN_ADDR | I2C_IEN_RXDATAV | I2C_IEN_SSTOP);
   I2C_IntClear(I2C0, I2C_IFC_ADDR | I2C_IF_RXDATAV | I2C_IFC_SSTOP);
 }
@@ -140,6 +146,7 @@ void initI2C(void)
   i2c_rxInProgress = false;
   i2c_startTx = false;
   i2c_rxBufferIndex = 0;
+  i2cMasterQueueInit(&i2c_queue, I2C0);
 
   // Setting up to enable slave mode
   I2C0->SADDR = I2C_ADDRESS;
@@ -149,30 +156,28 @@ void initI2C(void)
 }
 
 /**************************************************************************//**
- * @brief  Transmitting I2C data. Will busy-wait until the transfer is complete.
+ * @brief  Transmitting I2C data. Along with the I2C interrupt, it will keep the
+  EFM32 in EM1 while the data is sent.
  *****************************************************************************/
 void performI2CTransfer(void)
 {
-  // Transfer structure
-  I2C_TransferSeq_TypeDef i2cTransfer;
-  I2C_TransferReturn_TypeDef result;
-
   // Setting LED to indicate transfer
   GPIO_PinOutSet(BSP_GPIO_LED1_PORT, BSP_GPIO_LED1_PIN);
 
-  // Initializing I2C transfer
-  i2cTransfer.addr          = I2C_ADDRESS;
-  i2cTransfer.flags         = I2C_FLAG_WRITE;
-  i2cTransfer.buf[0].data   = i2c_txBuffer;
-  i2cTransfer.buf[0].len    = i2c_txBufferSize;
-  i2cTransfer.buf[1].data   = i2c_rxBuffer;
-  i2cTransfer.buf[1].len    = I2C_RXBUFFER_SIZE;
-  result = I2C_TransferInit(I2C0, &i2cTransfer);
+  // Initializing I2C transfer, the I2C interrupt sends it
+  i2c_transaction.address  = I2C_ADDRESS;
+  i2c_transaction.tx       = i2c_txBuffer;
+  i2c_transaction.txLength = i2c_txBufferSize;
+  i2c_transaction.rx       = NULL;
+  i2c_transaction.rxLength = 0;
+  i2c_transaction.done     = NULL;
+  i2c_transaction.user     = NULL;
+  i2cMasterQueueSubmit(&i2c_queue, &i2c_transaction);
 
   // Sending data
-  while (result == i2cTransferInProgress)
+  while (!i2cMasterQueueIdle(&i2c_queue))
   {
-    result = I2C_Transfer(I2C0);
+    EMU_EnterEM1();
   }
 
   // Clearing pin to indicate end of transfer
@@ -199,6 +204,14 @@ void receiveI2CData(void)
 void I2C0_IRQHandler(void)
 {
   int status;
+  uint8_t rxData;
+
+  // Transfer sent as master
+  if (!i2cMasterQueueIdle(&i2c_queue))
+  {
+    i2cMasterQueueIrq(&i2c_queue);
+    return;
+  }
 
   status = I2C0->IF;
 
@@ -214,9 +227,13 @@ void I2C0_IRQHandler(void)
 
   } else if (status & I2C_IF_RXDATAV)
   {
-    // Data received
-    i2c_rxBuffer[i2c_rxBufferIndex] = I2C0->RXDATA;
-    i2c_rxBufferIndex++;
+    // Data received, bytes past the end of the buffer are dropped
+    rxData = I2C0->RXDATA;
+    if (i2c_rxBufferIndex < I2C_RXBUFFER_SIZE)
+    {
+      i2c_rxBuffer[i2c_rxBufferIndex] = rxData;
+      i2c_rxBufferIndex++;
+    }
   }
 
   if(status & I2C_IF_SSTOP){
@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ * @file edge_analyzer.h
+ * @brief Frequency and duty cycle of a signal from the TIMER captures of
+ * both of its edges, over a sliding window of cycles.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EDGE_ANALYZER_H
+#define EDGE_ANALYZER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cycles in the sliding window, a power of two
+#ifndef EDGE_ANALYZER_WINDOW
+#define EDGE_ANALYZER_WINDOW  64
+#endif
+
+/*
+ * The captures alternate between rising and falling edges, starting with
+ * the polarity given to edgeAnalyzerInit(). The time between two captures
+ * is taken modulo the counter range, top + 1, so it is right as long as
+ * the counter wraps at most once between two edges, and a period must fit
+ * in 32 bits.
+ *
+ * Each rising edge completes a cycle: its period, from the previous rising
+ * edge, and its high time, up to the falling edge in between. The last
+ * EDGE_ANALYZER_WINDOW cycles are kept with running sums, so a capture
+ * costs the same whatever the window, and the shortest and longest period
+ * in the window are kept in two monotonic queues of cycle numbers.
+ */
+typedef struct {
+  uint32_t top;                                // Counter TOP value
+  uint32_t last;                               // Previous capture
+  uint32_t high;                               // High time of this cycle
+  bool     nextRising;                         // Polarity of next capture
+  bool     primed;                             // last is valid
+  bool     started;                            // A rising edge was seen
+  uint32_t cycles;                             // Cycles completed
+  uint32_t lastPeriod;                         // Period of the last cycle
+  uint32_t period[EDGE_ANALYZER_WINDOW];       // Periods, by cycle number
+  uint32_t highTime[EDGE_ANALYZER_WINDOW];     // High times
+  uint32_t change[EDGE_ANALYZER_WINDOW];       // |period - previous period|
+  uint64_t sumPeriod;                          // Sums over the window
+  uint64_t sumHigh;
+  uint64_t sumChange;
+  uint32_t minQueue[EDGE_ANALYZER_WINDOW];     // Cycles, increasing periods
+  uint32_t maxQueue[EDGE_ANALYZER_WINDOW];     // Cycles, decreasing periods
+  uint32_t minHead, minTail;
+  uint32_t maxHead, maxTail;
+} EdgeAnalyzer_t;
+
+typedef struct {
+  uint32_t cycles;            // Cycles in the window
+  uint32_t frequencyMilliHz;  // Mean frequency
+  uint32_t dutyPermyriad;     // Mean duty cycle, in 0.01 %
+  uint32_t periodMinNs;       // Shortest period
+  uint32_t periodMaxNs;       // Longest period
+  uint32_t jitterNs;          // Mean change of the period from a cycle
+                              // to the next
+} EdgeStats_t;
+
+void edgeAnalyzerInit(EdgeAnalyzer_t *analyzer, uint32_t top,
+                      bool firstRising);
+void edgeAnalyzerProcess(EdgeAnalyzer_t *analyzer,
+                         const uint32_t *captures, uint32_t count);
+void edgeAnalyzerSkip(EdgeAnalyzer_t *analyzer, uint32_t count);
+bool edgeAnalyzerStats(const EdgeAnalyzer_t *analyzer, uint32_t timerFreq,
+                       EdgeStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDGE_ANALYZER_H
@@ -0,0 +1,272 @@
+/***************************************************************************//**
+ * @file edge_analyzer.c
+ * @brief Frequency and duty cycle of a signal from the TIMER captures of
+ * both of its edges, over a sliding window of cycles.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "em_assert.h"
+#include "edge_analyzer.h"
+
+#define WINDOW_MASK  (EDGE_ANALYZER_WINDOW - 1)
+
+/**************************************************************************//**
+ * @brief
+ *    Add a cycle to the window, dropping the oldest one once it is full
+ *****************************************************************************/
+static void addCycle(EdgeAnalyzer_t *analyzer, uint32_t period, uint32_t high)
+{
+  uint32_t cycle = analyzer->cycles;
+  uint32_t slot = cycle & WINDOW_MASK;
+  uint32_t change = 0;
+
+  if (cycle >= EDGE_ANALYZER_WINDOW) {
+    analyzer->sumPeriod -= analyzer->period[slot];
+    analyzer->sumHigh -= analyzer->highTime[slot];
+    analyzer->sumChange -= analyzer->change[slot];
+
+    // The cycle leaving the window leaves the queues as well
+    if (analyzer->minQueue[analyzer->minHead & WINDOW_MASK]
+        == cycle - EDGE_ANALYZER_WINDOW)
+      analyzer->minHead++;
+    if (analyzer->maxQueue[analyzer->maxHead & WINDOW_MASK]
+        == cycle - EDGE_ANALYZER_WINDOW)
+      analyzer->maxHead++;
+  }
+
+  if (cycle > 0) {
+    change = (period > analyzer->lastPeriod) ? period - analyzer->lastPeriod
+                                             : analyzer->lastPeriod - period;
+  }
+
+  // Cycles that can never be the shortest or the longest again are dropped
+  // from the back of the queues
+  while (analyzer->minTail != analyzer->minHead
+         && analyzer->period[analyzer->minQueue[(analyzer->minTail - 1) & WINDOW_MASK]
+                             & WINDOW_MASK] >= period)
+    analyzer->minTail--;
+  while (analyzer->maxTail != analyzer->maxHead
+         && analyzer->period[analyzer->maxQueue[(analyzer->maxTail - 1) & WINDOW_MASK]
+                             & WINDOW_MASK] <= period)
+    analyzer->maxTail--;
+  analyzer->minQueue[analyzer->minTail++ & WINDOW_MASK] = cycle;
+  analyzer->maxQueue[analyzer->maxTail++ & WINDOW_MASK] = cycle;
+
+  analyzer->period[slot] = period;
+  analyzer->highTime[slot] = high;
+  analyzer->change[slot] = change;
+  analyzer->sumPeriod += period;
+  analyzer->sumHigh += high;
+  analyzer->sumChange += change;
+  analyzer->lastPeriod = period;
+  analyzer->cycles = cycle + 1;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start analyzing a stream of captures
+ *
+ * @param[in] analyzer
+ *    Analyzer state
+ *
+ * @param[in] top
+ *    TOP value of the TIMER, the counter wraps from top to 0
+ *
+ * @param[in] firstRising
+ *    True if the first capture is that of a rising edge
+ *****************************************************************************/
+void edgeAnalyzerInit(EdgeAnalyzer_t *analyzer, uint32_t top,
+                      bool firstRising)
+{
+  EFM_ASSERT((EDGE_ANALYZER_WINDOW & WINDOW_MASK) == 0);
+
+  analyzer->top = top;
+  analyzer->last = 0;
+  analyzer->high = 0;
+  analyzer->nextRising = firstRising;
+  analyzer->primed = false;
+  analyzer->started = false;
+  analyzer->cycles = 0;
+  analyzer->lastPeriod = 0;
+  analyzer->sumPeriod = 0;
+  analyzer->sumHigh = 0;
+  analyzer->sumChange = 0;
+  analyzer->minHead = 0;
+  analyzer->minTail = 0;
+  analyzer->maxHead = 0;
+  analyzer->maxTail = 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Process a block of consecutive captures
+ *
+ * @details
+ *    The captures continue those of the previous call, so a stream can be
+ *    processed in blocks of any size, e.g. as they are found in a ring.
+ *
+ * @param[in] analyzer
+ *    Analyzer state
+ *
+ * @param[in] captures
+ *    Counter values captured on the edges
+ *
+ * @param[in] count
+ *    Number of captures
+ *****************************************************************************/
+void edgeAnalyzerProcess(EdgeAnalyzer_t *analyzer,
+                         const uint32_t *captures, uint32_t count)
+{
+  uint32_t top = analyzer->top;
+  uint32_t last = analyzer->last;
+  bool rising = analyzer->nextRising;
+  uint32_t delta;
+  uint32_t i = 0;
+
+  if (count == 0)
+    return;
+
+  // The first capture only gives the time of the next edges
+  if (!analyzer->primed) {
+    last = captures[0];
+    analyzer->primed = true;
+    analyzer->started = rising;
+    rising = !rising;
+    i = 1;
+  }
+
+  for (; i < count; i++) {
+    uint32_t capture = captures[i];
+
+    // Time since the previous edge, the counter may have wrapped once
+    delta = (capture >= last) ? capture - last : capture + (top - last) + 1;
+    last = capture;
+
+    if (rising) {
+      // The low time completes the cycle
+      if (analyzer->started)
+        addCycle(analyzer, analyzer->high + delta, analyzer->high);
+      analyzer->started = true;
+    } else {
+      analyzer->high = delta;
+    }
+
+    rising = !rising;
+  }
+
+  analyzer->last = last;
+  analyzer->nextRising = rising;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Skip captures that were lost, e.g. overwritten in a ring
+ *
+ * @details
+ *    The cycle in progress is dropped and the analysis starts again at the
+ *    next capture, whose polarity follows from the number of captures
+ *    skipped. The window keeps the cycles measured before.
+ *****************************************************************************/
+void edgeAnalyzerSkip(EdgeAnalyzer_t *analyzer, uint32_t count)
+{
+  if (count == 0)
+    return;
+
+  if (count & 1)
+    analyzer->nextRising = !analyzer->nextRising;
+  analyzer->primed = false;
+  analyzer->started = false;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Convert a sum of n times in TIMER ticks to the mean in nanoseconds
+ *****************************************************************************/
+static uint32_t meanNs(uint64_t sum, uint32_t n, uint32_t timerFreq)
+{
+  uint64_t whole = sum / n;
+  uint64_t ns = (whole * 1000000000ULL
+                 + ((sum % n) * 1000000000ULL) / n) / timerFreq;
+
+  return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t) ns;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Statistics of the cycles in the window
+ *
+ * @param[in] analyzer
+ *    Analyzer state
+ *
+ * @param[in] timerFreq
+ *    Frequency of the TIMER counter after prescaling in Hz
+ *
+ * @param[out] stats
+ *    Statistics, left unchanged if no cycle has been completed
+ *
+ * @return
+ *    True if at least one cycle has been completed
+ *****************************************************************************/
+bool edgeAnalyzerStats(const EdgeAnalyzer_t *analyzer, uint32_t timerFreq,
+                       EdgeStats_t *stats)
+{
+  uint32_t n = analyzer->cycles;
+  uint32_t changes;
+  uint64_t frequency;
+
+  if (n == 0 || analyzer->sumPeriod == 0)
+    return false;
+
+  // The change of the first cycle ever is not counted
+  if (n > EDGE_ANALYZER_WINDOW) {
+    n = EDGE_ANALYZER_WINDOW;
+    changes = n;
+  } else {
+    changes = n - 1;
+  }
+
+  frequency = ((uint64_t) timerFreq * 1000 * n) / analyzer->sumPeriod;
+
+  stats->cycles = n;
+  stats->frequencyMilliHz = (frequency > UINT32_MAX) ? UINT32_MAX
+                                                     : (uint32_t) frequency;
+  stats->dutyPermyriad = (uint32_t) ((analyzer->sumHigh * 10000)
+                                     / analyzer->sumPeriod);
+  stats->periodMinNs = meanNs(analyzer->period[analyzer->minQueue[analyzer->minHead & WINDOW_MASK]
+                                               & WINDOW_MASK], 1, timerFreq);
+  stats->periodMaxNs = meanNs(analyzer->period[analyzer->maxQueue[analyzer->maxHead & WINDOW_MASK]
+                                               & WINDOW_MASK], 1, timerFreq);
+  stats->jitterNs = (changes > 0) ? meanNs(analyzer->sumChange, changes,
+                                           timerFreq) : 0;
+
+  return true;
+}
@@ -1,8 +1,10 @@
 /***************************************************************************//**
  * @file main_s1.c
- * @brief This project demonstrates edge capture with LDMA. The first 512 events
- * captured by TIMER0 CC0 are transferred to a fixed length buffer by the LDMA.
- * This project captures falling edges.
+ * @brief This project demonstrates edge capture with LDMA. Both edges of the
+ * signal are captured by TIMER0 CC0 and copied by the LDMA into a ring that
+ * it fills continuously. The CPU wakes up once per half of the ring to
+ * compute the frequency, duty cycle, jitter and shortest and longest period
+ * of the signal over the last cycles.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -42,16 +44,50 @@
 #include "em_gpio.h"
 #include "em_timer.h"
 #include "em_ldma.h"
+#include "ldma_ring.h"
+#include "edge_analyzer.h"
 
-// Timer prescale
-#define TIMER0_PRESCALE timerPrescale1;
+// Define to measure the analysis with the DWT cycle counter
+// #define ANALYZER_BENCHMARK
 
-// Buffer size
-#define BUFFER_SIZE 512
+// Timer prescale, the time between two edges must be less than the
+// counter range
+#define TIMER0_PRESCALE timerPrescale1
 
-// Buffer to hold edge capture values
-// Note: needs to be volatile or else the compiler will optimize it out
-static volatile uint32_t buffer[BUFFER_SIZE];
+// Captures in the ring, a power of two. The CPU is woken up once every
+// half of the ring, i.e. every RING_SIZE / 4 cycles of the signal.
+#define RING_SIZE 512
+
+// LDMA channel copying the captures
+#define CAPTURE_LDMA_CHANNEL 0
+
+// Ring of edge capture values, written by the LDMA
+static uint32_t ring[RING_SIZE];
+
+static LDMA_Descriptor_t ringDescriptors[2];
+static LdmaRing_t captureRing;
+static EdgeAnalyzer_t analyzer;
+
+// Captures dropped from the ring, as known to the analyzer
+static uint32_t dropped;
+
+// Frequency of the TIMER counter
+static uint32_t timerFreq;
+
+// Set by the TIMER0 interrupt on the first edge
+static volatile bool firstCapture;
+
+// Note: view the statistics in the Expressions window
+EdgeStats_t stats;
+
+#if defined(ANALYZER_BENCHMARK)
+// Captures of the benchmark, 128 cycles
+#define BENCHMARK_CAPTURES 256
+
+// Note: view the results in the Expressions window
+uint32_t benchmarkCycles;
+uint32_t benchmarkCapturesPerKcycle;
+#endif
 
 /**************************************************************************//**
  * @brief
@@ -75,9 +111,9 @@ void initTimer(void)
   // Enable clock for TIMER0 module
   CMU_ClockEnable(cmuClock_TIMER0, true);
 
-  // Configure TIMER0 Compare/Capture for input capture on falling edges
+  // Configure TIMER0 Compare/Capture for input capture on both edges
   TIMER_InitCC_TypeDef timerCCInit = TIMER_INITCC_DEFAULT;
-  timerCCInit.edge = timerEdgeFalling;
+  timerCCInit.edge = timerEdgeBoth;
   timerCCInit.mode = timerCCModeCapture;
   TIMER_InitCC(TIMER0, 0, &timerCCInit);
 
@@ -88,48 +124,153 @@ void initTimer(void)
 
   // Initialize timer
   TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
+  timerInit.prescale = TIMER0_PRESCALE;
   TIMER_Init(TIMER0, &timerInit);
+
+  // The prescaler divides by a power of two
+  timerFreq = CMU_ClockFreqGet(cmuClock_TIMER0) >> TIMER0_PRESCALE;
 }
 
 /**************************************************************************//**
-* @brief
-*    Initialize the LDMA module
-*
-* @details
-*    Configure the channel descriptor to use the default peripheral to
-*    memory transfer descriptor. Modify it to not generate an interrupt
-*    upon transfer completion (we don't need it). Additionally, the transfer
-*    configuration selects the TIMER0_CC0 signal as the trigger for the LDMA
-*    transaction to occur.
-*
-* @note
-*    The descriptor object needs to at least have static scope persistence so
-*    that the reference to the object is valid beyond its first use in
-*    initialization
-*****************************************************************************/
-void initLdma(void)
+ * @brief
+ *    Interrupt handler for TIMER0, the first edge has been captured
+ *****************************************************************************/
+void TIMER0_IRQHandler(void)
+{
+  TIMER_IntDisable(TIMER0, TIMER_IEN_CC0);
+  TIMER_IntClear(TIMER0, TIMER_IF_CC0);
+  firstCapture = true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start copying the captures into the ring
+ *
+ * @details
+ *    The polarity of the first edge is read from TIMER0 STATUS before the
+ *    LDMA is started, the capture stays in CCV until the LDMA copies it.
+ *    The edges alternate from then on. Captures are never lost by the
+ *    LDMA, only overwritten in the ring if they are not processed in time,
+ *    so the polarity of every capture follows from its number.
+ *****************************************************************************/
+void startCapture(void)
 {
-  // Channel descriptor configuration
-  static LDMA_Descriptor_t descriptor =
-    LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(&TIMER0->CC[0].CCV, // Peripheral source address
-                                    &buffer,            // Memory destination address
-                                    BUFFER_SIZE);       // Number of bytes per transfer
-  descriptor.xfer.size     = ldmaCtrlSizeWord; // Unit transfer size
-  descriptor.xfer.doneIfs  = 0;                // Don't trigger interrupt when done
-
-  // Transfer configuration and trigger selection
   LDMA_TransferCfg_t transferConfig =
     LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_TIMER0_CC0);
+  bool firstRising;
+
+  // Drop the captures made so far and wait in EM1 for the next edge
+  while (TIMER0->STATUS & TIMER_STATUS_ICV0)
+    (void) TIMER0->CC[0].CCV;
+  TIMER_IntClear(TIMER0, TIMER_IF_CC0 | TIMER_IF_ICBOF0);
+  firstCapture = false;
+  TIMER_IntEnable(TIMER0, TIMER_IEN_CC0);
+  NVIC_ClearPendingIRQ(TIMER0_IRQn);
+  NVIC_EnableIRQ(TIMER0_IRQn);
+  while (!firstCapture)
+    EMU_EnterEM1();
+
+  // CCPOL0 is set for a falling edge
+  firstRising = !(TIMER0->STATUS & TIMER_STATUS_CCPOL0);
+
+  edgeAnalyzerInit(&analyzer, TIMER_TopGet(TIMER0), firstRising);
+  // Two halves, one descriptor each
+  ldmaRingInit(&captureRing, CAPTURE_LDMA_CHANNEL, ringDescriptors, ring, 2,
+               RING_SIZE / 2, ldmaCtrlSizeWord, &TIMER0->CC[0].CCV);
+  ldmaRingStart(&captureRing, &transferConfig);
+  dropped = 0;
+}
 
-  // LDMA initialization
+/**************************************************************************//**
+ * @brief
+ *    Initialize the LDMA module
+ *****************************************************************************/
+void initLdma(void)
+{
+  // LDMA initialization, also enables the LDMA interrupt
   LDMA_Init_t init = LDMA_INIT_DEFAULT;
   LDMA_Init(&init);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    The LDMA interrupt tracks the halves of the ring filled
+ *****************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGet();
 
-  // Start the transfer
-  uint32_t channelNum = 0;
-  LDMA_StartTransfer(channelNum, &transferConfig, &descriptor);
+  LDMA_IntClear(pending);
+  ldmaRingIrqHandler(&captureRing, pending);
 }
 
+/**************************************************************************//**
+ * @brief
+ *    Analyze the captures in the ring and update the statistics
+ *****************************************************************************/
+void analyzeCaptures(void)
+{
+  const void *captures;
+  uint32_t count;
+
+  while (1) {
+    count = ldmaRingSpan(&captureRing, &captures);
+
+    // Captures overwritten before they could be processed
+    if (captureRing.dropped != dropped) {
+      edgeAnalyzerSkip(&analyzer, captureRing.dropped - dropped);
+      dropped = captureRing.dropped;
+    }
+
+    if (count == 0)
+      break;
+
+    edgeAnalyzerProcess(&analyzer, captures, count);
+    ldmaRingConsume(&captureRing, count);
+  }
+
+  edgeAnalyzerStats(&analyzer, timerFreq, &stats);
+}
+
+#if defined(ANALYZER_BENCHMARK)
+/**************************************************************************//**
+ * @brief
+ *    Time the analysis of a block of captures with the DWT cycle counter
+ *
+ * @details
+ *    The captures are those of a 20 kHz signal with a duty cycle of 30 %
+ *    and a period that alternates between two values two ticks apart,
+ *    captured by a 16-bit counter that wraps many times over the block.
+ *****************************************************************************/
+void benchmarkAnalyzer(void)
+{
+  static uint32_t captures[BENCHMARK_CAPTURES];
+  EdgeAnalyzer_t benchmark;
+  uint32_t period = timerFreq / 20000;
+  uint32_t time = 0;
+  uint32_t start;
+  uint32_t i;
+
+  for (i = 0; i < BENCHMARK_CAPTURES; i += 2) {
+    captures[i] = time & 0xFFFF;
+    time += (period * 3) / 10;
+    captures[i + 1] = time & 0xFFFF;
+    time += period - (period * 3) / 10 + (i & 2);
+  }
+
+  // Enable the cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  edgeAnalyzerInit(&benchmark, 0xFFFF, true);
+  start = DWT->CYCCNT;
+  edgeAnalyzerProcess(&benchmark, captures, BENCHMARK_CAPTURES);
+  benchmarkCycles = DWT->CYCCNT - start;
+  benchmarkCapturesPerKcycle = (BENCHMARK_CAPTURES * 1000) / benchmarkCycles;
+}
+#endif
+
 /**************************************************************************//**
  * @brief
  *    Main function
@@ -148,8 +289,14 @@ int main(void)
   initLdma();
   initTimer();
 
+#if defined(ANALYZER_BENCHMARK)
+  benchmarkAnalyzer();
+#endif
+
+  startCapture();
+
   while (1) {
-    EMU_EnterEM1(); // Enter EM1 mode (won't exit)
+    EMU_EnterEM1(); // Enter EM1 mode (woken up once per half of the ring)
+    analyzeCaptures();
   }
 }
-
@@ -0,0 +1,372 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Host test and benchmark of the edge analyzer of timer_dma_edge_capture.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#include "edge_analyzer.h"
+
+// Cycles generated by each test
+#define TEST_CYCLES       20000
+
+// Longest block of captures given to edgeAnalyzerProcess()
+#define MAX_BLOCK         300
+
+// Captures analyzed by the benchmark, in blocks of BENCH_BLOCK
+#define BENCH_CAPTURES    (64 * 1024 * 1024)
+#define BENCH_BLOCK       256
+
+typedef struct {
+  const char *name;
+  uint32_t top;               // Counter TOP
+  uint32_t timerFreq;         // Counter frequency in Hz
+  double frequency;           // Signal frequency in Hz
+  double duty;                // Duty cycle, 0 to 1
+  uint32_t jitter;            // Random change of each half period, ticks
+  bool firstRising;           // Polarity of the first capture
+  double step;                // Frequency factor from the middle on
+  uint32_t skipEvery;         // Drop captures every skipEvery cycles, or 0
+} Test_t;
+
+static const Test_t tests[] = {
+  { "20 kHz, 16-bit",            0xFFFF, 19000000, 20000.0, 0.30, 0, true, 1.0, 0 },
+  { "20 kHz, jitter",            0xFFFF, 19000000, 20000.0, 0.30, 5, true, 1.0, 0 },
+  { "50 kHz, falling first",     0xFFFF, 19000000, 50000.0, 0.75, 3, false, 1.0, 0 },
+  { "300 Hz, wraps every edge",  0xFFFF, 19000000, 300.0, 0.50, 40, true, 1.0, 0 },
+  { "7 kHz, TOP 49999",          49999, 38400000, 7000.0, 0.10, 9, true, 1.0, 0 },
+  { "1 Hz, 32-bit",              0xFFFFFFFF, 38400000, 1.0, 0.42, 1000, false, 1.0, 0 },
+  { "10 kHz, steps to 30 kHz",   0xFFFF, 19000000, 10000.0, 0.60, 2, true, 3.0, 0 },
+  { "40 kHz, lost captures",     0xFFFF, 19000000, 40000.0, 0.25, 4, true, 1.0, 997 },
+};
+
+// Generated cycles and the captures of their edges
+static uint32_t periods[TEST_CYCLES];
+static uint32_t highs[TEST_CYCLES];
+static uint32_t captures[2 * TEST_CYCLES + 2];
+
+static uint32_t benchCaptures[BENCH_BLOCK * 64];
+
+static uint32_t rngState = 0x2545F491;
+
+static uint32_t rng(void)
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Random change of up to +/- jitter ticks
+ ******************************************************************************/
+static int32_t randomJitter(uint32_t jitter)
+{
+  if (jitter == 0)
+    return 0;
+  return (int32_t)(rng() % (2 * jitter + 1)) - (int32_t)jitter;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Convert n periods in ticks to the mean in ns, rounded down
+ ******************************************************************************/
+static double refNs(double ticks, uint32_t timerFreq)
+{
+  return ticks * 1e9 / timerFreq;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Compare the statistics with those of the last cycles, computed from the
+ *    generated cycles by brute force
+ *
+ * @param[in] last
+ *    Number of cycles completed, the window ends with cycle last - 1
+ *
+ * @param[in] first
+ *    First cycle that counts, the analyzer dropped those before
+ ******************************************************************************/
+static bool checkStats(const Test_t *test, const EdgeAnalyzer_t *analyzer,
+                       uint32_t last, uint32_t first, bool verbose)
+{
+  EdgeStats_t stats;
+  uint32_t n = last - first;
+  uint32_t changes;
+  uint32_t i;
+  double sumPeriod = 0, sumHigh = 0, sumChange = 0;
+  uint32_t minPeriod = UINT32_MAX, maxPeriod = 0;
+  double frequency, duty, jitter;
+  bool ok;
+
+  if (!edgeAnalyzerStats(analyzer, test->timerFreq, &stats)) {
+    printf("  no statistics after %u cycles\n", n);
+    return n == 0;
+  }
+
+  if (n > EDGE_ANALYZER_WINDOW)
+    n = EDGE_ANALYZER_WINDOW;
+  changes = (last - first > EDGE_ANALYZER_WINDOW) ? n : n - 1;
+
+  for (i = last - n; i < last; i++) {
+    sumPeriod += periods[i];
+    sumHigh += highs[i];
+    if (periods[i] < minPeriod)
+      minPeriod = periods[i];
+    if (periods[i] > maxPeriod)
+      maxPeriod = periods[i];
+    if (i > first && i + changes >= last)
+      sumChange += abs((int32_t)periods[i] - (int32_t)periods[i - 1]);
+  }
+
+  frequency = (double)test->timerFreq * 1000.0 * n / sumPeriod;
+  duty = sumHigh * 10000.0 / sumPeriod;
+  jitter = changes ? refNs(sumChange / changes, test->timerFreq) : 0;
+
+  ok = stats.cycles == n
+       && stats.frequencyMilliHz + 1 >= frequency
+       && stats.frequencyMilliHz <= frequency
+       && stats.dutyPermyriad + 1 >= duty && stats.dutyPermyriad <= duty
+       && stats.periodMinNs + 1 >= refNs(minPeriod, test->timerFreq)
+       && stats.periodMinNs <= refNs(minPeriod, test->timerFreq)
+       && stats.periodMaxNs + 1 >= refNs(maxPeriod, test->timerFreq)
+       && stats.periodMaxNs <= refNs(maxPeriod, test->timerFreq)
+       && stats.jitterNs + 1 >= jitter && stats.jitterNs <= jitter + 1e-6;
+
+  if (verbose || !ok) {
+    printf("  %-8s cycles %u, %u.%03u Hz, duty %u.%02u %%, "
+           "period %u..%u ns, jitter %u ns\n",
+           ok ? "" : "FAILED", stats.cycles,
+           stats.frequencyMilliHz / 1000, stats.frequencyMilliHz % 1000,
+           stats.dutyPermyriad / 100, stats.dutyPermyriad % 100,
+           stats.periodMinNs, stats.periodMaxNs, stats.jitterNs);
+  }
+  if (!ok) {
+    printf("  expected cycles %u, %.3f mHz, duty %.2f, period %.1f..%.1f ns, "
+           "jitter %.1f ns\n", n, frequency, duty / 100,
+           refNs(minPeriod, test->timerFreq), refNs(maxPeriod, test->timerFreq),
+           jitter);
+  }
+
+  return ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Generate the cycles of a test and the captures of their edges
+ *
+ * @return
+ *    Number of captures. When the first capture is falling, it is that of
+ *    the middle of a cycle before cycle 0.
+ ******************************************************************************/
+static uint32_t generate(const Test_t *test)
+{
+  uint64_t time = rng();
+  double frequency = test->frequency;
+  uint32_t count = 0;
+  uint32_t i;
+
+  if (!test->firstRising) {
+    captures[count++] = (uint32_t)(time % ((uint64_t)test->top + 1));
+    time += (uint64_t)(test->timerFreq / frequency * (1.0 - test->duty));
+  }
+
+  for (i = 0; i < TEST_CYCLES; i++) {
+    double nominal;
+    int32_t high, low;
+
+    if (i == TEST_CYCLES / 2)
+      frequency *= test->step;
+    nominal = test->timerFreq / frequency;
+    high = (int32_t)(nominal * test->duty) + randomJitter(test->jitter);
+    low = (int32_t)nominal - (int32_t)(nominal * test->duty)
+          + randomJitter(test->jitter);
+    if (high < 1)
+      high = 1;
+    if (low < 1)
+      low = 1;
+
+    periods[i] = (uint32_t)(high + low);
+    highs[i] = (uint32_t)high;
+
+    captures[count++] = (uint32_t)(time % ((uint64_t)test->top + 1));
+    time += (uint32_t)high;
+    captures[count++] = (uint32_t)(time % ((uint64_t)test->top + 1));
+    time += (uint32_t)low;
+  }
+
+  // Rising edge that completes the last cycle
+  captures[count++] = (uint32_t)(time % ((uint64_t)test->top + 1));
+
+  return count;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Feed the captures of a test in random blocks and check the statistics
+ *    against the generated cycles after every block
+ ******************************************************************************/
+static bool runTest(const Test_t *test)
+{
+  static EdgeAnalyzer_t analyzer;
+  uint32_t count = generate(test);
+  uint32_t offset = test->firstRising ? 0 : 1;
+  uint32_t first = 0;
+  uint32_t pos = 0;
+  uint32_t checks = 0;
+  uint32_t skipped = 0;
+  bool ok = true;
+
+  printf("%s\n", test->name);
+  edgeAnalyzerInit(&analyzer, test->top, test->firstRising);
+
+  while (pos < count && ok) {
+    uint32_t block = 1 + rng() % MAX_BLOCK;
+    uint32_t done;
+
+    if (block > count - pos)
+      block = count - pos;
+
+    // Lose a few captures now and then, as if the ring had overrun
+    if (test->skipEvery && pos > 0
+        && (pos - offset) / 2 / test->skipEvery
+           != (pos - offset + block) / 2 / test->skipEvery) {
+      uint32_t skip = 1 + rng() % 7;
+
+      if (skip > count - pos - 1)
+        skip = 0;
+      edgeAnalyzerSkip(&analyzer, skip);
+      pos += skip;
+      skipped += skip;
+
+      // The first cycle measured again is the one that starts with the
+      // first rising edge after the gap
+      first = (pos - offset + 1) / 2;
+      if (block > count - pos)
+        block = count - pos;
+    }
+
+    edgeAnalyzerProcess(&analyzer, &captures[pos], block);
+    pos += block;
+
+    // Cycle i is completed by capture offset + 2 * i + 2
+    done = (pos > offset + 1) ? (pos - offset - 1) / 2 : 0;
+    // Until the window holds no cycle from before a gap
+    if (first == 0 || done - first > EDGE_ANALYZER_WINDOW) {
+      // The statistics are printed after the last block
+      ok = checkStats(test, &analyzer, done, first, pos == count);
+      checks++;
+    }
+  }
+
+  printf("  %u checks, %u captures skipped\n", checks, skipped);
+
+  return ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Time the analysis of blocks of BENCH_BLOCK captures
+ ******************************************************************************/
+static void benchmark(void)
+{
+  static EdgeAnalyzer_t analyzer;
+  uint32_t frames = sizeof(benchCaptures) / sizeof(benchCaptures[0]);
+  uint32_t time = 0;
+  uint32_t period = 950;
+  uint32_t i;
+  struct timespec start, end;
+  double seconds;
+  EdgeStats_t stats;
+#if defined(__x86_64__)
+  uint64_t tsc;
+#endif
+
+  // 20 kHz at 19 MHz, 30 % duty, alternating between two periods
+  for (i = 0; i < frames; i += 2) {
+    benchCaptures[i] = time & 0xFFFF;
+    time += (period * 3) / 10;
+    benchCaptures[i + 1] = time & 0xFFFF;
+    time += period - (period * 3) / 10 + (i & 2);
+  }
+
+  edgeAnalyzerInit(&analyzer, 0xFFFF, true);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+#if defined(__x86_64__)
+  tsc = __rdtsc();
+#endif
+  for (i = 0; i < BENCH_CAPTURES; i += BENCH_BLOCK) {
+    // One cycle is off where the buffer starts over, which costs the same
+    edgeAnalyzerProcess(&analyzer, &benchCaptures[i % frames], BENCH_BLOCK);
+  }
+#if defined(__x86_64__)
+  tsc = __rdtsc() - tsc;
+#endif
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+  edgeAnalyzerStats(&analyzer, 19000000, &stats);
+  printf("Benchmark: %u captures in blocks of %u, %.1f Mcaptures/s, "
+         "%.2f ns per capture\n", BENCH_CAPTURES, BENCH_BLOCK,
+         BENCH_CAPTURES / seconds / 1e6, seconds * 1e9 / BENCH_CAPTURES);
+#if defined(__x86_64__)
+  printf("Benchmark: %.2f TSC cycles per capture, %.3f captures per cycle\n",
+         (double)tsc / BENCH_CAPTURES, (double)BENCH_CAPTURES / tsc);
+#endif
+  printf("Benchmark: %u.%03u Hz, duty %u.%02u %%\n",
+         stats.frequencyMilliHz / 1000, stats.frequencyMilliHz % 1000,
+         stats.dutyPermyriad / 100, stats.dutyPermyriad % 100);
+}
+
+int main(void)
+{
+  bool passed = true;
+  uint32_t i;
+
+  for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    if (!runTest(&tests[i]))
+      passed = false;
+  }
+
+  benchmark();
+
+  printf("%s\n", passed ? "PASSED" : "FAILED");
+  return passed ? 0 : 1;
+}
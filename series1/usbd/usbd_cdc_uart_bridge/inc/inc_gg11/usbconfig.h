@@ -111,12 +111,21 @@ extern "C" {
 #define CDC_TX_DMA_SIGNAL           DMAREQ_USART0_TXBL
 #define CDC_RX_DMA_SIGNAL           DMAREQ_USART0_RXDATAV
 
+// Buffer queue configuration options
+// The host is only NAKed when all USB receive buffers wait for the UART, and
+// the UART Rx DMA is only stopped when all UART receive buffers wait for USB
+// Needed for src/cdc_gg11.c
+#define CDC_USB_RX_QUEUE_DEPTH      4   // Number of USB receive buffers
+#define CDC_UART_RX_QUEUE_DEPTH     4   // Number of UART receive buffers
+
 // USART configuration options
 // Needed for Drivers/cdc.c
 #define CDC_UART                    USART0
 #define CDC_UART_CLOCK              cmuClock_USART0
 #define CDC_UART_ROUTEPEN           (USART_ROUTEPEN_RXPEN | USART_ROUTEPEN_TXPEN)
 #define CDC_UART_ROUTELOC0          (UART_ROUTELOC0_RXLOC_LOC0 | UART_ROUTELOC0_TXLOC_LOC0)
+#define CDC_UART_RX_IRQn            USART0_RX_IRQn        // Rx line idle interrupt
+#define CDC_UART_RX_IRQHandler      USART0_RX_IRQHandler
 #define CDC_UART_TX_PORT            gpioPortE
 #define CDC_UART_TX_PIN             10
 #define CDC_UART_RX_PORT            gpioPortE
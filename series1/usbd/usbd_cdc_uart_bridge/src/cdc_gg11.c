@@ -118,9 +118,40 @@
 #define CDC_USB_RX_BUF_SIZ  CDC_BULK_EP_SIZE // Packet size when receiving on USB.
 #define CDC_USB_TX_BUF_SIZ  127    // Packet size when transmitting on USB.
 
-// Calculate a timeout in ms corresponding to 5 char times on current
-// baudrate. Minimum timeout is set to 10 ms.
-#define CDC_RX_TIMEOUT    SL_MAX(10U, 50000 / (cdcLineCoding.dwDTERate))
+// Number of buffers queued in each direction, see usbconfig.h.
+#if !defined(CDC_USB_RX_QUEUE_DEPTH)
+#define CDC_USB_RX_QUEUE_DEPTH    4
+#endif
+#if !defined(CDC_UART_RX_QUEUE_DEPTH)
+#define CDC_UART_RX_QUEUE_DEPTH   4
+#endif
+#if (CDC_USB_RX_QUEUE_DEPTH < 2) || (CDC_UART_RX_QUEUE_DEPTH < 2)
+#error "The CDC buffer queues must be at least 2 buffers deep"
+#endif
+
+// A partial UART receive buffer is sent on USB once the UART Rx line has
+// been idle for uartRxIdleBits bit times. The idle time adapts between the
+// limits below to the length of the recent buffers: each short buffer
+// (interactive use) halves it down to 2 characters, while a long average
+// (bulk transfers) doubles it each time so that short gaps in the stream
+// don't split it into small USB packets.
+#define CDC_RX_IDLE_MIN_BITS        20     // 2 characters.
+#define CDC_RX_IDLE_MAX_BITS        255    // Largest USART TIMECMP0 value.
+#define CDC_RX_INTERACTIVE_LENGTH   8      // Length of short buffers.
+#define CDC_RX_BULK_LENGTH          (CDC_BULK_EP_SIZE / 2) // Average of long ones.
+
+// The USART detects the idle line when it has the TIMECMP0 comparator,
+// otherwise UartRxTimeout() does.
+#if defined(USART_TIMECMP0_TSTART_RXEOF)
+#define CDC_RX_IDLE_DETECT          1
+#else
+#define CDC_RX_IDLE_DETECT          0
+#endif
+
+// Calculate a timeout in ms corresponding to the idle time on current
+// baudrate. Minimum timeout is set to 1 ms, the USBTIMER resolution.
+#define CDC_RX_TIMEOUT    SL_MAX(1U, (uartRxIdleBits * 1000)            \
+                                     / (cdcLineCoding.dwDTERate))
 
 // The serial port LINE CODING data structure, used to carry information
 // about serial port baudrate, parity etc. between host and device.
@@ -144,6 +175,14 @@ static int  LineCodingReceived(USB_Status_TypeDef status,
                                uint32_t remaining);
 static void SerialPortInit(void);
 static void UartRxTimeout(void);
+static int  UsbDataTransmitted(USB_Status_TypeDef status, uint32_t xferred,
+                               uint32_t remaining);
+static void UsbRxStart(void);
+static void UartTxStart(void);
+static void UartRxStart(void);
+static void UsbTxStart(void);
+static void UartRxFlush(void);
+static void UartRxAdapt(int length);
 
 static LDMA_Descriptor_t descriptorRx;
 static LDMA_Descriptor_t descriptorTx;
@@ -164,16 +203,29 @@ static cdcLineCoding_TypeDef SL_ATTRIBUTE_ALIGN(4) cdcLineCoding =
 };
 SL_PACK_END()
 
-STATIC_UBUF(usbRxBuffer0, CDC_USB_RX_BUF_SIZ);    // USB receive buffers.
-STATIC_UBUF(usbRxBuffer1, CDC_USB_RX_BUF_SIZ);
-STATIC_UBUF(uartRxBuffer0, CDC_USB_TX_BUF_SIZ);   // UART receive buffers.
-STATIC_UBUF(uartRxBuffer1, CDC_USB_TX_BUF_SIZ);
-
-static const uint8_t  *usbRxBuffer[2] = { usbRxBuffer0, usbRxBuffer1 };
-static const uint8_t  *uartRxBuffer[2] = { uartRxBuffer0, uartRxBuffer1 };
-
-static int            usbRxIndex, usbBytesReceived;
-static int            uartRxIndex, uartRxCount;
+/*
+ * Each direction has a queue of buffers. USB receives into the buffer at
+ * the head of the USB queue while the UART Tx DMA sends the buffer at its
+ * tail, and the UART Rx DMA fills the head of the UART queue while USB
+ * sends its tail. A new transfer is started into the next free buffer as
+ * soon as one completes, so the USB OUT endpoint is only NAKed (no USB
+ * receive transfer active) while all CDC_USB_RX_QUEUE_DEPTH buffers wait
+ * for the UART.
+ */
+SL_ALIGN(4)                                           // USB receive buffers.
+static uint8_t usbRxBuffer[CDC_USB_RX_QUEUE_DEPTH][CDC_USB_RX_BUF_SIZ]
+  SL_ATTRIBUTE_ALIGN(4);
+SL_ALIGN(4)                                           // UART receive buffers.
+static uint8_t uartRxBuffer[CDC_UART_RX_QUEUE_DEPTH][(CDC_USB_TX_BUF_SIZ + 3) & ~3]
+  SL_ATTRIBUTE_ALIGN(4);
+
+static int            usbRxLength[CDC_USB_RX_QUEUE_DEPTH];
+static int            usbRxHead, usbRxTail, usbRxQueued;
+static int            uartRxLength[CDC_UART_RX_QUEUE_DEPTH];
+static int            uartRxHead, uartRxTail, uartRxQueued;
+static int            uartRxCount;
+static uint32_t       uartRxIdleBits;
+static int            uartRxAverage;   // Average buffer length, times 4.
 static int            LastUsbTxCnt;
 
 static bool           dmaRxCompleted;
@@ -273,22 +325,24 @@ void CDC_StateChangeEvent(USBD_State_TypeDef oldState,
     }
 
     // Start receiving data from USB host.
-    usbRxIndex  = 0;
+    usbRxHead   = 0;
+    usbRxTail   = 0;
+    usbRxQueued = 0;
     usbRxActive = true;
     dmaTxActive = false;
-    USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer[usbRxIndex],
-              CDC_USB_RX_BUF_SIZ, UsbDataReceived);
+    UsbRxStart();
 
     // Start receiving data on UART.
-    uartRxIndex    = 0;
-    LastUsbTxCnt   = 0;
-    uartRxCount    = 0;
-    dmaRxActive    = true;
-    usbTxActive    = false;
-    dmaRxCompleted = true;
-    LDMA_StartTransfer(CDC_UART_RX_DMA_CHANNEL, &transferConfigRx, &descriptorRx);
-
-    USBTIMER_Start(CDC_TIMER_ID, CDC_RX_TIMEOUT, UartRxTimeout);
+    uartRxIdleBits = CDC_RX_IDLE_MIN_BITS;
+    uartRxAverage  = 0;
+    UartRxAdapt(0);
+    uartRxHead   = 0;
+    uartRxTail   = 0;
+    uartRxQueued = 0;
+    LastUsbTxCnt = 0;
+    dmaRxActive  = true;
+    usbTxActive  = false;
+    UartRxStart();
   } else if ((oldState == USBD_STATE_CONFIGURED)
              && (newState != USBD_STATE_SUSPENDED)) {
     // We have been de-configured, stop CDC functionality.
@@ -306,6 +360,51 @@ void CDC_StateChangeEvent(USBD_State_TypeDef oldState,
 
 /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
 
+/**************************************************************************//**
+ * @brief Start a USB receive transfer into the buffer at the head of the USB
+ *        queue.
+ *****************************************************************************/
+static void UsbRxStart(void)
+{
+  USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer[usbRxHead],
+            CDC_USB_RX_BUF_SIZ, UsbDataReceived);
+}
+
+/**************************************************************************//**
+ * @brief Start a UART transmit DMA from the buffer at the tail of the USB
+ *        queue.
+ *****************************************************************************/
+static void UartTxStart(void)
+{
+  descriptorTx.xfer.xferCnt = usbRxLength[usbRxTail] - 1;
+  descriptorTx.xfer.srcAddr = (uint32_t) usbRxBuffer[usbRxTail];
+  LDMA_StartTransfer(CDC_UART_TX_DMA_CHANNEL, &transferConfigTx, &descriptorTx);
+}
+
+/**************************************************************************//**
+ * @brief Start a UART receive DMA into the buffer at the head of the UART
+ *        queue, and the timer monitoring it.
+ *****************************************************************************/
+static void UartRxStart(void)
+{
+  dmaRxCompleted = true;
+  descriptorRx.xfer.dstAddr = (uint32_t) uartRxBuffer[uartRxHead];
+  LDMA_StartTransfer(CDC_UART_RX_DMA_CHANNEL, &transferConfigRx, &descriptorRx);
+  uartRxCount = 0;
+  USBTIMER_Start(CDC_TIMER_ID, CDC_RX_TIMEOUT, UartRxTimeout);
+}
+
+/**************************************************************************//**
+ * @brief Start a USB transmit transfer from the buffer at the tail of the
+ *        UART queue.
+ *****************************************************************************/
+static void UsbTxStart(void)
+{
+  USBD_Write(CDC_EP_DATA_IN, (void*) uartRxBuffer[uartRxTail],
+             uartRxLength[uartRxTail], UsbDataTransmitted);
+  LastUsbTxCnt = uartRxLength[uartRxTail];
+}
+
 /**************************************************************************//**
  * @brief Callback function called whenever a new packet with data is received
  *        on USB.
@@ -320,36 +419,43 @@ static int UsbDataReceived(USB_Status_TypeDef status,
                            uint32_t xferred,
                            uint32_t remaining)
 {
+  CORE_DECLARE_IRQ_STATE;
   (void) remaining;            // Unused parameter.
 
-  if ((status == USB_STATUS_OK) && (xferred > 0)) {
-    usbRxIndex ^= 1;
+  if (status != USB_STATUS_OK) {
+    return USB_STATUS_OK;
+  }
+
+  CORE_ENTER_ATOMIC();
+
+  if (xferred > 0) {
+    // Queue the packet for the UART.
+    usbRxLength[usbRxHead] = xferred;
+    usbRxHead = (usbRxHead + 1) % CDC_USB_RX_QUEUE_DEPTH;
+    usbRxQueued++;
 
     if (!dmaTxActive) {
       // dmaTxActive = false means that a new UART Tx DMA can be started.
       dmaTxActive = true;
-      descriptorTx.xfer.xferCnt = xferred - 1;
-      descriptorTx.xfer.srcAddr = (uint32_t) usbRxBuffer[usbRxIndex ^ 1];
-      LDMA_StartTransfer(CDC_UART_TX_DMA_CHANNEL, &transferConfigTx, &descriptorTx);
-
-      // Start a new USB receive transfer.
-      USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer[usbRxIndex],
-                CDC_USB_RX_BUF_SIZ, UsbDataReceived);
-    } else {
-      // The UART transmit DMA callback function will start a new DMA.
-      usbRxActive      = false;
-      usbBytesReceived = xferred;
+      UartTxStart();
     }
   }
+
+  if (usbRxQueued < CDC_USB_RX_QUEUE_DEPTH) {
+    // Start a new USB receive transfer into the next free buffer.
+    UsbRxStart();
+  } else {
+    // All buffers are full, the host is NAKed until the UART Tx DMA
+    // callback function frees one and starts a new USB receive transfer.
+    usbRxActive = false;
+  }
+
+  CORE_EXIT_ATOMIC();
   return USB_STATUS_OK;
 }
 
 /**************************************************************************//**
  * @brief Callback function called whenever a UART transmit DMA has completed.
- *
- * @param[in] channel DMA channel number.
- * @param[in] primary True if this is the primary DMA channel.
- * @param[in] user    Optional user supplied parameter.
  *****************************************************************************/
 static void DmaTxComplete(void)
 {
@@ -361,22 +467,25 @@ static void DmaTxComplete(void)
    */
   CORE_ENTER_ATOMIC();
 
-  if (!usbRxActive) {
-    // usbRxActive = false means that an USB receive packet has been received
-
-    descriptorTx.xfer.xferCnt = usbBytesReceived - 1;
-    descriptorTx.xfer.srcAddr = (uint32_t) usbRxBuffer[usbRxIndex ^ 1];
-    LDMA_StartTransfer(CDC_UART_TX_DMA_CHANNEL, &transferConfigTx, &descriptorTx);
+  // The buffer at the tail has been sent, free it.
+  usbRxTail = (usbRxTail + 1) % CDC_USB_RX_QUEUE_DEPTH;
+  usbRxQueued--;
 
-    // Start a new USB receive transfer.
-    usbRxActive = true;
-    USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer[usbRxIndex],
-              CDC_USB_RX_BUF_SIZ, UsbDataReceived);
+  if (usbRxQueued > 0) {
+    // Send the next queued packet.
+    UartTxStart();
   } else {
     // The USB receive complete callback function will start a new DMA.
     dmaTxActive = false;
   }
 
+  if (!usbRxActive) {
+    // usbRxActive = false means that the queue was full, receive from USB
+    // into the buffer just freed.
+    usbRxActive = true;
+    UsbRxStart();
+  }
+
   CORE_EXIT_ATOMIC();
 }
 
@@ -394,36 +503,42 @@ static int UsbDataTransmitted(USB_Status_TypeDef status,
                               uint32_t xferred,
                               uint32_t remaining)
 {
+  CORE_DECLARE_IRQ_STATE;
   (void) xferred;              // Unused parameter.
   (void) remaining;            // Unused parameter.
 
-  if (status == USB_STATUS_OK) {
-    if (!dmaRxActive) {
-      // dmaRxActive = false means that a new UART Rx DMA can be started.
+  if (status != USB_STATUS_OK) {
+    return USB_STATUS_OK;
+  }
 
-      USBD_Write(CDC_EP_DATA_IN, (void*) uartRxBuffer[uartRxIndex ^ 1],
-                 uartRxCount, UsbDataTransmitted);
-      LastUsbTxCnt = uartRxCount;
+  CORE_ENTER_ATOMIC();
 
-      dmaRxActive    = true;
-      dmaRxCompleted = true;
-      LDMA_StartTransfer(CDC_UART_RX_DMA_CHANNEL, &transferConfigRx, &descriptorRx);
-      uartRxCount = 0;
-      USBTIMER_Start(CDC_TIMER_ID, CDC_RX_TIMEOUT, UartRxTimeout);
-    } else {
-      // The UART receive DMA callback function will start a new DMA.
-      usbTxActive = false;
-    }
+  // The buffer at the tail has been sent, free it.
+  uartRxTail = (uartRxTail + 1) % CDC_UART_RX_QUEUE_DEPTH;
+  uartRxQueued--;
+
+  if (uartRxQueued > 0) {
+    // Send the next queued buffer.
+    UsbTxStart();
+  } else {
+    // The UART receive DMA callback function will start a new transfer.
+    usbTxActive = false;
+  }
+
+  if (!dmaRxActive) {
+    // dmaRxActive = false means that the queue was full, receive from the
+    // UART into the buffer just freed.
+    dmaRxActive = true;
+    UartRxStart();
   }
+
+  CORE_EXIT_ATOMIC();
   return USB_STATUS_OK;
 }
 
 /**************************************************************************//**
- * @brief Callback function called whenever a UART receive DMA has completed.
- *
- * @param[in] channel DMA channel number.
- * @param[in] primary True if this is the primary DMA channel.
- * @param[in] user    Optional user supplied parameter.
+ * @brief Callback function called whenever a UART receive DMA has completed,
+ *        or has been stopped by UartRxTimeout().
  *****************************************************************************/
 static void DmaRxComplete(void)
 {
@@ -435,28 +550,26 @@ static void DmaRxComplete(void)
    */
   CORE_ENTER_ATOMIC();
 
-  uartRxIndex ^= 1;
-
+  // Queue the received bytes for USB.
   if (dmaRxCompleted) {
-    uartRxCount = CDC_USB_TX_BUF_SIZ;
+    uartRxLength[uartRxHead] = CDC_USB_TX_BUF_SIZ;
   } else {
     uint32_t numRemaining = LDMA_TransferRemainingCount(CDC_UART_RX_DMA_CHANNEL);
-    uartRxCount = CDC_USB_TX_BUF_SIZ - numRemaining;
+    uartRxLength[uartRxHead] = CDC_USB_TX_BUF_SIZ - numRemaining;
   }
+  UartRxAdapt(uartRxLength[uartRxHead]);
+  uartRxHead = (uartRxHead + 1) % CDC_UART_RX_QUEUE_DEPTH;
+  uartRxQueued++;
 
   if (!usbTxActive) {
     // usbTxActive = false means that a new USB packet can be transferred.
     usbTxActive = true;
-    USBD_Write(CDC_EP_DATA_IN, (void*) uartRxBuffer[uartRxIndex ^ 1],
-               uartRxCount, UsbDataTransmitted);
-    LastUsbTxCnt = uartRxCount;
-
-    // Start a new UART receive DMA.
-    dmaRxCompleted = true;
-    descriptorRx.xfer.dstAddr = (uint32_t) uartRxBuffer[uartRxIndex];
-    LDMA_StartTransfer(CDC_UART_RX_DMA_CHANNEL, &transferConfigRx, &descriptorRx);
-    uartRxCount = 0;
-    USBTIMER_Start(CDC_TIMER_ID, CDC_RX_TIMEOUT, UartRxTimeout);
+    UsbTxStart();
+  }
+
+  if (uartRxQueued < CDC_UART_RX_QUEUE_DEPTH) {
+    // Start a new UART receive DMA into the next free buffer.
+    UartRxStart();
   } else {
     // The USB transmit complete callback function will start a new DMA.
     dmaRxActive = false;
@@ -466,6 +579,52 @@ static void DmaRxComplete(void)
   CORE_EXIT_ATOMIC();
 }
 
+/**************************************************************************//**
+ * @brief Stop the UART receive DMA and send the bytes received so far on USB.
+ *****************************************************************************/
+static void UartRxFlush(void)
+{
+  // Stop Rx DMA channel.
+  LDMA_StopTransfer(CDC_UART_RX_DMA_CHANNEL);
+  // The transfer may have completed just before it was stopped, the
+  // completion callback is called below instead of by LDMA_IRQHandler().
+  LDMA_IntClear(0x01 << CDC_UART_RX_DMA_CHANNEL);
+  dmaRxCompleted = false;
+  // Call DMA completion callback.
+  DmaRxComplete();
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Adapt the UART Rx idle time to the length of the last receive buffer.
+ *
+ * @param[in] length Number of bytes in the buffer, 0 to only program the
+ *                   current idle time.
+ *****************************************************************************/
+static void UartRxAdapt(int length)
+{
+  if (length > 0) {
+    // Running average over the last few buffers.
+    uartRxAverage += length - uartRxAverage / 4;
+
+    if (length <= CDC_RX_INTERACTIVE_LENGTH) {
+      // Interactive use, send each keystroke as soon as possible.
+      uartRxIdleBits = SL_MAX(uartRxIdleBits / 2, CDC_RX_IDLE_MIN_BITS);
+    } else if (uartRxAverage >= 4 * CDC_RX_BULK_LENGTH) {
+      // Sustained load, batch more bytes per USB packet.
+      uartRxIdleBits = SL_MIN(2 * uartRxIdleBits, CDC_RX_IDLE_MAX_BITS);
+    }
+  }
+
+#if CDC_RX_IDLE_DETECT
+  // Compare match when the Rx line has been idle for uartRxIdleBits after
+  // the end of a frame, a new start bit stops the comparator.
+  CDC_UART->TIMECMP0 = USART_TIMECMP0_TSTART_RXEOF
+                       | USART_TIMECMP0_TSTOP_RXACT
+                       | (uartRxIdleBits << _USART_TIMECMP0_TCMPVAL_SHIFT);
+#endif
+}
+
 /**************************************************************************//**
  * @brief
  *   Called each time UART Rx timeout period elapses.
@@ -483,24 +642,17 @@ static void UartRxTimeout(void)
      * No activity on UART Rx, send a ZERO length USB package if last USB
      * USB package sent was CDC_BULK_EP_SIZE (max. EP size) long.
      */
-    // Stop Rx DMA channel.
-    LDMA_StopTransfer(CDC_UART_RX_DMA_CHANNEL);
-    dmaRxCompleted = false;
-    // Call DMA completion callback.
-    DmaRxComplete();
+    UartRxFlush();
     return;
   }
 
-  if ((numReceived > 0) && (numReceived == uartRxCount)) {
+  if ((numReceived > 0) && (numReceived == (uint32_t) uartRxCount)) {
     /*
      * There is curently no activity on UART Rx but some chars have been
      * received. Stop DMA and transmit the chars we have got so far on USB.
+     * With CDC_RX_IDLE_DETECT the USART normally does this first.
      */
-    // Stop Rx DMA channel.
-    LDMA_StopTransfer(CDC_UART_RX_DMA_CHANNEL);
-    dmaRxCompleted = false;
-    // Call DMA completion callback.
-    DmaRxComplete();
+    UartRxFlush();
     return;
   }
 
@@ -601,6 +753,28 @@ void LDMA_IRQHandler(void)
   }
 }
 
+#if CDC_RX_IDLE_DETECT
+/**************************************************************************//**
+ * @brief UART Rx Handler, called when the Rx line has become idle
+ *****************************************************************************/
+void CDC_UART_RX_IRQHandler(void)
+{
+  uint32_t pending = USART_IntGetEnabled(CDC_UART);
+  uint32_t numRemaining;
+
+  USART_IntClear(CDC_UART, pending);
+
+  if ((pending & USART_IF_TCMP0) && dmaRxActive) {
+    numRemaining = LDMA_TransferRemainingCount(CDC_UART_RX_DMA_CHANNEL);
+
+    // Send the partial buffer, a full buffer is sent by LDMA_IRQHandler().
+    if ((numRemaining > 0) && (numRemaining < CDC_USB_TX_BUF_SIZ)) {
+      UartRxFlush();
+    }
+  }
+}
+#endif
+
 /**************************************************************************//**
  * @brief Initialize the DMA peripheral.
  *****************************************************************************/
@@ -614,9 +788,9 @@ static void DmaSetup(void)
 
   // Channel descriptor configuration
   descriptorTx = (LDMA_Descriptor_t)
-    LDMA_DESCRIPTOR_SINGLE_M2P_BYTE((void *) usbRxBuffer[usbRxIndex], // Memory source address
+    LDMA_DESCRIPTOR_SINGLE_M2P_BYTE((void *) usbRxBuffer[usbRxTail],  // Memory source address
                                     (void *) &(CDC_UART->TXDATA),     // Peripheral destination address
-                                    usbBytesReceived);                // Number of bytes per transfer
+                                    CDC_USB_RX_BUF_SIZ);              // Number of bytes per transfer
   descriptorTx.xfer.doneIfs = 1; // Trigger an interrupt when done
 
   // Transfer configuration and trigger selection
@@ -627,7 +801,7 @@ static void DmaSetup(void)
   // Channel descriptor configuration
   descriptorRx = (LDMA_Descriptor_t)
     LDMA_DESCRIPTOR_SINGLE_P2M_BYTE((void *) &(CDC_UART->RXDATA),       // Peripheral source address
-                                    (void *) uartRxBuffer[uartRxIndex], // Memory destination address
+                                    (void *) uartRxBuffer[uartRxHead],  // Memory destination address
                                     CDC_USB_TX_BUF_SIZ);                // Number of bytes per transfer
   descriptorRx.xfer.doneIfs = 1; // Trigger an interrupt when done
 
@@ -664,6 +838,14 @@ static void SerialPortInit(void)
   CDC_UART->ROUTEPEN = CDC_UART_ROUTEPEN;
   CDC_UART->ROUTELOC0 = CDC_UART_ROUTELOC0;
 
+#if CDC_RX_IDLE_DETECT
+  // Enable the Rx line idle interrupt, see UartRxAdapt().
+  USART_IntClear(CDC_UART, USART_IF_TCMP0);
+  USART_IntEnable(CDC_UART, USART_IEN_TCMP0);
+  NVIC_ClearPendingIRQ(CDC_UART_RX_IRQn);
+  NVIC_EnableIRQ(CDC_UART_RX_IRQn);
+#endif
+
   // Finally enable it
   USART_Enable(CDC_UART, usartEnable);
 }
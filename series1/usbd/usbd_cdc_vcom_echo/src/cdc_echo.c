@@ -34,7 +34,16 @@
  ******************************************************************************/
 
 #include "em_usb.h"
-#include "cdc.h"
+#include "cdc_echo.h"
+
+// Uncomment to measure the echo throughput and latency with a free-running
+// timer, view the benchmark* variables in the Expressions window
+// #define CDC_ECHO_BENCHMARK
+
+#if defined(CDC_ECHO_BENCHMARK)
+#include "em_cmu.h"
+#include "em_timer.h"
+#endif
 
 // The serial port LINE CODING data structure, used to carry information
 // about serial port baudrate, parity, etc. between host and device.
@@ -64,16 +73,165 @@ SL_PACK_END()
 // By default, the receive buffer size is same size as the max size of a full speed bulk endpoint
 #define CDC_USB_RX_BUF_SIZE  (USB_FS_BULK_EP_MAXSIZE)
 
-// Create a 4-byte aligned uint8_t array for the USB receive buffer
-STATIC_UBUF(usbRxBuffer, CDC_USB_RX_BUF_SIZE);
+// Note: change this to change the number of receive buffers
+// A packet is received into a free buffer while earlier packets are echoed
+// from the others, the host only has to wait when all of them are in use
+#define CDC_USB_RX_BUF_COUNT  4
+
+// Create 4-byte aligned uint8_t arrays for the ring of USB receive buffers
+SL_ALIGN(4)
+static uint8_t usbRxBuffer[CDC_USB_RX_BUF_COUNT][(CDC_USB_RX_BUF_SIZE + 3) & ~3]
+  SL_ATTRIBUTE_ALIGN(4);
+
+// Number of bytes received into each buffer
+static uint32_t usbRxLength[CDC_USB_RX_BUF_COUNT];
+
+// Buffer being received into, oldest buffer waiting for or being echoed,
+// and number of buffers waiting for or being echoed
+static int usbRxHead;
+static int usbRxTail;
+static int usbRxCount;
 
-// Global for letting us know if USB data transmission is currently in progress or not
+// Globals for letting us know if USB data reception/transmission is currently in progress or not
+static bool usbRxActive;
 static bool usbTxActive;
 
 // Function prototypes for receiving/transmitting data over USB
 static int usbDataReceived(USB_Status_TypeDef status, uint32_t xferred, uint32_t remaining);
 static int usbDataTransmitted(USB_Status_TypeDef status, uint32_t xferred, uint32_t remaining);
 
+#if defined(CDC_ECHO_BENCHMARK)
+// Free-running 32-bit timer used for the timestamps
+#define BENCHMARK_TIMER         WTIMER0
+#define BENCHMARK_TIMER_CLOCK   cmuClock_WTIMER0
+
+// Number of received packets that can wait for their echo
+#define BENCHMARK_PENDING       CDC_USB_RX_BUF_COUNT
+
+// Timer frequency in Hz
+uint32_t benchmarkTimerFreq;
+
+// Bytes echoed, and the timer ticks from the first packet received to the
+// last echo transmitted
+uint32_t benchmarkBytes;
+uint32_t benchmarkTicks;
+uint32_t benchmarkBytesPerSecond;
+
+// Packets received and echoed
+uint32_t benchmarkRxPackets;
+uint32_t benchmarkTxPackets;
+
+// benchmarkLatency[n] counts the packets echoed less than 2^n timer ticks
+// after they were received. benchmarkLatencyP50 and benchmarkLatencyP99
+// are the bucket limits, in ticks, that 50% and 99% of the packets meet.
+uint32_t benchmarkLatency[32];
+uint32_t benchmarkLatencyP50;
+uint32_t benchmarkLatencyP99;
+
+// Receive timestamps of the packets waiting for their echo
+static uint32_t benchmarkPending[BENCHMARK_PENDING];
+static int benchmarkPendingHead, benchmarkPendingCount;
+static uint32_t benchmarkLast;
+
+/**************************************************************************//**
+ * @brief
+ *    Start the benchmark timer and clear the results
+ *****************************************************************************/
+static void benchmarkInit(void)
+{
+  TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
+
+  CMU_ClockEnable(BENCHMARK_TIMER_CLOCK, true);
+  TIMER_Init(BENCHMARK_TIMER, &timerInit);
+  benchmarkTimerFreq = CMU_ClockFreqGet(BENCHMARK_TIMER_CLOCK);
+
+  benchmarkBytes = 0;
+  benchmarkTicks = 0;
+  benchmarkBytesPerSecond = 0;
+  benchmarkRxPackets = 0;
+  benchmarkTxPackets = 0;
+  for (int i = 0; i < 32; i++) {
+    benchmarkLatency[i] = 0;
+  }
+  benchmarkPendingHead = 0;
+  benchmarkPendingCount = 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Bucket limit in ticks that pct percent of the echoed packets meet
+ *****************************************************************************/
+static uint32_t benchmarkPercentile(uint32_t pct)
+{
+  uint32_t target = (benchmarkTxPackets * pct + 99) / 100;
+  uint32_t count = 0;
+  int n;
+
+  for (n = 0; n < 31; n++) {
+    count += benchmarkLatency[n];
+    if (count >= target) {
+      break;
+    }
+  }
+  return 1UL << n;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Timestamp a received packet that will be echoed
+ *****************************************************************************/
+static void benchmarkReceived(void)
+{
+  uint32_t now = TIMER_CounterGet(BENCHMARK_TIMER);
+
+  if (benchmarkRxPackets == 0) {
+    benchmarkLast = now;
+  }
+  benchmarkRxPackets++;
+
+  if (benchmarkPendingCount < BENCHMARK_PENDING) {
+    benchmarkPending[(benchmarkPendingHead + benchmarkPendingCount)
+                     % BENCHMARK_PENDING] = now;
+    benchmarkPendingCount++;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Account for an echoed packet of bytes bytes
+ *****************************************************************************/
+static void benchmarkTransmitted(uint32_t bytes)
+{
+  uint32_t now = TIMER_CounterGet(BENCHMARK_TIMER);
+  uint32_t latency;
+  int n;
+
+  // Accumulate the elapsed ticks so that the timer may wrap around
+  benchmarkTicks += now - benchmarkLast;
+  benchmarkLast = now;
+  benchmarkBytes += bytes;
+  if (benchmarkTicks > 0) {
+    benchmarkBytesPerSecond = (uint32_t) ((uint64_t) benchmarkBytes
+                                          * benchmarkTimerFreq
+                                          / benchmarkTicks);
+  }
+
+  // Packets are echoed in the order they were received
+  if (benchmarkPendingCount > 0) {
+    latency = now - benchmarkPending[benchmarkPendingHead];
+    benchmarkPendingHead = (benchmarkPendingHead + 1) % BENCHMARK_PENDING;
+    benchmarkPendingCount--;
+
+    for (n = 0; (n < 31) && (latency >= (1UL << n)); n++) {
+    }
+    benchmarkLatency[n]++;
+    benchmarkTxPackets++;
+    benchmarkLatencyP50 = benchmarkPercentile(50);
+    benchmarkLatencyP99 = benchmarkPercentile(99);
+  }
+}
+#endif
+
 /**************************************************************************//**
 * @brief
 *    Callback that gets called when the data stage of a CDC_SET_LINECODING
@@ -240,10 +398,18 @@ void cdcStateChangeEvent(USBD_State_TypeDef oldState, USBD_State_TypeDef newStat
     if (oldState == USBD_STATE_SUSPENDED) {} // Currently does nothing
 
     // Initially, we are waiting to receive data from the USB host over USB
+    usbRxHead = 0;
+    usbRxTail = 0;
+    usbRxCount = 0;
+    usbRxActive = true;
     usbTxActive = false;
 
+#if defined(CDC_ECHO_BENCHMARK)
+    benchmarkInit();
+#endif
+
     // Setup a new USB receive transfer on the USB host's OUT endpoint
-    USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer,
+    USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer[usbRxHead],
               CDC_USB_RX_BUF_SIZE, usbDataReceived);
   }
   // Else if we have been de-configured
@@ -277,22 +443,40 @@ static int usbDataReceived(USB_Status_TypeDef status, uint32_t xferred, uint32_t
 {
   (void) remaining; // Unused parameter
 
-  // If the status is OK and we actually received data
-  if ((status == USB_STATUS_OK) && (xferred > 0)) {
+  // The transfer was aborted, e.g. by a USB reset
+  if (status != USB_STATUS_OK) {
+    return USB_STATUS_OK;
+  }
+
+  // If we actually received data, queue the buffer for echoing
+  if (xferred > 0) {
+
+#if defined(CDC_ECHO_BENCHMARK)
+    benchmarkReceived();
+#endif
+
+    usbRxLength[usbRxHead] = xferred;
+    usbRxHead = (usbRxHead + 1) % CDC_USB_RX_BUF_COUNT;
+    usbRxCount++;
 
     // If the TX line is not busy, we can send a new USB packet
     if (!usbTxActive) {
 
-      // Setup a USB transmit transfer
+      // Setup a USB transmit transfer from the oldest buffer
       usbTxActive = true;
-      USBD_Write(CDC_EP_DATA_IN, (void*) usbRxBuffer,
-          xferred, usbDataTransmitted);
-
-      // Setup a new USB receive transfer
-      USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer,
-          CDC_USB_RX_BUF_SIZE, usbDataReceived);
+      USBD_Write(CDC_EP_DATA_IN, (void*) usbRxBuffer[usbRxTail],
+          usbRxLength[usbRxTail], usbDataTransmitted);
     }
   }
+
+  // Setup a new USB receive transfer into the next buffer if it is free,
+  // else the host waits (NAK) until usbDataTransmitted() frees one
+  if (usbRxCount < CDC_USB_RX_BUF_COUNT) {
+    USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer[usbRxHead],
+        CDC_USB_RX_BUF_SIZE, usbDataReceived);
+  } else {
+    usbRxActive = false;
+  }
   return USB_STATUS_OK;
 }
 
@@ -318,11 +502,34 @@ static int usbDataTransmitted(USB_Status_TypeDef status, uint32_t xferred, uint3
   (void) xferred;   // Unused parameter
   (void) remaining; // Unused parameter
 
-  // Mark that the USB transmit transaction has been completed
-  if (status == USB_STATUS_OK) {
+  // The transfer was aborted, e.g. by a USB reset
+  if (status != USB_STATUS_OK) {
+    return USB_STATUS_OK;
+  }
+
+#if defined(CDC_ECHO_BENCHMARK)
+  benchmarkTransmitted(xferred);
+#endif
+
+  // The oldest buffer has been echoed, free it
+  usbRxTail = (usbRxTail + 1) % CDC_USB_RX_BUF_COUNT;
+  usbRxCount--;
+
+  // Echo the next buffer, or mark that the USB transmit transaction has been completed
+  if (usbRxCount > 0) {
+    USBD_Write(CDC_EP_DATA_IN, (void*) usbRxBuffer[usbRxTail],
+        usbRxLength[usbRxTail], usbDataTransmitted);
+  } else {
     usbTxActive = false;
   }
 
+  // If all buffers were full, setup a new USB receive transfer into the one just freed
+  if (!usbRxActive) {
+    usbRxActive = true;
+    USBD_Read(CDC_EP_DATA_OUT, (void*) usbRxBuffer[usbRxHead],
+        CDC_USB_RX_BUF_SIZE, usbDataReceived);
+  }
+
   return USB_STATUS_OK;
 }
 
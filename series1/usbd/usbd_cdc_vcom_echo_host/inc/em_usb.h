@@ -0,0 +1,118 @@
+/***************************************************************************//**
+ * @file em_usb.h
+ * @brief Host build replacement for the USB device stack header. Provides the
+ * types, macros and USBD_Read()/USBD_Write() used by cdc_echo.c, which are
+ * implemented by the model in src/usbd_model.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ ******************************************************************************/
+
+#ifndef EM_USB_H
+#define EM_USB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "usbconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// em_common.h
+#define SL_ALIGN(x)
+#define SL_ATTRIBUTE_ALIGN(x)       __attribute__ ((aligned(x)))
+#define SL_ATTRIBUTE_PACKED         __attribute__ ((packed))
+#define SL_PACK_START(x)
+#define SL_PACK_END()
+
+// Declares a 4-byte aligned buffer of at least x bytes
+#define STATIC_UBUF(x, y) static uint8_t x[((y) + 3) & ~3] SL_ATTRIBUTE_ALIGN(4)
+
+#define USB_FS_BULK_EP_MAXSIZE      64
+
+// Transfer status codes passed to the transfer complete callbacks
+typedef enum {
+  USB_STATUS_OK              =  0,
+  USB_STATUS_REQ_ERR         = -1,
+  USB_STATUS_EP_BUSY         = -2,
+  USB_STATUS_REQ_UNHANDLED   = -3,
+  USB_STATUS_ILLEGAL         = -4,
+  USB_STATUS_EP_STALLED      = -5,
+  USB_STATUS_EP_ABORTED      = -6,
+  USB_STATUS_EP_ERROR        = -7,
+  USB_STATUS_EP_NAK          = -8,
+  USB_STATUS_DEVICE_UNCONFIGURED = -9,
+  USB_STATUS_DEVICE_SUSPENDED = -10,
+  USB_STATUS_DEVICE_RESET    = -11,
+  USB_STATUS_TIMEOUT         = -12,
+  USB_STATUS_DEVICE_REMOVED  = -13,
+} USB_Status_TypeDef;
+
+typedef enum {
+  USBD_STATE_NONE       = 0,
+  USBD_STATE_ATTACHED   = 1,
+  USBD_STATE_POWERED    = 2,
+  USBD_STATE_DEFAULT    = 3,
+  USBD_STATE_ADDRESSED  = 4,
+  USBD_STATE_CONFIGURED = 5,
+  USBD_STATE_SUSPENDED  = 6,
+} USBD_State_TypeDef;
+
+// Setup request, only the fields used by the CDC class requests
+typedef struct {
+  union {
+    struct {
+      uint8_t Recipient : 5;
+      uint8_t Type      : 2;
+      uint8_t Direction : 1;
+    };
+    uint8_t bmRequestType;
+  };
+  uint8_t  bRequest;
+  uint16_t wValue;
+  uint16_t wIndex;
+  uint16_t wLength;
+} USB_Setup_TypeDef;
+
+#define USB_SETUP_DIR_OUT               0
+#define USB_SETUP_DIR_IN                1
+#define USB_SETUP_TYPE_CLASS            1
+#define USB_SETUP_RECIPIENT_INTERFACE   1
+
+#define USB_CDC_SETLINECODING           0x20
+#define USB_CDC_GETLINECODING           0x21
+#define USB_CDC_SETCTRLLINESTATE        0x22
+
+// em_usart.h frame settings checked by the line coding callback
+#define USART_FRAME_DATABITS_FIVE       0x2UL
+#define USART_FRAME_DATABITS_SIX        0x3UL
+#define USART_FRAME_DATABITS_SEVEN      0x4UL
+#define USART_FRAME_DATABITS_EIGHT      0x5UL
+#define USART_FRAME_DATABITS_SIXTEEN    0xDUL
+#define USART_FRAME_PARITY_NONE         (0x0UL << 8)
+#define USART_FRAME_PARITY_EVEN         (0x2UL << 8)
+#define USART_FRAME_PARITY_ODD          (0x3UL << 8)
+#define USART_FRAME_STOPBITS_ONE        (0x1UL << 12)
+#define USART_FRAME_STOPBITS_ONEANDAHALF (0x2UL << 12)
+#define USART_FRAME_STOPBITS_TWO        (0x3UL << 12)
+
+typedef int (*USB_XferCompleteCb_TypeDef)(USB_Status_TypeDef status,
+                                          uint32_t xferred,
+                                          uint32_t remaining);
+
+int USBD_Read(int epAddr, void *data, int byteCount,
+              USB_XferCompleteCb_TypeDef callback);
+int USBD_Write(int epAddr, void *data, int byteCount,
+               USB_XferCompleteCb_TypeDef callback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM_USB_H
@@ -0,0 +1,97 @@
+/***************************************************************************//**
+ * @file usbd_model.h
+ * @brief Host-side model of the USB device stack transfer API and a full speed
+ * USB host, used to measure the echo path of cdc_echo.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef USBD_MODEL_H
+#define USBD_MODEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_usb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Traffic generated by the modelled host. The host sends a byte sequence in
+ * OUT packets of packetSize bytes, keeping at most window bytes sent but not
+ * yet echoed, and polls the IN endpoint for the echo. It schedules up to
+ * burst transactions on one endpoint before switching to the other, as host
+ * controllers do when several packets are queued for an endpoint.
+ */
+typedef struct {
+  const char *name;             // Printed with the results
+  uint32_t packetSize;          // Bytes per OUT packet, 1 to 64
+  uint32_t window;              // Bytes in flight, packetSize or more
+  uint32_t burst;               // Transactions per endpoint in a row
+  uint32_t totalBytes;          // Bytes to send
+  uint32_t callbackNs;          // Device time from a callback to the next
+                                // transfer being ready on the endpoint
+} USBDMODEL_Host_t;
+
+// Results of USBDMODEL_Run()
+typedef struct {
+  uint32_t bytesSent;           // Bytes accepted on the OUT endpoint
+  uint32_t bytesEchoed;         // Bytes received on the IN endpoint
+  uint32_t bytesWrong;          // Echoed bytes that were not the bytes sent
+  uint64_t elapsedNs;           // Bus time until the last echo
+  uint32_t packets;             // OUT packets echoed completely
+  uint32_t latencyP50Ns;        // Median time from sending an OUT packet
+                                // to receiving its last byte back
+  uint32_t latencyP99Ns;        // 99th percentile of the same
+  uint32_t readCalls;           // USBD_Read() calls
+  uint32_t writeCalls;          // USBD_Write() calls
+  uint32_t busyCalls;           // Calls on an endpoint already in use
+  uint32_t readCallbacks;       // USBD_Read() transfer complete callbacks
+  uint32_t writeCallbacks;      // USBD_Write() transfer complete callbacks
+  uint32_t outNaks;             // OUT packets refused, no read ready
+  uint32_t inNaks;              // IN polls refused, no write ready
+  bool     stalled;             // No progress for USBDMODEL_STALL_NS
+} USBDMODEL_Stats_t;
+
+// The run stops when no byte has been sent or echoed for this long
+#define USBDMODEL_STALL_NS      10000000UL
+
+void USBDMODEL_Reset(USBDMODEL_Stats_t *stats);
+void USBDMODEL_Run(const USBDMODEL_Host_t *host, USBDMODEL_Stats_t *stats);
+void USBDMODEL_PrintStats(const USBDMODEL_Host_t *host,
+                          const USBDMODEL_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USBD_MODEL_H
@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Host benchmark of the echo path of usbd_cdc_vcom_echo. Runs
+ * cdc_echo.c against a model of the USB device stack and a full speed host
+ * and reports throughput, latency and callback counts.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include "em_usb.h"
+#include "cdc_echo.h"
+#include "usbd_model.h"
+
+// Device time from a transfer complete callback to the next transfer being
+// ready, interrupt entry and exit included
+#define CALLBACK_NS     2000
+
+// Traffic patterns, see USBDMODEL_Host_t
+static const USBDMODEL_Host_t hosts[] = {
+  // Name            Packet  Window  Burst  Bytes   Callback
+  { "interactive",        1,      1,     1,   200, CALLBACK_NS },
+  { "bulk",              64,   4096,     1, 65536, CALLBACK_NS },
+  { "bulk burst",        64,   4096,     4, 65536, CALLBACK_NS },
+  { "short burst",       37,   4096,     4, 65536, CALLBACK_NS },
+  { "short window",      37,     40,     1,  4096, CALLBACK_NS },
+};
+
+/***************************************************************************//**
+ * @brief
+ *    Run every traffic pattern against cdc_echo.c. Returns 0 if every byte
+ *    was echoed unchanged.
+ ******************************************************************************/
+int main(void)
+{
+  USBDMODEL_Stats_t stats;
+  int failed = 0;
+
+  for (unsigned int i = 0; i < sizeof(hosts) / sizeof(hosts[0]); i++) {
+    // Configure the device, which starts its first USB receive transfer
+    USBDMODEL_Reset(&stats);
+    cdcStateChangeEvent(USBD_STATE_ADDRESSED, USBD_STATE_CONFIGURED);
+
+    USBDMODEL_Run(&hosts[i], &stats);
+    USBDMODEL_PrintStats(&hosts[i], &stats);
+
+    if (stats.stalled || (stats.bytesWrong > 0)) {
+      failed = 1;
+    }
+  }
+
+  printf(failed ? "FAILED\n" : "PASSED\n");
+  return failed;
+}
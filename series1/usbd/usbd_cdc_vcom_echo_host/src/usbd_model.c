@@ -0,0 +1,328 @@
+/***************************************************************************//**
+ * @file usbd_model.c
+ * @brief Host-side model of the USB device stack transfer API and a full speed
+ * USB host, used to measure the echo path of cdc_echo.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usbd_model.h"
+
+/*
+ * Full speed bus timing. A bulk transaction is a token packet, a data packet
+ * of 8 bits per byte plus framing, a handshake and the gaps between them,
+ * about 105 + 8 * bytes bit times at 12 Mbit/s (bit stuffing and start of
+ * frame packets are ignored). An OUT packet takes the same time whether the
+ * device accepts it or NAKs it, an IN poll that is NAKed only costs the
+ * token and the handshake.
+ */
+#define TRANSACTION_BITS(bytes) (105 + 8 * (bytes))
+#define IN_NAK_BITS             62
+#define BITS_TO_NS(bits)        (((uint64_t) (bits) * 1000 + 11) / 12)
+
+// State of a transfer started by USBD_Read() or USBD_Write()
+typedef struct {
+  bool armed;                   // Transfer in progress
+  uint8_t *data;                // Transfer buffer
+  uint32_t size;                // Bytes to transfer
+  uint32_t offset;              // Bytes transferred so far
+  uint64_t readyAt;             // Time the device has the endpoint ready
+  USB_XferCompleteCb_TypeDef callback;
+} ModelEp_t;
+
+static ModelEp_t epOut, epIn;
+static uint64_t modelNow;
+static uint32_t modelCallbackNs;
+static USBDMODEL_Stats_t *modelStats;
+
+/***************************************************************************//**
+ * @brief Value of byte number index of the host's sequence
+ ******************************************************************************/
+static uint8_t sequenceByte(uint32_t index)
+{
+  return (uint8_t) (index + (index >> 8));
+}
+
+/***************************************************************************//**
+ * @brief Start a transfer on an endpoint, as USBD_Read() and USBD_Write() do
+ ******************************************************************************/
+static int startTransfer(ModelEp_t *ep, void *data, int byteCount,
+                         USB_XferCompleteCb_TypeDef callback)
+{
+  if (ep->armed) {
+    if (modelStats != NULL) {
+      modelStats->busyCalls++;
+    }
+    return USB_STATUS_EP_BUSY;
+  }
+
+  ep->armed = true;
+  ep->data = data;
+  ep->size = byteCount;
+  ep->offset = 0;
+  ep->readyAt = modelNow + modelCallbackNs;
+  ep->callback = callback;
+  return USB_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief Complete the transfer on an endpoint and call its callback
+ ******************************************************************************/
+static void completeTransfer(ModelEp_t *ep)
+{
+  USB_XferCompleteCb_TypeDef callback = ep->callback;
+
+  // The callback may start the next transfer on the endpoint
+  ep->armed = false;
+  if (callback != NULL) {
+    callback(USB_STATUS_OK, ep->offset, ep->size - ep->offset);
+  }
+}
+
+int USBD_Read(int epAddr, void *data, int byteCount,
+              USB_XferCompleteCb_TypeDef callback)
+{
+  if (epAddr != CDC_EP_DATA_OUT) {
+    // Control transfers are not modelled
+    return USB_STATUS_OK;
+  }
+  if (modelStats != NULL) {
+    modelStats->readCalls++;
+  }
+  return startTransfer(&epOut, data, byteCount, callback);
+}
+
+int USBD_Write(int epAddr, void *data, int byteCount,
+               USB_XferCompleteCb_TypeDef callback)
+{
+  if (epAddr != CDC_EP_DATA_IN) {
+    return USB_STATUS_OK;
+  }
+  if (modelStats != NULL) {
+    modelStats->writeCalls++;
+  }
+  return startTransfer(&epIn, data, byteCount, callback);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Abort all transfers, restart the bus time and clear stats, which counts
+ *    the calls and callbacks until the end of the next USBDMODEL_Run()
+ ******************************************************************************/
+void USBDMODEL_Reset(USBDMODEL_Stats_t *stats)
+{
+  memset(&epOut, 0, sizeof(epOut));
+  memset(&epIn, 0, sizeof(epIn));
+  memset(stats, 0, sizeof(*stats));
+  modelNow = 0;
+  modelCallbackNs = 0;
+  modelStats = stats;
+}
+
+/***************************************************************************//**
+ * @brief Compare function for sorting the latencies
+ ******************************************************************************/
+static int compareLatency(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *) a;
+  uint32_t y = *(const uint32_t *) b;
+
+  return (x > y) - (x < y);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Run the host traffic against the transfers started by the device code
+ *    until all bytes are echoed or the echo stalls
+ *
+ * @details
+ *    The device code must have started its first USBD_Read() (e.g. from the
+ *    configured state change callback) after USBDMODEL_Reset(stats). The transfer
+ *    complete callbacks run synchronously at the end of the transaction that
+ *    completes the transfer, a transfer started from a callback is ready
+ *    host->callbackNs later. IN packets read the device buffer when they
+ *    are sent, so a buffer reused too early shows up as wrong bytes.
+ ******************************************************************************/
+void USBDMODEL_Run(const USBDMODEL_Host_t *host, USBDMODEL_Stats_t *stats)
+{
+  // Packets are cut short at the end of the window, so there can be up to
+  // one per byte
+  uint32_t maxPackets = host->totalBytes;
+  uint32_t *packetEnd = malloc(maxPackets * sizeof(uint32_t));
+  uint64_t *packetStart = malloc(maxPackets * sizeof(uint64_t));
+  uint32_t *latency = malloc(maxPackets * sizeof(uint32_t));
+  uint32_t packetsSent = 0;
+  uint64_t lastProgress = 0;
+  uint32_t burstLeft = host->burst;
+  bool outTurn = true;
+
+  if ((packetEnd == NULL) || (packetStart == NULL) || (latency == NULL)) {
+    fprintf(stderr, "usbd_model: out of memory\n");
+    exit(1);
+  }
+
+  modelCallbackNs = host->callbackNs;
+
+  while (stats->bytesEchoed < host->totalBytes) {
+    uint32_t inFlight = stats->bytesSent - stats->bytesEchoed;
+    bool canSend = (stats->bytesSent < host->totalBytes)
+                   && (inFlight < host->window);
+
+    if (modelNow - lastProgress > USBDMODEL_STALL_NS) {
+      stats->stalled = true;
+      break;
+    }
+
+    // Switch endpoint after a burst, or when the host has nothing to send
+    if (burstLeft == 0) {
+      outTurn = !outTurn;
+      burstLeft = host->burst;
+    }
+    burstLeft--;
+
+    if (outTurn && canSend) {
+      uint32_t n = host->packetSize;
+
+      if (n > host->totalBytes - stats->bytesSent) {
+        n = host->totalBytes - stats->bytesSent;
+      }
+      if (n > host->window - inFlight) {
+        n = host->window - inFlight;
+      }
+
+      if (epOut.armed && (modelNow >= epOut.readyAt)
+          && (epOut.offset + n <= epOut.size)) {
+        for (uint32_t i = 0; i < n; i++) {
+          epOut.data[epOut.offset + i] = sequenceByte(stats->bytesSent + i);
+        }
+        epOut.offset += n;
+        packetStart[packetsSent] = modelNow;
+        stats->bytesSent += n;
+        packetEnd[packetsSent++] = stats->bytesSent;
+        lastProgress = modelNow;
+        modelNow += BITS_TO_NS(TRANSACTION_BITS(n));
+
+        // A short packet or a full buffer ends the transfer
+        if ((n < USB_FS_BULK_EP_MAXSIZE) || (epOut.offset == epOut.size)) {
+          stats->readCallbacks++;
+          completeTransfer(&epOut);
+        }
+      } else {
+        stats->outNaks++;
+        modelNow += BITS_TO_NS(TRANSACTION_BITS(n));
+      }
+    } else {
+      if (outTurn) {
+        // Nothing to send, poll IN without using up the OUT burst
+        burstLeft++;
+      }
+
+      if (epIn.armed && (modelNow >= epIn.readyAt)) {
+        uint32_t n = epIn.size - epIn.offset;
+
+        if (n > USB_FS_BULK_EP_MAXSIZE) {
+          n = USB_FS_BULK_EP_MAXSIZE;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+          if (epIn.data[epIn.offset + i]
+              != sequenceByte(stats->bytesEchoed + i)) {
+            stats->bytesWrong++;
+          }
+        }
+        epIn.offset += n;
+        stats->bytesEchoed += n;
+        modelNow += BITS_TO_NS(TRANSACTION_BITS(n));
+        if (n > 0) {
+          lastProgress = modelNow;
+        }
+
+        // Every OUT packet whose last byte has come back is done
+        while ((stats->packets < packetsSent)
+               && (packetEnd[stats->packets] <= stats->bytesEchoed)) {
+          latency[stats->packets] = (uint32_t) (modelNow
+                                                - packetStart[stats->packets]);
+          stats->packets++;
+        }
+
+        if ((n < USB_FS_BULK_EP_MAXSIZE) || (epIn.offset == epIn.size)) {
+          stats->writeCallbacks++;
+          completeTransfer(&epIn);
+        }
+      } else {
+        stats->inNaks++;
+        modelNow += BITS_TO_NS(IN_NAK_BITS);
+      }
+    }
+  }
+
+  stats->elapsedNs = modelNow;
+  if (stats->packets > 0) {
+    qsort(latency, stats->packets, sizeof(uint32_t), compareLatency);
+    stats->latencyP50Ns = latency[(stats->packets - 1) / 2];
+    stats->latencyP99Ns = latency[(stats->packets * 99 - 1) / 100];
+  }
+
+  modelStats = NULL;
+  free(packetEnd);
+  free(packetStart);
+  free(latency);
+}
+
+/***************************************************************************//**
+ * @brief Print the results of a run on one line, then the callback counts
+ ******************************************************************************/
+void USBDMODEL_PrintStats(const USBDMODEL_Host_t *host,
+                          const USBDMODEL_Stats_t *stats)
+{
+  double seconds = stats->elapsedNs / 1e9;
+
+  printf("%-16s %7lu bytes %7.1f kB/s  p50 %7.1f us  p99 %7.1f us%s%s\n",
+         host->name,
+         (unsigned long) stats->bytesEchoed,
+         seconds > 0 ? stats->bytesEchoed / seconds / 1000 : 0.0,
+         stats->latencyP50Ns / 1000.0,
+         stats->latencyP99Ns / 1000.0,
+         stats->bytesWrong ? "  WRONG DATA" : "",
+         stats->stalled ? "  STALLED" : "");
+  printf("%-16s reads %lu/%lu  writes %lu/%lu  busy %lu  "
+         "NAKs out %lu in %lu\n",
+         "",
+         (unsigned long) stats->readCallbacks,
+         (unsigned long) stats->readCalls,
+         (unsigned long) stats->writeCallbacks,
+         (unsigned long) stats->writeCalls,
+         (unsigned long) stats->busyCalls,
+         (unsigned long) stats->outNaks,
+         (unsigned long) stats->inNaks);
+}
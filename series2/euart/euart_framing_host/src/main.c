@@ -0,0 +1,481 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Host test and benchmark of the COBS and SLIP framing of euart_ldma.
+ * Decodes fuzzed streams through a ring in random chunks and reports the
+ * encode and decode throughput.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "frame.h"
+
+// Frames sent through the ring in each mode
+#define FUZZ_FRAMES       20000
+
+// Longest payload, the encoded frame must fit in the ring
+#define MAX_PAYLOAD       600
+
+// Receive ring, as in euart_ldma
+#define RING_SIZE         2048
+
+// One in CORRUPT_RATE frames is damaged on the line
+#define CORRUPT_RATE      20
+
+// Each payload starts with the number of its frame, two bytes without zeros
+#define SEQUENCE_BYTES    2
+
+// Bytes encoded and decoded by each benchmark
+#define BENCH_BYTES       (64 * 1024 * 1024)
+#define BENCH_PAYLOAD     256
+
+// Payloads as sent, back to back
+static uint8_t sentData[FUZZ_FRAMES * (MAX_PAYLOAD / 2 + 64)];
+
+typedef struct {
+  uint32_t offset;            // Payload in sentData
+  uint32_t length;
+  bool corrupted;             // Damaged on the line, may be lost
+} SentFrame_t;
+
+static SentFrame_t sent[FUZZ_FRAMES];
+
+// Encoded stream as it arrives at the receiver
+static uint8_t stream[FUZZ_FRAMES * (MAX_PAYLOAD + 64)];
+static uint32_t streamLength;
+
+static uint8_t ring[RING_SIZE];
+static uint8_t encoded[FRAME_ENCODED_MAX(MAX_PAYLOAD) + 8];
+static uint8_t payload[MAX_PAYLOAD];
+
+static uint32_t rngState = 0x2545F491;
+
+static uint32_t rng(void)
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Fill a payload with the frame number, then one of several patterns that
+ *    stress the encodings: random bytes, zeros, delimiters and escapes, long
+ *    runs without zeros and block boundaries of COBS.
+ ******************************************************************************/
+static uint32_t makePayload(uint8_t *data, uint32_t number)
+{
+  static const uint32_t edges[] = { 2, 3, 253, 254, 255, 256, 507, 508 };
+  static const uint8_t special[] = { 0x00, 0xC0, 0xDB, 0xDC, 0xDD, 0xFF };
+  uint32_t length;
+  uint32_t pattern = rng() % 5;
+  uint32_t i;
+
+  if (rng() % 4 == 0) {
+    length = edges[rng() % (sizeof(edges) / sizeof(edges[0]))];
+  } else {
+    length = SEQUENCE_BYTES + rng() % (MAX_PAYLOAD - SEQUENCE_BYTES + 1);
+  }
+
+  data[0] = (uint8_t)(1 + number % 255);
+  data[1] = (uint8_t)(1 + number / 255);
+  for (i = SEQUENCE_BYTES; i < length; i++) {
+    switch (pattern) {
+      case 0:
+        data[i] = (uint8_t)rng();
+        break;
+      case 1:
+        data[i] = 0;
+        break;
+      case 2:
+        data[i] = special[rng() % sizeof(special)];
+        break;
+      case 3:
+        data[i] = (uint8_t)(1 + rng() % 255);
+        break;
+      default:
+        data[i] = (rng() % 8) ? (uint8_t)rng() : special[rng() % 3];
+        break;
+    }
+  }
+  return length;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Damage an encoded frame: flip a bit, drop a byte or insert one.
+ ******************************************************************************/
+static uint32_t corrupt(uint8_t *data, uint32_t length)
+{
+  uint32_t at = rng() % length;
+
+  switch (rng() % 3) {
+    case 0:
+      data[at] ^= (uint8_t)(1 << (rng() % 8));
+      break;
+    case 1:
+      memmove(&data[at], &data[at + 1], length - at - 1);
+      length--;
+      break;
+    default:
+      memmove(&data[at + 1], &data[at], length - at);
+      data[at] = (uint8_t)rng();
+      length++;
+      break;
+  }
+  return length;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Encode a payload into encoded[], in one piece or in random fragments
+ *    as if it wrapped around a ring.
+ ******************************************************************************/
+static uint32_t encodeFragments(FrameMode_t mode, const uint8_t *data,
+                                uint32_t length)
+{
+  FrameEncoder_t encoder;
+  uint32_t fragment;
+
+  if (rng() % 2) {
+    return frameEncode(mode, data, length, encoded, sizeof(encoded) - 1);
+  }
+
+  frameEncodeStart(&encoder, mode, encoded, sizeof(encoded) - 1);
+  do {
+    fragment = rng() % (length + 1);
+    frameEncodeAppend(&encoder, data, fragment);
+    data += fragment;
+    length -= fragment;
+  } while (length > 0);
+  return frameEncodeEnd(&encoder);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Encode FUZZ_FRAMES frames into stream, damaging some of them.
+ ******************************************************************************/
+static bool buildStream(FrameMode_t mode)
+{
+  uint32_t dataLength = 0;
+  uint32_t length;
+  uint32_t i;
+
+  streamLength = 0;
+  for (i = 0; i < FUZZ_FRAMES; i++) {
+    sent[i].offset = dataLength;
+    sent[i].length = makePayload(&sentData[dataLength], i);
+    dataLength += sent[i].length;
+    if (dataLength > sizeof(sentData) - MAX_PAYLOAD) {
+      dataLength = 0;
+    }
+
+    length = encodeFragments(mode, &sentData[sent[i].offset],
+                             sent[i].length);
+    if (length == 0) {
+      return false;
+    }
+    sent[i].corrupted = (rng() % CORRUPT_RATE == 0);
+    if (sent[i].corrupted) {
+      length = corrupt(encoded, length);
+    }
+    memcpy(&stream[streamLength], encoded, length);
+    streamLength += length;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    true if frame i may be missing at the receiver: it was damaged, or the
+ *    damage of the frame before it removed the delimiter between them.
+ ******************************************************************************/
+static bool mayBeLost(uint32_t i)
+{
+  return sent[i].corrupted || ((i > 0) && sent[i - 1].corrupted);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Number of the frame a decoded payload claims to be, FUZZ_FRAMES if it
+ *    has none.
+ ******************************************************************************/
+static uint32_t frameNumber(const FrameDecoder_t *decoder, const Frame_t *frame)
+{
+  const uint8_t *data;
+  uint8_t number[SEQUENCE_BYTES];
+  uint32_t offset;
+
+  if (frame->length < SEQUENCE_BYTES) {
+    return FUZZ_FRAMES;
+  }
+  for (offset = 0; offset < SEQUENCE_BYTES; offset++) {
+    frameSpan(decoder, frame, offset, &data);
+    number[offset] = data[0];
+  }
+  if ((number[0] == 0) || (number[1] == 0)) {
+    return FUZZ_FRAMES;
+  }
+  return (number[0] - 1) + (number[1] - 1) * 255;
+}
+
+static bool samePayload(const FrameDecoder_t *decoder, const Frame_t *frame,
+                        uint32_t i)
+{
+  const uint8_t *data;
+  uint32_t offset = 0;
+  uint32_t span;
+
+  if (frame->length != sent[i].length) {
+    return false;
+  }
+  while (offset < frame->length) {
+    span = frameSpan(decoder, frame, offset, &data);
+    if (memcmp(data, &sentData[sent[i].offset + offset], span) != 0) {
+      return false;
+    }
+    offset += span;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Feed the stream into the ring in random chunks, as the LDMA would, and
+ *    decode it in place. Every frame that was not damaged must be decoded
+ *    unchanged and in order.
+ ******************************************************************************/
+static bool runFuzz(FrameMode_t mode, const char *name)
+{
+  FrameDecoder_t decoder;
+  Frame_t frame;
+  uint32_t written = 0;
+  uint32_t released = 0;
+  uint32_t chunk;
+  uint32_t next = 0;
+  uint32_t match;
+  uint32_t lost = 0;
+  uint32_t undetected = 0;
+  uint32_t corrupted = 0;
+  uint32_t i;
+  bool passed = true;
+
+  if (!buildStream(mode)) {
+    printf("%s: frame does not fit\n", name);
+    return false;
+  }
+
+  frameDecoderInit(&decoder, mode, ring, RING_SIZE, 0);
+
+  while (written < streamLength) {
+    // The receiver writes up to the bytes not released yet
+    chunk = 1 + rng() % 97;
+    if (chunk > streamLength - written) {
+      chunk = streamLength - written;
+    }
+    if (chunk > RING_SIZE - (written - released)) {
+      chunk = RING_SIZE - (written - released);
+    }
+    for (i = 0; i < chunk; i++) {
+      ring[(written + i) % RING_SIZE] = stream[written + i];
+    }
+    written += chunk;
+
+    while (frameDecode(&decoder, written, &frame)) {
+      // The frame must be the next one sent, or a later one if all frames
+      // in between may have been lost to damage on the line
+      match = frameNumber(&decoder, &frame);
+      for (i = next; (i < match) && (match < FUZZ_FRAMES); i++) {
+        if (!mayBeLost(i)) {
+          match = FUZZ_FRAMES;
+        }
+      }
+      if ((match < FUZZ_FRAMES) && (match >= next)
+          && samePayload(&decoder, &frame, match)) {
+        lost += match - next;
+        next = match + 1;
+      } else {
+        // A damaged frame that passed the CRC
+        undetected++;
+      }
+    }
+    released = frameDecoderConsumed(&decoder);
+  }
+
+  for (i = next; i < FUZZ_FRAMES; i++) {
+    if (!mayBeLost(i)) {
+      passed = false;
+    }
+  }
+  for (i = 0; i < FUZZ_FRAMES; i++) {
+    corrupted += sent[i].corrupted;
+  }
+
+  printf("%s: %u bytes, %u frames, %u damaged, %u decoded, %u errors, "
+         "%u lost, %u undetected\n", name, (unsigned)streamLength,
+         FUZZ_FRAMES, (unsigned)corrupted, (unsigned)decoder.frames,
+         (unsigned)decoder.errors, (unsigned)lost, (unsigned)undetected);
+
+  // Every damaged frame must be rejected
+  if (undetected > 0) {
+    passed = false;
+  }
+  if (!passed) {
+    printf("%s: FAILED\n", name);
+  }
+  return passed;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Payloads too short to carry a frame number: an empty frame before each
+ *    one byte frame, back to back, must all be decoded in order.
+ ******************************************************************************/
+static bool runShortFrames(FrameMode_t mode, const char *name)
+{
+  static const uint8_t bytes[] = { 0x00, 0x01, 0xC0, 0xDB, 0xDC, 0xDD, 0xFF };
+  FrameDecoder_t decoder;
+  Frame_t frame;
+  const uint8_t *data;
+  uint32_t length = 0;
+  uint32_t i;
+  bool passed = true;
+
+  for (i = 0; i < sizeof(bytes); i++) {
+    length += frameEncode(mode, bytes, 0, &ring[length], RING_SIZE - length);
+    length += frameEncode(mode, &bytes[i], 1, &ring[length],
+                          RING_SIZE - length);
+  }
+
+  frameDecoderInit(&decoder, mode, ring, RING_SIZE, 0);
+  for (i = 0; i < 2 * sizeof(bytes); i++) {
+    if (!frameDecode(&decoder, length, &frame) || (frame.length != i % 2)) {
+      passed = false;
+      break;
+    }
+    if (frame.length == 1) {
+      frameSpan(&decoder, &frame, 0, &data);
+      passed = passed && (data[0] == bytes[i / 2]);
+    }
+  }
+  passed = passed && !frameDecode(&decoder, length, &frame);
+
+  if (!passed) {
+    printf("%s short frames: FAILED\n", name);
+  }
+  return passed;
+}
+
+static double seconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Measure the encode and decode throughput on BENCH_PAYLOAD byte frames,
+ *    in MB of payload per second.
+ ******************************************************************************/
+static void runBenchmark(FrameMode_t mode, const char *name, int pattern)
+{
+  static uint8_t benchRing[4096];
+  FrameDecoder_t decoder;
+  Frame_t frame;
+  uint32_t frames = BENCH_BYTES / BENCH_PAYLOAD;
+  uint32_t length = 0;
+  uint32_t position = 0;
+  uint32_t checksum = 0;
+  uint32_t i;
+  double start;
+  double encodeTime;
+  double decodeTime = 0;
+
+  for (i = 0; i < BENCH_PAYLOAD; i++) {
+    payload[i] = pattern ? (uint8_t)((i % 5) ? 0 : 0xC0) : (uint8_t)rng();
+  }
+
+  start = seconds();
+  for (i = 0; i < frames; i++) {
+    payload[0] = (uint8_t)i;
+    length = frameEncode(mode, payload, BENCH_PAYLOAD, encoded,
+                         sizeof(encoded));
+    checksum += encoded[length / 2];
+  }
+  encodeTime = seconds() - start;
+
+  // Decode the same frame over and over, copying it in first
+  frameDecoderInit(&decoder, mode, benchRing, sizeof(benchRing), 0);
+  for (i = 0; i < frames; i++) {
+    memcpy(&benchRing[position % sizeof(benchRing)], encoded, length);
+    start = seconds();
+    frameDecode(&decoder, position + length, &frame);
+    decodeTime += seconds() - start;
+    position += sizeof(benchRing) / 2;
+    frameDecoderResync(&decoder, position);
+    decoder.hunting = false;
+  }
+
+  printf("%-16s encode %7.1f MB/s, decode %7.1f MB/s (%u)\n", name,
+         BENCH_BYTES / encodeTime / 1e6, BENCH_BYTES / decodeTime / 1e6,
+         (unsigned)(checksum & 1));
+}
+
+int main(void)
+{
+  static const uint8_t check[] = "123456789";
+  bool passed = true;
+
+  // Check value of CRC-16/CCITT-FALSE
+  if (frameCrc16(0xFFFF, check, 9) != 0x29B1) {
+    printf("CRC: FAILED\n");
+    passed = false;
+  }
+
+  passed = runShortFrames(frameModeCobs, "COBS") && passed;
+  passed = runShortFrames(frameModeSlip, "SLIP") && passed;
+  passed = runFuzz(frameModeCobs, "COBS") && passed;
+  passed = runFuzz(frameModeSlip, "SLIP") && passed;
+
+  runBenchmark(frameModeCobs, "COBS random", 0);
+  runBenchmark(frameModeCobs, "COBS sparse", 1);
+  runBenchmark(frameModeSlip, "SLIP random", 0);
+  runBenchmark(frameModeSlip, "SLIP escapes", 1);
+
+  printf(passed ? "PASSED\n" : "FAILED\n");
+  return passed ? 0 : 1;
+}
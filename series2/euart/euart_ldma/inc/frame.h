@@ -0,0 +1,126 @@
+/***************************************************************************//**
+ * @file frame.h
+ * @brief COBS and SLIP framing with a CRC, encoding straight into a transmit
+ * buffer and decoding in place in a receive ring
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  frameModeCobs,              // Consistent overhead byte stuffing, ends in 0x00
+  frameModeSlip               // RFC 1055 byte stuffing, ends in 0xC0
+} FrameMode_t;
+
+// Every frame ends in a CRC-16/CCITT (polynomial 0x1021, initial value
+// 0xFFFF) of its payload, sent most significant byte first
+#define FRAME_CRC_SIZE              2
+
+// Size of the buffer frameEncode() needs for a payload of length bytes in
+// either mode
+#define FRAME_ENCODED_MAX(length)   (2 * ((length) + FRAME_CRC_SIZE) + 2)
+
+// Frame being encoded, see frameEncodeStart()
+typedef struct {
+  FrameMode_t mode;
+  uint8_t *out;
+  uint32_t size;
+  uint32_t length;            // Bytes written to out so far
+  uint32_t codePos;           // COBS: code byte of the current block
+  uint16_t crc;               // CRC of the payload so far
+  uint8_t code;               // COBS: code of the current block
+  bool overflow;              // out is too small
+} FrameEncoder_t;
+
+// A decoded frame in the ring, from position start on (modulo the ring size)
+typedef struct {
+  uint32_t start;
+  uint32_t length;            // Payload bytes, without the CRC
+} Frame_t;
+
+/*
+ * The decoder works on a ring that a receiver fills in, e.g. an LDMA ring
+ * read with ldmaRingSpan(). Positions count bytes since the start of reception and
+ * wrap around with the ring. Decoded bytes are written back into the ring
+ * behind the encoded bytes, which is possible because neither encoding
+ * ever decodes into more bytes than it takes. The CRC is updated with
+ * every decoded byte, so a frame is checked as soon as its delimiter is
+ * read, without another pass over it or a copy.
+ *
+ * The ring may be released up to frameDecoderConsumed() once the frames
+ * returned so far have been processed.
+ */
+typedef struct {
+  FrameMode_t mode;
+  uint8_t *buffer;            // Ring, size bytes
+  uint32_t size;              // Power of two
+  uint32_t in;                // Position of the next byte to decode
+  uint32_t out;               // Position the next decoded byte goes to
+  uint32_t start;             // Position of the frame being decoded
+  uint16_t crc;               // CRC of the bytes decoded so far
+  uint8_t remaining;          // COBS: data bytes left in the block
+  bool zero;                  // COBS: the block is followed by a zero
+  bool escape;                // SLIP: escape byte read
+  bool hunting;               // Skipping to the next delimiter
+  uint32_t frames;            // Frames decoded
+  uint32_t errors;            // Frames dropped for their encoding or CRC
+} FrameDecoder_t;
+
+uint16_t frameCrc16(uint16_t crc, const uint8_t *data, uint32_t length);
+void frameEncodeStart(FrameEncoder_t *encoder, FrameMode_t mode,
+                      uint8_t *out, uint32_t size);
+bool frameEncodeAppend(FrameEncoder_t *encoder, const uint8_t *data,
+                       uint32_t length);
+uint32_t frameEncodeEnd(FrameEncoder_t *encoder);
+uint32_t frameEncode(FrameMode_t mode, const uint8_t *payload,
+                     uint32_t length, uint8_t *out, uint32_t size);
+void frameDecoderInit(FrameDecoder_t *decoder, FrameMode_t mode,
+                      uint8_t *buffer, uint32_t size, uint32_t position);
+void frameDecoderResync(FrameDecoder_t *decoder, uint32_t position);
+bool frameDecode(FrameDecoder_t *decoder, uint32_t end, Frame_t *frame);
+uint32_t frameDecoderConsumed(const FrameDecoder_t *decoder);
+uint32_t frameSpan(const FrameDecoder_t *decoder, const Frame_t *frame,
+                   uint32_t offset, const uint8_t **data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_H
@@ -0,0 +1,101 @@
+/***************************************************************************//**
+ * @file ldma_ring.h
+ * @brief Zero-copy LDMA ring buffer for continuous peripheral receive.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef LDMA_RING_H
+#define LDMA_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_ldma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The ring is a looping list of numSegments LINKREL descriptors, each
+ * filling one segment of the buffer and raising DONE. head counts segments
+ * filled by the LDMA and is only written from the LDMA IRQ handler; tail
+ * counts segments released by the application and is only written from
+ * the main loop, so neither side needs a critical section.
+ *
+ * Up to numSegments - 1 completed segments can be held by the application
+ * while the LDMA fills the remaining one.
+ *
+ * For byte streams, ldmaRingAvailable(), ldmaRingSpan() and ldmaRingConsume()
+ * read the data in place at unit granularity instead, including the segment
+ * still being filled. readTotal counts units consumed; data overwritten
+ * before it was consumed is skipped and counted in dropped. Use either the
+ * segment or the stream functions on a ring, not both.
+ */
+typedef struct
+{
+  LDMA_Descriptor_t *desc;          // One descriptor per segment
+  uint8_t           *buffer;        // numSegments * segmentBytes bytes
+  uint32_t          segmentBytes;   // Bytes per segment
+  LDMA_CtrlSize_t   unitSize;       // Size of each unit
+  uint32_t          numSegments;    // Power of two, at least 2
+  int               channel;        // LDMA channel
+  volatile uint32_t head;           // Producer index, segments filled
+  volatile uint32_t tail;           // Consumer index, segments released
+  uint32_t          overruns;       // Segments overwritten before release
+  uint32_t          readTotal;      // Stream units consumed
+  uint32_t          dropped;        // Stream units overwritten unconsumed
+} LdmaRing_t;
+
+void ldmaRingInit(LdmaRing_t *ring,
+                  int channel,
+                  LDMA_Descriptor_t *desc,
+                  void *buffer,
+                  uint32_t numSegments,
+                  uint32_t unitsPerSegment,
+                  LDMA_CtrlSize_t unitSize,
+                  volatile const void *srcAddr);
+void ldmaRingStart(LdmaRing_t *ring, const LDMA_TransferCfg_t *transfer);
+void ldmaRingStop(LdmaRing_t *ring);
+bool ldmaRingIrqHandler(LdmaRing_t *ring, uint32_t pending);
+uint32_t ldmaRingCount(LdmaRing_t *ring);
+void *ldmaRingPeek(LdmaRing_t *ring);
+bool ldmaRingRelease(LdmaRing_t *ring);
+uint32_t ldmaRingWritten(LdmaRing_t *ring);
+uint32_t ldmaRingAvailable(LdmaRing_t *ring);
+uint32_t ldmaRingSpan(LdmaRing_t *ring, const void **data);
+void ldmaRingConsume(LdmaRing_t *ring, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LDMA_RING_H
@@ -0,0 +1,457 @@
+/***************************************************************************//**
+ * @file frame.c
+ * @brief COBS and SLIP framing with a CRC, encoding straight into a transmit
+ * buffer and decoding in place in a receive ring
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "em_assert.h"
+#include "frame.h"
+
+// Frame delimiters
+#define COBS_END  0x00
+#define SLIP_END  0xC0
+
+// SLIP escape sequences
+#define SLIP_ESC      0xDB
+#define SLIP_ESC_END  0xDC
+#define SLIP_ESC_ESC  0xDD
+
+#define CRC_INIT  0xFFFF
+
+// CRC-16/CCITT of each byte value
+static const uint16_t crcTable[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+// Update a CRC with one byte
+#define CRC_UPDATE(crc, byte) \
+  ((uint16_t)(((crc) << 8) ^ crcTable[(((crc) >> 8) ^ (byte)) & 0xFF]))
+
+/**************************************************************************//**
+ * @brief
+ *    Continue a CRC-16/CCITT over length bytes
+ *
+ * @param[in] crc
+ *    0xFFFF to start a CRC, or the CRC of the preceding bytes
+ *
+ * @return
+ *    CRC of the bytes so far. Continuing it over the CRC itself, most
+ *    significant byte first, gives 0.
+ *****************************************************************************/
+uint16_t frameCrc16(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+  while (length--) {
+    crc = CRC_UPDATE(crc, *data++);
+  }
+  return crc;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Encode bytes after the ones encoded so far and add them to the CRC,
+ *    without checking the space left
+ *****************************************************************************/
+static void encodeBytes(FrameEncoder_t *encoder, const uint8_t *data,
+                        uint32_t length)
+{
+  uint8_t *out = encoder->out;
+  uint32_t o = encoder->length;
+  uint32_t codePos = encoder->codePos;
+  uint16_t crc = encoder->crc;
+  uint8_t code = encoder->code;
+  uint8_t b;
+
+  if (encoder->mode == frameModeCobs) {
+    while (length--) {
+      b = *data++;
+      crc = CRC_UPDATE(crc, b);
+      if (b != 0) {
+        out[o++] = b;
+        code++;
+      }
+      // A zero, or 254 bytes without one, end the block
+      if ((b == 0) || (code == 0xFF)) {
+        out[codePos] = code;
+        codePos = o++;
+        code = 1;
+      }
+    }
+  } else {
+    while (length--) {
+      b = *data++;
+      crc = CRC_UPDATE(crc, b);
+      if (b == SLIP_END) {
+        out[o++] = SLIP_ESC;
+        out[o++] = SLIP_ESC_END;
+      } else if (b == SLIP_ESC) {
+        out[o++] = SLIP_ESC;
+        out[o++] = SLIP_ESC_ESC;
+      } else {
+        out[o++] = b;
+      }
+    }
+  }
+
+  encoder->length = o;
+  encoder->codePos = codePos;
+  encoder->crc = crc;
+  encoder->code = code;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start encoding a frame into out
+ *
+ * @details
+ *    The frame is written straight into out, e.g. the buffer the transmit
+ *    LDMA channel sends from, and the CRC is computed in the same pass.
+ *    COBS frames are the payload and CRC with their zeros replaced by the
+ *    distance to the next zero, followed by a 0x00 delimiter. SLIP frames
+ *    escape 0xC0 and 0xDB and end in a 0xC0 delimiter.
+ *
+ * @param[in] size
+ *    Size of out, at least FRAME_ENCODED_MAX() of the payload length
+ *****************************************************************************/
+void frameEncodeStart(FrameEncoder_t *encoder, FrameMode_t mode,
+                      uint8_t *out, uint32_t size)
+{
+  encoder->mode = mode;
+  encoder->out = out;
+  encoder->size = size;
+  encoder->crc = CRC_INIT;
+  encoder->codePos = 0;
+  encoder->code = 1;
+  encoder->overflow = false;
+
+  // The first COBS code byte is filled in once the first block ends
+  encoder->length = (mode == frameModeCobs) ? 1 : 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Add payload bytes to the frame, e.g. each span of a payload that wraps
+ *    around a ring
+ *
+ * @return
+ *    false if out may not have room for the bytes, they are not added and
+ *    frameEncodeEnd() fails
+ *****************************************************************************/
+bool frameEncodeAppend(FrameEncoder_t *encoder, const uint8_t *data,
+                       uint32_t length)
+{
+  if (encoder->overflow
+      || (FRAME_ENCODED_MAX(length) - 2 * FRAME_CRC_SIZE
+          > encoder->size - encoder->length)) {
+    encoder->overflow = true;
+    return false;
+  }
+
+  encodeBytes(encoder, data, length);
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Add the CRC and the delimiter
+ *
+ * @return
+ *    Bytes of the encoded frame, or 0 if out was too small
+ *****************************************************************************/
+uint32_t frameEncodeEnd(FrameEncoder_t *encoder)
+{
+  uint8_t crcBytes[FRAME_CRC_SIZE];
+
+  if (encoder->overflow
+      || (FRAME_ENCODED_MAX(0) > encoder->size - encoder->length)) {
+    return 0;
+  }
+
+  crcBytes[0] = (uint8_t)(encoder->crc >> 8);
+  crcBytes[1] = (uint8_t)encoder->crc;
+  encodeBytes(encoder, crcBytes, FRAME_CRC_SIZE);
+
+  if (encoder->mode == frameModeCobs) {
+    encoder->out[encoder->codePos] = encoder->code;
+    encoder->out[encoder->length++] = COBS_END;
+  } else {
+    encoder->out[encoder->length++] = SLIP_END;
+  }
+
+  return encoder->length;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Encode a payload and its CRC as one frame
+ *
+ * @param[in] size
+ *    Size of out, at least FRAME_ENCODED_MAX(length)
+ *
+ * @return
+ *    Bytes of the encoded frame, or 0 if out is too small
+ *****************************************************************************/
+uint32_t frameEncode(FrameMode_t mode, const uint8_t *payload,
+                     uint32_t length, uint8_t *out, uint32_t size)
+{
+  FrameEncoder_t encoder;
+
+  frameEncodeStart(&encoder, mode, out, size);
+  frameEncodeAppend(&encoder, payload, length);
+  return frameEncodeEnd(&encoder);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start a new frame at the next byte to decode
+ *****************************************************************************/
+static void startFrame(FrameDecoder_t *decoder)
+{
+  decoder->start = decoder->in;
+  decoder->out = decoder->in;
+  decoder->crc = CRC_INIT;
+  decoder->remaining = 0;
+  decoder->zero = false;
+  decoder->escape = false;
+  decoder->hunting = false;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start decoding a ring
+ *
+ * @param[in] buffer
+ *    Ring the received bytes are written into
+ *
+ * @param[in] size
+ *    Size of the ring in bytes, a power of two
+ *
+ * @param[in] position
+ *    Position of the first byte of the first frame
+ *****************************************************************************/
+void frameDecoderInit(FrameDecoder_t *decoder, FrameMode_t mode,
+                      uint8_t *buffer, uint32_t size, uint32_t position)
+{
+  EFM_ASSERT((size >= 2) && ((size & (size - 1)) == 0));
+
+  decoder->mode = mode;
+  decoder->buffer = buffer;
+  decoder->size = size;
+  decoder->in = position;
+  decoder->frames = 0;
+  decoder->errors = 0;
+  startFrame(decoder);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Continue from position, e.g. after the receive ring dropped data,
+ *    skipping bytes up to the next delimiter
+ *****************************************************************************/
+void frameDecoderResync(FrameDecoder_t *decoder, uint32_t position)
+{
+  decoder->in = position;
+  startFrame(decoder);
+  decoder->hunting = true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Decode received bytes up to the next complete frame
+ *
+ * @details
+ *    Frames with a bad encoding or CRC and frames shorter than the CRC are
+ *    dropped and counted in errors. Empty frames, e.g. a delimiter sent
+ *    ahead of each frame, are skipped.
+ *
+ * @param[in] end
+ *    Position after the last received byte
+ *
+ * @param[out] frame
+ *    The next frame, its payload is in the ring
+ *
+ * @return
+ *    true if a frame was decoded, false once all bytes up to end have been
+ *    decoded without completing one. Call again with more bytes.
+ *****************************************************************************/
+bool frameDecode(FrameDecoder_t *decoder, uint32_t end, Frame_t *frame)
+{
+  uint8_t *buffer = decoder->buffer;
+  uint32_t mask = decoder->size - 1;
+  uint32_t in = decoder->in;
+  uint32_t out = decoder->out;
+  uint16_t crc = decoder->crc;
+  uint8_t delimiter = (decoder->mode == frameModeCobs) ? COBS_END : SLIP_END;
+  uint32_t length;
+  bool valid;
+  uint8_t b;
+
+  while (in != end) {
+    b = buffer[in & mask];
+    in++;
+
+    if (b == delimiter) {
+      length = out - decoder->start;
+      valid = !decoder->hunting && (decoder->remaining == 0)
+              && !decoder->escape;
+      decoder->in = in;
+
+      if (valid && (length >= FRAME_CRC_SIZE) && (crc == 0)) {
+        frame->start = decoder->start;
+        frame->length = length - FRAME_CRC_SIZE;
+        decoder->frames++;
+        startFrame(decoder);
+        return true;
+      }
+      if (!decoder->hunting && (length > 0 || !valid)) {
+        decoder->errors++;
+      }
+      startFrame(decoder);
+      out = decoder->out;
+      crc = decoder->crc;
+      continue;
+    }
+
+    if (decoder->hunting) {
+      continue;
+    }
+
+    if (decoder->mode == frameModeCobs) {
+      if (decoder->remaining == 0) {
+        // Code byte, the previous block may end in a zero
+        if (decoder->zero) {
+          buffer[out & mask] = 0;
+          out++;
+          crc = CRC_UPDATE(crc, 0);
+        }
+        decoder->remaining = b - 1;
+        decoder->zero = (b != 0xFF);
+      } else {
+        buffer[out & mask] = b;
+        out++;
+        crc = CRC_UPDATE(crc, b);
+        decoder->remaining--;
+      }
+    } else {
+      if (decoder->escape) {
+        decoder->escape = false;
+        if (b == SLIP_ESC_END) {
+          b = SLIP_END;
+        } else if (b == SLIP_ESC_ESC) {
+          b = SLIP_ESC;
+        } else {
+          // Not a valid escape sequence, drop the frame
+          decoder->errors++;
+          decoder->hunting = true;
+          continue;
+        }
+      } else if (b == SLIP_ESC) {
+        decoder->escape = true;
+        continue;
+      }
+      buffer[out & mask] = b;
+      out++;
+      crc = CRC_UPDATE(crc, b);
+    }
+  }
+
+  decoder->in = in;
+  decoder->out = out;
+  decoder->crc = crc;
+  return false;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Position up to which the ring may be released once the frames
+ *    returned by frameDecode() have been processed
+ *****************************************************************************/
+uint32_t frameDecoderConsumed(const FrameDecoder_t *decoder)
+{
+  return decoder->hunting ? decoder->in : decoder->start;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Get the payload of a frame without copying it
+ *
+ * @param[in] offset
+ *    First payload byte to get
+ *
+ * @param[out] data
+ *    Set to the payload byte at offset
+ *
+ * @return
+ *    Number of bytes that can be read from data, less than the rest of the
+ *    payload if it wraps around the end of the ring
+ *****************************************************************************/
+uint32_t frameSpan(const FrameDecoder_t *decoder, const Frame_t *frame,
+                   uint32_t offset, const uint8_t **data)
+{
+  uint32_t start = (frame->start + offset) & (decoder->size - 1);
+  uint32_t length = frame->length - offset;
+
+  *data = &decoder->buffer[start];
+  return (length < decoder->size - start) ? length : decoder->size - start;
+}
@@ -2,8 +2,8 @@
  * @file main_xg2x.c
  * @brief This project shows how to configure the EUART for using LDMA to write
  * and read to the EUART transmit/receive registers while remaining in EM2. This
- * example receives input from the serial terminal device and echoes it back.
- * See the readme.txt for details.
+ * example receives input into a circular LDMA buffer and echoes it back when
+ * the receive line goes idle. See the readme.txt for details.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -40,25 +40,58 @@
 #include "em_device.h"
 #include "em_chip.h"
 #include "em_cmu.h"
+#include "em_core.h"
 #include "em_emu.h"
 #include "em_eusart.h"
 #include "em_gpio.h"
 #include "em_ldma.h"
 #include "mx25flash_spi.h"
 #include "bspconfig.h"
+#include "ldma_ring.h"
+#include "frame.h"
 
-// Size of the buffer for received data
-#define BUFLEN  90
+// Size of the receive ring, a power of two
+#define RX_RING_SIZE  128
 
-// Receive data buffer
-uint8_t buffer[BUFLEN];
+// Define to echo COBS or SLIP frames instead of raw bytes, see readme.txt
+// #define ECHO_FRAMES  frameModeCobs
 
-// Current position ins buffer
-uint32_t inpos = 0;
-uint32_t outpos = 0;
+// Define to measure encoding and decoding with the DWT cycle counter
+// #define FRAME_BENCHMARK
 
-// True while receiving data (waiting for CR or BUFLEN characters)
-bool receive = true;
+// LDMA channels
+#define RX_LDMA_CHANNEL  0
+#define TX_LDMA_CHANNEL  1
+
+// Receive ring, written by the LDMA in two halves of one descriptor each
+uint8_t rxBuffer[RX_RING_SIZE];
+LDMA_Descriptor_t rxDescriptors[2];
+LdmaRing_t rxRing;
+
+// Set by the RX timeout interrupt when the receive line has gone idle
+volatile bool rxIdle = false;
+
+// Bytes of the ring being echoed by the Tx channel
+uint32_t txLength = 0;
+volatile bool txBusy = false;
+
+#if defined(ECHO_FRAMES)
+// Frames are decoded in place in rxBuffer and encoded again into txFrame
+FrameDecoder_t decoder;
+uint8_t txFrame[FRAME_ENCODED_MAX(RX_RING_SIZE)];
+#endif
+
+#if defined(FRAME_BENCHMARK)
+// Payload bytes of the benchmark frame
+#define BENCHMARK_PAYLOAD  100
+
+// Cycles to encode and to decode the benchmark frame in each mode, view in
+// the Expressions window
+uint32_t cyclesEncodeCobs;
+uint32_t cyclesDecodeCobs;
+uint32_t cyclesEncodeSlip;
+uint32_t cyclesDecodeSlip;
+#endif
 
 #define RETARGET_TXPORT      gpioPortA                    /* EUSART transmission port */
 #define RETARGET_TXPIN       5                            /* EUSART transmission pin */
@@ -117,43 +150,192 @@ void initEusart0(void)
   EUSART_UartInit_TypeDef init = EUSART_UART_INIT_DEFAULT_LF;
   EUSART_AdvancedInit_TypeDef advance_init = EUSART_ADVANCED_INIT_DEFAULT;
   init.baudrate = BAUDRATE;
+  init.enable = eusartDisable;
   init.advancedSettings = &advance_init;
   init.advancedSettings->dmaWakeUpOnRx = true;
-  init.advancedSettings->dmaWakeUpOnTx = false;
+  init.advancedSettings->dmaWakeUpOnTx = true;
   init.advancedSettings->dmaHaltOnError = true;
   EUSART_UartInitLf(EUART0, &init);
+
+  // Flag the end of a frame when the line has been idle for three
+  // characters, CFG1 can only be written while the EUART is disabled
+  EUART0->EN_CLR = EUSART_EN_EN;
+  EUART0->CFG1 = (EUART0->CFG1 & ~_EUSART_CFG1_RXTIMEOUT_MASK)
+                 | EUSART_CFG1_RXTIMEOUT_THREEFRAMES;
+  EUART0->EN_SET = EUSART_EN_EN;
+  EUSART_Enable(EUART0, eusartEnable);
+
+  // The RX timeout wakes the device from EM2
+  EUSART_IntClear(EUART0, EUSART_IF_RXTOIF);
+  EUSART_IntEnable(EUART0, EUSART_IEN_RXTOIEN);
+  NVIC_ClearPendingIRQ(EUART0_RX_IRQn);
+  NVIC_EnableIRQ(EUART0_RX_IRQn);
 }
 
 /**************************************************************************//**
  * @brief
  *    LDMA initialization
+ *
+ * @details
+ *    The Rx channel writes every received byte into rxRing and never stops.
+ *    The Tx channel is started by main() for each block that is echoed.
  *****************************************************************************/
 void initLdma(void)
 {
   // Enable LDMA Clock
   CMU_ClockEnable(cmuClock_LDMA, true);
 
-  // Channel descriptor configuration
-  static LDMA_Descriptor_t descriptor =
-    LDMA_DESCRIPTOR_SINGLE_P2P_BYTE(&(EUART0->RXDATA), // Peripheral source address
-                                    &(EUART0->TXDATA), // Peripheral destination address
-                                    4);               // Number of bytes per transfer
-  descriptor.xfer.doneIfs  = 0;               // Don't trigger interrupt when done
-  descriptor.xfer.linkMode = ldmaLinkModeRel; // Relative addressing to get next link
-  descriptor.xfer.link     = 1;               // Enable descriptor linking
-  descriptor.xfer.linkAddr = 0;               // Link to same descriptor
-
-  // Transfer configuration and trigger selection
-  LDMA_TransferCfg_t transferConfig =
-    LDMA_TRANSFER_CFG_PERIPHERAL(LDMAXBAR_CH_REQSEL_SIGSEL_EUART0RXFL|LDMAXBAR_CH_REQSEL_SOURCESEL_EUART0);
-
   // LDMA initialization
   LDMA_Init_t init = LDMA_INIT_DEFAULT;
   LDMA_Init(&init);
 
-  // Start the transfer
-  uint32_t channelNum = 0;
-  LDMA_StartTransfer(channelNum, &transferConfig, &descriptor);
+  // Start receiving into the ring
+  LDMA_TransferCfg_t transferConfig =
+    LDMA_TRANSFER_CFG_PERIPHERAL(LDMAXBAR_CH_REQSEL_SIGSEL_EUART0RXFL|LDMAXBAR_CH_REQSEL_SOURCESEL_EUART0);
+  ldmaRingInit(&rxRing, RX_LDMA_CHANNEL, rxDescriptors, rxBuffer, 2,
+               RX_RING_SIZE / 2, ldmaCtrlSizeByte, &EUART0->RXDATA);
+  ldmaRingStart(&rxRing, &transferConfig);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Echo bytes straight from the ring, without copying them
+ *****************************************************************************/
+void startEcho(const uint8_t *data, uint32_t length)
+{
+  static LDMA_Descriptor_t descriptor;
+  LDMA_TransferCfg_t transferConfig =
+    LDMA_TRANSFER_CFG_PERIPHERAL(LDMAXBAR_CH_REQSEL_SIGSEL_EUART0TXFL|LDMAXBAR_CH_REQSEL_SOURCESEL_EUART0);
+
+  descriptor = (LDMA_Descriptor_t)
+    LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(data, &(EUART0->TXDATA), length);
+
+  txLength = length;
+  txBusy = true;
+  LDMA_StartTransfer(TX_LDMA_CHANNEL, &transferConfig, &descriptor);
+}
+
+#if defined(ECHO_FRAMES)
+/**************************************************************************//**
+ * @brief
+ *    Decode the received bytes and echo the next complete frame
+ *
+ * @details
+ *    The payload is decoded in place in the ring and encoded again straight
+ *    into txFrame, a span at a time if it wraps around the end of the ring.
+ *    The ring is released up to the bytes the decoder no longer needs.
+ *****************************************************************************/
+void echoFrame(void)
+{
+  FrameEncoder_t encoder;
+  Frame_t frame;
+  const uint8_t *data;
+  uint32_t available = ldmaRingAvailable(&rxRing);
+  uint32_t offset;
+  uint32_t span;
+
+  // The ring overran and dropped bytes the decoder still needed, skip to
+  // the next frame
+  if (rxRing.readTotal != frameDecoderConsumed(&decoder)) {
+    frameDecoderResync(&decoder, rxRing.readTotal);
+  }
+
+  if (frameDecode(&decoder, rxRing.readTotal + available, &frame)) {
+    frameEncodeStart(&encoder, ECHO_FRAMES, txFrame, sizeof(txFrame));
+    for (offset = 0; offset < frame.length; offset += span) {
+      span = frameSpan(&decoder, &frame, offset, &data);
+      frameEncodeAppend(&encoder, data, span);
+    }
+    startEcho(txFrame, frameEncodeEnd(&encoder));
+  }
+
+  ldmaRingConsume(&rxRing,
+                  frameDecoderConsumed(&decoder) - rxRing.readTotal);
+}
+#endif
+
+#if defined(FRAME_BENCHMARK)
+/**************************************************************************//**
+ * @brief
+ *    Time encoding and decoding a frame with the DWT cycle counter
+ *
+ * @details
+ *    The frame is encoded into a ring and decoded in place, as the echo
+ *    does. Both modes are timed on the same payload, which has as many
+ *    bytes to escape as bytes that don't need it.
+ *****************************************************************************/
+void benchmarkFrames(void)
+{
+  static uint8_t payload[BENCHMARK_PAYLOAD];
+  static uint8_t ring[256];
+  FrameDecoder_t benchmarkDecoder;
+  Frame_t frame;
+  uint32_t length;
+  uint32_t start;
+  uint32_t i;
+
+  EFM_ASSERT(FRAME_ENCODED_MAX(BENCHMARK_PAYLOAD) <= sizeof(ring));
+
+  for (i = 0; i < BENCHMARK_PAYLOAD; i++) {
+    payload[i] = (i & 1) ? (uint8_t)i : 0xC0;
+  }
+
+  // Enable the cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  length = frameEncode(frameModeCobs, payload, BENCHMARK_PAYLOAD,
+                       ring, sizeof(ring));
+  cyclesEncodeCobs = DWT->CYCCNT - start;
+
+  frameDecoderInit(&benchmarkDecoder, frameModeCobs, ring, sizeof(ring), 0);
+  start = DWT->CYCCNT;
+  frameDecode(&benchmarkDecoder, length, &frame);
+  cyclesDecodeCobs = DWT->CYCCNT - start;
+  EFM_ASSERT(frame.length == BENCHMARK_PAYLOAD);
+
+  start = DWT->CYCCNT;
+  length = frameEncode(frameModeSlip, payload, BENCHMARK_PAYLOAD,
+                       ring, sizeof(ring));
+  cyclesEncodeSlip = DWT->CYCCNT - start;
+
+  frameDecoderInit(&benchmarkDecoder, frameModeSlip, ring, sizeof(ring), 0);
+  start = DWT->CYCCNT;
+  frameDecode(&benchmarkDecoder, length, &frame);
+  cyclesDecodeSlip = DWT->CYCCNT - start;
+  EFM_ASSERT(frame.length == BENCHMARK_PAYLOAD);
+}
+#endif
+
+/**************************************************************************//**
+ * @brief
+ *    EUART0 RX interrupt handler, the receive line has gone idle
+ *****************************************************************************/
+void EUART0_RX_IRQHandler(void)
+{
+  EUSART_IntClear(EUART0, EUSART_IF_RXTOIF);
+  rxIdle = true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    LDMA interrupt handler
+ *****************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGet();
+
+  LDMA_IntClear(pending);
+
+  // A half of the ring has been filled
+  ldmaRingIrqHandler(&rxRing, pending);
+
+  // The echo has been sent
+  if (pending & (1 << TX_LDMA_CHANNEL)) {
+    txBusy = false;
+  }
 }
 
 /**************************************************************************//**
@@ -161,6 +343,14 @@ void initLdma(void)
  *****************************************************************************/
 int main(void)
 {
+#if !defined(ECHO_FRAMES)
+  const void *data;
+  uint32_t available;
+  uint32_t length;
+  bool idle;
+#endif
+  CORE_DECLARE_IRQ_STATE;
+
   // Chip errata
   CHIP_Init();
 
@@ -179,14 +369,70 @@ int main(void)
   MX25_DP();
   MX25_deinit();
 
+#if defined(FRAME_BENCHMARK)
+  benchmarkFrames();
+#endif
+
   // Initialize Clock, GPIO, EUSART and LDMA
   initClock();
   initGpio();
   initEusart0();
   initLdma();
 
-  while (1){
-    // Won't exit EM2
-	EMU_EnterEM2(false);
+#if defined(ECHO_FRAMES)
+  frameDecoderInit(&decoder, ECHO_FRAMES, rxBuffer, RX_RING_SIZE, 0);
+
+  while (1) {
+    if (!txBusy) {
+      rxIdle = false;
+      echoFrame();
+    }
+
+    // Stay in EM2 until the line goes idle, half of the ring fills up with
+    // bytes that have not been decoded or the echo is done. Frames that
+    // arrived back to back are decoded once the echo of the one before
+    // them is done.
+    CORE_ENTER_ATOMIC();
+    if (txBusy || (!rxIdle
+                   && (rxRing.readTotal + ldmaRingAvailable(&rxRing)
+                       - decoder.in < RX_RING_SIZE / 2))) {
+      EMU_EnterEM2(false);
+    }
+    CORE_EXIT_ATOMIC();
   }
-}
\ No newline at end of file
+#else
+  while (1) {
+    if (!txBusy) {
+      // Release the bytes that have been echoed
+      ldmaRingConsume(&rxRing, txLength);
+      txLength = 0;
+
+      CORE_ENTER_ATOMIC();
+      idle = rxIdle;
+      rxIdle = false;
+      CORE_EXIT_ATOMIC();
+
+      // Echo once the line is idle, or once half of the ring has filled up
+      // so that long frames don't overrun it. Data that wraps around the end
+      // of the ring is sent in two blocks.
+      available = ldmaRingAvailable(&rxRing);
+      if ((idle || (available >= RX_RING_SIZE / 2)) && available) {
+        length = ldmaRingSpan(&rxRing, &data);
+        if (length < available) {
+          rxIdle = true;
+        }
+        startEcho(data, length);
+      }
+    }
+
+    // Stay in EM2 until the line goes idle, half of the ring fills up or
+    // the echo is done
+    CORE_ENTER_ATOMIC();
+    if (txBusy || (!rxIdle
+                   && ldmaRingAvailable(&rxRing) < RX_RING_SIZE / 2)) {
+      EMU_EnterEM2(false);
+    }
+    CORE_EXIT_ATOMIC();
+  }
+#endif
+}
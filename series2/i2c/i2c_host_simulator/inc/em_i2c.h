@@ -0,0 +1,271 @@
+/***************************************************************************//**
+ * @file em_i2c.h
+ * @brief Host replacement for the I2C registers and the emlib I2C API, backed by
+ * the bus model in src/i2c_sim.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_I2C_H
+#define EM_I2C_H
+
+#include "em_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Commands a handler can write in one call, see the CMD macro below
+#define I2CSIM_MAX_COMMANDS         8
+
+/*
+ * I2C register block of series 0, 1 and 2 devices. The model reacts to
+ * register accesses after each call of the IRQ handler, except for reads of
+ * RXDATA and writes of CMD, which go through the RXDATA and CMD macros at
+ * the end of this file so that it sees every one of them, as the hardware
+ * does. The series 2 CTRL_SET and CTRL_CLR aliases are applied to CTRL.
+ */
+typedef struct
+{
+  __IOM uint32_t CTRL;            // Control
+  __IOM uint32_t CTRL_SET;        // Set alias of CTRL
+  __IOM uint32_t CTRL_CLR;        // Clear alias of CTRL
+  __IOM uint32_t cmd[I2CSIM_MAX_COMMANDS];  // Commands, written through CMD
+  __IOM uint32_t STATE;           // State
+  __IOM uint32_t STATUS;          // Status
+  __IOM uint32_t SADDR;           // Slave address
+  __IOM uint32_t SADDRMASK;       // Slave address mask
+  __IOM uint32_t rxdata[1];       // Receive buffer, read through RXDATA
+  __IOM uint32_t TXDATA;          // Transmit buffer
+  __IOM uint32_t IF;              // Interrupt flags
+  __IOM uint32_t IEN;             // Interrupt enable
+  __IOM uint32_t ROUTE;           // Series 0 pin routing
+  __IOM uint32_t ROUTEPEN;        // Series 1 pin enable
+  __IOM uint32_t ROUTELOC0;       // Series 1 pin location
+} I2C_TypeDef;
+
+extern I2C_TypeDef i2cSimRegs;
+#define I2C0 (&i2cSimRegs)
+
+#define I2C_CTRL_EN                 (0x1UL << 0)
+#define I2C_CTRL_SLAVE              (0x1UL << 1)
+#define I2C_CTRL_AUTOACK            (0x1UL << 2)
+#define I2C_CTRL_AUTOSE             (0x1UL << 3)
+#define I2C_CTRL_AUTOSN             (0x1UL << 4)
+
+#define I2C_CMD_START               (0x1UL << 0)
+#define I2C_CMD_STOP                (0x1UL << 1)
+#define I2C_CMD_ACK                 (0x1UL << 2)
+#define I2C_CMD_NACK                (0x1UL << 3)
+#define I2C_CMD_CONT                (0x1UL << 4)
+#define I2C_CMD_ABORT               (0x1UL << 5)
+#define I2C_CMD_CLEARTX             (0x1UL << 6)
+#define I2C_CMD_CLEARPC             (0x1UL << 7)
+
+#define I2C_STATUS_TXBL             (0x1UL << 7)
+#define I2C_STATUS_RXDATAV          (0x1UL << 8)
+
+// Interrupt flags, with the same bits in IEN and the series 0/1 IFC
+#define I2C_IF_START                (0x1UL << 0)
+#define I2C_IF_RSTART               (0x1UL << 1)
+#define I2C_IF_ADDR                 (0x1UL << 2)
+#define I2C_IF_TXC                  (0x1UL << 3)
+#define I2C_IF_TXBL                 (0x1UL << 4)
+#define I2C_IF_RXDATAV              (0x1UL << 5)
+#define I2C_IF_ACK                  (0x1UL << 6)
+#define I2C_IF_NACK                 (0x1UL << 7)
+#define I2C_IF_MSTOP                (0x1UL << 8)
+#define I2C_IF_ARBLOST              (0x1UL << 9)
+#define I2C_IF_BUSERR               (0x1UL << 10)
+#define I2C_IF_BUSHOLD              (0x1UL << 11)
+#define I2C_IF_TXOF                 (0x1UL << 12)
+#define I2C_IF_RXUF                 (0x1UL << 13)
+#define I2C_IF_BITO                 (0x1UL << 14)
+#define I2C_IF_CLTO                 (0x1UL << 15)
+#define I2C_IF_SSTOP                (0x1UL << 16)
+#define _I2C_IF_MASK                0x0001FFFFUL
+
+#define I2C_IEN_ADDR                I2C_IF_ADDR
+#define I2C_IEN_RXDATAV             I2C_IF_RXDATAV
+#define I2C_IEN_ACK                 I2C_IF_ACK
+#define I2C_IEN_NACK                I2C_IF_NACK
+#define I2C_IEN_MSTOP               I2C_IF_MSTOP
+#define I2C_IEN_ARBLOST             I2C_IF_ARBLOST
+#define I2C_IEN_BUSERR              I2C_IF_BUSERR
+#define I2C_IEN_SSTOP               I2C_IF_SSTOP
+
+#define I2C_IFC_ADDR                I2C_IF_ADDR
+#define I2C_IFC_SSTOP               I2C_IF_SSTOP
+
+// Series 0 pin routing, carried through only
+#define I2C_ROUTE_SDAPEN            (0x1UL << 0)
+#define I2C_ROUTE_SCLPEN            (0x1UL << 1)
+#define _I2C_ROUTE_LOCATION_MASK    0x700UL
+#define I2C_ROUTE_LOCATION_LOC1     (0x1UL << 8)
+
+// Series 1 pin routing, carried through only
+#define I2C_ROUTEPEN_SDAPEN         (0x1UL << 0)
+#define I2C_ROUTEPEN_SCLPEN         (0x1UL << 1)
+#define _I2C_ROUTELOC0_SDALOC_MASK  0x1FUL
+#define _I2C_ROUTELOC0_SCLLOC_MASK  0x1F00UL
+#define I2C_ROUTELOC0_SDALOC_LOC1   (1UL << 0)
+#define I2C_ROUTELOC0_SDALOC_LOC4   (4UL << 0)
+#define I2C_ROUTELOC0_SDALOC_LOC15  (15UL << 0)
+#define I2C_ROUTELOC0_SDALOC_LOC16  (16UL << 0)
+#define I2C_ROUTELOC0_SCLLOC_LOC1   (1UL << 8)
+#define I2C_ROUTELOC0_SCLLOC_LOC4   (4UL << 8)
+#define I2C_ROUTELOC0_SCLLOC_LOC14  (14UL << 8)
+#define I2C_ROUTELOC0_SCLLOC_LOC15  (15UL << 8)
+
+// emlib types
+typedef enum
+{
+  i2cTransferInProgress = 1,
+  i2cTransferDone = 0,
+  i2cTransferNack = -1,
+  i2cTransferBusErr = -2,
+  i2cTransferArbLost = -3,
+  i2cTransferUsageFault = -4,
+  i2cTransferSwFault = -5
+} I2C_TransferReturn_TypeDef;
+
+#define I2C_FLAG_WRITE              0x0001
+#define I2C_FLAG_READ               0x0002
+#define I2C_FLAG_WRITE_READ         0x0004
+#define I2C_FLAG_WRITE_WRITE        0x0008
+
+typedef struct
+{
+  uint16_t addr;
+  uint16_t flags;
+  struct
+  {
+    uint8_t *data;
+    uint16_t len;
+  } buf[2];
+} I2C_TransferSeq_TypeDef;
+
+typedef enum
+{
+  i2cClockHLRStandard,
+  i2cClockHLRAsymetric,
+  i2cClockHLRFast
+} I2C_ClockHLR_TypeDef;
+
+#define I2C_FREQ_STANDARD_MAX       100000
+#define I2C_FREQ_FAST_MAX           392157
+
+typedef struct
+{
+  bool enable;
+  bool master;
+  uint32_t refFreq;
+  uint32_t freq;
+  I2C_ClockHLR_TypeDef clhr;
+} I2C_Init_TypeDef;
+
+#define I2C_INIT_DEFAULT                                                    \
+  {                                                                         \
+    true,                   /* Enable when initialization done */          \
+    true,                   /* Set to master mode */                       \
+    0,                      /* Use currently configured reference clock */ \
+    I2C_FREQ_STANDARD_MAX,  /* Standard rate */                            \
+    i2cClockHLRStandard     /* Duty cycle 4:4 */                           \
+  }
+
+// Bus speed is not modelled, only the mode is kept
+__STATIC_INLINE void I2C_Init(I2C_TypeDef *i2c, const I2C_Init_TypeDef *init)
+{
+  i2c->CTRL = (init->enable ? I2C_CTRL_EN : 0)
+              | (init->master ? 0 : I2C_CTRL_SLAVE);
+}
+
+__STATIC_INLINE void I2C_Enable(I2C_TypeDef *i2c, bool enable)
+{
+  if (enable) {
+    i2c->CTRL |= I2C_CTRL_EN;
+  } else {
+    i2c->CTRL &= ~I2C_CTRL_EN;
+  }
+}
+
+__STATIC_INLINE void I2C_SlaveAddressSet(I2C_TypeDef *i2c, uint8_t addr)
+{
+  i2c->SADDR = addr & 0xFE;
+}
+
+__STATIC_INLINE void I2C_SlaveAddressMaskSet(I2C_TypeDef *i2c, uint8_t mask)
+{
+  i2c->SADDRMASK = mask & 0xFE;
+}
+
+__STATIC_INLINE void I2C_IntClear(I2C_TypeDef *i2c, uint32_t flags)
+{
+  i2c->IF &= ~flags;
+}
+
+__STATIC_INLINE void I2C_IntEnable(I2C_TypeDef *i2c, uint32_t flags)
+{
+  i2c->IEN |= flags;
+}
+
+__STATIC_INLINE void I2C_IntDisable(I2C_TypeDef *i2c, uint32_t flags)
+{
+  i2c->IEN &= ~flags;
+}
+
+__STATIC_INLINE uint32_t I2C_IntGet(I2C_TypeDef *i2c)
+{
+  return i2c->IF;
+}
+
+__STATIC_INLINE uint32_t I2C_IntGetEnabled(I2C_TypeDef *i2c)
+{
+  return i2c->IF & i2c->IEN;
+}
+
+// Master transfers, run against the devices added with I2CSIM_AddDevice()
+I2C_TransferReturn_TypeDef I2C_TransferInit(I2C_TypeDef *i2c,
+                                            I2C_TransferSeq_TypeDef *seq);
+I2C_TransferReturn_TypeDef I2C_Transfer(I2C_TypeDef *i2c);
+
+// Accesses with side effects, reported to the model
+uint32_t I2CSIM_ReadRxData(void);
+uint32_t I2CSIM_WriteCommand(void);
+
+#define RXDATA  rxdata[I2CSIM_ReadRxData()]
+#define CMD     cmd[I2CSIM_WriteCommand()]
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM_I2C_H
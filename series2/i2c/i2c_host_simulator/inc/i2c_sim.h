@@ -0,0 +1,131 @@
+/***************************************************************************//**
+ * @file i2c_sim.h
+ * @brief Host model of an I2C bus, driving the I2C interrupt handlers of the
+ * examples.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef I2C_SIM_H
+#define I2C_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The model plays the other end of the bus. With the I2C peripheral a
+ * slave, the host program is the master and calls I2CSIM_MasterWrite() and
+ * I2CSIM_MasterRead(). With the peripheral a master, emlib I2C_Transfer()
+ * runs against the devices added with I2CSIM_AddDevice().
+ *
+ * Bus events set flags in I2C0->IF, and the handler attached with
+ * I2CSIM_AttachHandler() is called as long as one of them is enabled in
+ * I2C0->IEN, as the NVIC would. The bus waits for the handler or the LDMA:
+ * a received byte is not acknowledged before AUTOACK or an ACK command, the
+ * next byte is not received before RXDATA has been read, and a read does
+ * not go on before a byte has been written to TXDATA. A transfer the slave
+ * never serves ends with i2cSimHang instead of hanging the host.
+ */
+typedef enum
+{
+  i2cSimOk,               // Transfer done, all bytes acknowledged
+  i2cSimNack,             // Address or data byte not acknowledged
+  i2cSimHang,             // The slave held the bus for good
+  i2cSimFault             // Aborted by a fault from I2CSIM_InjectFault()
+} I2CSIM_Result_t;
+
+typedef void (*I2CSIM_Handler_t)(void);
+
+// Interrupts handled without clearing any flag before the bus is declared
+// stuck
+#if !defined(I2CSIM_MAX_IDLE_INTERRUPTS)
+#define I2CSIM_MAX_IDLE_INTERRUPTS  16
+#endif
+
+// Statistics, accumulated until I2CSIM_ResetStats()
+typedef struct
+{
+  uint32_t bytes;               // Data bytes on the bus, without addresses
+  uint32_t interrupts;          // Handler calls
+  uint64_t instructions;        // Host instructions executed by the handler
+  uint32_t transferCalls;       // Calls of I2C_Transfer()
+  uint32_t txOverflows;         // Writes of TXDATA with a byte pending
+  uint32_t stuckInterrupts;     // Handlers returning with the flags set
+} I2CSIM_Stats_t;
+
+// Devices answering master transfers, each with 256 bytes of registers
+#define I2CSIM_MAX_DEVICES          8
+
+typedef struct
+{
+  uint8_t address;              // Write address, bit 0 cleared
+  uint8_t pointer;              // Set by the first byte of each write
+  uint8_t memory[256];          // Registers
+  uint8_t received[256];        // Bytes of the last write, pointer included
+  uint32_t receivedLength;
+  uint32_t writes;              // Write transfers
+  uint32_t reads;               // Read transfers
+} I2CSIM_Device_t;
+
+void I2CSIM_Reset(void);
+void I2CSIM_AttachHandler(I2CSIM_Handler_t handler);
+void I2CSIM_ConnectLdma(int rxChannel, int txChannel);
+
+// The peripheral as a slave
+I2CSIM_Result_t I2CSIM_MasterWrite(uint8_t address, const uint8_t *data,
+                                   uint32_t length, bool stop);
+I2CSIM_Result_t I2CSIM_MasterRead(uint8_t address, uint8_t *data,
+                                  uint32_t length, bool stop);
+void I2CSIM_MasterStop(void);
+
+// The peripheral as a master
+I2CSIM_Device_t *I2CSIM_AddDevice(uint8_t address);
+void I2CSIM_Idle(void);
+bool I2CSIM_MasterBusy(void);
+
+// Faults, raised once afterBytes data bytes of the next transfer are done
+void I2CSIM_InjectFault(uint32_t flag, uint32_t afterBytes);
+
+bool I2CSIM_InstructionsCounted(void);
+void I2CSIM_GetStats(I2CSIM_Stats_t *stats);
+void I2CSIM_ResetStats(void);
+void I2CSIM_PrintStats(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_SIM_H
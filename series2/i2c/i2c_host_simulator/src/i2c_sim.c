@@ -0,0 +1,913 @@
+/***************************************************************************//**
+ * @file i2c_sim.c
+ * @brief Host model of an I2C bus. Raises the interrupt flags of the I2C
+ * peripheral as bytes go over the bus and calls the handler under test.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include "em_i2c.h"
+#include "ldma_sim.h"
+#include "i2c_sim.h"
+
+// Simulated register block, see em_i2c.h
+I2C_TypeDef i2cSimRegs;
+
+// TXDATA holds this value while the CPU has not written it
+#define TXDATA_EMPTY        0xFFFFFFFFUL
+
+// Flags raised for transfers with the peripheral as a master
+#define MASTER_FLAGS        (I2C_IF_ACK | I2C_IF_NACK | I2C_IF_RXDATAV     \
+                             | I2C_IF_MSTOP | I2C_IF_ARBLOST               \
+                             | I2C_IF_BUSERR)
+
+// Upper bound on LDMA bus cycles for one request
+#define MAX_LDMA_CYCLES     10000
+
+// Acknowledge of the last byte received by the slave
+typedef enum
+{
+  ackNone,
+  ackPending,               // Bus held until AUTOACK or a command
+  ackSent,
+  nackSent
+} SimAck_t;
+
+// Transfer with the peripheral as a master
+typedef enum
+{
+  masterIdle,
+  masterAddress,            // Address sent
+  masterWriting,            // Byte sent
+  masterReadAddress,        // Address sent after a repeated start
+  masterReading,            // Byte received
+  masterStopping            // STOP sent
+} SimMasterState_t;
+
+typedef struct
+{
+  SimMasterState_t state;
+  I2C_TransferSeq_TypeDef *seq;
+  I2CSIM_Device_t *device;
+  uint32_t buffer;          // Buffer of seq in use
+  uint32_t index;           // Next byte of the buffer
+  uint32_t event;           // Flag raised when the bus next moves
+  I2C_TransferReturn_TypeDef result;
+} SimMaster_t;
+
+static I2CSIM_Handler_t handler;
+static int rxChannel;
+static int txChannel;
+static uint32_t commands;         // Slots of cmd written
+static bool rxValid;              // Byte in RXDATA not read yet
+static bool txFull;               // Byte written to TXDATA not sent yet
+static uint8_t txByte;
+static SimAck_t ack;
+static bool slaveAddressed;       // Slave addressed since the last start
+static SimMaster_t master;
+static I2CSIM_Device_t devices[I2CSIM_MAX_DEVICES];
+static uint32_t numDevices;
+static uint32_t faultFlag;
+static uint32_t faultAfter;
+static uint32_t transferBytes;    // Data bytes of the current transfer
+static I2CSIM_Stats_t stats;
+
+/*
+ * Instructions are counted by single stepping the handler with the x86-64
+ * trap flag. Steps are not counted while inModel is set, so the model
+ * behind RXDATA, CMD and I2C_Transfer() costs only the calls to it.
+ */
+static volatile sig_atomic_t inModel;
+
+#if defined(__x86_64__) && defined(__linux__)
+static volatile uint64_t steps;
+static uint64_t stepOverhead;
+static bool trapInstalled;
+
+static void trapHandler(int sig)
+{
+  (void)sig;
+  if (!inModel)
+  {
+    steps++;
+  }
+}
+
+// The stack pointer skips the red zone before the flags are pushed
+#define TRACE_ON()  __asm__ volatile ("lea -128(%%rsp), %%rsp\n\t"          \
+                                      "pushfq\n\t"                          \
+                                      "orq $0x100, (%%rsp)\n\t"             \
+                                      "popfq\n\t"                           \
+                                      "lea 128(%%rsp), %%rsp"               \
+                                      ::: "memory", "cc")
+#define TRACE_OFF() __asm__ volatile ("lea -128(%%rsp), %%rsp\n\t"          \
+                                      "pushfq\n\t"                          \
+                                      "andq $~0x100, (%%rsp)\n\t"           \
+                                      "popfq\n\t"                           \
+                                      "lea 128(%%rsp), %%rsp"               \
+                                      ::: "memory", "cc")
+
+static void emptyHandler(void)
+{
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Call a handler, single stepped.
+ *
+ * @return
+ *   Instructions executed by the handler and the call to it.
+ ******************************************************************************/
+static uint64_t countInstructions(I2CSIM_Handler_t function)
+{
+  uint64_t count;
+
+  steps = 0;
+  TRACE_ON();
+  function();
+  TRACE_OFF();
+  count = steps;
+
+  return (count > stepOverhead) ? count - stepOverhead : 0;
+}
+
+static void installTrap(void)
+{
+  struct sigaction action;
+  I2CSIM_Handler_t volatile empty = emptyHandler;
+
+  if (trapInstalled)
+  {
+    return;
+  }
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = trapHandler;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGTRAP, &action, NULL);
+  trapInstalled = true;
+
+  // The steps of an empty handler are those of the call and the trap flag
+  stepOverhead = 0;
+  stepOverhead = countInstructions(empty);
+}
+
+#else
+static uint64_t countInstructions(I2CSIM_Handler_t function)
+{
+  function();
+  return 0;
+}
+
+static void installTrap(void)
+{
+}
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *   Show the state of the buffers in STATUS.
+ ******************************************************************************/
+static void updateStatus(void)
+{
+  i2cSimRegs.STATUS = (txFull ? 0 : I2C_STATUS_TXBL)
+                      | (rxValid ? I2C_STATUS_RXDATAV : 0);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Apply the register writes of the handler or the program.
+ ******************************************************************************/
+static void syncRegisters(void)
+{
+  uint32_t i;
+
+  // Series 2 set and clear aliases
+  i2cSimRegs.CTRL |= i2cSimRegs.CTRL_SET;
+  i2cSimRegs.CTRL &= ~i2cSimRegs.CTRL_CLR;
+  i2cSimRegs.CTRL_SET = 0;
+  i2cSimRegs.CTRL_CLR = 0;
+
+  for (i = 0; i < commands; i++)
+  {
+    uint32_t cmd = i2cSimRegs.cmd[i];
+
+    if (cmd & I2C_CMD_CLEARTX)
+    {
+      txFull = false;
+    }
+    if ((cmd & I2C_CMD_ACK) && (ack == ackPending))
+    {
+      ack = ackSent;
+    }
+    if ((cmd & I2C_CMD_NACK) && (ack == ackPending))
+    {
+      ack = nackSent;
+    }
+    i2cSimRegs.cmd[i] = 0;
+  }
+  commands = 0;
+
+  if (i2cSimRegs.TXDATA != TXDATA_EMPTY)
+  {
+    if (txFull)
+    {
+      stats.txOverflows++;
+    }
+    txByte = (uint8_t)i2cSimRegs.TXDATA;
+    txFull = true;
+    i2cSimRegs.TXDATA = TXDATA_EMPTY;
+  }
+
+  if ((ack == ackPending) && (i2cSimRegs.CTRL & I2C_CTRL_AUTOACK))
+  {
+    ack = ackSent;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   LDMA write to the I2C registers, a byte for the transmit buffer.
+ ******************************************************************************/
+static void ldmaWrite(uint32_t addr, unsigned int size, uint32_t value)
+{
+  (void)size;
+
+  if (addr == (uint32_t)(uintptr_t)&i2cSimRegs.TXDATA)
+  {
+    if (txFull)
+    {
+      stats.txOverflows++;
+    }
+    txByte = (uint8_t)value;
+    txFull = true;
+    i2cSimRegs.TXDATA = TXDATA_EMPTY;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Serve the RXDATAV and TXBL requests of the connected LDMA channels.
+ ******************************************************************************/
+static void serviceLdma(void)
+{
+  LDMASIM_Stats_t before, after;
+
+  if ((rxChannel >= 0) && rxValid)
+  {
+    LDMASIM_GetStats(rxChannel, &before);
+    LDMASIM_PeripheralRequest(1UL << rxChannel);
+    LDMASIM_Run(MAX_LDMA_CYCLES);
+    LDMASIM_GetStats(rxChannel, &after);
+    if (after.unitsMoved != before.unitsMoved)
+    {
+      rxValid = false;
+      i2cSimRegs.IF &= ~I2C_IF_RXDATAV;
+    }
+  }
+
+  if ((txChannel >= 0) && !txFull)
+  {
+    LDMASIM_PeripheralRequest(1UL << txChannel);
+    LDMASIM_Run(MAX_LDMA_CYCLES);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Let the LDMA and the handler act until the bus waits for the other end.
+ *
+ * @details
+ *   The handler is called while an enabled flag is set. It is given up on
+ *   after I2CSIM_MAX_IDLE_INTERRUPTS calls that change nothing, which is
+ *   counted in stuckInterrupts.
+ ******************************************************************************/
+static void service(void)
+{
+  uint32_t pending, idle = 0;
+  bool wasValid, wasFull;
+  SimAck_t wasAck;
+
+  syncRegisters();
+  while (1)
+  {
+    serviceLdma();
+
+    pending = i2cSimRegs.IF & i2cSimRegs.IEN;
+    if ((pending == 0) || (handler == NULL))
+    {
+      break;
+    }
+
+    wasValid = rxValid;
+    wasFull = txFull;
+    wasAck = ack;
+
+    updateStatus();
+    stats.interrupts++;
+    stats.instructions += countInstructions(handler);
+    syncRegisters();
+
+    if (((i2cSimRegs.IF & i2cSimRegs.IEN) == pending)
+        && (rxValid == wasValid) && (txFull == wasFull) && (ack == wasAck))
+    {
+      if (++idle == I2CSIM_MAX_IDLE_INTERRUPTS)
+      {
+        stats.stuckInterrupts++;
+        break;
+      }
+    }
+    else
+    {
+      idle = 0;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Raise the injected fault if the transfer has reached it.
+ ******************************************************************************/
+static bool faultDue(void)
+{
+  if ((faultFlag != 0) && (transferBytes == faultAfter))
+  {
+    i2cSimRegs.IF |= faultFlag;
+    faultFlag = 0;
+    return true;
+  }
+  return false;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Shift a byte from the master into the slave.
+ *
+ * @param[in] flags
+ *   Flags raised with RXDATAV, I2C_IF_ADDR for an address
+ ******************************************************************************/
+static I2CSIM_Result_t slaveReceive(uint8_t byte, uint32_t flags)
+{
+  // The previous byte must have been read, the bus is held until then
+  service();
+  if (rxValid)
+  {
+    return i2cSimHang;
+  }
+
+  i2cSimRegs.rxdata[0] = byte;
+  rxValid = true;
+  ack = ackPending;
+  i2cSimRegs.IF |= I2C_IF_RXDATAV | flags;
+
+  service();
+  if (ack == ackPending)
+  {
+    return i2cSimHang;
+  }
+  if (ack == nackSent)
+  {
+    return i2cSimNack;
+  }
+  return i2cSimOk;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Address the slave after a start or a repeated start.
+ ******************************************************************************/
+static I2CSIM_Result_t slaveAddress(uint8_t address)
+{
+  syncRegisters();
+  transferBytes = 0;
+
+  if (!(i2cSimRegs.CTRL & I2C_CTRL_EN)
+      || !(i2cSimRegs.CTRL & I2C_CTRL_SLAVE)
+      || ((address ^ i2cSimRegs.SADDR) & i2cSimRegs.SADDRMASK & 0xFE))
+  {
+    slaveAddressed = false;
+    return i2cSimNack;
+  }
+
+  if (slaveAddressed)
+  {
+    i2cSimRegs.IF |= I2C_IF_RSTART;
+  }
+  slaveAddressed = true;
+
+  return slaveReceive(address, I2C_IF_ADDR);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Drop the transfer after a fault, the bus is free again.
+ ******************************************************************************/
+static I2CSIM_Result_t slaveFault(void)
+{
+  service();
+  slaveAddressed = false;
+  rxValid = false;
+  ack = ackNone;
+
+  return i2cSimFault;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write bytes to the peripheral as a slave.
+ *
+ * @param[in] address
+ *   Write address, bit 0 cleared
+ *
+ * @param[in] stop
+ *   End with a stop condition, false to go on with a repeated start
+ ******************************************************************************/
+I2CSIM_Result_t I2CSIM_MasterWrite(uint8_t address, const uint8_t *data,
+                                   uint32_t length, bool stop)
+{
+  I2CSIM_Result_t result;
+  uint32_t i;
+
+  result = slaveAddress(address & 0xFE);
+  for (i = 0; (i < length) && (result == i2cSimOk); i++)
+  {
+    if (faultDue())
+    {
+      return slaveFault();
+    }
+    result = slaveReceive(data[i], 0);
+    stats.bytes++;
+    transferBytes++;
+  }
+
+  if ((result != i2cSimHang) && stop)
+  {
+    I2CSIM_MasterStop();
+  }
+  return result;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read bytes from the peripheral as a slave.
+ *
+ * @param[in] address
+ *   Write address, bit 0 is set for the read
+ ******************************************************************************/
+I2CSIM_Result_t I2CSIM_MasterRead(uint8_t address, uint8_t *data,
+                                  uint32_t length, bool stop)
+{
+  I2CSIM_Result_t result;
+  uint32_t i;
+
+  result = slaveAddress(address | 1);
+  for (i = 0; (i < length) && (result == i2cSimOk); i++)
+  {
+    if (faultDue())
+    {
+      return slaveFault();
+    }
+
+    // The slave holds the bus until it has a byte to send
+    service();
+    if (!txFull)
+    {
+      return i2cSimHang;
+    }
+    data[i] = txByte;
+    txFull = false;
+    stats.bytes++;
+    transferBytes++;
+  }
+
+  if ((result != i2cSimHang) && stop)
+  {
+    I2CSIM_MasterStop();
+  }
+  return result;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Send a stop condition.
+ ******************************************************************************/
+void I2CSIM_MasterStop(void)
+{
+  if (slaveAddressed)
+  {
+    i2cSimRegs.IF |= I2C_IF_SSTOP;
+  }
+  slaveAddressed = false;
+  ack = ackNone;
+  service();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Choose the bus event after the one just handled by I2C_Transfer().
+ ******************************************************************************/
+static void masterNext(void)
+{
+  I2C_TransferSeq_TypeDef *seq = master.seq;
+  I2CSIM_Device_t *device = master.device;
+  uint8_t byte;
+
+  // Go on with the second buffer of a write-write, or read after a write
+  if ((master.state != masterReading) && (master.state != masterReadAddress)
+      && (master.index == seq->buf[master.buffer].len))
+  {
+    if ((seq->flags & I2C_FLAG_WRITE_WRITE) && (master.buffer == 0))
+    {
+      master.buffer = 1;
+      master.index = 0;
+    }
+    else if ((seq->flags & I2C_FLAG_WRITE_READ) && (master.buffer == 0))
+    {
+      master.state = masterReadAddress;
+      master.buffer = 1;
+      master.index = 0;
+      device->reads++;
+      master.event = I2C_IF_ACK;
+      return;
+    }
+  }
+
+  if (faultDue())
+  {
+    master.event = 0;
+    return;
+  }
+
+  if ((master.state == masterReading) || (master.state == masterReadAddress))
+  {
+    // Every byte but the last is acknowledged, then the STOP follows
+    if (master.index == seq->buf[master.buffer].len)
+    {
+      master.state = masterStopping;
+      master.event = I2C_IF_MSTOP;
+      return;
+    }
+    i2cSimRegs.rxdata[0] = device->memory[device->pointer++];
+    master.state = masterReading;
+    master.event = I2C_IF_RXDATAV;
+    stats.bytes++;
+    transferBytes++;
+    return;
+  }
+
+  if (master.index == seq->buf[master.buffer].len)
+  {
+    master.state = masterStopping;
+    master.event = I2C_IF_MSTOP;
+    return;
+  }
+
+  // The device takes the first byte of a write as its register pointer
+  byte = seq->buf[master.buffer].data[master.index++];
+  if (device->receivedLength == 0)
+  {
+    device->pointer = byte;
+  }
+  else
+  {
+    device->memory[device->pointer++] = byte;
+  }
+  device->received[device->receivedLength++ & 0xFF] = byte;
+  master.state = masterWriting;
+  master.event = I2C_IF_ACK;
+  stats.bytes++;
+  transferBytes++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Move the bus of a master transfer on by one event.
+ *
+ * @return
+ *   true if a flag was raised.
+ ******************************************************************************/
+static bool masterStep(void)
+{
+  if ((master.state == masterIdle) || (master.event == 0))
+  {
+    return false;
+  }
+
+  i2cSimRegs.IF |= master.event;
+  master.event = 0;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of emlib I2C_TransferInit(), starts a master transfer.
+ ******************************************************************************/
+I2C_TransferReturn_TypeDef I2C_TransferInit(I2C_TypeDef *i2c,
+                                            I2C_TransferSeq_TypeDef *seq)
+{
+  uint32_t i;
+
+  inModel = 1;
+  (void)i2c;
+
+  if (!(seq->flags & (I2C_FLAG_WRITE | I2C_FLAG_READ | I2C_FLAG_WRITE_READ
+                      | I2C_FLAG_WRITE_WRITE)))
+  {
+    inModel = 0;
+    return i2cTransferUsageFault;
+  }
+
+  // emlib clears every pending flag before starting
+  i2cSimRegs.IF = 0;
+  memset(&master, 0, sizeof(master));
+  master.seq = seq;
+  master.state = masterAddress;
+  master.result = i2cTransferDone;
+  transferBytes = 0;
+
+  for (i = 0; i < numDevices; i++)
+  {
+    if (devices[i].address == (seq->addr & 0xFE))
+    {
+      master.device = &devices[i];
+    }
+  }
+
+  if (master.device == NULL)
+  {
+    master.event = I2C_IF_NACK;
+  }
+  else if (seq->flags & I2C_FLAG_READ)
+  {
+    master.state = masterReadAddress;
+    master.device->reads++;
+    master.event = I2C_IF_ACK;
+  }
+  else
+  {
+    master.device->writes++;
+    master.device->receivedLength = 0;
+    master.event = I2C_IF_ACK;
+  }
+
+  inModel = 0;
+  return i2cTransferInProgress;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of emlib I2C_Transfer(), handles the pending flag of the master
+ *   transfer.
+ *
+ * @details
+ *   Called from a polling loop with no flag pending, the bus is moved on
+ *   first, as time passes between two calls.
+ ******************************************************************************/
+I2C_TransferReturn_TypeDef I2C_Transfer(I2C_TypeDef *i2c)
+{
+  I2C_TransferReturn_TypeDef result = i2cTransferInProgress;
+  uint32_t flags;
+
+  inModel = 1;
+  (void)i2c;
+  stats.transferCalls++;
+
+  if (master.state == masterIdle)
+  {
+    inModel = 0;
+    return master.result;
+  }
+
+  flags = i2cSimRegs.IF & MASTER_FLAGS;
+  if (flags == 0)
+  {
+    masterStep();
+    flags = i2cSimRegs.IF & MASTER_FLAGS;
+  }
+
+  if (flags & (I2C_IF_ARBLOST | I2C_IF_BUSERR))
+  {
+    result = (flags & I2C_IF_ARBLOST) ? i2cTransferArbLost
+                                      : i2cTransferBusErr;
+    i2cSimRegs.IF &= ~MASTER_FLAGS;
+    master.state = masterIdle;
+    master.result = result;
+  }
+  else if (flags & I2C_IF_MSTOP)
+  {
+    i2cSimRegs.IF &= ~I2C_IF_MSTOP;
+    master.state = masterIdle;
+    result = master.result;
+  }
+  else if (flags & I2C_IF_NACK)
+  {
+    // A STOP ends the transfer, which fails once it is sent
+    i2cSimRegs.IF &= ~I2C_IF_NACK;
+    master.result = i2cTransferNack;
+    master.state = masterStopping;
+    master.event = I2C_IF_MSTOP;
+  }
+  else if (flags & I2C_IF_ACK)
+  {
+    i2cSimRegs.IF &= ~I2C_IF_ACK;
+    masterNext();
+  }
+  else if (flags & I2C_IF_RXDATAV)
+  {
+    i2cSimRegs.IF &= ~I2C_IF_RXDATAV;
+    master.seq->buf[master.buffer].data[master.index++] =
+      (uint8_t)i2cSimRegs.rxdata[0];
+    masterNext();
+  }
+
+  inModel = 0;
+  return result;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Let time pass while the program sleeps, called by EMU_EnterEM1().
+ ******************************************************************************/
+void I2CSIM_Idle(void)
+{
+  masterStep();
+  service();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   true while a master transfer has not ended.
+ ******************************************************************************/
+bool I2CSIM_MasterBusy(void)
+{
+  return master.state != masterIdle;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add a device answering master transfers at address, bit 0 cleared.
+ ******************************************************************************/
+I2CSIM_Device_t *I2CSIM_AddDevice(uint8_t address)
+{
+  I2CSIM_Device_t *device;
+
+  if (numDevices == I2CSIM_MAX_DEVICES)
+  {
+    return NULL;
+  }
+
+  device = &devices[numDevices++];
+  memset(device, 0, sizeof(*device));
+  device->address = address & 0xFE;
+  return device;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Raise flag (I2C_IF_BUSERR or I2C_IF_ARBLOST) in the next transfer,
+ *   before its data byte afterBytes.
+ ******************************************************************************/
+void I2CSIM_InjectFault(uint32_t flag, uint32_t afterBytes)
+{
+  faultFlag = flag;
+  faultAfter = afterBytes;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Handler called for the flags enabled in I2C0->IEN.
+ ******************************************************************************/
+void I2CSIM_AttachHandler(I2CSIM_Handler_t irqHandler)
+{
+  handler = irqHandler;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   LDMA channels serving the RXDATAV and TXBL requests, -1 for none.
+ *
+ * @note
+ *   Call after LDMASIM_Reset(), which drops the model of TXDATA.
+ ******************************************************************************/
+void I2CSIM_ConnectLdma(int rx, int tx)
+{
+  rxChannel = rx;
+  txChannel = tx;
+  LDMASIM_MapRegisters(&i2cSimRegs.TXDATA, sizeof(i2cSimRegs.TXDATA),
+                       ldmaWrite);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reset the I2C peripheral, the bus and the statistics.
+ ******************************************************************************/
+void I2CSIM_Reset(void)
+{
+  memset(&i2cSimRegs, 0, sizeof(i2cSimRegs));
+  i2cSimRegs.TXDATA = TXDATA_EMPTY;
+  memset(&master, 0, sizeof(master));
+  memset(&stats, 0, sizeof(stats));
+  handler = NULL;
+  rxChannel = -1;
+  txChannel = -1;
+  commands = 0;
+  rxValid = false;
+  txFull = false;
+  ack = ackNone;
+  slaveAddressed = false;
+  numDevices = 0;
+  faultFlag = 0;
+  updateStatus();
+  installTrap();
+}
+
+// Register accesses seen by the model, see em_i2c.h
+uint32_t I2CSIM_ReadRxData(void)
+{
+  inModel = 1;
+  if (rxValid)
+  {
+    rxValid = false;
+    i2cSimRegs.IF &= ~I2C_IF_RXDATAV;
+    updateStatus();
+  }
+  inModel = 0;
+  return 0;
+}
+
+uint32_t I2CSIM_WriteCommand(void)
+{
+  uint32_t slot;
+
+  inModel = 1;
+  slot = (commands < I2CSIM_MAX_COMMANDS) ? commands++ : commands - 1;
+  inModel = 0;
+  return slot;
+}
+
+bool I2CSIM_InstructionsCounted(void)
+{
+#if defined(__x86_64__) && defined(__linux__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void I2CSIM_GetStats(I2CSIM_Stats_t *statsOut)
+{
+  *statsOut = stats;
+}
+
+void I2CSIM_ResetStats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print the statistics, with the handler instructions per byte.
+ ******************************************************************************/
+void I2CSIM_PrintStats(const char *name)
+{
+  printf("%-24s %5lu bytes %4lu IRQs %7llu instr %7.1f instr/byte%s\n",
+         name,
+         (unsigned long)stats.bytes,
+         (unsigned long)stats.interrupts,
+         (unsigned long long)stats.instructions,
+         stats.bytes ? (double)stats.instructions / stats.bytes : 0.0,
+         stats.stuckInterrupts ? " STUCK" : "");
+}
@@ -0,0 +1,502 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Runs the I2C handlers of the examples against the bus model and checks
+ * the data they move.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "ldma_sim.h"
+#include "i2c_sim.h"
+
+// The selected example is built into this file with its main() renamed
+#define main i2cExampleMain
+
+#if defined(I2C_SIM_GG_LG_WG)
+#include "../../../../series0/i2c/i2c/src/main_gg_lg_wg.c"
+#define BUTTON_IRQHandler GPIO_ODD_IRQHandler
+#elif defined(I2C_SIM_G8XX)
+#include "../../../../series0/i2c/i2c/src/main_g8xx.c"
+#define BUTTON_IRQHandler GPIO_ODD_IRQHandler
+#elif defined(I2C_SIM_ZG_HG)
+#include "../../../../series0/i2c/i2c/src/main_zg_hg.c"
+#define BUTTON_IRQHandler GPIO_ODD_IRQHandler
+#elif defined(I2C_SIM_EFR)
+#include "../../../../series1/i2c/i2c/src/main_efr.c"
+#define BUTTON_IRQHandler GPIO_EVEN_IRQHandler
+#elif defined(I2C_SIM_GG11)
+#include "../../../../series1/i2c/i2c/src/main_gg11.c"
+#define BUTTON_IRQHandler GPIO_EVEN_IRQHandler
+#elif defined(I2C_SIM_PGXX)
+#include "../../../../series1/i2c/i2c/src/main_pgxx.c"
+#define BUTTON_IRQHandler GPIO_EVEN_IRQHandler
+#elif defined(I2C_SIM_TG11)
+#include "../../../../series1/i2c/i2c/src/main_tg11.c"
+#define BUTTON_IRQHandler GPIO_ODD_IRQHandler
+#elif defined(I2C_SIM_SLAVE_REGMAP)
+#include "i2c_slave_registers.h"
+#elif defined(I2C_SIM_MASTER_QUEUE)
+#include "em_emu.h"
+#include "i2c_master_queue.h"
+#else
+#error "Select an example, e.g. -DI2C_SIM_GG_LG_WG"
+#endif
+
+#undef main
+
+// The series 0 and series 1 examples share their slave handler, the series
+// 1 ones send as a master from the I2C interrupt
+#if defined(BUTTON_IRQHandler)
+#define I2C_SIM_PB0_EXAMPLE
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *   Report the outcome of a scenario and start the next one.
+ ******************************************************************************/
+static bool checkScenario(const char *name, bool passed)
+{
+  I2CSIM_Stats_t stats;
+
+  I2CSIM_GetStats(&stats);
+  I2CSIM_PrintStats(name);
+  if (stats.stuckInterrupts || stats.txOverflows)
+  {
+    passed = false;
+  }
+  if (!passed)
+  {
+    printf("%s: FAILED\n", name);
+  }
+  I2CSIM_ResetStats();
+  return passed;
+}
+
+#if defined(I2C_SIM_PB0_EXAMPLE)
+/***************************************************************************//**
+ * @brief
+ *   Press PB0 and run the main loop once, as main() does
+ ******************************************************************************/
+static void pressButton(void)
+{
+  BUTTON_IRQHandler();
+  if (i2c_startTx)
+  {
+    performI2CTransfer();
+    i2c_startTx = false;
+  }
+}
+
+static bool runScenarios(void)
+{
+  static const uint8_t hello[] = { 'H', 'e', 'l', 'l', 'o' };
+  static const uint8_t hi[] = { 'H', 'i' };
+  const uint32_t slaveIen = I2C_IEN_ADDR | I2C_IEN_RXDATAV | I2C_IEN_SSTOP;
+  uint8_t overlong[16];
+  I2CSIM_Device_t *device;
+  I2CSIM_Stats_t stats;
+  bool passed = true;
+  bool ok;
+  uint32_t i;
+
+  I2CSIM_Reset();
+  I2CSIM_AttachHandler(I2C0_IRQHandler);
+  initCMU();
+  initGPIO();
+  initI2C();
+
+  // Another master writes to the slave, the index is reset by the stop
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, hello, sizeof(hello), false)
+        == i2cSimOk)
+       && i2c_rxInProgress
+       && (i2c_rxBufferIndex == sizeof(hello))
+       && (memcmp(i2c_rxBuffer, hello, sizeof(hello)) == 0);
+  I2CSIM_MasterStop();
+  ok = ok && !i2c_rxInProgress && (i2c_rxBufferIndex == 0);
+  passed &= checkScenario("slave write", ok);
+
+  // Each transfer starts at the beginning of the buffer
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, hi, sizeof(hi), false) == i2cSimOk)
+       && (i2c_rxBufferIndex == sizeof(hi))
+       && (memcmp(i2c_rxBuffer, hi, sizeof(hi)) == 0)
+       && (i2c_rxBuffer[2] == 'l');
+  I2CSIM_MasterStop();
+  passed &= checkScenario("slave write again", ok);
+
+  // Bytes past the end of the buffer must not be stored
+  for (i = 0; i < sizeof(overlong); i++)
+  {
+    overlong[i] = (uint8_t)(0xA0 + i);
+  }
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, overlong, sizeof(overlong), false)
+        == i2cSimOk)
+       && (i2c_rxBufferIndex == I2C_RXBUFFER_SIZE)
+       && (memcmp(i2c_rxBuffer, overlong, I2C_RXBUFFER_SIZE) == 0);
+  I2CSIM_MasterStop();
+  ok = ok && (i2c_rxBufferIndex == 0);
+  passed &= checkScenario("slave overlong write", ok);
+
+  // Other addresses are not acknowledged
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS + 2, hi, sizeof(hi), true)
+        == i2cSimNack)
+       && !i2c_rxInProgress;
+  I2CSIM_GetStats(&stats);
+  ok = ok && (stats.interrupts == 0);
+  passed &= checkScenario("slave other address", ok);
+
+  // A bus error leaves the reception open, the next transfer restarts it
+  I2CSIM_InjectFault(I2C_IF_BUSERR, 2);
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, hello, sizeof(hello), true)
+        == i2cSimFault)
+       && i2c_rxInProgress;
+  ok = ok
+       && (I2CSIM_MasterWrite(I2C_ADDRESS, hi, sizeof(hi), true) == i2cSimOk)
+       && !i2c_rxInProgress
+       && (memcmp(i2c_rxBuffer, hi, sizeof(hi)) == 0);
+  passed &= checkScenario("slave bus error", ok);
+
+  // PB0 is ignored while receiving
+  I2CSIM_MasterWrite(I2C_ADDRESS, hi, sizeof(hi), false);
+  BUTTON_IRQHandler();
+  ok = !i2c_startTx && (I2C0->IEN == slaveIen);
+  I2CSIM_MasterStop();
+  passed &= checkScenario("button while receiving", ok);
+
+  // PB0 sends "Gecko" to the other board, then slave mode is back on
+  device = I2CSIM_AddDevice(I2C_ADDRESS);
+  pressButton();
+  ok = (device->writes == 1)
+       && (device->receivedLength == i2c_txBufferSize)
+       && (memcmp(device->received, i2c_txBuffer, i2c_txBufferSize) == 0)
+       && (I2C0->IEN == slaveIen);
+  I2CSIM_GetStats(&stats);
+  printf("%-24s %5lu I2C_Transfer() calls\n", "",
+         (unsigned long)stats.transferCalls);
+  passed &= checkScenario("master write", ok);
+
+  // The transfer ends when the other board loses arbitration or is
+  // missing, the slave interrupts are enabled again
+  I2CSIM_InjectFault(I2C_IF_ARBLOST, 3);
+  pressButton();
+  ok = (device->writes == 2) && (device->receivedLength == 3)
+       && (I2C0->IEN == slaveIen) && !I2CSIM_MasterBusy();
+  passed &= checkScenario("master arbitration lost", ok);
+
+  I2CSIM_Reset();
+  I2CSIM_AttachHandler(I2C0_IRQHandler);
+  initI2C();
+  pressButton();
+  ok = (I2C0->IEN == slaveIen) && !I2CSIM_MasterBusy();
+  passed &= checkScenario("master no answer", ok);
+
+  return passed;
+}
+
+#elif defined(I2C_SIM_SLAVE_REGMAP)
+#define I2C_ADDRESS         0xE2
+#define RX_LDMA_CHANNEL     0
+#define TX_LDMA_CHANNEL     1
+
+static uint32_t commands;
+static uint8_t command;
+static uint32_t threshold;
+
+// Callbacks of the register map of series2/i2c/i2c_slave
+void commandWritten(uint8_t address, const uint8_t *data, uint8_t width)
+{
+  (void)address;
+  (void)width;
+  command = data[0];
+  commands++;
+}
+
+void thresholdWritten(uint8_t address, const uint8_t *data, uint8_t width)
+{
+  (void)address;
+  (void)width;
+  threshold = data[0] | (data[1] << 8) | (data[2] << 16)
+              | ((uint32_t)data[3] << 24);
+}
+
+static I2cSlave_t slave;
+
+void I2C0_IRQHandler(void)
+{
+  i2cSlaveIrq(&slave);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read length bytes from register address on, after a repeated start.
+ ******************************************************************************/
+static bool readRegisters(uint8_t address, uint8_t *data, uint32_t length)
+{
+  return (I2CSIM_MasterWrite(I2C_ADDRESS, &address, 1, false) == i2cSimOk)
+         && (I2CSIM_MasterRead(I2C_ADDRESS, data, length, true) == i2cSimOk);
+}
+
+static bool runScenarios(void)
+{
+  I2C_Init_TypeDef i2cInit = I2C_INIT_DEFAULT;
+  LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
+  uint8_t whoAmI = WHO_AM_I;
+  uint8_t tx[1 + REG_SAMPLES_SIZE];
+  uint8_t rx[REG_SAMPLES_SIZE];
+  uint8_t samples[REG_SAMPLES_SIZE];
+  I2CSIM_Stats_t stats;
+  bool passed = true;
+  bool ok;
+  uint32_t i;
+
+  LDMASIM_Reset();
+  I2CSIM_Reset();
+  I2CSIM_AttachHandler(I2C0_IRQHandler);
+  I2CSIM_ConnectLdma(RX_LDMA_CHANNEL, TX_LDMA_CHANNEL);
+
+  i2cInit.master = false;
+  I2C_Init(I2C0, &i2cInit);
+  I2C_SlaveAddressSet(I2C0, I2C_ADDRESS);
+  I2C_SlaveAddressMaskSet(I2C0, 0xFE);
+  LDMA_Init(&ldmaInit);
+  i2cSlaveInit(&slave, I2C0, slaveRegisters, slaveRegisterCount,
+               RX_LDMA_CHANNEL,
+               LDMAXBAR_CH_REQSEL_SIGSEL_I2C0RXDATAV
+               | LDMAXBAR_CH_REQSEL_SOURCESEL_I2C0,
+               TX_LDMA_CHANNEL,
+               LDMAXBAR_CH_REQSEL_SIGSEL_I2C0TXBL
+               | LDMAXBAR_CH_REQSEL_SOURCESEL_I2C0);
+  i2cSlaveSet(&slave, REG_WHO_AM_I, &whoAmI, 1);
+
+  // The exchange of i2c_master: read the buffer, write it incremented and
+  // read it back
+  ok = readRegisters(REG_BUFFER, rx, REG_BUFFER_SIZE);
+  tx[0] = REG_BUFFER;
+  for (i = 0; i < REG_BUFFER_SIZE; i++)
+  {
+    tx[1 + i] = (uint8_t)(rx[i] + 1);
+  }
+  ok = ok && (I2CSIM_MasterWrite(I2C_ADDRESS, tx, 1 + REG_BUFFER_SIZE, true)
+              == i2cSimOk);
+  ok = ok && readRegisters(REG_BUFFER, rx, REG_BUFFER_SIZE)
+       && (memcmp(rx, &tx[1], REG_BUFFER_SIZE) == 0)
+       && !i2cSlaveBusy(&slave) && (slave.transfers == 5);
+  passed &= checkScenario("buffer read/write", ok);
+
+  // One burst of samples, moved by the LDMA
+  for (i = 0; i < REG_SAMPLES_SIZE; i++)
+  {
+    samples[i] = (uint8_t)(3 * i);
+  }
+  i2cSlaveSet(&slave, REG_SAMPLES, samples, REG_SAMPLES_SIZE);
+  ok = readRegisters(REG_SAMPLES, rx, REG_SAMPLES_SIZE)
+       && (memcmp(rx, samples, REG_SAMPLES_SIZE) == 0);
+  I2CSIM_GetStats(&stats);
+  ok = ok && (stats.interrupts <= 4);
+  passed &= checkScenario("samples burst", ok);
+
+  // Multi-byte registers change once written in full
+  tx[0] = REG_THRESHOLD;
+  tx[1] = 0x78;
+  tx[2] = 0x56;
+  tx[3] = 0x34;
+  tx[4] = 0x12;
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, tx, 5, true) == i2cSimOk)
+       && (threshold == 0x12345678);
+  tx[1] = 0x00;
+  tx[2] = 0x00;
+  ok = ok && (I2CSIM_MasterWrite(I2C_ADDRESS, tx, 3, true) == i2cSimOk)
+       && (threshold == 0x12345678)
+       && readRegisters(REG_THRESHOLD, rx, 4) && (rx[0] == 0x78);
+  passed &= checkScenario("threshold", ok);
+
+  // Read-only and write-only registers
+  tx[0] = REG_COMMAND;
+  tx[1] = 0x01;
+  tx[2] = 0x00;
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, tx, 3, true) == i2cSimOk)
+       && (commands == 1) && (command == 0x01)
+       && readRegisters(REG_COMMAND, rx, 2)
+       && (rx[0] == I2C_SLAVE_FILL) && (rx[1] == WHO_AM_I);
+  passed &= checkScenario("command and who am i", ok);
+
+  // Past the end of the address space
+  tx[0] = I2C_SLAVE_SIZE - 1;
+  tx[1] = 0x11;
+  tx[2] = 0x22;
+  tx[3] = 0x33;
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, tx, 4, true) == i2cSimOk)
+       && readRegisters(I2C_SLAVE_SIZE - 2, rx, 4)
+       && (rx[0] == I2C_SLAVE_FILL) && (rx[1] == I2C_SLAVE_FILL)
+       && (rx[2] == I2C_SLAVE_FILL) && (rx[3] == I2C_SLAVE_FILL)
+       && (slave.errors == 0);
+  passed &= checkScenario("past the end", ok);
+
+  // Faults drop the bytes written and are counted
+  tx[0] = REG_BUFFER;
+  memset(&tx[1], 0x5A, REG_BUFFER_SIZE);
+  I2CSIM_InjectFault(I2C_IF_BUSERR, 4);
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS, tx, 1 + REG_BUFFER_SIZE, true)
+        == i2cSimFault)
+       && (slave.errors == 1) && !i2cSlaveBusy(&slave);
+  I2CSIM_InjectFault(I2C_IF_ARBLOST, 2);
+  ok = ok && (I2CSIM_MasterRead(I2C_ADDRESS, rx, 8, true) == i2cSimFault)
+       && (slave.errors == 2) && !i2cSlaveBusy(&slave)
+       && readRegisters(REG_BUFFER, rx, REG_BUFFER_SIZE)
+       && (rx[3] != 0x5A);
+  passed &= checkScenario("bus errors", ok);
+
+  // Other addresses are not acknowledged
+  ok = (I2CSIM_MasterWrite(I2C_ADDRESS + 2, tx, 2, true) == i2cSimNack);
+  I2CSIM_GetStats(&stats);
+  ok = ok && (stats.interrupts == 0);
+  passed &= checkScenario("other address", ok);
+
+  return passed;
+}
+
+#elif defined(I2C_SIM_MASTER_QUEUE)
+#define SENSOR_ADDRESS      0x90
+#define SENSOR_COUNT        5
+#define REG_DATA            0x20
+#define MAX_SLEEPS          10000
+
+static I2cMasterQueue_t queue;
+static I2cTransaction_t transactions[SENSOR_COUNT];
+static uint8_t pointer = REG_DATA;
+static uint8_t data[SENSOR_COUNT][2];
+static uint32_t doneOrder[SENSOR_COUNT];
+static uint32_t doneCount;
+
+void I2C0_IRQHandler(void)
+{
+  i2cMasterQueueIrq(&queue);
+}
+
+static void transactionDone(I2cTransaction_t *transaction)
+{
+  doneOrder[doneCount++] = (uint32_t)(transaction - transactions);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Queue a register read of every sensor and sleep until all are done.
+ ******************************************************************************/
+static bool readSensors(void)
+{
+  uint32_t i;
+
+  doneCount = 0;
+  for (i = 0; i < SENSOR_COUNT; i++)
+  {
+    transactions[i].address = SENSOR_ADDRESS + 2 * i;
+    transactions[i].tx = &pointer;
+    transactions[i].txLength = 1;
+    transactions[i].rx = data[i];
+    transactions[i].rxLength = 2;
+    transactions[i].done = transactionDone;
+    if (!i2cMasterQueueSubmit(&queue, &transactions[i]))
+    {
+      return false;
+    }
+  }
+
+  for (i = 0; (i < MAX_SLEEPS) && !i2cMasterQueueIdle(&queue); i++)
+  {
+    EMU_EnterEM1();
+  }
+  return i2cMasterQueueIdle(&queue) && (doneCount == SENSOR_COUNT);
+}
+
+static bool runScenarios(void)
+{
+  I2C_Init_TypeDef i2cInit = I2C_INIT_DEFAULT;
+  I2CSIM_Device_t *sensors[SENSOR_COUNT];
+  bool passed = true;
+  bool ok;
+  uint32_t i;
+
+  I2CSIM_Reset();
+  I2CSIM_AttachHandler(I2C0_IRQHandler);
+  for (i = 0; i < SENSOR_COUNT; i++)
+  {
+    sensors[i] = I2CSIM_AddDevice(SENSOR_ADDRESS + 2 * i);
+    sensors[i]->memory[REG_DATA] = (uint8_t)(0x10 * i);
+    sensors[i]->memory[REG_DATA + 1] = (uint8_t)(0x10 * i + 1);
+  }
+  I2C_Init(I2C0, &i2cInit);
+  i2cMasterQueueInit(&queue, I2C0);
+
+  // Write-read transactions run back to back, completed in order
+  ok = readSensors();
+  for (i = 0; ok && (i < SENSOR_COUNT); i++)
+  {
+    ok = (transactions[i].result == i2cTransferDone)
+         && (doneOrder[i] == i)
+         && (data[i][0] == 0x10 * i) && (data[i][1] == 0x10 * i + 1)
+         && (sensors[i]->pointer == REG_DATA + 2);
+  }
+  ok = ok && (I2C0->IEN == 0);
+  passed &= checkScenario("queued write-read", ok);
+
+  // A faulty sensor does not stop the queue
+  I2CSIM_InjectFault(I2C_IF_ARBLOST, 2);
+  ok = readSensors()
+       && (transactions[0].result == i2cTransferArbLost);
+  for (i = 1; ok && (i < SENSOR_COUNT); i++)
+  {
+    ok = (transactions[i].result == i2cTransferDone);
+  }
+  passed &= checkScenario("arbitration lost", ok);
+
+  // A missing sensor is not acknowledged
+  sensors[2]->address = 0;
+  ok = readSensors()
+       && (transactions[2].result == i2cTransferNack)
+       && (transactions[3].result == i2cTransferDone);
+  passed &= checkScenario("missing sensor", ok);
+
+  return passed;
+}
+#endif
+
+int main(void)
+{
+  bool passed = runScenarios();
+
+  if (!I2CSIM_InstructionsCounted())
+  {
+    printf("Handler instructions are only counted on x86-64 Linux\n");
+  }
+  printf("%s\n", passed ? "PASSED" : "FAILED");
+  return passed ? 0 : 1;
+}
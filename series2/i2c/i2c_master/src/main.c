@@ -15,7 +15,11 @@
  * error, or if the verification step of the I2C test fails, LED1 is turned on
  * and the master sits and remains in an infinite while loop. Connecting to the
  * device via debugger while in the infinite loop, the I2C error code can be
- * retrieved.
+ * retrieved from i2c_result.
+ *
+ * The transfers are queued (src/i2c_master_queue.c) and run back to back by
+ * the I2C interrupt handler, which calls a callback as each one ends. The
+ * core waits in EM1 while the bus is busy instead of polling I2C_Transfer().
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -56,19 +60,26 @@
 #include "em_emu.h"
 #include "em_gpio.h"
 #include "bsp.h"
+#include "i2c_master_queue.h"
 
 // Defines
 #define I2C_SLAVE_ADDRESS               0xE2
 #define I2C_TXBUFFER_SIZE                 10
 #define I2C_RXBUFFER_SIZE                 10
 
-// Buffers
-uint8_t i2c_txBuffer[I2C_TXBUFFER_SIZE];
+// Buffers, the register address is sent before the values written
+uint8_t i2c_targetAddress = 0;
+uint8_t i2c_txBuffer[1 + I2C_TXBUFFER_SIZE];
 uint8_t i2c_rxBuffer[I2C_RXBUFFER_SIZE];
 
 // Transmission flags
 volatile bool i2c_startTx;
 
+// Transactions of the test, run from the I2C interrupt
+I2cMasterQueue_t i2c_queue;
+I2cTransaction_t i2c_transactions[3];
+I2C_TransferReturn_TypeDef i2c_result;
+
 /**************************************************************************//**
  * @brief Enable clocks
  *****************************************************************************/
@@ -125,74 +136,54 @@ void initI2C(void)
   i2c_startTx = false;
 
   I2C0->CTRL = I2C_CTRL_AUTOSN;
+
+  // Transfers are run by the I2C interrupt
+  i2cMasterQueueInit(&i2c_queue, I2C0);
+  NVIC_ClearPendingIRQ(I2C0_IRQn);
+  NVIC_EnableIRQ(I2C0_IRQn);
 }
 
 /***************************************************************************//**
- * @brief I2C read numBytes from slave device starting at target address
+ * @brief Called from the I2C interrupt when a transaction of the test ends
  ******************************************************************************/
-void I2C_MasterRead(uint16_t slaveAddress, uint8_t targetAddress, uint8_t *rxBuff, uint8_t numBytes)
+void transactionDone(I2cTransaction_t *transaction)
 {
-  // Transfer structure
-  I2C_TransferSeq_TypeDef i2cTransfer;
-  I2C_TransferReturn_TypeDef result;
-
-  // Initializing I2C transfer
-  i2cTransfer.addr          = slaveAddress;
-  i2cTransfer.flags         = I2C_FLAG_WRITE_READ; // must write target address before reading
-  i2cTransfer.buf[0].data   = &targetAddress;
-  i2cTransfer.buf[0].len    = 1;
-  i2cTransfer.buf[1].data   = rxBuff;
-  i2cTransfer.buf[1].len    = numBytes;
-
-  result = I2C_TransferInit(I2C0, &i2cTransfer);
-
-  // Sending data
-  while (result == i2cTransferInProgress)
+  // Keep the first error
+  if (i2c_result == i2cTransferDone)
   {
-    result = I2C_Transfer(I2C0);
-  }
-
-  if(result != i2cTransferDone)
-  {
-    // LED1 ON and infinite while loop to indicate I2C transmission problem
-    GPIO_PinOutSet(BSP_GPIO_LED1_PORT, BSP_GPIO_LED1_PIN);
-    while(1);
+    i2c_result = transaction->result;
   }
 }
 
 /***************************************************************************//**
- * @brief I2C write numBytes to slave device starting at target address
+ * @brief Queue a transaction with the slave device
  ******************************************************************************/
-void I2C_MasterWrite(uint16_t slaveAddress, uint8_t targetAddress, uint8_t *txBuff, uint8_t numBytes)
+void I2C_MasterQueue(I2cTransaction_t *transaction, const uint8_t *txBuff,
+                     uint16_t txLength, uint8_t *rxBuff, uint16_t rxLength)
 {
-  // Transfer structure
-  I2C_TransferSeq_TypeDef i2cTransfer;
-  I2C_TransferReturn_TypeDef result;
-  uint8_t txBuffer[I2C_TXBUFFER_SIZE + 1];
-
-  txBuffer[0] = targetAddress;
-  for(int i = 0; i < numBytes; i++)
-  {
-      txBuffer[i + 1] = txBuff[i];
-  }
-
-  // Initializing I2C transfer
-  i2cTransfer.addr          = slaveAddress;
-  i2cTransfer.flags         = I2C_FLAG_WRITE;
-  i2cTransfer.buf[0].data   = txBuffer;
-  i2cTransfer.buf[0].len    = numBytes + 1;
-  i2cTransfer.buf[1].data   = NULL;
-  i2cTransfer.buf[1].len    = 0;
-
-  result = I2C_TransferInit(I2C0, &i2cTransfer);
+  transaction->address  = I2C_SLAVE_ADDRESS;
+  transaction->tx       = txBuff;
+  transaction->txLength = txLength;
+  transaction->rx       = rxBuff;
+  transaction->rxLength = rxLength;
+  transaction->done     = transactionDone;
+  transaction->user     = NULL;
+
+  // The queue holds all the transactions of the test
+  i2cMasterQueueSubmit(&i2c_queue, transaction);
+}
 
-  // Sending data
-  while (result == i2cTransferInProgress)
+/***************************************************************************//**
+ * @brief Wait in EM1 until the transactions queued are done
+ ******************************************************************************/
+void I2C_MasterWait(void)
+{
+  while (!i2cMasterQueueIdle(&i2c_queue))
   {
-    result = I2C_Transfer(I2C0);
+    EMU_EnterEM1();
   }
 
-  if(result != i2cTransferDone)
+  if(i2c_result != i2cTransferDone)
   {
     // LED1 ON and infinite while loop to indicate I2C transmission problem
     GPIO_PinOutSet(BSP_GPIO_LED1_PORT, BSP_GPIO_LED1_PIN);
@@ -208,26 +199,34 @@ bool testI2C(void)
   int i;
   bool I2CWriteVerify;
 
-  // Initial read of bytes from slave
-  I2C_MasterRead(I2C_SLAVE_ADDRESS, 0, i2c_rxBuffer, I2C_RXBUFFER_SIZE);
+  i2c_result = i2cTransferDone;
+
+  // Initial read of bytes from slave, the target address is written before
+  // reading
+  I2C_MasterQueue(&i2c_transactions[0], &i2c_targetAddress, 1,
+                  i2c_rxBuffer, I2C_RXBUFFER_SIZE);
+  I2C_MasterWait();
 
   // Increment received values and prepare to write back to slave
+  i2c_txBuffer[0] = i2c_targetAddress;
   for(i = 0; i < I2C_RXBUFFER_SIZE; i++)
   {
-    i2c_txBuffer[i] = i2c_rxBuffer[i] + 1;
+    i2c_txBuffer[i + 1] = i2c_rxBuffer[i] + 1;
   }
 
-  // Block write new values to slave
-  I2C_MasterWrite(I2C_SLAVE_ADDRESS, 0, i2c_txBuffer, I2C_TXBUFFER_SIZE);
-
-  // Block read from slave
-  I2C_MasterRead(I2C_SLAVE_ADDRESS, 0, i2c_rxBuffer, I2C_RXBUFFER_SIZE);
+  // Block write new values to slave and read them back, the I2C interrupt
+  // starts the read as soon as the write is done
+  I2C_MasterQueue(&i2c_transactions[1], i2c_txBuffer, 1 + I2C_TXBUFFER_SIZE,
+                  NULL, 0);
+  I2C_MasterQueue(&i2c_transactions[2], &i2c_targetAddress, 1,
+                  i2c_rxBuffer, I2C_RXBUFFER_SIZE);
+  I2C_MasterWait();
 
   // Verify I2C transmission
   I2CWriteVerify = true;
   for(i = 0; i < I2C_RXBUFFER_SIZE; i++)
   {
-    if(i2c_txBuffer[i] != i2c_rxBuffer[i])
+    if(i2c_txBuffer[i + 1] != i2c_rxBuffer[i])
     {
       I2CWriteVerify = false;
       break;
@@ -237,6 +236,14 @@ bool testI2C(void)
   return I2CWriteVerify;
 }
 
+/**************************************************************************//**
+ * @brief I2C Interrupt Handler, runs the queued transactions
+ *****************************************************************************/
+void I2C0_IRQHandler(void)
+{
+  i2cMasterQueueIrq(&i2c_queue);
+}
+
 /***************************************************************************//**
  * @brief GPIO Interrupt handler
  ******************************************************************************/
@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * @file i2c_slave_registers.h
+ * @brief Register map of the I2C slave example
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef I2C_SLAVE_REGISTERS_H
+#define I2C_SLAVE_REGISTERS_H
+
+#include <stdint.h>
+#include "i2c_slave_regmap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Register addresses
+#define REG_BUFFER                      0x00  // 10 bytes, read by i2c_master
+#define REG_BUFFER_SIZE                 10
+#define REG_COMMAND                     0x0E  // Write-only
+#define REG_WHO_AM_I                    0x0F  // Read-only
+#define REG_SAMPLES                     0x10  // 64 bytes, read-only
+#define REG_SAMPLES_SIZE                64
+#define REG_THRESHOLD                   0x50  // 32 bits, little endian
+
+// Commands written to REG_COMMAND
+#define COMMAND_CLEAR_ERROR             0x01
+
+// Value of REG_WHO_AM_I
+#define WHO_AM_I                        0xA5
+
+// Register map served to the master, see i2cSlaveInit()
+extern const I2cSlaveRegister_t slaveRegisters[];
+extern const uint32_t slaveRegisterCount;
+
+// Called when the master writes REG_COMMAND and all 4 bytes of
+// REG_THRESHOLD, defined by the application
+void commandWritten(uint8_t address, const uint8_t *data, uint8_t width);
+void thresholdWritten(uint8_t address, const uint8_t *data, uint8_t width);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_SLAVE_REGISTERS_H
@@ -0,0 +1,135 @@
+/***************************************************************************//**
+ * @file i2c_slave_regmap.h
+ * @brief I2C slave serving a table of registers, with LDMA bursts
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef I2C_SLAVE_REGMAP_H
+#define I2C_SLAVE_REGMAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+#include "em_i2c.h"
+#include "em_ldma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of the register address space, addresses go from 0 to
+// I2C_SLAVE_SIZE - 1
+#if !defined(I2C_SLAVE_SIZE)
+#define I2C_SLAVE_SIZE            128
+#endif
+
+// Sent for addresses that are not readable and once the master reads past
+// the end of the address space
+#if !defined(I2C_SLAVE_FILL)
+#define I2C_SLAVE_FILL            0xFF
+#endif
+
+// Register flags, registers are readable and writable by default
+#define I2C_SLAVE_REG_READ_ONLY   0x01
+#define I2C_SLAVE_REG_WRITE_ONLY  0x02
+
+// Called from the I2C interrupt once a write transfer has ended, for each
+// register the master wrote in full. data holds the width bytes written.
+typedef void (*I2cSlaveWritten_t)(uint8_t address, const uint8_t *data,
+                                  uint8_t width);
+
+typedef struct {
+  uint8_t address;            // First byte of the register
+  uint8_t width;              // Bytes, written and committed as a whole
+  uint8_t flags;              // I2C_SLAVE_REG_x
+  I2cSlaveWritten_t written;  // NULL if not needed
+} I2cSlaveRegister_t;
+
+typedef enum {
+  i2cSlaveIdle,
+  i2cSlaveRegisterAddress,    // Waiting for the register address
+  i2cSlaveWriting,
+  i2cSlaveReading
+} I2cSlaveState_t;
+
+/*
+ * The master writes the register address after the slave address, then
+ * any number of bytes to write from that address on. A read, usually after
+ * a repeated start, returns bytes from the last register address written
+ * on. Only the slave address and the register address interrupt the CPU:
+ * the LDMA streams the bytes after them between RXDATA or TXDATA and the
+ * image of the address space, and the transfer ends in the stop or
+ * repeated start interrupt.
+ *
+ * Written bytes land in a shadow of the image, and are committed when the
+ * transfer ends. Only writable registers written in full are copied into
+ * the image, so read-only registers, gaps between registers and partly
+ * written registers keep their values, and multi-byte registers change at
+ * once. Write-only registers are only passed to their callback and read as
+ * I2C_SLAVE_FILL.
+ */
+typedef struct {
+  I2C_TypeDef *i2c;
+  const I2cSlaveRegister_t *map;
+  uint32_t count;             // Registers in map
+  uint32_t rxChannel;         // LDMA channel writing to the shadow
+  uint32_t txChannel;         // LDMA channel reading from the image
+  LDMA_TransferCfg_t rxConfig;
+  LDMA_TransferCfg_t txConfig;
+  LDMA_Descriptor_t rxDescriptor[2];
+  LDMA_Descriptor_t txDescriptor[2];
+  volatile I2cSlaveState_t state;
+  uint8_t pointer;            // Register address of the transfer
+  uint8_t fill;               // Sent past the end of the image
+  uint8_t discard;            // Written past the end of the shadow
+  uint32_t transfers;         // Transfers completed
+  uint32_t errors;            // Bus errors and lost arbitrations
+  uint8_t image[I2C_SLAVE_SIZE];
+  uint8_t shadow[I2C_SLAVE_SIZE];
+} I2cSlave_t;
+
+void i2cSlaveInit(I2cSlave_t *slave, I2C_TypeDef *i2c,
+                  const I2cSlaveRegister_t *map, uint32_t count,
+                  uint32_t rxChannel, uint32_t rxReqSel,
+                  uint32_t txChannel, uint32_t txReqSel);
+void i2cSlaveIrq(I2cSlave_t *slave);
+bool i2cSlaveBusy(I2cSlave_t *slave);
+void i2cSlaveSet(I2cSlave_t *slave, uint8_t address, const void *data,
+                 uint32_t length);
+void i2cSlaveGet(I2cSlave_t *slave, uint8_t address, void *data,
+                 uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_SLAVE_REGMAP_H
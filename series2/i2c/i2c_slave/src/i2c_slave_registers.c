@@ -0,0 +1,57 @@
+/***************************************************************************//**
+ * @file i2c_slave_registers.c
+ * @brief Register map of the I2C slave example
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "i2c_slave_registers.h"
+
+const I2cSlaveRegister_t slaveRegisters[] = {
+  { REG_BUFFER + 0, 1, 0, NULL },
+  { REG_BUFFER + 1, 1, 0, NULL },
+  { REG_BUFFER + 2, 1, 0, NULL },
+  { REG_BUFFER + 3, 1, 0, NULL },
+  { REG_BUFFER + 4, 1, 0, NULL },
+  { REG_BUFFER + 5, 1, 0, NULL },
+  { REG_BUFFER + 6, 1, 0, NULL },
+  { REG_BUFFER + 7, 1, 0, NULL },
+  { REG_BUFFER + 8, 1, 0, NULL },
+  { REG_BUFFER + 9, 1, 0, NULL },
+  { REG_COMMAND, 1, I2C_SLAVE_REG_WRITE_ONLY, commandWritten },
+  { REG_WHO_AM_I, 1, I2C_SLAVE_REG_READ_ONLY, NULL },
+  { REG_SAMPLES, REG_SAMPLES_SIZE, I2C_SLAVE_REG_READ_ONLY, NULL },
+  { REG_THRESHOLD, 4, 0, thresholdWritten },
+};
+
+const uint32_t slaveRegisterCount =
+  sizeof(slaveRegisters) / sizeof(slaveRegisters[0]);
@@ -0,0 +1,406 @@
+/***************************************************************************//**
+ * @file i2c_slave_regmap.c
+ * @brief I2C slave serving a table of registers, with LDMA bursts
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <string.h>
+#include "em_assert.h"
+#include "em_core.h"
+#include "em_i2c.h"
+#include "em_ldma.h"
+#include "i2c_slave_regmap.h"
+
+// Largest transfer count of one LDMA descriptor
+#define LDMA_MAX_XFER_COUNT  ((_LDMA_CH_CTRL_XFERCNT_MASK                      \
+                               >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+
+/**************************************************************************//**
+ * @brief
+ *    Stream the bytes the master writes into the shadow, from the register
+ *    address on
+ *****************************************************************************/
+static void startWrite(I2cSlave_t *slave)
+{
+  LDMA_Descriptor_t *first = &slave->rxDescriptor[1];
+
+  if (slave->pointer < I2C_SLAVE_SIZE) {
+    slave->rxDescriptor[0] = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&slave->i2c->RXDATA,
+                                       &slave->shadow[slave->pointer],
+                                       I2C_SLAVE_SIZE - slave->pointer, 1);
+    slave->rxDescriptor[0].xfer.doneIfs = 0;
+    first = &slave->rxDescriptor[0];
+  }
+
+  LDMA_StartTransfer(slave->rxChannel, &slave->rxConfig, first);
+  slave->state = i2cSlaveWriting;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Stream the image to the master, from the register address on
+ *****************************************************************************/
+static void startRead(I2cSlave_t *slave)
+{
+  LDMA_Descriptor_t *first = &slave->txDescriptor[1];
+
+  if (slave->pointer < I2C_SLAVE_SIZE) {
+    slave->txDescriptor[0] = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(&slave->image[slave->pointer],
+                                       &slave->i2c->TXDATA,
+                                       I2C_SLAVE_SIZE - slave->pointer, 1);
+    slave->txDescriptor[0].xfer.doneIfs = 0;
+    first = &slave->txDescriptor[0];
+  }
+
+  LDMA_StartTransfer(slave->txChannel, &slave->txConfig, first);
+  slave->state = i2cSlaveReading;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Stop the channel taking the written bytes
+ *
+ * @return
+ *    Register address after the last byte stored in the shadow, or
+ *    I2C_SLAVE_SIZE + 1 once the channel is on the discard byte
+ *
+ * @details
+ *    Waits until a byte in flight is stored, so DST and the RXDATAV flag
+ *    don't change anymore. Stopping again returns the same address.
+ *****************************************************************************/
+static uint32_t stopWrite(I2cSlave_t *slave)
+{
+  uint32_t dst;
+
+  LDMA_StopTransfer(slave->rxChannel);
+  while (LDMA->CHBUSY & (1UL << slave->rxChannel)) {
+  }
+
+  // The channel writes the next byte to DST
+  dst = LDMA->CH[slave->rxChannel].DST;
+  if (dst == (uint32_t)(uintptr_t)&slave->discard) {
+    return I2C_SLAVE_SIZE + 1;
+  }
+  return dst - (uint32_t)(uintptr_t)slave->shadow;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Copy the registers written in full into the image and call their
+ *    callbacks
+ *
+ * @param[in] end
+ *    Register address after the last byte written
+ *****************************************************************************/
+static void commitWrite(I2cSlave_t *slave, uint32_t end)
+{
+  const I2cSlaveRegister_t *reg;
+  const uint8_t *data;
+  uint32_t i;
+
+  for (i = 0; i < slave->count; i++) {
+    reg = &slave->map[i];
+    if ((reg->address < slave->pointer)
+        || (reg->address + reg->width > end)
+        || (reg->flags & I2C_SLAVE_REG_READ_ONLY)) {
+      continue;
+    }
+
+    if (reg->flags & I2C_SLAVE_REG_WRITE_ONLY) {
+      data = &slave->shadow[reg->address];
+    } else {
+      memcpy(&slave->image[reg->address], &slave->shadow[reg->address],
+             reg->width);
+      data = &slave->image[reg->address];
+    }
+    if (reg->written != NULL) {
+      reg->written(reg->address, data, reg->width);
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    End the current transfer on a stop, a repeated start or an error
+ *
+ * @param[in] commit
+ *    Commit the bytes written, false to drop them
+ *
+ * @param[in] addressTaken
+ *    The LDMA stored the address of a repeated start after the bytes
+ *    written
+ *****************************************************************************/
+static void endTransfer(I2cSlave_t *slave, bool commit, bool addressTaken)
+{
+  uint32_t end;
+
+  switch (slave->state) {
+    case i2cSlaveRegisterAddress:
+      I2C_IntDisable(slave->i2c, I2C_IEN_RXDATAV);
+      break;
+
+    case i2cSlaveWriting:
+      end = stopWrite(slave);
+      slave->i2c->CTRL_CLR = I2C_CTRL_AUTOACK;
+      if (end > I2C_SLAVE_SIZE) {
+        end = I2C_SLAVE_SIZE;
+      } else if (addressTaken) {
+        end--;
+      }
+      if (commit) {
+        commitWrite(slave, end);
+      }
+      slave->transfers++;
+      break;
+
+    case i2cSlaveReading:
+      // Drop the bytes the LDMA wrote ahead into the transmit buffer
+      LDMA_StopTransfer(slave->txChannel);
+      slave->i2c->CMD = I2C_CMD_CLEARTX;
+      slave->transfers++;
+      break;
+
+    default:
+      break;
+  }
+
+  slave->state = i2cSlaveIdle;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start serving the register map
+ *
+ * @param[in] slave
+ *    Slave state, the image is cleared to I2C_SLAVE_FILL
+ *
+ * @param[in] i2c
+ *    I2C initialized as a slave with its slave address set
+ *
+ * @param[in] map
+ *    Registers sorted by address, not overlapping and within
+ *    I2C_SLAVE_SIZE. Must stay valid.
+ *
+ * @param[in] count
+ *    Registers in map
+ *
+ * @param[in] rxChannel
+ *    LDMA channel for written bytes, must not be used by anything else
+ *
+ * @param[in] rxReqSel
+ *    LDMAXBAR request signal and source of the I2C RXDATAV request
+ *
+ * @param[in] txChannel
+ *    LDMA channel for read bytes, must not be used by anything else
+ *
+ * @param[in] txReqSel
+ *    LDMAXBAR request signal and source of the I2C TXBL request
+ *
+ * @note
+ *    LDMA_Init() must have been called. The LDMA channels never interrupt.
+ *****************************************************************************/
+void i2cSlaveInit(I2cSlave_t *slave, I2C_TypeDef *i2c,
+                  const I2cSlaveRegister_t *map, uint32_t count,
+                  uint32_t rxChannel, uint32_t rxReqSel,
+                  uint32_t txChannel, uint32_t txReqSel)
+{
+  LDMA_TransferCfg_t rxConfig = LDMA_TRANSFER_CFG_PERIPHERAL(rxReqSel);
+  LDMA_TransferCfg_t txConfig = LDMA_TRANSFER_CFG_PERIPHERAL(txReqSel);
+  uint32_t i;
+
+  EFM_ASSERT((I2C_SLAVE_SIZE <= 256)
+             && (I2C_SLAVE_SIZE <= LDMA_MAX_XFER_COUNT));
+  for (i = 0; i < count; i++) {
+    EFM_ASSERT(map[i].width > 0);
+    EFM_ASSERT(map[i].address + map[i].width <= I2C_SLAVE_SIZE);
+    EFM_ASSERT((i == 0)
+               || (map[i - 1].address + map[i - 1].width <= map[i].address));
+  }
+
+  slave->i2c = i2c;
+  slave->map = map;
+  slave->count = count;
+  slave->rxChannel = rxChannel;
+  slave->txChannel = txChannel;
+  slave->rxConfig = rxConfig;
+  slave->txConfig = txConfig;
+  slave->state = i2cSlaveIdle;
+  slave->pointer = 0;
+  slave->fill = I2C_SLAVE_FILL;
+  slave->transfers = 0;
+  slave->errors = 0;
+  memset(slave->image, I2C_SLAVE_FILL, sizeof(slave->image));
+
+  // Bytes written past the end of the address space are dropped
+  LDMA_Descriptor_t discard =
+    LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&i2c->RXDATA, &slave->discard,
+                                     LDMA_MAX_XFER_COUNT, 0);
+  discard.xfer.dstInc = ldmaCtrlDstIncNone;
+  discard.xfer.doneIfs = 0;
+  slave->rxDescriptor[1] = discard;
+
+  // Fill bytes are sent past it, both are linked to themselves so that the
+  // channels never end
+  LDMA_Descriptor_t fill =
+    LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(&slave->fill, &i2c->TXDATA,
+                                     LDMA_MAX_XFER_COUNT, 0);
+  fill.xfer.srcInc = ldmaCtrlSrcIncNone;
+  fill.xfer.doneIfs = 0;
+  slave->txDescriptor[1] = fill;
+
+  I2C_IntClear(i2c, _I2C_IF_MASK);
+  I2C_IntEnable(i2c, I2C_IEN_ADDR | I2C_IEN_SSTOP | I2C_IEN_BUSERR
+                | I2C_IEN_ARBLOST);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Handle the I2C interrupt, call from the I2C IRQ handler
+ *
+ * @details
+ *    Interrupts on the slave address, the register address of writes, the
+ *    stop condition and bus errors. The bus is held after the addresses
+ *    until they are acknowledged, which is done once the LDMA is ready.
+ *****************************************************************************/
+void i2cSlaveIrq(I2cSlave_t *slave)
+{
+  I2C_TypeDef *i2c = slave->i2c;
+  uint32_t pending = I2C_IntGetEnabled(i2c);
+  uint32_t rxData = 0;
+  uint32_t end;
+  bool addressTaken;
+
+  // A fault aborts the transfer, the bytes written are dropped
+  if (pending & (I2C_IF_BUSERR | I2C_IF_ARBLOST)) {
+    I2C_IntClear(i2c, I2C_IF_BUSERR | I2C_IF_ARBLOST);
+    endTransfer(slave, false, false);
+    slave->errors++;
+    return;
+  }
+
+  // The end of the previous transfer comes before a new address
+  if (pending & I2C_IF_SSTOP) {
+    I2C_IntClear(i2c, I2C_IF_SSTOP);
+    endTransfer(slave, true, false);
+  }
+
+  if (pending & I2C_IF_ADDR) {
+    // A repeated start ends the transfer before it. The address sets
+    // RXDATAV, so while writing the LDMA may already have taken it as one
+    // more byte, the one before DST. The channel is stopped first so that
+    // it can't take the address between the two reads.
+    addressTaken = false;
+    if (slave->state == i2cSlaveWriting) {
+      end = stopWrite(slave);
+      if (!(i2c->STATUS & I2C_STATUS_RXDATAV)) {
+        rxData = (end > I2C_SLAVE_SIZE) ? slave->discard
+                                        : slave->shadow[end - 1];
+        addressTaken = true;
+      }
+    }
+    if (!addressTaken) {
+      rxData = i2c->RXDATA;
+    }
+    endTransfer(slave, true, addressTaken);
+
+    I2C_IntClear(i2c, I2C_IF_ADDR | I2C_IF_RXDATAV);
+
+    if (rxData & 0x1) {
+      // Read bit set, the first byte is in the transmit buffer before the
+      // master gets the acknowledge
+      startRead(slave);
+    } else {
+      slave->state = i2cSlaveRegisterAddress;
+      I2C_IntEnable(i2c, I2C_IEN_RXDATAV);
+    }
+    i2c->CMD = I2C_CMD_ACK;
+  } else if ((pending & I2C_IF_RXDATAV)
+             && (slave->state == i2cSlaveRegisterAddress)) {
+    // Register address, the LDMA takes the bytes after it and they are
+    // acknowledged automatically
+    slave->pointer = (uint8_t)i2c->RXDATA;
+    I2C_IntDisable(i2c, I2C_IEN_RXDATAV);
+    I2C_IntClear(i2c, I2C_IF_RXDATAV);
+    startWrite(slave);
+    i2c->CTRL_SET = I2C_CTRL_AUTOACK;
+    i2c->CMD = I2C_CMD_ACK;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    true while a transfer is in progress
+ *****************************************************************************/
+bool i2cSlaveBusy(I2cSlave_t *slave)
+{
+  return slave->state != i2cSlaveIdle;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Update the value of registers read by the master, e.g. new samples
+ *
+ * @details
+ *    The bytes are copied with interrupts disabled, so they don't change
+ *    in the middle of a write commit. A read in progress may send some of
+ *    the old bytes and some of the new ones; update between transfers, see
+ *    i2cSlaveBusy(), for multi-byte registers that must be read as a whole.
+ *****************************************************************************/
+void i2cSlaveSet(I2cSlave_t *slave, uint8_t address, const void *data,
+                 uint32_t length)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  EFM_ASSERT(address + length <= I2C_SLAVE_SIZE);
+
+  CORE_ENTER_ATOMIC();
+  memcpy(&slave->image[address], data, length);
+  CORE_EXIT_ATOMIC();
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Get the value of registers, as last committed or set
+ *****************************************************************************/
+void i2cSlaveGet(I2cSlave_t *slave, uint8_t address, void *data,
+                 uint32_t length)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  EFM_ASSERT(address + length <= I2C_SLAVE_SIZE);
+
+  CORE_ENTER_ATOMIC();
+  memcpy(data, &slave->image[address], length);
+  CORE_EXIT_ATOMIC();
+}
@@ -9,6 +9,12 @@
  * program runs in a continuous loop, entering and exiting EM2 to handle I2C
  * transmissions. Slave toggles LED0 on during I2C transaction and off when
  * complete. Slave will set LED1 if an I2C transmission error is encountered.
+ *
+ * The slave serves the table of registers in src/i2c_slave_registers.c with
+ * the engine in src/i2c_slave_regmap.c. The byte after the slave address of
+ * a write selects a register, and the bytes written or read after it are
+ * moved by the LDMA, so the CPU only handles the addresses and the stop
+ * condition of each transfer.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -48,20 +54,22 @@
 #include "em_cmu.h"
 #include "em_emu.h"
 #include "em_gpio.h"
+#include "em_ldma.h"
 #include "em_rtcc.h"
 #include "bsp.h"
+#include "i2c_slave_registers.h"
 
 // Defines
 #define I2C_ADDRESS                     0xE2
-#define I2C_BUFFER_SIZE                 10
 
-// Buffers
-uint8_t i2c_Buffer[I2C_BUFFER_SIZE];
-uint8_t i2c_BufferIndex;
+// LDMA channels for the bytes written and read by the master
+#define RX_LDMA_CHANNEL                 0
+#define TX_LDMA_CHANNEL                 1
+
+I2cSlave_t slave;
 
-// Transmission flags
-volatile bool i2c_gotTargetAddress;
-volatile bool i2c_rxInProgress;
+// Last threshold written by the master
+uint32_t threshold;
 
 extern void disableClocks(void);
 
@@ -70,9 +78,10 @@ extern void disableClocks(void);
  *****************************************************************************/
 void initCMU(void)
 {
-  // Enabling clock to the I2C and GPIO
+  // Enabling clock to the I2C, GPIO and LDMA
   CMU_ClockEnable(cmuClock_I2C0, true);
   CMU_ClockEnable(cmuClock_GPIO, true);
+  CMU_ClockEnable(cmuClock_LDMA, true);
 }
 
 /**************************************************************************//**
@@ -86,12 +95,14 @@ void initGPIO(void)
 }
 
 /**************************************************************************//**
- * @brief  Setup I2C
+ * @brief  Setup I2C and the register map
  *****************************************************************************/
 void initI2C(void)
 {
   // Using default settings
   I2C_Init_TypeDef i2cInit = I2C_INIT_DEFAULT;
+  LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
+  uint8_t whoAmI = WHO_AM_I;
 
   // Configure to be addressable as slave
   i2cInit.master = false;
@@ -112,128 +123,78 @@ void initI2C(void)
   // Initializing the I2C
   I2C_Init(I2C0, &i2cInit);
 
-  // Initializing the buffer index
-  i2c_BufferIndex = 0;
-
   // Setting up to enable slave mode
   I2C_SlaveAddressSet(I2C0, I2C_ADDRESS);
   I2C_SlaveAddressMaskSet(I2C0, 0xFE); // must match exact address
 
-  // Configure interrupts
-  I2C_IntClear(I2C0, _I2C_IF_MASK);
-  I2C_IntEnable(I2C0, I2C_IEN_ADDR | I2C_IEN_RXDATAV | I2C_IEN_ACK | I2C_IEN_SSTOP | I2C_IEN_BUSERR | I2C_IEN_ARBLOST);
+  // Serve the register map, the LDMA moves the data bytes
+  LDMA_Init(&ldmaInit);
+  i2cSlaveInit(&slave, I2C0, slaveRegisters, slaveRegisterCount,
+               RX_LDMA_CHANNEL,
+               LDMAXBAR_CH_REQSEL_SIGSEL_I2C0RXDATAV
+               | LDMAXBAR_CH_REQSEL_SOURCESEL_I2C0,
+               TX_LDMA_CHANNEL,
+               LDMAXBAR_CH_REQSEL_SIGSEL_I2C0TXBL
+               | LDMAXBAR_CH_REQSEL_SOURCESEL_I2C0);
+  i2cSlaveSet(&slave, REG_WHO_AM_I, &whoAmI, 1);
+
   NVIC_EnableIRQ(I2C0_IRQn);
 }
 
 /**************************************************************************//**
- * @brief I2C Interrupt Handler.
- *        The interrupt table is in assembly startup file startup_efm32.s
+ * @brief Called when the master writes REG_COMMAND
  *****************************************************************************/
-void I2C0_IRQHandler(void)
+void commandWritten(uint8_t address, const uint8_t *data, uint8_t width)
 {
-  uint32_t pending;
-  uint32_t rxData;
+  (void)address;
+  (void)width;
 
-  pending = I2C0->IF;
+  if (data[0] == COMMAND_CLEAR_ERROR) {
+    GPIO_PinOutClear(BSP_GPIO_LED1_PORT, BSP_GPIO_LED1_PIN);
+  }
+}
 
-  /* If some sort of fault, abort transfer. */
-  if (pending & (I2C_IF_BUSERR | I2C_IF_ARBLOST))
-  {
-    i2c_rxInProgress = false;
-    GPIO_PinOutSet(BSP_GPIO_LED1_PORT, BSP_GPIO_LED1_PIN);
-  } else
-  {
-    if(pending & I2C_IF_ADDR)
-    {
-      // Address Match
-      // Indicating that reception is started
-      rxData = I2C0->RXDATA;
-      I2C0->CMD = I2C_CMD_ACK;
-      i2c_rxInProgress = true;
-
-      if(rxData & 0x1) // read bit set
-      {
-        if(i2c_BufferIndex < I2C_BUFFER_SIZE) {
-          // transfer data
-          I2C0->TXDATA     = i2c_Buffer[i2c_BufferIndex++];
-        } else
-        {
-          // invalid buffer index; transfer data as if slave non-responsive
-          I2C0->TXDATA     = 0xFF;
-        }
-      } else
-      {
-        i2c_gotTargetAddress = false;
-      }
-
-      I2C_IntClear(I2C0, I2C_IF_ADDR | I2C_IF_RXDATAV);
-
-      GPIO_PinOutSet(BSP_GPIO_LED0_PORT, BSP_GPIO_LED0_PIN);
-    } else if(pending & I2C_IF_RXDATAV)
-    {
-      rxData = I2C0->RXDATA;
-
-      if(!i2c_gotTargetAddress)
-      {
-        /******************************************************/
-        /* Read target address from master.                   */
-        /******************************************************/
-        // verify that target address is valid
-        if(rxData < I2C_BUFFER_SIZE)
-        {
-          // store target address
-          i2c_BufferIndex = rxData;
-          I2C0->CMD = I2C_CMD_ACK;
-          i2c_gotTargetAddress = true;
-        } else
-        {
-          I2C0->CMD = I2C_CMD_NACK;
-        }
-      } else
-      {
-        /******************************************************/
-        /* Read new data and write to target address          */
-        /******************************************************/
-        // verify that target address is valid
-        if(i2c_BufferIndex < I2C_BUFFER_SIZE)
-        {
-          // write new data to target address; auto increment target address
-          i2c_Buffer[i2c_BufferIndex++] = rxData;
-          I2C0->CMD = I2C_CMD_ACK;
-        } else
-        {
-          I2C0->CMD = I2C_CMD_NACK;
-        }
-      }
-
-      I2C_IntClear(I2C0, I2C_IF_RXDATAV);
-    }
+/**************************************************************************//**
+ * @brief Called when the master writes all 4 bytes of REG_THRESHOLD
+ *****************************************************************************/
+void thresholdWritten(uint8_t address, const uint8_t *data, uint8_t width)
+{
+  (void)address;
+  (void)width;
 
-    if(pending & I2C_IF_ACK)
-    {
-      /******************************************************/
-      /* Master ACK'ed, so requesting more data.            */
-      /******************************************************/
-      if(i2c_BufferIndex < I2C_BUFFER_SIZE)
-      {
-        // transfer data
-        I2C0->TXDATA     = i2c_Buffer[i2c_BufferIndex++];
-      } else
-      {
-        // invalid buffer index; transfer data as if slave non-responsive
-        I2C0->TXDATA     = 0xFF;
-      }
-
-      I2C_IntClear(I2C0, I2C_IF_ACK);
-    }
+  threshold = data[0] | (data[1] << 8) | (data[2] << 16)
+              | ((uint32_t)data[3] << 24);
+}
 
-    if(pending & I2C_IF_SSTOP)
-    {
-      // end of transaction
-      i2c_rxInProgress = false;
+/**************************************************************************//**
+ * @brief Update the samples the master reads in one burst
+ *****************************************************************************/
+static void updateSamples(void)
+{
+  static uint8_t samples[REG_SAMPLES_SIZE];
+  uint32_t i;
 
-      I2C_IntClear(I2C0, I2C_IF_SSTOP);
-    }
+  // Stand-in for sensor data, changes with every transfer
+  for (i = 0; i < REG_SAMPLES_SIZE; i++) {
+    samples[i] = (uint8_t)(slave.transfers + i);
+  }
+  i2cSlaveSet(&slave, REG_SAMPLES, samples, REG_SAMPLES_SIZE);
+}
+
+/**************************************************************************//**
+ * @brief I2C Interrupt Handler.
+ *        The interrupt table is in assembly startup file startup_efm32.s
+ *****************************************************************************/
+void I2C0_IRQHandler(void)
+{
+  i2cSlaveIrq(&slave);
+
+  // LED0 is on during transfers, LED1 once an error has been seen
+  if (i2cSlaveBusy(&slave)) {
+    GPIO_PinOutSet(BSP_GPIO_LED0_PORT, BSP_GPIO_LED0_PIN);
+  }
+  if (slave.errors) {
+    GPIO_PinOutSet(BSP_GPIO_LED1_PORT, BSP_GPIO_LED1_PIN);
   }
 }
 
@@ -299,12 +260,16 @@ int main(void)
 
   while (1)
   {
-    // Receiving I2C data; keep in EM1 during transmission
-    while(i2c_rxInProgress)
+    // Receiving I2C data; keep in EM1 during transmission, the LDMA moves
+    // the data bytes
+    while(i2cSlaveBusy(&slave))
     {
       EMU_EnterEM1();
     }
 
+    // New samples for the next burst read
+    updateSamples();
+
     GPIO_PinOutClear(BSP_GPIO_LED0_PORT, BSP_GPIO_LED0_PIN);
 
     // Enter EM2. The I2C address match will wake up the EFM32
@@ -0,0 +1,50 @@
+/***************************************************************************//**
+ * @file bsp.h
+ * @brief Host build replacement for the kit BSP pin definitions.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef BSP_H
+#define BSP_H
+
+#include "em_gpio.h"
+
+#define BSP_GPIO_PB0_PORT   gpioPortB
+#define BSP_GPIO_PB0_PIN    0
+#define BSP_GPIO_PB1_PORT   gpioPortB
+#define BSP_GPIO_PB1_PIN    1
+#define BSP_GPIO_LED0_PORT  gpioPortD
+#define BSP_GPIO_LED0_PIN   2
+#define BSP_GPIO_LED1_PORT  gpioPortD
+#define BSP_GPIO_LED1_PIN   3
+
+#endif // BSP_H
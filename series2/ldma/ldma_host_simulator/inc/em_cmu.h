@@ -0,0 +1,77 @@
+/***************************************************************************//**
+ * @file em_cmu.h
+ * @brief Host build replacement for the emlib CMU API.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_CMU_H
+#define EM_CMU_H
+
+#include "em_device.h"
+
+typedef enum
+{
+  cmuClock_GPIO,
+  cmuClock_LDMA,
+  cmuClock_PRS,
+  cmuClock_PDM,
+  cmuClock_IADC0,
+  cmuClock_EUART0,
+  cmuClock_USART0,
+  cmuClock_TIMER0,
+  cmuClock_GPCRC,
+  cmuClock_I2C0,
+  cmuClock_HFLE
+} CMU_Clock_TypeDef;
+
+typedef enum
+{
+  cmuOsc_LFXO,
+  cmuOsc_LFRCO
+} CMU_Osc_TypeDef;
+
+// Clocks are always running on the host
+__STATIC_INLINE void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
+{
+  (void)clock;
+  (void)enable;
+}
+
+__STATIC_INLINE void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable,
+                                          bool wait)
+{
+  (void)osc;
+  (void)enable;
+  (void)wait;
+}
+
+#endif // EM_CMU_H
@@ -0,0 +1,47 @@
+/***************************************************************************//**
+ * @file em_core.h
+ * @brief Host build replacement for the emlib CORE critical section macros.
+ * The simulator calls LDMA_IRQHandler() from LDMASIM_Run(), so interrupts
+ * never preempt the host program and the macros have no effect.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_CORE_H
+#define EM_CORE_H
+
+#define CORE_DECLARE_IRQ_STATE    int coreIrqState __attribute__((unused))
+#define CORE_ENTER_ATOMIC()       ((void)0)
+#define CORE_EXIT_ATOMIC()        ((void)0)
+#define CORE_ENTER_CRITICAL()     ((void)0)
+#define CORE_EXIT_CRITICAL()      ((void)0)
+
+#endif // EM_CORE_H
@@ -0,0 +1,186 @@
+/***************************************************************************//**
+ * @file em_device.h
+ * @brief Host build replacement for the device header. Provides the
+ * register blocks the LDMA simulator models and the request selection
+ * constants used by the series 2 LDMA examples.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __STATIC_INLINE static inline
+#define __IM  volatile const
+#define __IOM volatile
+
+// Interrupts of the examples. The NVIC is not modelled, the simulators call
+// the IRQ handlers directly.
+typedef enum
+{
+  LDMA_IRQn,
+  GPIO_EVEN_IRQn,
+  GPIO_ODD_IRQn,
+  I2C0_IRQn
+} IRQn_Type;
+
+__STATIC_INLINE void NVIC_EnableIRQ(IRQn_Type irq)
+{
+  (void)irq;
+}
+
+__STATIC_INLINE void NVIC_DisableIRQ(IRQn_Type irq)
+{
+  (void)irq;
+}
+
+__STATIC_INLINE void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+  (void)irq;
+}
+
+// LDMA channel registers, updated by the simulator as a channel runs
+typedef struct
+{
+  __IOM uint32_t CFG;             // Channel configuration
+  __IOM uint32_t LOOP;            // Channel loop counter
+  __IOM uint32_t CTRL;            // Channel descriptor control word
+  __IOM uint32_t SRC;             // Channel descriptor source address
+  __IOM uint32_t DST;             // Channel descriptor destination address
+  __IOM uint32_t LINK;            // Channel descriptor link address
+} LDMA_CH_TypeDef;
+
+// Subset of the LDMA register block touched directly by the examples
+typedef struct
+{
+  __IOM uint32_t CHEN;            // Channel enable
+  __IOM uint32_t CHBUSY;          // Channel busy
+  __IOM uint32_t CHDONE;          // Channel linking done
+  __IOM uint32_t SWREQ;           // Channel software transfer request
+  __IOM uint32_t REQDIS;          // Channel request disable
+  __IOM uint32_t SYNC;            // Synchronization trigger
+  __IOM uint32_t IF;              // Interrupt flags
+  __IOM uint32_t IEN;             // Interrupt enable
+  LDMA_CH_TypeDef CH[8];          // Channel registers
+} LDMA_TypeDef;
+
+extern LDMA_TypeDef ldmaSimRegs;
+#define LDMA (&ldmaSimRegs)
+
+// GPCRC register block, modelled by src/gpcrc_sim.c
+typedef struct
+{
+  __IOM uint32_t CTRL;            // Control
+  __IOM uint32_t CMD;             // Command
+  __IOM uint32_t INIT;            // CRC init value
+  __IOM uint32_t POLY;            // CRC polynomial value
+  __IOM uint32_t INPUTDATA;       // Input 32-bit data
+  __IOM uint32_t INPUTDATAHWORD;  // Input 16-bit data
+  __IOM uint32_t INPUTDATABYTE;   // Input 8-bit data
+  __IM  uint32_t DATA;            // CRC data
+  __IM  uint32_t DATAREV;         // CRC data reverse
+  __IM  uint32_t DATABYTEREV;     // CRC data byte reverse
+} GPCRC_TypeDef;
+
+extern GPCRC_TypeDef gpcrcSimRegs;
+#define GPCRC (&gpcrcSimRegs)
+
+#define GPCRC_CTRL_EN               (0x1UL << 0)
+#define GPCRC_CTRL_POLYSEL          (0x1UL << 4)
+#define GPCRC_CTRL_BYTEMODE         (0x1UL << 8)
+#define GPCRC_CTRL_BITREVERSE       (0x1UL << 9)
+#define GPCRC_CTRL_BYTEREVERSE      (0x1UL << 10)
+#define GPCRC_CTRL_AUTOINIT         (0x1UL << 13)
+#define GPCRC_CMD_INIT              (0x1UL << 0)
+
+// USART register block. TXDATA is written by the LDMA and observed through
+// LDMASIM_MapRegisters(), RXDATA and STATUS are set by the host program and
+// CMD is read back by it.
+typedef struct
+{
+  __IOM uint32_t RXDATA;          // RX data
+  __IOM uint32_t TXDATA;          // TX data
+  __IOM uint32_t STATUS;          // Status
+  __IOM uint32_t CMD;             // Command
+} USART_TypeDef;
+
+#define USART_STATUS_RXDATAV        (0x1UL << 7)
+#define USART_CMD_CLEARTX           (0x1UL << 10)
+#define USART_CMD_CLEARRX           (0x1UL << 11)
+
+extern USART_TypeDef usartSimRegs[2];
+#define USART0 (&usartSimRegs[0])
+#define USART1 (&usartSimRegs[1])
+
+// GPIO port registers. Only DOUT is used, the LDMA writes its set and clear
+// aliases, which are observed through LDMASIM_MapRegisters().
+typedef struct
+{
+  __IOM uint32_t DOUT;            // Data out
+} GPIO_PORT_TypeDef;
+
+typedef struct
+{
+  GPIO_PORT_TypeDef P[4];         // Port registers
+  GPIO_PORT_TypeDef P_SET[4];     // Set alias of the port registers
+  GPIO_PORT_TypeDef P_CLR[4];     // Clear alias of the port registers
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef gpioSimRegs;
+#define GPIO (&gpioSimRegs)
+
+// Transfer count field of the channel CTRL register
+#define _LDMA_CH_CTRL_XFERCNT_SHIFT                 4
+#define _LDMA_CH_CTRL_XFERCNT_MASK                  0x7FF0UL
+
+// LDMAXBAR request selection, only carried through to the simulator
+#define LDMAXBAR_CH_REQSEL_SOURCESEL_LDMAXBAR       (0x1UL << 16)
+#define LDMAXBAR_CH_REQSEL_SIGSEL_LDMAXBARPRSREQ0   (0x0UL << 0)
+#define LDMAXBAR_CH_REQSEL_SIGSEL_LDMAXBARPRSREQ1   (0x1UL << 0)
+#define LDMAXBAR_CH_REQSEL_SOURCESEL_USART1         (0x21UL << 16)
+#define LDMAXBAR_CH_REQSEL_SIGSEL_USART1TXBL        (0x1UL << 0)
+#define LDMAXBAR_CH_REQSEL_SOURCESEL_I2C0           (0x18UL << 16)
+#define LDMAXBAR_CH_REQSEL_SIGSEL_I2C0RXDATAV       (0x0UL << 0)
+#define LDMAXBAR_CH_REQSEL_SIGSEL_I2C0TXBL          (0x1UL << 0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM_DEVICE_H
@@ -0,0 +1,81 @@
+/***************************************************************************//**
+ * @file em_gpcrc.h
+ * @brief Host replacement for the GPCRC driver, backed by the model in
+ * src/gpcrc_sim.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_GPCRC_H
+#define EM_GPCRC_H
+
+#include "em_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  uint32_t crcPoly;           // CRC polynomial, only 0x04C11DB7 is modelled
+  uint32_t initValue;         // Value loaded into GPCRC_DATA on start
+  bool     reverseByteOrder;  // Process 16/32-bit inputs MSB first
+  bool     reverseBits;       // Reverse the bits of each input byte
+  bool     enableByteMode;    // Only the low byte of each input is used
+  bool     autoInit;          // Reload initValue after every read
+  bool     enable;            // Enable the GPCRC
+} GPCRC_Init_TypeDef;
+
+#define GPCRC_INIT_DEFAULT                                                  \
+  {                                                                         \
+    0x04C11DB7UL, /* CRC32 polynomial */                                    \
+    0x00000000UL, /* Initial value 0 */                                     \
+    false,        /* Input bytes LSB first */                               \
+    false,        /* No bit reversal */                                     \
+    false,        /* All bytes of an input are used */                      \
+    false,        /* No automatic reload */                                 \
+    true,         /* Enable */                                              \
+  }
+
+void GPCRC_Init(GPCRC_TypeDef *gpcrc, const GPCRC_Init_TypeDef *init);
+void GPCRC_Start(GPCRC_TypeDef *gpcrc);
+void GPCRC_InputU32(GPCRC_TypeDef *gpcrc, uint32_t data);
+void GPCRC_InputU16(GPCRC_TypeDef *gpcrc, uint16_t data);
+void GPCRC_InputU8(GPCRC_TypeDef *gpcrc, uint8_t data);
+uint32_t GPCRC_DataRead(GPCRC_TypeDef *gpcrc);
+uint32_t GPCRC_DataReadBitReversed(GPCRC_TypeDef *gpcrc);
+uint32_t GPCRC_DataReadByteReversed(GPCRC_TypeDef *gpcrc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM_GPCRC_H
@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ * @file em_gpio.h
+ * @brief Host build replacement for the parts of the emlib GPIO API
+ * referenced by the LDMA examples. Pin configuration has no effect.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_GPIO_H
+#define EM_GPIO_H
+
+#include "em_device.h"
+
+typedef enum
+{
+  gpioPortA,
+  gpioPortB,
+  gpioPortC,
+  gpioPortD
+} GPIO_Port_TypeDef;
+
+typedef enum
+{
+  gpioModeDisabled,
+  gpioModeInput,
+  gpioModeInputPull,
+  gpioModeInputPullFilter,
+  gpioModePushPull,
+  gpioModeWiredAndPullUpFilter
+} GPIO_Mode_TypeDef;
+
+__STATIC_INLINE void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin,
+                                     GPIO_Mode_TypeDef mode, unsigned int out)
+{
+  (void)port;
+  (void)pin;
+  (void)mode;
+  (void)out;
+}
+
+__STATIC_INLINE void GPIO_IntConfig(GPIO_Port_TypeDef port, unsigned int pin,
+                                    bool risingEdge, bool fallingEdge,
+                                    bool enable)
+{
+  (void)port;
+  (void)pin;
+  (void)risingEdge;
+  (void)fallingEdge;
+  (void)enable;
+}
+
+// Pins are not modelled, LEDs and buttons have no effect
+__STATIC_INLINE void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  (void)port;
+  (void)pin;
+}
+
+__STATIC_INLINE void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  (void)port;
+  (void)pin;
+}
+
+__STATIC_INLINE void GPIO_PinOutToggle(GPIO_Port_TypeDef port,
+                                       unsigned int pin)
+{
+  (void)port;
+  (void)pin;
+}
+
+__STATIC_INLINE uint32_t GPIO_IntGet(void)
+{
+  return 0;
+}
+
+__STATIC_INLINE void GPIO_IntClear(uint32_t flags)
+{
+  (void)flags;
+}
+
+#endif // EM_GPIO_H
@@ -0,0 +1,522 @@
+/***************************************************************************//**
+ * @file em_ldma.h
+ * @brief Host build replacement for the emlib LDMA API. Provides the
+ * descriptor layout, transfer configuration and descriptor macros used by
+ * the series 2 LDMA examples so their initLdma() functions build unmodified
+ * on Linux and execute against the simulator in ldma_sim.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_LDMA_H
+#define EM_LDMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of simulated DMA channels
+#define DMA_CHAN_COUNT              8
+
+// Number of 32-bit words in a descriptor
+#define LDMA_DESCRIPTOR_NDWORDS     4
+
+// Interrupt flags, one DONE flag per channel plus the ERROR flag
+#define LDMA_IF_DONE0               (1UL << 0)
+#define LDMA_IF_ERROR               (1UL << 31)
+#define _LDMA_IF_DONE_MASK          ((1UL << DMA_CHAN_COUNT) - 1)
+
+typedef enum
+{
+  ldmaCtrlBlockSizeUnit1    = 0,
+  ldmaCtrlBlockSizeUnit2    = 1,
+  ldmaCtrlBlockSizeUnit3    = 2,
+  ldmaCtrlBlockSizeUnit4    = 3,
+  ldmaCtrlBlockSizeUnit6    = 4,
+  ldmaCtrlBlockSizeUnit8    = 5,
+  ldmaCtrlBlockSizeUnit16   = 7,
+  ldmaCtrlBlockSizeUnit32   = 9,
+  ldmaCtrlBlockSizeUnit64   = 10,
+  ldmaCtrlBlockSizeUnit128  = 11,
+  ldmaCtrlBlockSizeUnit256  = 12,
+  ldmaCtrlBlockSizeUnit512  = 13,
+  ldmaCtrlBlockSizeUnit1024 = 14,
+  ldmaCtrlBlockSizeAll      = 15
+} LDMA_CtrlBlockSize_t;
+
+typedef enum
+{
+  ldmaCtrlStructTypeXfer  = 0,
+  ldmaCtrlStructTypeSync  = 1,
+  ldmaCtrlStructTypeWrite = 2
+} LDMA_CtrlStructType_t;
+
+typedef enum
+{
+  ldmaCtrlReqModeBlock = 0,
+  ldmaCtrlReqModeAll   = 1
+} LDMA_CtrlReqMode_t;
+
+typedef enum
+{
+  ldmaCtrlSrcIncOne  = 0,
+  ldmaCtrlSrcIncTwo  = 1,
+  ldmaCtrlSrcIncFour = 2,
+  ldmaCtrlSrcIncNone = 3
+} LDMA_CtrlSrcInc_t;
+
+typedef enum
+{
+  ldmaCtrlSizeByte = 0,
+  ldmaCtrlSizeHalf = 1,
+  ldmaCtrlSizeWord = 2
+} LDMA_CtrlSize_t;
+
+typedef enum
+{
+  ldmaCtrlDstIncOne  = 0,
+  ldmaCtrlDstIncTwo  = 1,
+  ldmaCtrlDstIncFour = 2,
+  ldmaCtrlDstIncNone = 3
+} LDMA_CtrlDstInc_t;
+
+typedef enum
+{
+  ldmaCtrlSrcAddrModeAbs = 0,
+  ldmaCtrlSrcAddrModeRel = 1
+} LDMA_CtrlSrcAddrMode_t;
+
+typedef enum
+{
+  ldmaCtrlDstAddrModeAbs = 0,
+  ldmaCtrlDstAddrModeRel = 1
+} LDMA_CtrlDstAddrMode_t;
+
+typedef enum
+{
+  ldmaLinkModeAbs = 0,
+  ldmaLinkModeRel = 1
+} LDMA_LinkMode_t;
+
+typedef enum
+{
+  ldmaCfgArbSlotsAs1 = 0,
+  ldmaCfgArbSlotsAs2 = 1,
+  ldmaCfgArbSlotsAs4 = 2,
+  ldmaCfgArbSlotsAs8 = 3
+} LDMA_CfgArbSlots_t;
+
+typedef enum
+{
+  ldmaCfgSrcIncSignPos = 0,
+  ldmaCfgSrcIncSignNeg = 1
+} LDMA_CfgSrcIncSign_t;
+
+typedef enum
+{
+  ldmaCfgDstIncSignPos = 0,
+  ldmaCfgDstIncSignNeg = 1
+} LDMA_CfgDstIncSign_t;
+
+// Peripheral request signals referenced by the examples. The simulator does
+// not decode them; peripheral requests are raised with
+// LDMASIM_PeripheralRequest().
+typedef enum
+{
+  ldmaPeripheralSignal_NONE = 0,
+  ldmaPeripheralSignal_PDM_RXDATAV,
+  ldmaPeripheralSignal_IADC0_IADC_SCAN,
+  ldmaPeripheralSignal_IADC0_IADC_SINGLE,
+  ldmaPeripheralSignal_EUART0_RXFL,
+  ldmaPeripheralSignal_EUART0_TXFL,
+  ldmaPeripheralSignal_USART0_RXDATAV,
+  ldmaPeripheralSignal_USART0_TXBL,
+  ldmaPeripheralSignal_USART1_RXDATAV,
+  ldmaPeripheralSignal_USART1_TXBL,
+  ldmaPeripheralSignal_I2C0_RXDATAV,
+  ldmaPeripheralSignal_I2C0_TXBL,
+  ldmaPeripheralSignal_TIMER0_CC0,
+  ldmaPeripheralSignal_TIMER0_UFOF
+} LDMA_PeripheralSignal_t;
+
+// DMA descriptor, bit layout identical to the series 2 LDMA
+typedef union
+{
+  struct
+  {
+    uint32_t  structType : 2;
+    uint32_t  reserved0  : 1;
+    uint32_t  structReq  : 1;
+    uint32_t  xferCnt    : 11;
+    uint32_t  byteSwap   : 1;
+    uint32_t  blockSize  : 4;
+    uint32_t  doneIfs    : 1;
+    uint32_t  reqMode    : 1;
+    uint32_t  decLoopCnt : 1;
+    uint32_t  ignoreSrec : 1;
+    uint32_t  srcInc     : 2;
+    uint32_t  size       : 2;
+    uint32_t  dstInc     : 2;
+    uint32_t  srcAddrMode: 1;
+    uint32_t  dstAddrMode: 1;
+
+    uint32_t  srcAddr;
+    uint32_t  dstAddr;
+
+    uint32_t  linkMode   : 1;
+    uint32_t  link       : 1;
+    int32_t   linkAddr   : 30;
+  } xfer;
+
+  struct
+  {
+    uint32_t  structType : 2;
+    uint32_t  reserved0  : 1;
+    uint32_t  structReq  : 1;
+    uint32_t  xferCnt    : 11;
+    uint32_t  byteSwap   : 1;
+    uint32_t  blockSize  : 4;
+    uint32_t  doneIfs    : 1;
+    uint32_t  reqMode    : 1;
+    uint32_t  decLoopCnt : 1;
+    uint32_t  ignoreSrec : 1;
+    uint32_t  srcInc     : 2;
+    uint32_t  size       : 2;
+    uint32_t  dstInc     : 2;
+    uint32_t  srcAddrMode: 1;
+    uint32_t  dstAddrMode: 1;
+
+    uint32_t  syncSet    : 8;
+    uint32_t  syncClr    : 8;
+    uint32_t  reserved1  : 16;
+    uint32_t  matchVal   : 8;
+    uint32_t  matchEn    : 8;
+    uint32_t  reserved2  : 16;
+
+    uint32_t  linkMode   : 1;
+    uint32_t  link       : 1;
+    int32_t   linkAddr   : 30;
+  } sync;
+
+  struct
+  {
+    uint32_t  structType : 2;
+    uint32_t  reserved0  : 1;
+    uint32_t  structReq  : 1;
+    uint32_t  xferCnt    : 11;
+    uint32_t  byteSwap   : 1;
+    uint32_t  blockSize  : 4;
+    uint32_t  doneIfs    : 1;
+    uint32_t  reqMode    : 1;
+    uint32_t  decLoopCnt : 1;
+    uint32_t  ignoreSrec : 1;
+    uint32_t  srcInc     : 2;
+    uint32_t  size       : 2;
+    uint32_t  dstInc     : 2;
+    uint32_t  srcAddrMode: 1;
+    uint32_t  dstAddrMode: 1;
+
+    uint32_t  immVal;
+    uint32_t  dstAddr;
+
+    uint32_t  linkMode   : 1;
+    uint32_t  link       : 1;
+    int32_t   linkAddr   : 30;
+  } wri;
+} LDMA_Descriptor_t;
+
+typedef struct
+{
+  uint8_t   ldmaInitCtrlNumFixed;
+  uint8_t   ldmaInitCtrlSyncPrsClrEn;
+  uint8_t   ldmaInitCtrlSyncPrsSetEn;
+  uint8_t   ldmaInitIrqPriority;
+} LDMA_Init_t;
+
+typedef struct
+{
+  uint32_t              ldmaReqSel;
+  uint8_t               ldmaCtrlSyncPrsClrOff;
+  uint8_t               ldmaCtrlSyncPrsClrOn;
+  uint8_t               ldmaCtrlSyncPrsSetOff;
+  uint8_t               ldmaCtrlSyncPrsSetOn;
+  bool                  ldmaReqDis;
+  bool                  ldmaDbgHalt;
+  LDMA_CfgArbSlots_t    ldmaCfgArbSlots;
+  LDMA_CfgSrcIncSign_t  ldmaCfgSrcIncSign;
+  LDMA_CfgDstIncSign_t  ldmaCfgDstIncSign;
+  uint8_t               ldmaLoopCnt;
+} LDMA_TransferCfg_t;
+
+#define LDMA_INIT_DEFAULT                                                   \
+  {                                                                         \
+    0, 0, 0, 3                                                              \
+  }
+
+#define LDMA_TRANSFER_CFG_MEMORY()                                          \
+  {                                                                         \
+    0, 0, 0, 0, 0, false, false, ldmaCfgArbSlotsAs1,                        \
+    ldmaCfgSrcIncSignPos, ldmaCfgDstIncSignPos, 0                           \
+  }
+
+#define LDMA_TRANSFER_CFG_MEMORY_LOOP(loopCnt)                              \
+  {                                                                         \
+    0, 0, 0, 0, 0, false, false, ldmaCfgArbSlotsAs1,                        \
+    ldmaCfgSrcIncSignPos, ldmaCfgDstIncSignPos, (loopCnt)                   \
+  }
+
+#define LDMA_TRANSFER_CFG_PERIPHERAL(signal)                                \
+  {                                                                         \
+    (signal), 0, 0, 0, 0, false, false, ldmaCfgArbSlotsAs1,                 \
+    ldmaCfgSrcIncSignPos, ldmaCfgDstIncSignPos, 0                           \
+  }
+
+#define LDMA_TRANSFER_CFG_PERIPHERAL_LOOP(signal, loopCnt)                  \
+  {                                                                         \
+    (signal), 0, 0, 0, 0, false, false, ldmaCfgArbSlotsAs1,                 \
+    ldmaCfgSrcIncSignPos, ldmaCfgDstIncSignPos, (loopCnt)                   \
+  }
+
+// Common transfer descriptor body. Addresses are truncated to the 32-bit
+// LDMA address space, see readme.txt for the host link requirements.
+#define LDMASIM_DESCRIPTOR_XFER(req, bsize, ifs, rmode, sinc, sz, dinc,      \
+                                src, dest, count, lnk, jmp)                 \
+  {                                                                         \
+    .xfer =                                                                 \
+    {                                                                       \
+      .structType   = ldmaCtrlStructTypeXfer,                               \
+      .structReq    = (req),                                                \
+      .xferCnt      = (count) - 1,                                          \
+      .byteSwap     = 0,                                                    \
+      .blockSize    = (bsize),                                              \
+      .doneIfs      = (ifs),                                                \
+      .reqMode      = (rmode),                                              \
+      .decLoopCnt   = 0,                                                    \
+      .ignoreSrec   = 0,                                                    \
+      .srcInc       = (sinc),                                               \
+      .size         = (sz),                                                 \
+      .dstInc       = (dinc),                                               \
+      .srcAddrMode  = ldmaCtrlSrcAddrModeAbs,                               \
+      .dstAddrMode  = ldmaCtrlDstAddrModeAbs,                               \
+      .srcAddr      = (uint32_t)(uintptr_t)(src),                           \
+      .dstAddr      = (uint32_t)(uintptr_t)(dest),                          \
+      .linkMode     = ldmaLinkModeRel,                                      \
+      .link         = (lnk),                                                \
+      .linkAddr     = (jmp) * LDMA_DESCRIPTOR_NDWORDS                       \
+    }                                                                       \
+  }
+
+// Memory to memory descriptors
+#define LDMA_DESCRIPTOR_SINGLE_M2M(size, src, dest, count)                  \
+  LDMASIM_DESCRIPTOR_XFER(1, ldmaCtrlBlockSizeUnit1, 1, ldmaCtrlReqModeAll, \
+                          ldmaCtrlSrcIncOne, (size), ldmaCtrlDstIncOne,     \
+                          (src), (dest), (count), 0, 0)
+#define LDMA_DESCRIPTOR_LINKREL_M2M(size, src, dest, count, linkjmp)        \
+  LDMASIM_DESCRIPTOR_XFER(1, ldmaCtrlBlockSizeUnit1, 0, ldmaCtrlReqModeAll, \
+                          ldmaCtrlSrcIncOne, (size), ldmaCtrlDstIncOne,     \
+                          (src), (dest), (count), 1, (linkjmp))
+
+#define LDMA_DESCRIPTOR_SINGLE_M2M_WORD(src, dest, count)                   \
+  LDMA_DESCRIPTOR_SINGLE_M2M(ldmaCtrlSizeWord, src, dest, count)
+#define LDMA_DESCRIPTOR_SINGLE_M2M_HALF(src, dest, count)                   \
+  LDMA_DESCRIPTOR_SINGLE_M2M(ldmaCtrlSizeHalf, src, dest, count)
+#define LDMA_DESCRIPTOR_SINGLE_M2M_BYTE(src, dest, count)                   \
+  LDMA_DESCRIPTOR_SINGLE_M2M(ldmaCtrlSizeByte, src, dest, count)
+#define LDMA_DESCRIPTOR_LINKREL_M2M_WORD(src, dest, count, linkjmp)         \
+  LDMA_DESCRIPTOR_LINKREL_M2M(ldmaCtrlSizeWord, src, dest, count, linkjmp)
+#define LDMA_DESCRIPTOR_LINKREL_M2M_HALF(src, dest, count, linkjmp)         \
+  LDMA_DESCRIPTOR_LINKREL_M2M(ldmaCtrlSizeHalf, src, dest, count, linkjmp)
+#define LDMA_DESCRIPTOR_LINKREL_M2M_BYTE(src, dest, count, linkjmp)         \
+  LDMA_DESCRIPTOR_LINKREL_M2M(ldmaCtrlSizeByte, src, dest, count, linkjmp)
+
+// Absolute link descriptors, set linkAddr to (address of next) >> 2
+#define LDMA_DESCRIPTOR_LINKABS_M2M_WORD(src, dest, count)                  \
+  LDMA_DESCRIPTOR_LINKABS_M2M(ldmaCtrlSizeWord, src, dest, count)
+#define LDMA_DESCRIPTOR_LINKABS_M2M_HALF(src, dest, count)                  \
+  LDMA_DESCRIPTOR_LINKABS_M2M(ldmaCtrlSizeHalf, src, dest, count)
+#define LDMA_DESCRIPTOR_LINKABS_M2M_BYTE(src, dest, count)                  \
+  LDMA_DESCRIPTOR_LINKABS_M2M(ldmaCtrlSizeByte, src, dest, count)
+#define LDMA_DESCRIPTOR_LINKABS_M2M(size, src, dest, count)                 \
+  {                                                                         \
+    .xfer =                                                                 \
+    {                                                                       \
+      .structType   = ldmaCtrlStructTypeXfer,                               \
+      .structReq    = 1,                                                    \
+      .xferCnt      = (count) - 1,                                          \
+      .blockSize    = ldmaCtrlBlockSizeUnit1,                               \
+      .doneIfs      = 0,                                                    \
+      .reqMode      = ldmaCtrlReqModeAll,                                   \
+      .srcInc       = ldmaCtrlSrcIncOne,                                    \
+      .size         = (size),                                               \
+      .dstInc       = ldmaCtrlDstIncOne,                                    \
+      .srcAddr      = (uint32_t)(uintptr_t)(src),                           \
+      .dstAddr      = (uint32_t)(uintptr_t)(dest),                          \
+      .linkMode     = ldmaLinkModeAbs,                                      \
+      .link         = 1,                                                    \
+      .linkAddr     = 0                                                     \
+    }                                                                       \
+  }
+
+// Peripheral to memory descriptors
+#define LDMA_DESCRIPTOR_SINGLE_P2M(size, src, dest, count)                  \
+  LDMASIM_DESCRIPTOR_XFER(0, ldmaCtrlBlockSizeUnit1, 1,                     \
+                          ldmaCtrlReqModeBlock, ldmaCtrlSrcIncNone, (size), \
+                          ldmaCtrlDstIncOne, (src), (dest), (count), 0, 0)
+#define LDMA_DESCRIPTOR_LINKREL_P2M(size, src, dest, count, linkjmp)        \
+  LDMASIM_DESCRIPTOR_XFER(0, ldmaCtrlBlockSizeUnit1, 1,                     \
+                          ldmaCtrlReqModeBlock, ldmaCtrlSrcIncNone, (size), \
+                          ldmaCtrlDstIncOne, (src), (dest), (count), 1,     \
+                          (linkjmp))
+#define LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(src, dest, count)                   \
+  LDMA_DESCRIPTOR_SINGLE_P2M(ldmaCtrlSizeByte, src, dest, count)
+#define LDMA_DESCRIPTOR_SINGLE_P2M_WORD(src, dest, count)                   \
+  LDMA_DESCRIPTOR_SINGLE_P2M(ldmaCtrlSizeWord, src, dest, count)
+#define LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(src, dest, count, linkjmp)         \
+  LDMA_DESCRIPTOR_LINKREL_P2M(ldmaCtrlSizeByte, src, dest, count, linkjmp)
+#define LDMA_DESCRIPTOR_LINKREL_P2M_HALF(src, dest, count, linkjmp)         \
+  LDMA_DESCRIPTOR_LINKREL_P2M(ldmaCtrlSizeHalf, src, dest, count, linkjmp)
+#define LDMA_DESCRIPTOR_LINKREL_P2M_WORD(src, dest, count, linkjmp)         \
+  LDMA_DESCRIPTOR_LINKREL_P2M(ldmaCtrlSizeWord, src, dest, count, linkjmp)
+
+// Memory to peripheral descriptors
+#define LDMA_DESCRIPTOR_SINGLE_M2P(size, src, dest, count)                  \
+  LDMASIM_DESCRIPTOR_XFER(0, ldmaCtrlBlockSizeUnit1, 1,                     \
+                          ldmaCtrlReqModeBlock, ldmaCtrlSrcIncOne, (size),  \
+                          ldmaCtrlDstIncNone, (src), (dest), (count), 0, 0)
+#define LDMA_DESCRIPTOR_LINKREL_M2P(size, src, dest, count, linkjmp)        \
+  LDMASIM_DESCRIPTOR_XFER(0, ldmaCtrlBlockSizeUnit1, 1,                     \
+                          ldmaCtrlReqModeBlock, ldmaCtrlSrcIncOne, (size),  \
+                          ldmaCtrlDstIncNone, (src), (dest), (count), 1,    \
+                          (linkjmp))
+#define LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(src, dest, count)                   \
+  LDMA_DESCRIPTOR_SINGLE_M2P(ldmaCtrlSizeByte, src, dest, count)
+#define LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(src, dest, count, linkjmp)         \
+  LDMA_DESCRIPTOR_LINKREL_M2P(ldmaCtrlSizeByte, src, dest, count, linkjmp)
+
+// Peripheral to peripheral descriptor
+#define LDMA_DESCRIPTOR_SINGLE_P2P_BYTE(src, dest, count)                   \
+  LDMASIM_DESCRIPTOR_XFER(0, ldmaCtrlBlockSizeUnit1, 1,                     \
+                          ldmaCtrlReqModeBlock, ldmaCtrlSrcIncNone,         \
+                          ldmaCtrlSizeByte, ldmaCtrlDstIncNone, (src),      \
+                          (dest), (count), 0, 0)
+
+// Immediate write descriptors
+#define LDMASIM_DESCRIPTOR_WRITE(value, address, ifs, lnk, jmp)             \
+  {                                                                         \
+    .wri =                                                                  \
+    {                                                                       \
+      .structType   = ldmaCtrlStructTypeWrite,                              \
+      .structReq    = 1,                                                    \
+      .doneIfs      = (ifs),                                                \
+      .immVal       = (value),                                              \
+      .dstAddr      = (uint32_t)(uintptr_t)(address),                       \
+      .linkMode     = ldmaLinkModeRel,                                      \
+      .link         = (lnk),                                                \
+      .linkAddr     = (jmp) * LDMA_DESCRIPTOR_NDWORDS                       \
+    }                                                                       \
+  }
+#define LDMA_DESCRIPTOR_SINGLE_WRITE(value, address)                        \
+  LDMASIM_DESCRIPTOR_WRITE(value, address, 1, 0, 0)
+#define LDMA_DESCRIPTOR_LINKREL_WRITE(value, address, linkjmp)              \
+  LDMASIM_DESCRIPTOR_WRITE(value, address, 0, 1, linkjmp)
+
+// Synchronization descriptors
+#define LDMASIM_DESCRIPTOR_SYNC(set, clr, matchValue, matchEnable, ifs,      \
+                                lnk, jmp)                                   \
+  {                                                                         \
+    .sync =                                                                 \
+    {                                                                       \
+      .structType   = ldmaCtrlStructTypeSync,                               \
+      .structReq    = 1,                                                    \
+      .doneIfs      = (ifs),                                                \
+      .syncSet      = (set),                                                \
+      .syncClr      = (clr),                                                \
+      .matchVal     = (matchValue),                                         \
+      .matchEn      = (matchEnable),                                        \
+      .linkMode     = ldmaLinkModeRel,                                      \
+      .link         = (lnk),                                                \
+      .linkAddr     = (jmp) * LDMA_DESCRIPTOR_NDWORDS                       \
+    }                                                                       \
+  }
+#define LDMA_DESCRIPTOR_SINGLE_SYNC(set, clr, matchValue, matchEnable)      \
+  LDMASIM_DESCRIPTOR_SYNC(set, clr, matchValue, matchEnable, 1, 0, 0)
+#define LDMA_DESCRIPTOR_LINKREL_SYNC(set, clr, matchValue, matchEnable,     \
+                                     linkjmp)                               \
+  LDMASIM_DESCRIPTOR_SYNC(set, clr, matchValue, matchEnable, 0, 1, linkjmp)
+
+void LDMA_Init(const LDMA_Init_t *init);
+void LDMA_DeInit(void);
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer,
+                        const LDMA_Descriptor_t *descriptor);
+void LDMA_StopTransfer(int ch);
+bool LDMA_TransferDone(int ch);
+uint32_t LDMA_TransferRemainingCount(int ch);
+void LDMA_EnableChannelRequest(int ch, bool enable);
+
+static inline void LDMA_IntClear(uint32_t flags)
+{
+  LDMA->IF &= ~flags;
+}
+
+static inline void LDMA_IntDisable(uint32_t flags)
+{
+  LDMA->IEN &= ~flags;
+}
+
+static inline void LDMA_IntEnable(uint32_t flags)
+{
+  LDMA->IEN |= flags;
+}
+
+static inline uint32_t LDMA_IntGet(void)
+{
+  return LDMA->IF;
+}
+
+static inline uint32_t LDMA_IntGetEnabled(void)
+{
+  return LDMA->IF & LDMA->IEN;
+}
+
+static inline void LDMA_IntSet(uint32_t flags)
+{
+  LDMA->IF |= flags;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM_LDMA_H
@@ -0,0 +1,92 @@
+/***************************************************************************//**
+ * @file em_prs.h
+ * @brief Host build replacement for the parts of the emlib PRS API
+ * referenced by the LDMA examples. On the host, DMA requests routed
+ * through PRS are raised with LDMASIM_PeripheralRequest().
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_PRS_H
+#define EM_PRS_H
+
+#include "em_device.h"
+
+#define PRS_ASYNC_CH_CTRL_SOURCESEL_GPIO    0x1UL
+
+typedef enum
+{
+  prsTypeAsync,
+  prsTypeSync
+} PRS_ChType_t;
+
+typedef enum
+{
+  prsLogic_Zero,
+  prsLogic_A_NOR_B,
+  prsLogic_NOT_A_AND_B,
+  prsLogic_NOT_A,
+  prsLogic_A,
+  prsLogic_One
+} PRS_Logic_t;
+
+typedef enum
+{
+  prsConsumerLDMA_REQUEST0,
+  prsConsumerLDMA_REQUEST1
+} PRS_Consumer_t;
+
+__STATIC_INLINE void PRS_SourceAsyncSignalSet(unsigned int ch,
+                                              uint32_t source,
+                                              uint32_t signal)
+{
+  (void)ch;
+  (void)source;
+  (void)signal;
+}
+
+__STATIC_INLINE void PRS_Combine(unsigned int chA, unsigned int chB,
+                                 PRS_Logic_t logic)
+{
+  (void)chA;
+  (void)chB;
+  (void)logic;
+}
+
+__STATIC_INLINE void PRS_ConnectConsumer(unsigned int ch, PRS_ChType_t type,
+                                         PRS_Consumer_t consumer)
+{
+  (void)ch;
+  (void)type;
+  (void)consumer;
+}
+
+#endif // EM_PRS_H
@@ -0,0 +1,111 @@
+/***************************************************************************//**
+ * @file ldma_sim.h
+ * @brief Host-side LDMA descriptor chain simulator with bus cycle accounting.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef LDMA_SIM_H
+#define LDMA_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_ldma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bus cycle cost model. The LDMA on series 2 devices moves at most one unit
+ * per AHB read/write pair regardless of unit size, so the defaults below
+ * mirror zero wait state RAM to RAM transfers. Raise readCycles or
+ * writeCycles to model flash sources or peripheral registers on a slower
+ * bus.
+ */
+typedef struct
+{
+  uint32_t descWordCycles;      // Cycles per descriptor word fetched
+  uint32_t readCycles;          // Cycles per source unit read
+  uint32_t writeCycles;         // Cycles per destination unit write
+  uint32_t arbitrationCycles;   // Cycles lost at every arbitration point
+  uint32_t syncCycles;          // Cycles to execute a SYNC or WRI structure
+} LDMASIM_CostModel_t;
+
+#define LDMASIM_COST_MODEL_DEFAULT                                          \
+  {                                                                         \
+    1,    /* One cycle per descriptor word */                               \
+    1,    /* One cycle per read */                                          \
+    1,    /* One cycle per write */                                         \
+    2,    /* Two cycles per arbitration */                                  \
+    1     /* One cycle per SYNC or WRI structure */                         \
+  }
+
+// Per channel statistics, accumulated until LDMASIM_ResetStats()
+typedef struct
+{
+  uint32_t bytesMoved;          // Bytes written by XFER structures
+  uint32_t unitsMoved;          // Units (byte, half or word) moved
+  uint32_t descriptorFetches;   // Descriptors loaded, including loops
+  uint32_t descriptorsDone;     // Descriptors completed
+  uint32_t arbitrations;        // Arbitration points reached
+  uint32_t syncWaits;           // Times a SYNC structure stalled the channel
+  uint32_t busCycles;           // Estimated bus cycles spent by the channel
+  uint32_t doneInterrupts;      // DONE interrupts raised by the channel
+  bool     error;               // Channel stopped on an LDMA error
+} LDMASIM_Stats_t;
+
+/*
+ * Peripheral register models. Writes by the LDMA that fall inside a mapped
+ * register block are stored as usual and then passed to the model, which
+ * can act on them (e.g. feed a CRC). addr is the absolute address written.
+ */
+#define LDMASIM_MAX_REGISTER_MAPS   4
+
+typedef void (*LDMASIM_WriteHook_t)(uint32_t addr, unsigned int size,
+                                    uint32_t value);
+
+void LDMASIM_Reset(void);
+void LDMASIM_SetCostModel(const LDMASIM_CostModel_t *model);
+void LDMASIM_MapRegisters(volatile void *base, uint32_t length,
+                          LDMASIM_WriteHook_t write);
+void LDMASIM_PeripheralRequest(uint32_t chMask);
+uint32_t LDMASIM_Run(uint32_t maxCycles);
+bool LDMASIM_ErrorPending(void);
+void LDMASIM_GetStats(int ch, LDMASIM_Stats_t *stats);
+void LDMASIM_ResetStats(uint32_t chMask);
+void LDMASIM_PrintStats(const char *name, uint32_t chMask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LDMA_SIM_H
@@ -0,0 +1,229 @@
+/***************************************************************************//**
+ * @file gpcrc_sim.c
+ * @brief Bit-serial model of the series 1 GPCRC for the LDMA host simulator.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "em_gpcrc.h"
+#include "em_assert.h"
+#include "ldma_sim.h"
+
+// Simulated register block, see em_device.h
+GPCRC_TypeDef gpcrcSimRegs;
+
+/***************************************************************************//**
+ * @brief
+ *   Reverse the bit order of a word.
+ ******************************************************************************/
+static uint32_t reverseBits32(uint32_t x)
+{
+  uint32_t r = 0;
+  int i;
+
+  for (i = 0; i < 32; i++)
+  {
+    r = (r << 1) | ((x >> i) & 1);
+  }
+  return r;
+}
+
+static uint32_t reverseBytes32(uint32_t x)
+{
+  return (x >> 24) | ((x >> 8) & 0xFF00UL) | ((x << 8) & 0xFF0000UL)
+         | (x << 24);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Update the read registers from the CRC register.
+ ******************************************************************************/
+static void setData(GPCRC_TypeDef *gpcrc, uint32_t data)
+{
+  *(volatile uint32_t *)&gpcrc->DATA = data;
+  *(volatile uint32_t *)&gpcrc->DATAREV = reverseBits32(data);
+  *(volatile uint32_t *)&gpcrc->DATABYTEREV = reverseBytes32(data);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Shift one input byte through the CRC register.
+ *
+ * @details
+ *   The GPCRC is natively reflected: each byte enters LSB first and DATA
+ *   holds the reflected register. BITREVERSE reverses the bits of each
+ *   input byte, so DATAREV then holds the MSB-first CRC.
+ ******************************************************************************/
+static void inputByte(GPCRC_TypeDef *gpcrc, uint8_t byte)
+{
+  uint32_t crc = gpcrc->DATA;
+  uint32_t poly = reverseBits32(gpcrc->POLY);
+  int bit;
+
+  if (gpcrc->CTRL & GPCRC_CTRL_BITREVERSE)
+  {
+    byte = (uint8_t)(reverseBits32(byte) >> 24);
+  }
+
+  crc ^= byte;
+  for (bit = 0; bit < 8; bit++)
+  {
+    crc = (crc & 1) ? (crc >> 1) ^ poly : (crc >> 1);
+  }
+  setData(gpcrc, crc);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Process an input of 1, 2 or 4 bytes, LSB first unless BYTEREVERSE.
+ ******************************************************************************/
+static void inputData(GPCRC_TypeDef *gpcrc, uint32_t data, unsigned int bytes)
+{
+  unsigned int i;
+
+  if (gpcrc->CTRL & GPCRC_CTRL_BYTEMODE)
+  {
+    bytes = 1;
+  }
+  else if (gpcrc->CTRL & GPCRC_CTRL_BYTEREVERSE)
+  {
+    data = reverseBytes32(data) >> (8 * (4 - bytes));
+  }
+
+  for (i = 0; i < bytes; i++)
+  {
+    inputByte(gpcrc, (uint8_t)(data >> (8 * i)));
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Process an LDMA write to the GPCRC registers.
+ ******************************************************************************/
+static void gpcrcWrite(uint32_t addr, unsigned int size, uint32_t value)
+{
+  GPCRC_TypeDef *gpcrc = GPCRC;
+  uint32_t offset = addr - (uint32_t)(uintptr_t)gpcrc;
+
+  (void)size;
+  if (offset == offsetof(GPCRC_TypeDef, INPUTDATA))
+  {
+    inputData(gpcrc, value, 4);
+  }
+  else if (offset == offsetof(GPCRC_TypeDef, INPUTDATAHWORD))
+  {
+    inputData(gpcrc, value & 0xFFFF, 2);
+  }
+  else if (offset == offsetof(GPCRC_TypeDef, INPUTDATABYTE))
+  {
+    inputData(gpcrc, value & 0xFF, 1);
+  }
+  else if ((offset == offsetof(GPCRC_TypeDef, CMD))
+           && (value & GPCRC_CMD_INIT))
+  {
+    setData(gpcrc, gpcrc->INIT);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Configure the GPCRC and attach the model to the LDMA simulator.
+ ******************************************************************************/
+void GPCRC_Init(GPCRC_TypeDef *gpcrc, const GPCRC_Init_TypeDef *init)
+{
+  // Only the 32-bit polynomial of the examples is modelled
+  EFM_ASSERT(init->crcPoly == 0x04C11DB7UL);
+
+  gpcrc->CTRL = (init->enable ? GPCRC_CTRL_EN : 0)
+                | (init->enableByteMode ? GPCRC_CTRL_BYTEMODE : 0)
+                | (init->reverseBits ? GPCRC_CTRL_BITREVERSE : 0)
+                | (init->reverseByteOrder ? GPCRC_CTRL_BYTEREVERSE : 0)
+                | (init->autoInit ? GPCRC_CTRL_AUTOINIT : 0);
+  gpcrc->POLY = init->crcPoly;
+  gpcrc->INIT = init->initValue;
+
+  LDMASIM_MapRegisters(gpcrc, sizeof(GPCRC_TypeDef), gpcrcWrite);
+}
+
+void GPCRC_Start(GPCRC_TypeDef *gpcrc)
+{
+  gpcrc->CMD = GPCRC_CMD_INIT;
+  setData(gpcrc, gpcrc->INIT);
+}
+
+void GPCRC_InputU32(GPCRC_TypeDef *gpcrc, uint32_t data)
+{
+  gpcrc->INPUTDATA = data;
+  inputData(gpcrc, data, 4);
+}
+
+void GPCRC_InputU16(GPCRC_TypeDef *gpcrc, uint16_t data)
+{
+  gpcrc->INPUTDATAHWORD = data;
+  inputData(gpcrc, data, 2);
+}
+
+void GPCRC_InputU8(GPCRC_TypeDef *gpcrc, uint8_t data)
+{
+  gpcrc->INPUTDATABYTE = data;
+  inputData(gpcrc, data, 1);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read a result register, reloading the init value with AUTOINIT set.
+ ******************************************************************************/
+static uint32_t readData(GPCRC_TypeDef *gpcrc, volatile const uint32_t *reg)
+{
+  uint32_t data = *reg;
+
+  if (gpcrc->CTRL & GPCRC_CTRL_AUTOINIT)
+  {
+    setData(gpcrc, gpcrc->INIT);
+  }
+  return data;
+}
+
+uint32_t GPCRC_DataRead(GPCRC_TypeDef *gpcrc)
+{
+  return readData(gpcrc, &gpcrc->DATA);
+}
+
+uint32_t GPCRC_DataReadBitReversed(GPCRC_TypeDef *gpcrc)
+{
+  return readData(gpcrc, &gpcrc->DATAREV);
+}
+
+uint32_t GPCRC_DataReadByteReversed(GPCRC_TypeDef *gpcrc)
+{
+  return readData(gpcrc, &gpcrc->DATABYTEREV);
+}
@@ -0,0 +1,806 @@
+/***************************************************************************//**
+ * @file ldma_sim.c
+ * @brief Host-side LDMA descriptor chain simulator. Executes XFER, SYNC and
+ * WRI structures against host memory and accumulates bytes moved, descriptor
+ * fetches and estimated bus cycles per channel. See readme.txt for details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "ldma_sim.h"
+
+// Simulated register block, see em_device.h
+LDMA_TypeDef ldmaSimRegs;
+
+// Channel states
+typedef enum
+{
+  chIdle,             // Channel disabled or chain finished
+  chWaitReq,          // XFER structure loaded, waiting for a request
+  chActive,           // Request granted, moving units
+  chWaitSync          // SYNC structure loaded, waiting for a match
+} SimChState_t;
+
+// Channel context, mirrors the CTRL/SRC/DST/LINK/LOOP channel registers
+typedef struct
+{
+  SimChState_t      state;
+  LDMA_Descriptor_t desc;       // Loaded descriptor
+  uint32_t          descAddr;   // Address the descriptor was loaded from
+  uint32_t          src;
+  uint32_t          dst;
+  uint32_t          remaining;  // Units left in the descriptor
+  uint32_t          grant;      // Units left in the current request
+  uint32_t          loopCnt;
+  bool              request;    // Pending request
+  bool              stalled;    // SYNC stall already counted
+  bool              srcIncNeg;
+  bool              dstIncNeg;
+  LDMASIM_Stats_t   stats;
+} SimChannel_t;
+
+static SimChannel_t channels[DMA_CHAN_COUNT];
+static LDMASIM_CostModel_t costModel = LDMASIM_COST_MODEL_DEFAULT;
+
+// Peripheral register blocks with a write model
+typedef struct
+{
+  uint32_t            base;
+  uint32_t            length;
+  LDMASIM_WriteHook_t write;
+} SimRegisterMap_t;
+
+static SimRegisterMap_t registerMaps[LDMASIM_MAX_REGISTER_MAPS];
+static unsigned int numRegisterMaps;
+
+// Round-robin arbitration pointer
+static unsigned int nextChannel;
+
+// DONE flags raised since the IRQ handler last ran
+static uint32_t irqRaised;
+
+// Set when any channel stopped on an error
+static bool errorPending;
+
+// Units per block, indexed by LDMA_CtrlBlockSize_t (0 = reserved or All)
+static const uint16_t blockUnits[16] =
+{
+  1, 2, 3, 4, 6, 8, 0, 16, 0, 32, 64, 128, 256, 512, 1024, 0
+};
+
+// Address increment in units, indexed by LDMA_CtrlSrcInc_t/LDMA_CtrlDstInc_t
+static const uint8_t incUnits[4] = { 1, 2, 4, 0 };
+
+/***************************************************************************//**
+ * @brief
+ *   Default LDMA interrupt handler for chains that do not provide one.
+ ******************************************************************************/
+__attribute__((weak)) void LDMA_IRQHandler(void)
+{
+  LDMA_IntClear(LDMA_IntGet());
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Stop a channel on an LDMA error.
+ *
+ * @note
+ *   The examples spin forever on LDMA_IF_ERROR, so the IRQ handler is not
+ *   invoked for errors. LDMASIM_Run() returns instead and the reason is
+ *   printed to stderr.
+ ******************************************************************************/
+static void raiseError(int ch, const char *reason)
+{
+  fprintf(stderr, "ldma_sim: channel %d: %s\n", ch, reason);
+
+  channels[ch].state = chIdle;
+  channels[ch].stats.error = true;
+  LDMA->CHEN &= ~(1UL << ch);
+  LDMA->IF |= LDMA_IF_ERROR;
+  errorPending = true;
+}
+
+static void charge(SimChannel_t *c, uint32_t cycles)
+{
+  c->stats.busCycles += cycles;
+}
+
+static uint32_t readUnit(uint32_t addr, unsigned int size)
+{
+  switch (size)
+  {
+    case ldmaCtrlSizeByte:
+      return *(volatile uint8_t *)(uintptr_t)addr;
+    case ldmaCtrlSizeHalf:
+      return *(volatile uint16_t *)(uintptr_t)addr;
+    default:
+      return *(volatile uint32_t *)(uintptr_t)addr;
+  }
+}
+
+static void writeUnit(uint32_t addr, unsigned int size, uint32_t value)
+{
+  unsigned int i;
+
+  switch (size)
+  {
+    case ldmaCtrlSizeByte:
+      *(volatile uint8_t *)(uintptr_t)addr = (uint8_t)value;
+      break;
+    case ldmaCtrlSizeHalf:
+      *(volatile uint16_t *)(uintptr_t)addr = (uint16_t)value;
+      break;
+    default:
+      *(volatile uint32_t *)(uintptr_t)addr = value;
+      break;
+  }
+
+  // Let a peripheral model react to writes to its registers
+  for (i = 0; i < numRegisterMaps; i++)
+  {
+    if ((addr - registerMaps[i].base) < registerMaps[i].length)
+    {
+      registerMaps[i].write(addr, size, value);
+    }
+  }
+}
+
+static uint32_t swapUnit(uint32_t value, unsigned int size)
+{
+  if (size == ldmaCtrlSizeHalf)
+  {
+    return ((value >> 8) & 0xFF) | ((value & 0xFF) << 8);
+  }
+  if (size == ldmaCtrlSizeWord)
+  {
+    return (value >> 24) | ((value >> 8) & 0xFF00)
+           | ((value << 8) & 0xFF0000) | (value << 24);
+  }
+  return value;
+}
+
+static bool addrValid(uint32_t addr, uint32_t align)
+{
+  return (addr != 0) && ((addr & (align - 1)) == 0);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Mirror the channel context into the LDMA->CH[] registers.
+ ******************************************************************************/
+static void updateChannelRegisters(int ch)
+{
+  SimChannel_t *c = &channels[ch];
+  uint32_t words[LDMA_DESCRIPTOR_NDWORDS];
+
+  memcpy(words, &c->desc, sizeof(words));
+  LDMA->CH[ch].LOOP = c->loopCnt;
+  LDMA->CH[ch].CTRL = words[0];
+  LDMA->CH[ch].SRC = c->src;
+  LDMA->CH[ch].DST = c->dst;
+  LDMA->CH[ch].LINK = words[3];
+}
+
+static void loadDescriptor(int ch, uint32_t addr);
+
+/***************************************************************************//**
+ * @brief
+ *   Finish the loaded descriptor and follow the link, loop or stop.
+ *
+ * @details
+ *   With decLoopCnt set and a nonzero loop count the count is decremented
+ *   and the link address is taken, even if link is 0. Once the count has
+ *   run out a linked descriptor continues with the next sequential
+ *   descriptor instead, matching ldma_linked_list_looped and ldma_2d_copy.
+ ******************************************************************************/
+static void completeDescriptor(int ch)
+{
+  SimChannel_t *c = &channels[ch];
+  uint32_t linkTarget;
+  uint32_t next;
+
+  c->stats.descriptorsDone++;
+
+  if (c->desc.xfer.doneIfs)
+  {
+    LDMA->IF |= 1UL << ch;
+    irqRaised |= 1UL << ch;
+    c->stats.doneInterrupts++;
+  }
+
+  if (c->desc.xfer.linkMode == ldmaLinkModeRel)
+  {
+    linkTarget = c->descAddr + (uint32_t)(c->desc.xfer.linkAddr * 4);
+  }
+  else
+  {
+    linkTarget = ((uint32_t)c->desc.xfer.linkAddr & 0x3FFFFFFFUL) << 2;
+  }
+
+  if (c->desc.xfer.decLoopCnt && (c->loopCnt > 0))
+  {
+    c->loopCnt--;
+    next = linkTarget;
+  }
+  else if (c->desc.xfer.decLoopCnt && c->desc.xfer.link)
+  {
+    next = c->descAddr + sizeof(LDMA_Descriptor_t);
+  }
+  else if (c->desc.xfer.link)
+  {
+    next = linkTarget;
+  }
+  else
+  {
+    // End of chain
+    c->state = chIdle;
+    LDMA->CHEN &= ~(1UL << ch);
+    LDMA->CHDONE |= 1UL << ch;
+    return;
+  }
+
+  loadDescriptor(ch, next);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Fetch a descriptor into the channel registers.
+ ******************************************************************************/
+static void loadDescriptor(int ch, uint32_t addr)
+{
+  SimChannel_t *c = &channels[ch];
+
+  if (!addrValid(addr, 4))
+  {
+    raiseError(ch, "descriptor address is NULL or not word aligned");
+    return;
+  }
+
+  memcpy(&c->desc, (const void *)(uintptr_t)addr, sizeof(LDMA_Descriptor_t));
+  c->descAddr = addr;
+  c->stats.descriptorFetches++;
+  charge(c, LDMA_DESCRIPTOR_NDWORDS * costModel.descWordCycles);
+
+  switch (c->desc.xfer.structType)
+  {
+    case ldmaCtrlStructTypeXfer:
+      if (c->desc.xfer.size > ldmaCtrlSizeWord)
+      {
+        raiseError(ch, "invalid transfer size");
+        return;
+      }
+      if ((c->desc.xfer.blockSize != ldmaCtrlBlockSizeAll)
+          && (blockUnits[c->desc.xfer.blockSize] == 0))
+      {
+        raiseError(ch, "reserved block size");
+        return;
+      }
+
+      // Relative addresses are offsets from the current SRC/DST registers
+      if (c->desc.xfer.srcAddrMode == ldmaCtrlSrcAddrModeRel)
+      {
+        c->src += c->desc.xfer.srcAddr;
+      }
+      else
+      {
+        c->src = c->desc.xfer.srcAddr;
+      }
+      if (c->desc.xfer.dstAddrMode == ldmaCtrlDstAddrModeRel)
+      {
+        c->dst += c->desc.xfer.dstAddr;
+      }
+      else
+      {
+        c->dst = c->desc.xfer.dstAddr;
+      }
+
+      c->remaining = c->desc.xfer.xferCnt + 1;
+      if (c->desc.xfer.structReq)
+      {
+        c->request = true;
+      }
+      c->state = chWaitReq;
+      updateChannelRegisters(ch);
+      break;
+
+    case ldmaCtrlStructTypeSync:
+      LDMA->SYNC |= c->desc.sync.syncSet;
+      LDMA->SYNC &= ~(uint32_t)c->desc.sync.syncClr;
+      charge(c, costModel.syncCycles);
+      c->stalled = false;
+      c->state = chWaitSync;
+      break;
+
+    case ldmaCtrlStructTypeWrite:
+      if (!addrValid(c->desc.wri.dstAddr, 4))
+      {
+        raiseError(ch, "WRI destination is NULL or not word aligned");
+        return;
+      }
+      writeUnit(c->desc.wri.dstAddr, ldmaCtrlSizeWord, c->desc.wri.immVal);
+      charge(c, costModel.writeCycles + costModel.syncCycles);
+      completeDescriptor(ch);
+      break;
+
+    default:
+      raiseError(ch, "invalid structure type");
+      break;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Move one block of units on a channel that holds a request.
+ ******************************************************************************/
+static void transferBlock(int ch)
+{
+  SimChannel_t *c = &channels[ch];
+  unsigned int size = c->desc.xfer.size;
+  uint32_t unitBytes = 1UL << size;
+  uint32_t srcStep = incUnits[c->desc.xfer.srcInc] * unitBytes;
+  uint32_t dstStep = incUnits[c->desc.xfer.dstInc] * unitBytes;
+  uint32_t units;
+  uint32_t value;
+
+  if (c->desc.xfer.blockSize == ldmaCtrlBlockSizeAll)
+  {
+    units = c->grant;
+  }
+  else
+  {
+    units = blockUnits[c->desc.xfer.blockSize];
+    if (units > c->grant)
+    {
+      units = c->grant;
+    }
+  }
+
+  while (units--)
+  {
+    if (!addrValid(c->src, unitBytes) || !addrValid(c->dst, unitBytes))
+    {
+      raiseError(ch, "source or destination is NULL or misaligned");
+      return;
+    }
+
+    value = readUnit(c->src, size);
+    if (c->desc.xfer.byteSwap)
+    {
+      value = swapUnit(value, size);
+    }
+    writeUnit(c->dst, size, value);
+
+    c->src = c->srcIncNeg ? c->src - srcStep : c->src + srcStep;
+    c->dst = c->dstIncNeg ? c->dst - dstStep : c->dst + dstStep;
+    c->remaining--;
+    c->grant--;
+    c->stats.unitsMoved++;
+    c->stats.bytesMoved += unitBytes;
+    charge(c, costModel.readCycles + costModel.writeCycles);
+  }
+
+  // Every block ends in an arbitration point
+  c->stats.arbitrations++;
+  charge(c, costModel.arbitrationCycles);
+  updateChannelRegisters(ch);
+
+  if (c->remaining == 0)
+  {
+    completeDescriptor(ch);
+  }
+  else if (c->grant == 0)
+  {
+    c->state = chWaitReq;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Advance one channel by one arbitration slot.
+ *
+ * @return
+ *   True if the channel made progress.
+ ******************************************************************************/
+static bool stepChannel(int ch)
+{
+  SimChannel_t *c = &channels[ch];
+  uint32_t match;
+
+  switch (c->state)
+  {
+    case chWaitReq:
+      if (!c->request || (LDMA->REQDIS & (1UL << ch)))
+      {
+        return false;
+      }
+      c->request = false;
+      if ((c->desc.xfer.reqMode == ldmaCtrlReqModeAll)
+          || (c->desc.xfer.blockSize == ldmaCtrlBlockSizeAll))
+      {
+        c->grant = c->remaining;
+      }
+      else
+      {
+        c->grant = blockUnits[c->desc.xfer.blockSize];
+        if (c->grant > c->remaining)
+        {
+          c->grant = c->remaining;
+        }
+      }
+      c->state = chActive;
+      transferBlock(ch);
+      return true;
+
+    case chActive:
+      transferBlock(ch);
+      return true;
+
+    case chWaitSync:
+      match = c->desc.sync.matchEn;
+      if ((LDMA->SYNC & match) != (c->desc.sync.matchVal & match))
+      {
+        if (!c->stalled)
+        {
+          c->stats.syncWaits++;
+          c->stalled = true;
+        }
+        return false;
+      }
+      completeDescriptor(ch);
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Latch and clear software requests written to LDMA->SWREQ.
+ ******************************************************************************/
+static void latchSoftwareRequests(void)
+{
+  uint32_t swreq = LDMA->SWREQ & LDMA->CHEN;
+  int ch;
+
+  LDMA->SWREQ = 0;
+  for (ch = 0; ch < DMA_CHAN_COUNT; ch++)
+  {
+    if (swreq & (1UL << ch))
+    {
+      channels[ch].request = true;
+    }
+  }
+}
+
+static uint32_t totalCycles(void)
+{
+  uint32_t cycles = 0;
+  int ch;
+
+  for (ch = 0; ch < DMA_CHAN_COUNT; ch++)
+  {
+    cycles += channels[ch].stats.busCycles;
+  }
+  return cycles;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize the simulated LDMA.
+ ******************************************************************************/
+void LDMA_Init(const LDMA_Init_t *init)
+{
+  (void)init;
+
+  LDMA->IF = 0;
+  LDMA->IEN = LDMA_IF_ERROR;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Disable all channels and interrupts.
+ ******************************************************************************/
+void LDMA_DeInit(void)
+{
+  int ch;
+
+  for (ch = 0; ch < DMA_CHAN_COUNT; ch++)
+  {
+    channels[ch].state = chIdle;
+  }
+  LDMA->CHEN = 0;
+  LDMA->IEN = 0;
+  LDMA->IF = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start a descriptor chain on a channel.
+ ******************************************************************************/
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer,
+                        const LDMA_Descriptor_t *descriptor)
+{
+  SimChannel_t *c = &channels[ch];
+  uint32_t chMask = 1UL << ch;
+
+  // Descriptors hold 32-bit addresses; host data must live below 4 GB
+  if ((uintptr_t)descriptor > UINT32_MAX)
+  {
+    raiseError(ch, "descriptor outside the 32-bit address space, "
+                   "link with -no-pie");
+    return;
+  }
+
+  c->loopCnt = transfer->ldmaLoopCnt;
+  c->srcIncNeg = (transfer->ldmaCfgSrcIncSign == ldmaCfgSrcIncSignNeg);
+  c->dstIncNeg = (transfer->ldmaCfgDstIncSign == ldmaCfgDstIncSignNeg);
+  c->request = false;
+  c->src = 0;
+  c->dst = 0;
+
+  if (transfer->ldmaReqDis)
+  {
+    LDMA->REQDIS |= chMask;
+  }
+  else
+  {
+    LDMA->REQDIS &= ~chMask;
+  }
+
+  LDMA->IEN |= chMask;
+  LDMA->CHDONE &= ~chMask;
+  LDMA->CHEN |= chMask;
+
+  loadDescriptor(ch, (uint32_t)(uintptr_t)descriptor);
+}
+
+void LDMA_StopTransfer(int ch)
+{
+  channels[ch].state = chIdle;
+  LDMA->IEN &= ~(1UL << ch);
+  LDMA->CHEN &= ~(1UL << ch);
+}
+
+bool LDMA_TransferDone(int ch)
+{
+  return ((LDMA->CHEN & (1UL << ch)) == 0)
+         && ((LDMA->CHDONE & (1UL << ch)) != 0);
+}
+
+uint32_t LDMA_TransferRemainingCount(int ch)
+{
+  if (channels[ch].state == chIdle)
+  {
+    return 0;
+  }
+  return channels[ch].remaining;
+}
+
+void LDMA_EnableChannelRequest(int ch, bool enable)
+{
+  if (enable)
+  {
+    LDMA->REQDIS &= ~(1UL << ch);
+  }
+  else
+  {
+    LDMA->REQDIS |= 1UL << ch;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reset the simulated LDMA, all channel state and statistics.
+ ******************************************************************************/
+void LDMASIM_Reset(void)
+{
+  memset(&ldmaSimRegs, 0, sizeof(ldmaSimRegs));
+  memset(channels, 0, sizeof(channels));
+  numRegisterMaps = 0;
+  nextChannel = 0;
+  irqRaised = 0;
+  errorPending = false;
+}
+
+void LDMASIM_SetCostModel(const LDMASIM_CostModel_t *model)
+{
+  costModel = *model;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Call write for every LDMA write to the length bytes from base.
+ *
+ * @details
+ *   Up to LDMASIM_MAX_REGISTER_MAPS blocks can be mapped. Mapping a block
+ *   again replaces its model. The mappings are cleared by LDMASIM_Reset().
+ ******************************************************************************/
+void LDMASIM_MapRegisters(volatile void *base, uint32_t length,
+                          LDMASIM_WriteHook_t write)
+{
+  uint32_t addr = (uint32_t)(uintptr_t)base;
+  unsigned int i;
+
+  // Mapping the same block again replaces the model
+  for (i = 0; i < numRegisterMaps; i++)
+  {
+    if (registerMaps[i].base == addr)
+    {
+      break;
+    }
+  }
+
+  if (i < LDMASIM_MAX_REGISTER_MAPS)
+  {
+    registerMaps[i].base = addr;
+    registerMaps[i].length = length;
+    registerMaps[i].write = write;
+    if (i == numRegisterMaps)
+    {
+      numRegisterMaps++;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Raise a peripheral DMA request on the channels in chMask.
+ *
+ * @details
+ *   One request moves one block, or the whole descriptor when reqMode is
+ *   ldmaCtrlReqModeAll. A request stays pending until a channel consumes it.
+ ******************************************************************************/
+void LDMASIM_PeripheralRequest(uint32_t chMask)
+{
+  int ch;
+
+  for (ch = 0; ch < DMA_CHAN_COUNT; ch++)
+  {
+    if ((chMask & (1UL << ch)) && (LDMA->CHEN & (1UL << ch)))
+    {
+      channels[ch].request = true;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run the simulated LDMA until every channel is idle or blocked, an error
+ *   occurs or maxCycles bus cycles have been spent.
+ *
+ * @details
+ *   Channels are arbitrated round-robin, one block per slot. DONE interrupts
+ *   call LDMA_IRQHandler() as soon as they are raised, so chains that
+ *   re-trigger themselves through LDMA->SWREQ run to completion.
+ *
+ * @return
+ *   Bus cycles spent.
+ ******************************************************************************/
+uint32_t LDMASIM_Run(uint32_t maxCycles)
+{
+  uint32_t start = totalCycles();
+  bool progress;
+  unsigned int i;
+  int ch;
+
+  while (!errorPending && ((totalCycles() - start) < maxCycles))
+  {
+    latchSoftwareRequests();
+
+    progress = false;
+    for (i = 0; i < DMA_CHAN_COUNT; i++)
+    {
+      ch = (nextChannel + i) % DMA_CHAN_COUNT;
+      if (stepChannel(ch))
+      {
+        nextChannel = ch + 1;
+        progress = true;
+        break;
+      }
+    }
+
+    if (irqRaised & LDMA->IEN)
+    {
+      irqRaised = 0;
+      LDMA_IRQHandler();
+    }
+
+    if (!progress && (LDMA->SWREQ == 0))
+    {
+      break;
+    }
+  }
+
+  return totalCycles() - start;
+}
+
+bool LDMASIM_ErrorPending(void)
+{
+  return errorPending;
+}
+
+void LDMASIM_GetStats(int ch, LDMASIM_Stats_t *stats)
+{
+  *stats = channels[ch].stats;
+}
+
+void LDMASIM_ResetStats(uint32_t chMask)
+{
+  int ch;
+
+  for (ch = 0; ch < DMA_CHAN_COUNT; ch++)
+  {
+    if (chMask & (1UL << ch))
+    {
+      memset(&channels[ch].stats, 0, sizeof(LDMASIM_Stats_t));
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print the statistics summed over the channels in chMask.
+ ******************************************************************************/
+void LDMASIM_PrintStats(const char *name, uint32_t chMask)
+{
+  LDMASIM_Stats_t sum;
+  int ch;
+
+  memset(&sum, 0, sizeof(sum));
+  for (ch = 0; ch < DMA_CHAN_COUNT; ch++)
+  {
+    if (chMask & (1UL << ch))
+    {
+      sum.bytesMoved += channels[ch].stats.bytesMoved;
+      sum.unitsMoved += channels[ch].stats.unitsMoved;
+      sum.descriptorFetches += channels[ch].stats.descriptorFetches;
+      sum.arbitrations += channels[ch].stats.arbitrations;
+      sum.syncWaits += channels[ch].stats.syncWaits;
+      sum.busCycles += channels[ch].stats.busCycles;
+      sum.doneInterrupts += channels[ch].stats.doneInterrupts;
+      sum.error |= channels[ch].stats.error;
+    }
+  }
+
+  printf("%-24s %6lu bytes %5lu units %4lu fetches %6lu cycles "
+         "%5.2f bytes/cycle %3lu IRQs%s\n",
+         name,
+         (unsigned long)sum.bytesMoved,
+         (unsigned long)sum.unitsMoved,
+         (unsigned long)sum.descriptorFetches,
+         (unsigned long)sum.busCycles,
+         sum.busCycles ? (double)sum.bytesMoved / sum.busCycles : 0.0,
+         (unsigned long)sum.doneInterrupts,
+         sum.error ? " ERROR" : "");
+}
@@ -0,0 +1,1229 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Runs the initLdma() descriptor chains of the series 2 LDMA examples on
+ * the host LDMA simulator and reports bytes moved, descriptor fetches and
+ * estimated bus cycles per chain. See readme.txt for details.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "ldma_sim.h"
+
+// The selected example is built into this file with its main() renamed
+#define main ldmaExampleMain
+
+#if defined(LDMA_SIM_LINKED_LIST)
+#include "../../ldma_linked_list/src/main.c"
+#elif defined(LDMA_SIM_LINKED_LIST_LOOPED)
+#include "../../ldma_linked_list_looped/src/main.c"
+#elif defined(LDMA_SIM_2D_COPY)
+#include "../../ldma_2d_copy/src/main.c"
+#elif defined(LDMA_SIM_SCATTER_GATHER)
+#include "../../ldma_scatter_gather/src/main.c"
+#elif defined(LDMA_SIM_INTERCHANNEL_SYNCHRONIZATION)
+#include "../../ldma_interchannel_synchronization/src/main.c"
+#elif defined(LDMA_SIM_GPCRC_DMA)
+#include "../../../../series1/gpcrc/gpcrc_dma/src/main.c"
+#include "crc32.h"
+#elif defined(LDMA_SIM_USART_TX_QUEUE)
+#include "usart_tx_queue.h"
+#elif defined(LDMA_SIM_SPI_SCHEDULER)
+#include "spi_scheduler.h"
+#elif defined(LDMA_SIM_LDMA_RING)
+#include "ldma_ring.h"
+#elif defined(LDMA_SIM_SPI_SLAVE_RING)
+#include "spi_slave_ring.h"
+#else
+#error "Select an example chain, e.g. -DLDMA_SIM_LINKED_LIST"
+#endif
+
+#undef main
+
+// Upper bound on bus cycles for a single run
+#define MAX_RUN_CYCLES      1000000
+
+/***************************************************************************//**
+ * @brief
+ *   Report the outcome of a chain.
+ ******************************************************************************/
+static bool checkChain(const char *name, uint32_t chMask, bool passed)
+{
+  LDMASIM_PrintStats(name, chMask);
+  if (LDMASIM_ErrorPending())
+  {
+    passed = false;
+  }
+  if (!passed)
+  {
+    printf("%s: FAILED\n", name);
+  }
+  return passed;
+}
+
+#if defined(LDMA_SIM_LINKED_LIST)
+static bool runChains(void)
+{
+  initLdma();
+  LDMASIM_Run(MAX_RUN_CYCLES);
+
+  return checkChain("ldma_linked_list", LDMA_CH_MASK,
+                    memcmp(srcBuffer, dstBuffer, sizeof(dstBuffer)) == 0);
+}
+
+#elif defined(LDMA_SIM_LINKED_LIST_LOOPED)
+static bool runChains(void)
+{
+  initLdma();
+  LDMASIM_Run(MAX_RUN_CYCLES);
+
+  // A, B, A, B, A, B, A, B, C leaves C in the destination
+  return checkChain("ldma_linked_list_looped", LDMA_CH_MASK,
+                    (memcmp(srcC, dstBuffer, BUFFER_SIZE) == 0)
+                    && (LDMA_TransferDone(LDMA_CHANNEL)));
+}
+
+#elif defined(LDMA_SIM_2D_COPY)
+static bool runChains(void)
+{
+  bool passed = true;
+  uint32_t x, y;
+
+  initLdma();
+  LDMASIM_Run(MAX_RUN_CYCLES);
+
+  for (y = 0; y < BUFFER_2D_HEIGHT; y++)
+  {
+    for (x = 0; x < BUFFER_2D_WIDTH; x++)
+    {
+      bool inside = (y >= DST_ROW_INDEX)
+                    && (y < DST_ROW_INDEX + TRANSFER_HEIGHT)
+                    && (x >= DST_COL_INDEX)
+                    && (x < DST_COL_INDEX + TRANSFER_WIDTH);
+      uint16_t expected = inside
+        ? src2d[SRC_ROW_INDEX + y - DST_ROW_INDEX]
+               [SRC_COL_INDEX + x - DST_COL_INDEX]
+        : 0;
+
+      if (dst2d[y][x] != expected)
+      {
+        passed = false;
+      }
+    }
+  }
+
+  return checkChain("ldma_2d_copy", LDMA_CH_MASK, passed);
+}
+
+#elif defined(LDMA_SIM_SCATTER_GATHER)
+static bool runChains(void)
+{
+  bool passed = true;
+  uint32_t i;
+
+  initLdmaScatter();
+  LDMASIM_Run(MAX_RUN_CYCLES);
+
+  // Scatter fills the destination rows in reverse order
+  for (i = 0; i < BUFFER_SIZE * LIST_SIZE; i++)
+  {
+    if (dstBuffer[LAST_INDEX - i / BUFFER_SIZE][i % BUFFER_SIZE] != i)
+    {
+      passed = false;
+    }
+  }
+  passed = checkChain("ldma_scatter", LDMA_CH_MASK, passed);
+
+  LDMASIM_ResetStats(LDMA_CH_MASK);
+  initLdmaGather();
+  LDMASIM_Run(MAX_RUN_CYCLES);
+
+  // Gather restores the original ramp
+  for (i = 0; i < BUFFER_SIZE * LIST_SIZE; i++)
+  {
+    if (srcBuffer[i] != i)
+    {
+      passed = false;
+    }
+  }
+  return checkChain("ldma_gather", LDMA_CH_MASK, passed) && passed;
+}
+
+#elif defined(LDMA_SIM_INTERCHANNEL_SYNCHRONIZATION)
+static bool runChains(void)
+{
+  bool passed;
+
+  initLdma();
+  LDMASIM_Run(MAX_RUN_CYCLES);
+
+  // Press PB1, channel 1 moves YYyy and sets the sync flag
+  LDMASIM_PeripheralRequest(1 << (LDMA_CHANNEL + 1));
+  LDMASIM_Run(MAX_RUN_CYCLES);
+  passed = (memcmp(srcY, dstBuffer, BUFFER_SIZE) == 0);
+
+  // Press PB0, channel 0 moves AAaa, passes the sync match and moves CCcc
+  LDMASIM_PeripheralRequest(1 << LDMA_CHANNEL);
+  LDMASIM_Run(MAX_RUN_CYCLES);
+  passed = passed && (memcmp(srcC, dstBuffer, BUFFER_SIZE) == 0);
+
+  return checkChain("ldma_interchannel_sync",
+                    (1 << LDMA_CHANNEL) | (1 << (LDMA_CHANNEL + 1)), passed);
+}
+
+#elif defined(LDMA_SIM_GPCRC_DMA)
+// Large enough for the longest chain gpcrcLdmaStart() builds
+static uint8_t bigBuffer[GPCRC_LDMA_MAX_LENGTH + 3];
+
+// Example of the emlib GPCRC documentation: ~CRC of 0xC5 from all ones
+#define EMLIB_EXAMPLE_BYTE      0xC5
+#define EMLIB_EXAMPLE_CRC       0x390CD9B2UL
+
+// First result of gpcrc_software: 0xABCD with reverseBits, read bit reversed
+#define BITREVERSE_EXAMPLE_WORD 0xABCDUL
+#define BITREVERSE_EXAMPLE_CRC  0x326C7C5AUL
+
+/***************************************************************************//**
+ * @brief
+ *   Check the GPCRC model against the published examples.
+ ******************************************************************************/
+static bool checkModel(void)
+{
+  GPCRC_Init_TypeDef gpcrcInit = GPCRC_INIT_DEFAULT;
+  CRC32_Init_TypeDef softInit = CRC32_INIT_DEFAULT;
+  CRC32_TypeDef softCrc;
+  uint32_t crc;
+  bool passed;
+
+  gpcrcInit.initValue = 0xFFFFFFFFUL;
+  GPCRC_Init(GPCRC, &gpcrcInit);
+  GPCRC_Start(GPCRC);
+  GPCRC_InputU8(GPCRC, EMLIB_EXAMPLE_BYTE);
+  crc = ~GPCRC_DataRead(GPCRC);
+  passed = (crc == EMLIB_EXAMPLE_CRC);
+
+  // The software CRC must match the same examples to be a reference
+  softInit.initValue = 0xFFFFFFFFUL;
+  CRC32_Init(&softCrc, &softInit);
+  CRC32_InputU8(&softCrc, EMLIB_EXAMPLE_BYTE);
+  passed = (~CRC32_DataRead(&softCrc) == EMLIB_EXAMPLE_CRC) && passed;
+
+  gpcrcInit.reverseBits = true;
+  GPCRC_Init(GPCRC, &gpcrcInit);
+  GPCRC_Start(GPCRC);
+  GPCRC_InputU32(GPCRC, BITREVERSE_EXAMPLE_WORD);
+  passed = (GPCRC_DataReadBitReversed(GPCRC) == BITREVERSE_EXAMPLE_CRC)
+           && passed;
+
+  softInit.reverseBits = true;
+  CRC32_Init(&softCrc, &softInit);
+  CRC32_InputU32(&softCrc, BITREVERSE_EXAMPLE_WORD);
+  passed = (CRC32_DataReadBitReversed(&softCrc) == BITREVERSE_EXAMPLE_CRC)
+           && passed;
+
+  if (!passed)
+  {
+    printf("gpcrc_dma: GPCRC model or software CRC does not match the "
+           "examples\n");
+  }
+  return passed;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Checksum a buffer through the LDMA and compare with the software CRC.
+ ******************************************************************************/
+static bool checkBuffer(const uint8_t *data, size_t length, bool reverseBits)
+{
+  GPCRC_Init_TypeDef gpcrcInit = GPCRC_INIT_DEFAULT;
+  CRC32_Init_TypeDef softInit = CRC32_INIT_DEFAULT;
+  CRC32_TypeDef softCrc;
+  LDMASIM_Stats_t stats;
+  uint32_t expected;
+  bool passed;
+
+  gpcrcInit.initValue = PRESET;
+  gpcrcInit.autoInit = true;
+  gpcrcInit.reverseBits = reverseBits;
+  GPCRC_Init(GPCRC, &gpcrcInit);
+
+  softInit.initValue = PRESET;
+  softInit.reverseBits = reverseBits;
+  CRC32_Init(&softCrc, &softInit);
+  CRC32_Update(&softCrc, data, length);
+  expected = CRC32_DataRead(&softCrc);
+
+  result = ~expected;
+  LDMASIM_ResetStats(1 << LDMA_CHANNEL);
+  gpcrcLdmaStart(&crcDma, data, length);
+  LDMASIM_Run(UINT32_MAX);
+  LDMASIM_GetStats(LDMA_CHANNEL, &stats);
+
+  // An empty buffer leaves the init value and raises no interrupt
+  if (length == 0)
+  {
+    return (GPCRC_DataRead(GPCRC) == expected) && (stats.doneInterrupts == 0);
+  }
+
+  passed = (result == expected) && (stats.doneInterrupts == 1)
+           && !gpcrcLdmaBusy(&crcDma) && !LDMASIM_ErrorPending();
+  if (!passed)
+  {
+    printf("gpcrc_dma: offset %lu length %lu reverseBits %d: "
+           "0x%08lX, expected 0x%08lX\n",
+           (unsigned long)((uintptr_t)data & 3), (unsigned long)length,
+           reverseBits, (unsigned long)result, (unsigned long)expected);
+  }
+  return passed;
+}
+
+static bool runChains(void)
+{
+  static const size_t lengths[] =
+  {
+    0, 1, 2, 3, 4, 5, 7, 8, 9, 4 * GPCRC_LDMA_BLOCK_WORDS - 1,
+    4 * GPCRC_LDMA_BLOCK_WORDS, 4 * GPCRC_LDMA_BLOCK_WORDS + 1,
+    8 * GPCRC_LDMA_BLOCK_WORDS + 4, 256 * 1024
+  };
+  bool passed;
+  size_t i, offset;
+  int reverseBits;
+
+  // The example: an unaligned buffer with an odd length
+  for (i = 0; i < sizeof(buffer); i++)
+  {
+    buffer[i] = (uint8_t)(i * 7 + 3);
+  }
+  initGpcrc();
+  initLdma();
+  gpcrcLdmaStart(&crcDma, &buffer[BUFFER_OFFSET], BUFFER_SIZE);
+  LDMASIM_Run(UINT32_MAX);
+  LDMASIM_PrintStats("gpcrc_dma", 1 << LDMA_CHANNEL);
+
+  // Every head/body/tail split, in both bit orders
+  for (i = 0; i < sizeof(bigBuffer); i++)
+  {
+    bigBuffer[i] = (uint8_t)(i ^ (i >> 8) ^ (i >> 16));
+  }
+  passed = checkModel();
+  passed = checkBuffer(&buffer[BUFFER_OFFSET], BUFFER_SIZE, false) && passed;
+  for (reverseBits = 0; reverseBits <= 1; reverseBits++)
+  {
+    for (offset = 0; offset < 4; offset++)
+    {
+      for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+      {
+        passed = checkBuffer(&bigBuffer[offset], lengths[i], reverseBits)
+                 && passed;
+      }
+    }
+  }
+
+  // Longest chains, with and without partial words
+  passed = checkBuffer(&bigBuffer[1], GPCRC_LDMA_MAX_LENGTH, true) && passed;
+  passed = checkBuffer(&bigBuffer[0], GPCRC_LDMA_MAX_LENGTH, true) && passed;
+
+  return checkChain("gpcrc_dma max length", 1 << LDMA_CHANNEL, passed);
+}
+#elif defined(LDMA_SIM_USART_TX_QUEUE)
+// Bytes written to USART1 TXDATA by the LDMA
+static uint8_t txOutput[32768];
+static uint32_t txOutputLength;
+
+// Expected output and completed messages
+static uint8_t txExpected[sizeof(txOutput)];
+static uint32_t txExpectedLength;
+static uint32_t txMessagesDone;
+static bool txOrdered = true;
+
+// Message payloads, headers and checksums
+#define TX_MESSAGES 16
+static uint8_t txPayload[5000 + 8 * TX_MESSAGES];
+static uint8_t txHeaders[TX_MESSAGES][4];
+static uint8_t txChecksums[TX_MESSAGES];
+
+USART_TypeDef usartSimRegs[2];
+static UsartTxQueue_t txQueue;
+
+void LDMA_IRQHandler(void)
+{
+  usartTxQueueIrq(&txQueue);
+}
+
+static void usartWrite(uint32_t addr, unsigned int size, uint32_t value)
+{
+  (void)size;
+  if ((addr == (uint32_t)(uintptr_t)&USART1->TXDATA)
+      && (txOutputLength < sizeof(txOutput)))
+  {
+    txOutput[txOutputLength++] = (uint8_t)value;
+  }
+}
+
+static void messageDone(void *user)
+{
+  // Messages complete in the order they were queued
+  if ((uint32_t)(uintptr_t)user != txMessagesDone)
+  {
+    txOrdered = false;
+  }
+  txMessagesDone++;
+}
+
+static void emptyDone(void *user)
+{
+  (*(uint32_t *)user)++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Queue a header, a payload and a checksum as one message.
+ ******************************************************************************/
+static bool queueMessage(uint32_t number, uint32_t offset, uint32_t length)
+{
+  uint8_t *header = txHeaders[number];
+  uint8_t *checksum = &txChecksums[number];
+  UsartTxFragment_t fragments[3];
+  uint32_t i;
+
+  header[0] = 0x7E;
+  header[1] = (uint8_t)number;
+  header[2] = (uint8_t)length;
+  header[3] = (uint8_t)(length >> 8);
+  *checksum = 0;
+  for (i = 0; i < length; i++)
+  {
+    *checksum += txPayload[offset + i];
+  }
+
+  fragments[0].data = header;
+  fragments[0].length = 4;
+  fragments[1].data = &txPayload[offset];
+  fragments[1].length = length;
+  fragments[2].data = checksum;
+  fragments[2].length = 1;
+  if (!usartTxQueueWrite(&txQueue, fragments, 3, messageDone,
+                         (void *)(uintptr_t)number))
+  {
+    return false;
+  }
+
+  memcpy(&txExpected[txExpectedLength], header, 4);
+  memcpy(&txExpected[txExpectedLength + 4], &txPayload[offset], length);
+  txExpected[txExpectedLength + 4 + length] = *checksum;
+  txExpectedLength += length + 5;
+  return true;
+}
+
+static bool runChains(void)
+{
+  // Payload lengths, including empty payloads and payloads that need
+  // several descriptors
+  static const uint32_t lengths[TX_MESSAGES] =
+  {
+    16, 0, 1, 200, 2047, 2048, 2049, 5000, 3, 64, 0, 100, 700, 1, 4095, 33
+  };
+  const uint32_t count = TX_MESSAGES;
+  UsartTxFragment_t empty[2];
+  uint32_t emptyCount = 0;
+  bool emptyPassed;
+  LDMASIM_Stats_t stats;
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+  uint32_t queued = 0;
+  uint32_t rejected = 0;
+  uint32_t i;
+  bool passed;
+
+  for (i = 0; i < sizeof(txPayload); i++)
+  {
+    txPayload[i] = (uint8_t)(i * 13 + (i >> 8));
+  }
+
+  LDMASIM_MapRegisters(USART1, sizeof(*USART1), usartWrite);
+  LDMA_Init(&init);
+  usartTxQueueInit(&txQueue, USART1, 0,
+                   LDMAXBAR_CH_REQSEL_SIGSEL_USART1TXBL
+                   | LDMAXBAR_CH_REQSEL_SOURCESEL_USART1);
+
+  // Keep the queue full: TXBL requests one byte at a time, and a message is
+  // queued whenever there is room for it
+  while ((queued < count) || !usartTxQueueIdle(&txQueue))
+  {
+    while ((queued < count)
+           && queueMessage(queued, queued * 7, lengths[queued]))
+    {
+      queued++;
+    }
+    if ((queued < count) && usartTxQueueIdle(&txQueue))
+    {
+      rejected++;
+      break;
+    }
+    LDMASIM_PeripheralRequest(1 << 0);
+    LDMASIM_Run(MAX_RUN_CYCLES);
+    if (LDMASIM_ErrorPending())
+    {
+      break;
+    }
+  }
+
+  // Messages without any bytes are done at once, nothing is sent
+  empty[0].data = txPayload;
+  empty[0].length = 0;
+  empty[1] = empty[0];
+  emptyPassed = usartTxQueueWrite(&txQueue, empty, 0, emptyDone, &emptyCount)
+                && usartTxQueueWrite(&txQueue, empty, 2, emptyDone,
+                                     &emptyCount)
+                && usartTxQueueWrite(&txQueue, empty, 2, NULL, NULL)
+                && (emptyCount == 2) && usartTxQueueIdle(&txQueue);
+
+  LDMASIM_GetStats(0, &stats);
+  printf("usart_tx_queue: %lu messages, %lu bytes, %lu interrupts "
+         "(%lu with one TXBL interrupt per byte)\n",
+         (unsigned long)txMessagesDone, (unsigned long)txOutputLength,
+         (unsigned long)stats.doneInterrupts, (unsigned long)txOutputLength);
+
+  passed = (rejected == 0) && (txMessagesDone == count) && txOrdered
+           && emptyPassed
+           && (stats.doneInterrupts == count)
+           && (txOutputLength == txExpectedLength)
+           && (memcmp(txOutput, txExpected, txExpectedLength) == 0);
+
+  return checkChain("usart_tx_queue", 1 << 0, passed);
+}
+#elif defined(LDMA_SIM_SPI_SCHEDULER)
+#define SPI_RX_CHANNEL      0
+#define SPI_TX_CHANNEL      1
+#define SPI_SYNC_BIT        0
+
+// Three sensors, polled with one batch per period
+#define SPI_DEVICES         3
+#define SPI_BATCHES         12
+#define SPI_MAX_LENGTH      40
+
+static const SpiDevice_t spiDevices[SPI_DEVICES] =
+{
+  { gpioPortC, 1 },
+  { gpioPortC, 0 },
+  { gpioPortC, 2 }
+};
+
+// Bytes each device has seen while selected, and its selections
+static uint8_t spiSeen[SPI_DEVICES][SPI_BATCHES * SPI_MAX_LENGTH];
+static uint32_t spiSeenLength[SPI_DEVICES];
+static uint32_t spiSelections[SPI_DEVICES];
+static int spiSelected = -1;
+static bool spiFramed = true;
+
+static SpiTransaction_t spiTransactions[SPI_BATCHES][SPI_DEVICES];
+static uint8_t spiTx[SPI_BATCHES][SPI_DEVICES][SPI_MAX_LENGTH];
+static uint8_t spiRx[SPI_BATCHES][SPI_DEVICES][SPI_MAX_LENGTH];
+static uint32_t spiDone;
+static bool spiOrdered = true;
+
+USART_TypeDef usartSimRegs[2];
+GPIO_TypeDef gpioSimRegs;
+static SpiScheduler_t spiScheduler;
+
+void LDMA_IRQHandler(void)
+{
+  spiSchedulerIrq(&spiScheduler);
+}
+
+// Byte a device shifts out for the byte it receives
+static uint8_t spiResponse(int device, uint8_t byte)
+{
+  return (uint8_t)(byte ^ (0x35 * (device + 1)));
+}
+
+// Device whose chip select is low, -1 if none, -2 if several
+static int spiSelectedDevice(void)
+{
+  int selected = -1;
+  int i;
+
+  for (i = 0; i < SPI_DEVICES; i++)
+  {
+    if (!(GPIO->P[spiDevices[i].csPort].DOUT & (1UL << spiDevices[i].csPin)))
+    {
+      selected = (selected == -1) ? i : -2;
+    }
+  }
+  return selected;
+}
+
+static void gpioWrite(uint32_t addr, unsigned int size, uint32_t value)
+{
+  unsigned int port;
+  int selected;
+
+  (void)size;
+  for (port = 0; port < 4; port++)
+  {
+    if (addr == (uint32_t)(uintptr_t)&GPIO->P_SET[port].DOUT)
+    {
+      GPIO->P[port].DOUT |= value;
+    }
+    else if (addr == (uint32_t)(uintptr_t)&GPIO->P_CLR[port].DOUT)
+    {
+      GPIO->P[port].DOUT &= ~value;
+    }
+  }
+
+  // Chip select only changes between deselected and one device selected
+  selected = spiSelectedDevice();
+  if ((selected == -2) || ((spiSelected >= 0) && (selected >= 0)))
+  {
+    spiFramed = false;
+  }
+  if (selected >= 0)
+  {
+    spiSelections[selected]++;
+  }
+  spiSelected = selected;
+}
+
+// The selected device receives the byte and the master receives its reply
+static void usartWrite(uint32_t addr, unsigned int size, uint32_t value)
+{
+  (void)size;
+  if (addr != (uint32_t)(uintptr_t)&USART0->TXDATA)
+  {
+    return;
+  }
+  if (spiSelected < 0)
+  {
+    spiFramed = false;
+    return;
+  }
+  spiSeen[spiSelected][spiSeenLength[spiSelected]++] = (uint8_t)value;
+  USART0->RXDATA = spiResponse(spiSelected, (uint8_t)value);
+  LDMASIM_PeripheralRequest(1 << SPI_RX_CHANNEL);
+}
+
+static void transactionDone(SpiTransaction_t *transaction)
+{
+  // Callbacks run in the order the transactions were submitted
+  if (transaction != &spiTransactions[0][0] + spiDone)
+  {
+    spiOrdered = false;
+  }
+  spiDone++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Fill in a batch reading each device. Some transactions send only
+ *   zeros or discard what they receive.
+ ******************************************************************************/
+static void prepareBatch(uint32_t number)
+{
+  SpiTransaction_t *transaction;
+  uint32_t device;
+  uint32_t i;
+
+  for (device = 0; device < SPI_DEVICES; device++)
+  {
+    transaction = &spiTransactions[number][device];
+    transaction->device = &spiDevices[device];
+    transaction->length = 1 + (number * 7 + device * 13) % SPI_MAX_LENGTH;
+    transaction->tx = spiTx[number][device];
+    transaction->rx = spiRx[number][device];
+    transaction->done = transactionDone;
+    transaction->user = NULL;
+    for (i = 0; i < transaction->length; i++)
+    {
+      spiTx[number][device][i] = (uint8_t)(number * 31 + device * 7 + i);
+    }
+    if ((number % 4) == 1)
+    {
+      transaction->tx = NULL;
+      memset(spiTx[number][device], 0, transaction->length);
+    }
+    if (((number % 4) == 2) && (device == 1))
+    {
+      transaction->rx = NULL;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check what each device received and what was received from it.
+ ******************************************************************************/
+static bool checkTransfers(void)
+{
+  uint32_t offset[SPI_DEVICES] = { 0 };
+  SpiTransaction_t *transaction;
+  uint32_t number;
+  uint32_t device;
+  uint32_t i;
+
+  for (number = 0; number < SPI_BATCHES; number++)
+  {
+    for (device = 0; device < SPI_DEVICES; device++)
+    {
+      transaction = &spiTransactions[number][device];
+      for (i = 0; i < transaction->length; i++)
+      {
+        if (spiSeen[device][offset[device] + i] != spiTx[number][device][i])
+        {
+          return false;
+        }
+        if ((transaction->rx != NULL)
+            && (spiRx[number][device][i]
+                != spiResponse(device, spiTx[number][device][i])))
+        {
+          return false;
+        }
+      }
+      offset[device] += transaction->length;
+    }
+  }
+  for (device = 0; device < SPI_DEVICES; device++)
+  {
+    if ((offset[device] != spiSeenLength[device])
+        || (spiSelections[device] != SPI_BATCHES))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool runChains(void)
+{
+  const uint32_t count = SPI_BATCHES;
+  LDMASIM_Stats_t stats;
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+  uint32_t submitted = 0;
+  uint32_t bytes = 0;
+  uint32_t i;
+  bool passed;
+
+  for (i = 0; i < SPI_DEVICES; i++)
+  {
+    GPIO->P[spiDevices[i].csPort].DOUT |= 1UL << spiDevices[i].csPin;
+  }
+  for (i = 0; i < count; i++)
+  {
+    prepareBatch(i);
+  }
+
+  LDMASIM_MapRegisters(USART0, sizeof(*USART0), usartWrite);
+  LDMASIM_MapRegisters(GPIO, sizeof(*GPIO), gpioWrite);
+  LDMA_Init(&init);
+  spiSchedulerInit(&spiScheduler, USART0,
+                   SPI_RX_CHANNEL, ldmaPeripheralSignal_USART0_RXDATAV,
+                   SPI_TX_CHANNEL, ldmaPeripheralSignal_USART0_TXBL,
+                   SPI_SYNC_BIT);
+
+  // Keep the scheduler full, TXBL requests one byte at a time and the
+  // device replies before the next request
+  while ((submitted < count) || !spiSchedulerIdle(&spiScheduler))
+  {
+    while ((submitted < count)
+           && spiSchedulerSubmit(&spiScheduler, spiTransactions[submitted],
+                                 SPI_DEVICES))
+    {
+      submitted++;
+    }
+    LDMASIM_PeripheralRequest(1 << SPI_TX_CHANNEL);
+    LDMASIM_Run(MAX_RUN_CYCLES);
+    if (LDMASIM_ErrorPending())
+    {
+      break;
+    }
+  }
+
+  for (i = 0; i < SPI_DEVICES; i++)
+  {
+    bytes += spiSeenLength[i];
+  }
+  LDMASIM_GetStats(SPI_RX_CHANNEL, &stats);
+  printf("spi_scheduler: %lu transactions, %lu bytes, %lu interrupts "
+         "(%lu with one interrupt per transaction)\n",
+         (unsigned long)spiDone, (unsigned long)bytes,
+         (unsigned long)stats.doneInterrupts,
+         (unsigned long)(count * SPI_DEVICES));
+
+  passed = (spiDone == count * SPI_DEVICES) && spiOrdered && spiFramed
+           && (spiSelectedDevice() == -1)
+           && (stats.doneInterrupts == count) && checkTransfers();
+
+  return checkChain("spi_scheduler",
+                    (1 << SPI_RX_CHANNEL) | (1 << SPI_TX_CHANNEL), passed);
+}
+#elif defined(LDMA_SIM_LDMA_RING)
+#define RING_CHANNEL        0
+#define RING_SEGMENTS       4
+#define RING_UNITS          16
+
+// Peripheral data register the ring reads from, holds a word counter
+static volatile uint32_t ringSource;
+static uint32_t ringWords;
+
+static LDMA_Descriptor_t ringDesc[RING_SEGMENTS];
+static uint32_t ringBuffer[RING_SEGMENTS][RING_UNITS];
+static LdmaRing_t ring;
+
+// Interrupts left to hold off, and held off in a row before serving one
+static uint32_t ringHoldOff;
+static uint32_t ringHeld;
+
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGet();
+
+  LDMA_IntClear(pending);
+
+  // A held off interrupt is served together with a later one
+  if ((ringHoldOff > 0) && (ringHeld < 2))
+  {
+    ringHoldOff--;
+    ringHeld++;
+    return;
+  }
+  ringHeld = 0;
+  ldmaRingIrqHandler(&ring, pending);
+}
+
+// Let the peripheral produce count words, one request each
+static void ringProduce(uint32_t count)
+{
+  while (count-- > 0)
+  {
+    ringSource = ringWords++;
+    LDMASIM_PeripheralRequest(1 << RING_CHANNEL);
+    LDMASIM_Run(MAX_RUN_CYCLES);
+  }
+}
+
+// Consume every completed segment, each must hold the words of its number
+static bool ringDrain(uint32_t *segments)
+{
+  uint32_t *segment;
+  uint32_t number;
+  uint32_t i;
+  bool passed = true;
+
+  while ((segment = ldmaRingPeek(&ring)) != NULL)
+  {
+    number = ring.tail;
+    for (i = 0; i < RING_UNITS; i++)
+    {
+      if (segment[i] != number * RING_UNITS + i)
+      {
+        passed = false;
+      }
+    }
+    passed = ldmaRingRelease(&ring) && passed;
+    (*segments)++;
+  }
+  return passed;
+}
+
+// Read the stream in place in spans of at most chunk words, each must hold
+// the word produced at its position since the ring was started
+static bool ringRead(uint32_t chunk, uint32_t start, uint32_t *units)
+{
+  const void *data;
+  const uint32_t *words;
+  uint32_t length;
+  uint32_t i;
+  bool passed = true;
+
+  while ((length = ldmaRingSpan(&ring, &data)) > 0)
+  {
+    words = data;
+    if (length > chunk)
+    {
+      length = chunk;
+    }
+    for (i = 0; i < length; i++)
+    {
+      if (words[i] != start + ring.readTotal + i)
+      {
+        passed = false;
+      }
+    }
+    ldmaRingConsume(&ring, length);
+    *units += length;
+  }
+  return passed;
+}
+
+static bool runChains(void)
+{
+  LDMA_TransferCfg_t transfer =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_PDM_RXDATAV);
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+  uint32_t segments = 0;
+  uint32_t units;
+  uint32_t produced;
+  uint32_t start;
+  uint32_t i;
+  bool passed = true;
+
+  LDMA_Init(&init);
+  ldmaRingInit(&ring, RING_CHANNEL, ringDesc, ringBuffer, RING_SEGMENTS,
+               RING_UNITS, ldmaCtrlSizeWord, &ringSource);
+  ldmaRingStart(&ring, &transfer);
+
+  // Consumer keeping up, segments are taken as soon as they complete
+  for (i = 0; i < 8 * RING_SEGMENTS; i++)
+  {
+    ringProduce(RING_UNITS);
+    passed = ringDrain(&segments) && passed;
+  }
+  passed = passed && (segments == 8 * RING_SEGMENTS) && (ring.overruns == 0);
+  printf("ldma_ring: %lu segments in order\n", (unsigned long)segments);
+
+  // Two interrupts out of three held off, the third one catches up from
+  // the channel destination and no segment is lost
+  segments = 0;
+  ringHoldOff = 4 * RING_SEGMENTS;
+  for (i = 0; i < 6 * RING_SEGMENTS; i++)
+  {
+    ringProduce(RING_UNITS);
+    passed = ringDrain(&segments) && passed;
+  }
+  passed = passed && (segments == 6 * RING_SEGMENTS) && (ring.overruns == 0);
+  printf("ldma_ring: %lu segments with late interrupts\n",
+         (unsigned long)segments);
+
+  // Consumer stalled for 10 segments, the newest RING_SEGMENTS - 1 are
+  // still complete and the overwritten ones are counted
+  segments = 0;
+  ringProduce(10 * RING_UNITS);
+  passed = ringDrain(&segments) && passed;
+  passed = passed && (segments == RING_SEGMENTS - 1)
+           && (ring.overruns == 10 - (RING_SEGMENTS - 1));
+  printf("ldma_ring: %lu segments and %lu overruns after a stall\n",
+         (unsigned long)segments, (unsigned long)ring.overruns);
+
+  // A segment overwritten while it is held is reported on release
+  ringProduce(RING_UNITS);
+  passed = passed && (ldmaRingPeek(&ring) != NULL);
+  ringProduce(RING_SEGMENTS * RING_UNITS);
+  passed = !ldmaRingRelease(&ring) && passed;
+
+  // Stream read in place, produced and read in runs that do not line up
+  // with the segments, with late interrupts
+  ldmaRingStop(&ring);
+  start = ringWords;
+  ldmaRingStart(&ring, &transfer);
+  units = 0;
+  produced = 0;
+  ringHoldOff = 4 * RING_SEGMENTS;
+  for (i = 0; i < 16 * RING_SEGMENTS; i++)
+  {
+    ringProduce((i * 5) % 23 + 1);
+    produced += (i * 5) % 23 + 1;
+    passed = ringRead(i % 7 + 1, start, &units) && passed;
+  }
+  passed = passed && (units == produced) && (ring.dropped == 0);
+  printf("ldma_ring: %lu units streamed\n", (unsigned long)units);
+
+  // Stream lapped while the consumer stalled, everything in the ring is
+  // dropped and reading resumes with the next word
+  ringProduce(RING_SEGMENTS * RING_UNITS + 3);
+  passed = passed && (ldmaRingAvailable(&ring) == 0)
+           && (ring.dropped == RING_SEGMENTS * RING_UNITS + 3);
+  units = 0;
+  ringProduce(RING_UNITS / 2);
+  passed = ringRead(RING_UNITS, start, &units) && passed;
+  passed = passed && (units == RING_UNITS / 2);
+  printf("ldma_ring: %lu units dropped after a stall\n",
+         (unsigned long)ring.dropped);
+
+  return checkChain("ldma_ring", 1 << RING_CHANNEL, passed);
+}
+#elif defined(LDMA_SIM_SPI_SLAVE_RING)
+#define SLAVE_RX_CHANNEL    0
+#define SLAVE_TX_CHANNEL    1
+#define SLAVE_RING_SIZE     64
+#define SLAVE_MAX_PACKET    50
+#define SLAVE_PACKETS       40
+
+// Sent by the slave when nothing has been loaded into TXDATA
+#define SLAVE_UNDERFLOW     0xFF
+
+USART_TypeDef usartSimRegs[2];
+static uint8_t slaveBuffer[SLAVE_RING_SIZE];
+static SpiSlaveRing_t slave;
+
+// Byte loaded into TXDATA by the transmit channel, shifted out next
+static uint8_t slaveTxData;
+static bool slaveTxFull;
+
+// Master side of each packet: what it sent and what it received
+static uint8_t masterLength[SLAVE_PACKETS];
+static uint8_t masterRx[SLAVE_PACKETS][SLAVE_MAX_PACKET];
+
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGet();
+
+  LDMA_IntClear(pending);
+  ldmaRingIrqHandler(&slave.rx, pending);
+}
+
+static void usartWrite(uint32_t addr, unsigned int size, uint32_t value)
+{
+  (void)size;
+  if (addr == (uint32_t)(uintptr_t)&USART0->TXDATA)
+  {
+    slaveTxData = (uint8_t)value;
+    slaveTxFull = true;
+  }
+}
+
+// Byte the master sends as byte i of packet n
+static uint8_t masterByte(uint32_t n, uint32_t i)
+{
+  return (uint8_t)(n * 37 + i * 5 + 1);
+}
+
+// Let the transmit channel refill TXDATA, as on TXBL
+static void slaveLoadTx(void)
+{
+  if (!slaveTxFull)
+  {
+    LDMASIM_PeripheralRequest(1 << SLAVE_TX_CHANNEL);
+    LDMASIM_Run(MAX_RUN_CYCLES);
+  }
+}
+
+// Clock one byte each way, the receive channel moves it on RXDATAV
+static uint8_t masterExchange(uint8_t mosi)
+{
+  uint8_t miso = slaveTxFull ? slaveTxData : SLAVE_UNDERFLOW;
+
+  slaveTxFull = false;
+  USART0->RXDATA = mosi;
+  USART0->STATUS |= USART_STATUS_RXDATAV;
+  LDMASIM_PeripheralRequest(1 << SLAVE_RX_CHANNEL);
+  LDMASIM_Run(MAX_RUN_CYCLES);
+  USART0->STATUS &= ~USART_STATUS_RXDATAV;
+  slaveLoadTx();
+  return miso;
+}
+
+// Chip select rising edge, the GPIO interrupt ends the packet
+static void masterDeselect(void)
+{
+  spiSlaveRingCsIrq(&slave);
+  if (USART0->CMD & USART_CMD_CLEARTX)
+  {
+    slaveTxFull = false;
+  }
+  USART0->CMD = 0;
+  slaveLoadTx();
+}
+
+static void masterPacket(uint32_t n, uint32_t length)
+{
+  uint32_t i;
+
+  masterLength[n] = (uint8_t)length;
+  for (i = 0; i < length; i++)
+  {
+    masterRx[n][i] = masterExchange(masterByte(n, i));
+  }
+  masterDeselect();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read the next complete packet as the example does and echo it in a
+ *   later one. The packet must hold the bytes the master sent as packet n,
+ *   after skip bytes received late.
+ ******************************************************************************/
+static bool slaveReadPacket(uint32_t n, uint32_t skip, bool *passed)
+{
+  static uint8_t packet[SLAVE_MAX_PACKET + 1];
+  const uint8_t *data;
+  uint32_t length;
+  uint32_t total;
+  uint32_t span;
+  uint8_t *reply;
+
+  if (!spiSlaveRingPacket(&slave, &length))
+  {
+    return false;
+  }
+
+  total = 0;
+  while (length > 0)
+  {
+    span = spiSlaveRingSpan(&slave, &data);
+    if (span == 0)
+    {
+      break;
+    }
+    memcpy(&packet[total], data, span);
+    total += span;
+    spiSlaveRingConsume(&slave, span);
+    length -= span;
+  }
+
+  if (total != masterLength[n] + skip)
+  {
+    *passed = false;
+  }
+  for (length = 0; length < masterLength[n]; length++)
+  {
+    if (packet[skip + length] != masterByte(n, length))
+    {
+      *passed = false;
+    }
+  }
+
+  reply = spiSlaveReplyBuffer(&slave);
+  if (reply != NULL)
+  {
+    memcpy(reply, &packet[skip], masterLength[n]);
+    spiSlaveReplyCommit(&slave, masterLength[n]);
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Packet n must carry the echo of packet echo, then fill bytes.
+ ******************************************************************************/
+static bool checkReply(uint32_t n, int echo)
+{
+  uint32_t i;
+  uint8_t expected;
+
+  for (i = 0; i < masterLength[n]; i++)
+  {
+    expected = SPI_SLAVE_FILL;
+    if ((echo >= 0) && (i < masterLength[echo]))
+    {
+      expected = masterByte((uint32_t)echo, i);
+    }
+    if (masterRx[n][i] != expected)
+    {
+      printf("spi_slave_ring: packet %lu byte %lu: 0x%02X, expected 0x%02X\n",
+             (unsigned long)n, (unsigned long)i, masterRx[n][i], expected);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool runChains(void)
+{
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+  const uint8_t *data;
+  uint32_t packets = 0;
+  uint32_t n;
+  uint32_t i;
+  bool passed = true;
+
+  LDMA_Init(&init);
+  LDMASIM_MapRegisters(USART0, sizeof(USART_TypeDef), usartWrite);
+  spiSlaveRingInit(&slave, USART0, slaveBuffer, SLAVE_RING_SIZE,
+                   SLAVE_RX_CHANNEL, ldmaPeripheralSignal_USART0_RXDATAV,
+                   SLAVE_TX_CHANNEL, ldmaPeripheralSignal_USART0_TXBL);
+  slaveLoadTx();
+
+  // Packets of any length, wrapping around the ring. Each is read after
+  // its chip select, so its echo goes out two packets later.
+  for (n = 0; n < SLAVE_PACKETS - 8; n++)
+  {
+    masterPacket(n, 1 + (n * 13) % SLAVE_MAX_PACKET);
+    while (slaveReadPacket(n, 0, &passed))
+    {
+      packets++;
+    }
+    passed = checkReply(n, (int)n - 2) && passed;
+  }
+  passed = passed && (packets == n) && (slave.rx.dropped == 0);
+  printf("spi_slave_ring: %lu packets echoed\n", (unsigned long)packets);
+
+  // Receive channel stalled at chip select: the wait for RXDATAV gives up
+  // and the late byte starts the next packet. The chip select without
+  // clocks sends the echo of the packet before it one packet early.
+  masterPacket(n, 5);
+  passed = slaveReadPacket(n, 0, &passed) && passed;
+  n++;
+  USART0->RXDATA = 0xA5;
+  USART0->STATUS |= USART_STATUS_RXDATAV;
+  masterDeselect();
+  passed = !slaveReadPacket(n, 0, &passed) && passed;
+  LDMASIM_PeripheralRequest(1 << SLAVE_RX_CHANNEL);
+  LDMASIM_Run(MAX_RUN_CYCLES);
+  USART0->STATUS &= ~USART_STATUS_RXDATAV;
+  masterPacket(n, 7);
+  passed = slaveReadPacket(n, 1, &passed) && passed;
+  passed = checkReply(n, (int)n - 1) && passed;
+  n++;
+  printf("spi_slave_ring: late byte moved to the next packet\n");
+
+  // Three packets overrun the ring before the main loop runs: all of them
+  // are dropped and the next one is read intact
+  masterPacket(n++, SLAVE_MAX_PACKET);
+  masterPacket(n++, SLAVE_MAX_PACKET);
+  masterPacket(n++, SLAVE_MAX_PACKET);
+  passed = !slaveReadPacket(n - 1, 0, &passed) && passed;
+  passed = passed && (slave.rx.dropped == 3 * SLAVE_MAX_PACKET);
+
+  // The bytes of a packet still being clocked are not returned
+  masterLength[n] = 9;
+  for (i = 0; i < masterLength[n]; i++)
+  {
+    masterRx[n][i] = masterExchange(masterByte(n, i));
+    passed = (spiSlaveRingSpan(&slave, &data) == 0) && passed;
+  }
+  masterDeselect();
+  passed = slaveReadPacket(n, 0, &passed) && passed;
+  printf("spi_slave_ring: %lu bytes dropped after an overrun\n",
+         (unsigned long)slave.rx.dropped);
+
+  return checkChain("spi_slave_ring",
+                    (1 << SLAVE_RX_CHANNEL) | (1 << SLAVE_TX_CHANNEL), passed);
+}
+#endif
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main(void)
+{
+  LDMASIM_Reset();
+
+  return runChains() ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Host test of the deinterleave kernels of pdm_stereo_ldma.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "pdm_deinterleave.h"
+
+// Longest run of stereo words tested
+#define MAX_COUNT         1030
+
+// Random runs tested at every destination offset
+#define RANDOM_RUNS       2000
+
+// Written to the destinations first, must survive past the end of a run
+#define GUARD             ((int16_t)0x5AA5)
+
+static uint32_t src[MAX_COUNT + 1];
+
+// One spare sample in front so that the run can start on an odd halfword
+static int16_t leftPacked[MAX_COUNT + 8];
+static int16_t rightPacked[MAX_COUNT + 8];
+static int16_t leftScalar[MAX_COUNT + 8];
+static int16_t rightScalar[MAX_COUNT + 8];
+
+static uint32_t rngState = 0x2545F491;
+
+static uint32_t rng(void)
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Deinterleave count words from src + srcOffset into the destinations at
+ *   dstOffset with both kernels and compare the results.
+ *
+ * @details
+ *   Every sample of the run must be equal in both outputs, the samples
+ *   around the run must be left untouched.
+ ******************************************************************************/
+static bool checkRun(uint32_t srcOffset, uint32_t dstOffset, uint32_t count)
+{
+  uint32_t i;
+
+  for (i = 0; i < MAX_COUNT + 8; i++)
+  {
+    leftPacked[i] = GUARD;
+    rightPacked[i] = GUARD;
+    leftScalar[i] = GUARD;
+    rightScalar[i] = GUARD;
+  }
+
+  pdmDeinterleave(&src[srcOffset], &leftPacked[dstOffset],
+                  &rightPacked[dstOffset], count);
+  pdmDeinterleaveScalar(&src[srcOffset], &leftScalar[dstOffset],
+                        &rightScalar[dstOffset], count);
+
+  for (i = 0; i < MAX_COUNT + 8; i++)
+  {
+    bool inside = (i >= dstOffset) && (i < dstOffset + count);
+
+    if ((leftPacked[i] != leftScalar[i]) || (rightPacked[i] != rightScalar[i])
+        || (!inside && ((leftPacked[i] != GUARD) || (rightPacked[i] != GUARD))))
+    {
+      printf("count %lu, source offset %lu, destination offset %lu: "
+             "sample %lu differs\n",
+             (unsigned long)count, (unsigned long)srcOffset,
+             (unsigned long)dstOffset, (unsigned long)i);
+      return false;
+    }
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief  Main function
+ ******************************************************************************/
+int main(void)
+{
+  uint32_t checked = 0;
+  uint32_t dstOffset;
+  uint32_t count;
+  uint32_t i;
+  bool passed = true;
+
+  for (i = 0; i < MAX_COUNT + 1; i++)
+  {
+    src[i] = rng();
+  }
+
+  // Every count from 0 to 67, even and odd, then the segment sizes around
+  // those of the example, at aligned and odd halfword destinations
+  for (dstOffset = 0; dstOffset < 4; dstOffset++)
+  {
+    for (count = 0; count < 68; count++)
+    {
+      passed = checkRun(0, dstOffset, count) && passed;
+      passed = checkRun(1, dstOffset, count) && passed;
+      checked += 2;
+    }
+    passed = checkRun(0, dstOffset, 1023) && passed;
+    passed = checkRun(0, dstOffset, 1024) && passed;
+    passed = checkRun(1, dstOffset, MAX_COUNT) && passed;
+    checked += 3;
+  }
+
+  // Random data, lengths and offsets
+  for (i = 0; i < RANDOM_RUNS; i++)
+  {
+    uint32_t srcOffset = rng() % 2;
+
+    count = rng() % (MAX_COUNT + 1 - srcOffset);
+    dstOffset = rng() % 8;
+    if (count > MAX_COUNT + 8 - dstOffset)
+    {
+      count = MAX_COUNT + 8 - dstOffset;
+    }
+    src[rng() % (MAX_COUNT + 1)] = rng();
+    passed = checkRun(srcOffset, dstOffset, count) && passed;
+    checked++;
+  }
+
+  printf("%lu runs compared\n", (unsigned long)checked);
+  printf("%s\n", passed ? "PASSED" : "FAILED");
+  return passed ? 0 : 1;
+}
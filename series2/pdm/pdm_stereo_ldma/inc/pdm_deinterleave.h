@@ -0,0 +1,67 @@
+/***************************************************************************//**
+ * @file pdm_deinterleave.h
+ * @brief Stereo PDM sample deinterleave kernels.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef PDM_DEINTERLEAVE_H
+#define PDM_DEINTERLEAVE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * With PDM_CFG0_DATAFORMAT_DOUBLE16 every 32-bit FIFO word holds the left
+ * sample in bits 15:0 and the right sample in bits 31:16.
+ *
+ * pdmDeinterleave() processes two words per iteration. On cores with the
+ * DSP extension (Cortex-M33 on series 2) it packs the two left and the two
+ * right halfwords with PKHBT/PKHTB and stores each pair with a single word
+ * write. Elsewhere it uses a portable C version of the same algorithm.
+ * left and right should be 4-byte aligned so each pair is a single store.
+ *
+ * pdmDeinterleaveScalar() is the original one sample per iteration loop,
+ * kept as the reference and for benchmarking.
+ */
+void pdmDeinterleave(const uint32_t *src, int16_t *left, int16_t *right,
+                     uint32_t count);
+void pdmDeinterleaveScalar(const uint32_t *src, int16_t *left,
+                           int16_t *right, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PDM_DEINTERLEAVE_H
@@ -41,7 +41,10 @@
 #include "em_emu.h"
 #include "em_gpio.h"
 #include "em_ldma.h"
+#include "em_common.h"
 #include "em_pdm.h"
+#include "ldma_ring.h"
+#include "pdm_deinterleave.h"
 
 // DMA channel used for the example
 #define LDMA_CHANNEL        0
@@ -50,22 +53,62 @@
 // Left/right buffer size
 #define BUFFER_SIZE         128
 
-// Ping-pong buffer size
-#define PP_BUFFER_SIZE      64
+// Number of ring segments (power of two). Up to NUM_SEGMENTS - 1 segments
+// can wait for processing before the LDMA overruns the oldest one.
+#define NUM_SEGMENTS        4
 
-// Buffers for left/right PCM data
-int16_t left[BUFFER_SIZE];
-int16_t right[BUFFER_SIZE];
+// Stereo samples per ring segment
+#define SEGMENT_SIZE        64
 
-// Descriptor linked list for LDMA transfer
-LDMA_Descriptor_t descLink[2];
+// Define to measure the deinterleave kernels with the DWT cycle counter
+// #define DEINTERLEAVE_BENCHMARK
 
-// Buffers for ping-pong transfer
-uint32_t pingBuffer[PP_BUFFER_SIZE];
-uint32_t pongBuffer[PP_BUFFER_SIZE];
+// Buffers for left/right PCM data, word aligned for paired stores
+SL_ALIGN(4) int16_t left[BUFFER_SIZE] SL_ATTRIBUTE_ALIGN(4);
+SL_ALIGN(4) int16_t right[BUFFER_SIZE] SL_ATTRIBUTE_ALIGN(4);
 
-// Keeps track of previously written buffer
-bool prevBufferPing;
+// Descriptor list for LDMA ring transfer
+LDMA_Descriptor_t descLink[NUM_SEGMENTS];
+
+// Ring segments holding raw stereo PCM data
+uint32_t ringBuffer[NUM_SEGMENTS][SEGMENT_SIZE];
+
+// LDMA ring context
+LdmaRing_t pdmRing;
+
+#if defined(DEINTERLEAVE_BENCHMARK)
+// Cycles to deinterleave one segment, view in the Expressions window
+uint32_t cyclesScalar;
+uint32_t cyclesPacked;
+
+/***************************************************************************//**
+ * @brief
+ *   Time both deinterleave kernels on one segment with the DWT cycle counter
+ ******************************************************************************/
+void benchmarkDeinterleave(void)
+{
+  uint32_t start;
+  int i;
+
+  // Arbitrary stereo test pattern
+  for(i=0; i<SEGMENT_SIZE; i++) {
+    ringBuffer[0][i] = (i * 0x00010003UL) ^ 0x5A5AA5A5UL;
+  }
+
+  // Enable the cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  pdmDeinterleaveScalar(ringBuffer[0], left, right, SEGMENT_SIZE);
+  cyclesScalar = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  pdmDeinterleave(ringBuffer[0], left, right, SEGMENT_SIZE);
+  cyclesPacked = DWT->CYCCNT - start;
+}
+#endif
 
 /***************************************************************************//**
  * @brief
@@ -118,7 +161,7 @@ void initPdm(void)
 
 /***************************************************************************//**
  * @brief
- *   Initialize the LDMA controller for ping-pong transfer
+ *   Initialize the LDMA controller for ring transfer
  ******************************************************************************/
 void initLdma(void)
 {
@@ -128,20 +171,13 @@ void initLdma(void)
   LDMA_TransferCfg_t periTransferTx =
     LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_PDM_RXDATAV);
 
-  // Link descriptors for ping-pong transfer
-  descLink[0] = (LDMA_Descriptor_t)
-    LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&PDM->RXDATA, pingBuffer,
-                                     PP_BUFFER_SIZE, 1);
-  descLink[1] = (LDMA_Descriptor_t)
-    LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&PDM->RXDATA, pongBuffer,
-                                     PP_BUFFER_SIZE, -1);
-
-  // Next transfer writes to pingBuffer
-  prevBufferPing = false;
+  // Looping descriptor list, one descriptor per ring segment
+  ldmaRingInit(&pdmRing, LDMA_CHANNEL, descLink, ringBuffer, NUM_SEGMENTS,
+               SEGMENT_SIZE, ldmaCtrlSizeWord, &PDM->RXDATA);
 
   LDMA_Init(&init);
 
-  LDMA_StartTransfer(LDMA_CHANNEL, (void*)&periTransferTx, (void*)&descLink);
+  ldmaRingStart(&pdmRing, &periTransferTx);
 }
 
 /***************************************************************************//**
@@ -164,8 +200,8 @@ void LDMA_IRQHandler(void)
     while(1);
   }
 
-  // Keep track of previously written buffer
-  prevBufferPing = !prevBufferPing;
+  // Publish completed ring segments to the main loop
+  ldmaRingIrqHandler(&pdmRing, pending);
 }
 
 /***************************************************************************//**
@@ -174,11 +210,16 @@ void LDMA_IRQHandler(void)
  ******************************************************************************/
 int main(void)
 {
-  int i;
+  uint32_t *segment;
+  int outIndex = 0;
 
   // Chip errata
   CHIP_Init();
 
+#if defined(DEINTERLEAVE_BENCHMARK)
+  benchmarkDeinterleave();
+#endif
+
   // Initialize LDMA and PDM
   initLdma();
   initPdm();
@@ -186,18 +227,14 @@ int main(void)
   while(1) {
     EMU_EnterEM1();
 
-    // After LDMA transfer completes and wakes up device from EM1,
-    // convert data from ping-pong buffers to left/right PCM data
-    if(prevBufferPing) {
-      for(i=0; i<PP_BUFFER_SIZE; i++) {
-        left[i] = pingBuffer[i] & 0x0000FFFF;
-        right[i] = (pingBuffer[i] >> 16) & 0x0000FFFF;
-      }
-    } else {
-      for(i=0; i<PP_BUFFER_SIZE; i++) {
-        left[PP_BUFFER_SIZE + i] = pongBuffer[i] & 0x0000FFFF;
-        right[PP_BUFFER_SIZE + i] = (pongBuffer[i] >> 16) & 0x0000FFFF;
-      }
+    // After LDMA transfers complete and wake up device from EM1, convert
+    // every completed ring segment in place into left/right PCM data
+    while((segment = ldmaRingPeek(&pdmRing)) != NULL) {
+      pdmDeinterleave(segment, &left[outIndex], &right[outIndex],
+                      SEGMENT_SIZE);
+      ldmaRingRelease(&pdmRing);
+
+      outIndex = (outIndex + SEGMENT_SIZE) % BUFFER_SIZE;
     }
   }
 }
@@ -0,0 +1,111 @@
+/***************************************************************************//**
+ * @file pdm_deinterleave.c
+ * @brief Stereo PDM sample deinterleave kernels. See pdm_deinterleave.h.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <string.h>
+#include "pdm_deinterleave.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "em_device.h"
+
+// Pack the low halfwords of a and b into one word, a in bits 15:0
+#define PACK_LOW(a, b)      __PKHBT((a), (b), 16)
+
+// Pack the high halfwords of a and b into one word, a in bits 15:0
+#define PACK_HIGH(a, b)     __PKHTB((b), (a), 16)
+#else
+#define PACK_LOW(a, b)      (((a) & 0x0000FFFF) | ((b) << 16))
+#define PACK_HIGH(a, b)     (((a) >> 16) | ((b) & 0xFFFF0000))
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *   Split count stereo words into left and right samples, two words per
+ *   iteration.
+ *
+ * @param[in] src
+ *   Stereo words, left sample in bits 15:0.
+ *
+ * @param[out] left
+ *   Left samples, preferably 4-byte aligned.
+ *
+ * @param[out] right
+ *   Right samples, preferably 4-byte aligned.
+ *
+ * @param[in] count
+ *   Number of stereo words.
+ ******************************************************************************/
+void pdmDeinterleave(const uint32_t *src, int16_t *left, int16_t *right,
+                     uint32_t count)
+{
+  uint32_t w0, w1;
+  uint32_t pair;
+  uint32_t i;
+
+  for (i = 0; i + 1 < count; i += 2)
+  {
+    w0 = src[i];
+    w1 = src[i + 1];
+
+    // memcpy of a word compiles to a single STR
+    pair = PACK_LOW(w0, w1);
+    memcpy(&left[i], &pair, sizeof(pair));
+    pair = PACK_HIGH(w0, w1);
+    memcpy(&right[i], &pair, sizeof(pair));
+  }
+
+  // Odd trailing word
+  if (i < count)
+  {
+    left[i] = (int16_t)(src[i] & 0x0000FFFF);
+    right[i] = (int16_t)(src[i] >> 16);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Split count stereo words into left and right samples, one word per
+ *   iteration.
+ ******************************************************************************/
+void pdmDeinterleaveScalar(const uint32_t *src, int16_t *left,
+                           int16_t *right, uint32_t count)
+{
+  uint32_t i;
+
+  for (i = 0; i < count; i++)
+  {
+    left[i] = src[i] & 0x0000FFFF;
+    right[i] = (src[i] >> 16) & 0x0000FFFF;
+  }
+}
@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ * @file autobaud.h
+ * @brief Baud rate detection from the edges of a sync character captured by a
+ * TIMER and the LDMA
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef AUTOBAUD_H
+#define AUTOBAUD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+#include "em_gpio.h"
+#include "em_ldma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of edges captured, two 'U' (0x55) sync characters give 20
+#if !defined(AUTOBAUD_EDGES)
+#define AUTOBAUD_EDGES            20
+#endif
+
+// Longest low level: a start bit and 8 zero data bits
+#define AUTOBAUD_MAX_RUN          9
+
+// Largest distance of an edge from a multiple of the bit time, in 1/16 bit
+#define AUTOBAUD_JITTER           4
+
+// Detected rates within this many 1/1000 of a standard rate are rounded to
+// it (see autobaudStandardRate())
+#if !defined(AUTOBAUD_SNAP_PERMILLE)
+#define AUTOBAUD_SNAP_PERMILLE    20
+#endif
+
+/*
+ * The RX pin is routed to a TIMER capture channel that captures both edges.
+ * The LDMA copies AUTOBAUD_EDGES capture values into edges without waking
+ * the CPU, and interrupts once they are all in. The bit time is then the
+ * one of which every level within a character is a whole multiple; the
+ * high levels that hold a stop bit may include idle time and are skipped.
+ */
+typedef struct {
+  TIMER_TypeDef *timer;
+  uint32_t cc;                // Capture channel
+  uint32_t channel;           // LDMA channel
+  bool firstFalling;          // The line was high when capture started
+  volatile bool done;         // All edges have been captured
+  LDMA_Descriptor_t descriptor;
+  uint32_t edges[AUTOBAUD_EDGES];
+} Autobaud_t;
+
+void autobaudStart(Autobaud_t *autobaud, TIMER_TypeDef *timer, uint32_t cc,
+                   GPIO_Port_TypeDef port, unsigned int pin,
+                   uint32_t channel, uint32_t reqSel);
+void autobaudIrq(Autobaud_t *autobaud);
+bool autobaudDone(Autobaud_t *autobaud);
+uint32_t autobaudRate(Autobaud_t *autobaud, uint32_t timerFreq);
+uint32_t autobaudEstimate(const uint32_t *edges, uint32_t count,
+                          bool firstFalling, uint32_t timerFreq);
+uint32_t autobaudStandardRate(uint32_t baudrate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUTOBAUD_H
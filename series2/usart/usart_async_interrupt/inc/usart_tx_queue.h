@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ * @file usart_tx_queue.h
+ * @brief Queued USART transmit of scattered buffers through LDMA descriptor
+ * chains
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef USART_TX_QUEUE_H
+#define USART_TX_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+#include "em_ldma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of LDMA descriptors shared by the queued messages. Each fragment
+// takes one descriptor per 2048 bytes.
+#if !defined(USART_TX_QUEUE_DESCRIPTORS)
+#define USART_TX_QUEUE_DESCRIPTORS  16
+#endif
+
+// Number of messages that can be queued
+#if !defined(USART_TX_QUEUE_MESSAGES)
+#define USART_TX_QUEUE_MESSAGES     4
+#endif
+
+// One piece of a message, e.g. a header, a payload or a CRC
+typedef struct {
+  const void *data;
+  uint32_t length;
+} UsartTxFragment_t;
+
+// Called from the LDMA interrupt once the last byte of a message has been
+// written to the USART
+typedef void (*UsartTxDone_t)(void *user);
+
+typedef struct {
+  uint32_t first;             // First descriptor of the message
+  uint32_t count;             // Number of descriptors of the message
+  UsartTxDone_t done;
+  void *user;
+} UsartTxMessage_t;
+
+/*
+ * Each message is turned into one chain of linked LDMA descriptors that
+ * writes its fragments to TXDATA. Only the last descriptor raises an
+ * interrupt, which starts the chain of the next message. The fragments must
+ * stay valid until the message is done.
+ */
+typedef struct {
+  USART_TypeDef *usart;
+  uint32_t channel;
+  LDMA_TransferCfg_t transferConfig;
+  LDMA_Descriptor_t descriptor[USART_TX_QUEUE_DESCRIPTORS];
+  UsartTxMessage_t message[USART_TX_QUEUE_MESSAGES];
+  uint32_t descriptorHead;    // Next free descriptor
+  uint32_t descriptorsFree;
+  uint32_t messageHead;       // Next free message
+  uint32_t messageTail;       // Message being sent
+  volatile uint32_t messageCount;
+} UsartTxQueue_t;
+
+void usartTxQueueInit(UsartTxQueue_t *queue, USART_TypeDef *usart,
+                      uint32_t channel, uint32_t reqSel);
+bool usartTxQueueWrite(UsartTxQueue_t *queue,
+                       const UsartTxFragment_t *fragments, uint32_t count,
+                       UsartTxDone_t done, void *user);
+void usartTxQueueIrq(UsartTxQueue_t *queue);
+bool usartTxQueueIdle(UsartTxQueue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USART_TX_QUEUE_H
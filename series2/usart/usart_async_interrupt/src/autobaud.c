@@ -0,0 +1,305 @@
+/***************************************************************************//**
+ * @file autobaud.c
+ * @brief Baud rate detection from the edges of a sync character captured by a
+ * TIMER and the LDMA
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "em_assert.h"
+#include "em_core.h"
+#include "em_gpio.h"
+#include "em_ldma.h"
+#include "em_timer.h"
+#include "autobaud.h"
+
+// Rates autobaudStandardRate() rounds to
+static const uint32_t standardRates[] = {
+  1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 76800,
+  115200, 230400, 460800, 921600
+};
+
+/**************************************************************************//**
+ * @brief
+ *    Start capturing the edges of the RX pin
+ *
+ * @param[in] autobaud
+ *    Detection state
+ *
+ * @param[in] timer
+ *    A 32-bit TIMER, e.g. TIMER0, clocked without a prescaler
+ *
+ * @param[in] cc
+ *    Capture channel, its input must be routed to the RX pin
+ *
+ * @param[in] port
+ *    Port of the RX pin
+ *
+ * @param[in] pin
+ *    RX pin, which must be configured as an input
+ *
+ * @param[in] channel
+ *    LDMA channel, must not be used by anything else
+ *
+ * @param[in] reqSel
+ *    LDMAXBAR request signal and source of the capture channel
+ *
+ * @note
+ *    LDMA_Init() must have been called. The USART may stay enabled, it
+ *    receives the sync characters at the wrong rate.
+ *****************************************************************************/
+void autobaudStart(Autobaud_t *autobaud, TIMER_TypeDef *timer, uint32_t cc,
+                   GPIO_Port_TypeDef port, unsigned int pin,
+                   uint32_t channel, uint32_t reqSel)
+{
+  TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
+  TIMER_InitCC_TypeDef timerCCInit = TIMER_INITCC_DEFAULT;
+  LDMA_TransferCfg_t transferConfig = LDMA_TRANSFER_CFG_PERIPHERAL(reqSel);
+  CORE_DECLARE_IRQ_STATE;
+
+  autobaud->timer = timer;
+  autobaud->cc = cc;
+  autobaud->channel = channel;
+  autobaud->done = false;
+
+  // Capture both edges at the full timer clock
+  timerInit.enable = false;
+  timerInit.prescale = timerPrescale1;
+  timerCCInit.eventCtrl = timerEventEveryEdge;
+  timerCCInit.edge = timerEdgeBoth;
+  timerCCInit.mode = timerCCModeCapture;
+  TIMER_Init(timer, &timerInit);
+  TIMER_InitCC(timer, cc, &timerCCInit);
+
+  // Copy one capture value per edge, interrupt once all have been copied
+  autobaud->descriptor = (LDMA_Descriptor_t)
+    LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(&timer->CC[cc].ICF, autobaud->edges,
+                                    AUTOBAUD_EDGES);
+  autobaud->descriptor.xfer.size = ldmaCtrlSizeWord;
+  LDMA_StartTransfer(channel, &transferConfig, &autobaud->descriptor);
+
+  // The level of the line gives the direction of the first edge
+  CORE_ENTER_CRITICAL();
+  autobaud->firstFalling = (GPIO_PinInGet(port, pin) != 0);
+  TIMER_Enable(timer, true);
+  CORE_EXIT_CRITICAL();
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Handle the LDMA interrupt of the capture channel, call from
+ *    LDMA_IRQHandler()
+ *****************************************************************************/
+void autobaudIrq(Autobaud_t *autobaud)
+{
+  uint32_t mask = 1UL << autobaud->channel;
+
+  if (!(LDMA_IntGet() & mask)) {
+    return;
+  }
+  LDMA_IntClear(mask);
+
+  TIMER_Enable(autobaud->timer, false);
+  autobaud->done = true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    true once AUTOBAUD_EDGES edges have been captured
+ *****************************************************************************/
+bool autobaudDone(Autobaud_t *autobaud)
+{
+  return autobaud->done;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Get the rate of the captured sync characters
+ *
+ * @param[in] timerFreq
+ *    Clock frequency of the TIMER
+ *
+ * @return
+ *    Baud rate, rounded to a standard rate if it is close to one, or 0 if
+ *    the edges are not those of characters. Capture again in that case.
+ *****************************************************************************/
+uint32_t autobaudRate(Autobaud_t *autobaud, uint32_t timerFreq)
+{
+  EFM_ASSERT(autobaud->done);
+
+  return autobaudStandardRate(autobaudEstimate(autobaud->edges,
+                                               AUTOBAUD_EDGES,
+                                               autobaud->firstFalling,
+                                               timerFreq));
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Fit a bit time to the levels between captured edges
+ *
+ * @details
+ *    Every level lasts a whole number of bits, except for the high levels
+ *    that hold a stop bit, which may include idle time between characters.
+ *    The shortest level is a first guess of the bit time. The sync
+ *    characters must contain a low level of one bit, e.g. a start bit
+ *    followed by a 1 as in 'U' (0x55) or CR (0x0D), so that it is one bit
+ *    long. Each level is then counted as the nearest whole number of bits,
+ *    a histogram of the levels with one bin per bit time, and the bit time
+ *    is fitted to all of them at once: their total length over their total
+ *    number of bits. This averages out the timer resolution over all the
+ *    bits captured. The fit is repeated three times, each with the bits
+ *    counted against the fit before it. The first one uses the levels of
+ *    one or two bits, which the guess counts right even if it is a few
+ *    timer ticks off. The second one uses all low levels, which never hold
+ *    idle time, and the third one adds the high levels that end within 8.5
+ *    bits of the start bit before them, i.e. before the stop bit. High
+ *    levels too far off a whole number of bits are skipped, as idle time
+ *    that the first fit could not tell apart. A low level like that, or
+ *    longer than AUTOBAUD_MAX_RUN bits, means the edges are not those of
+ *    characters.
+ *
+ * @param[in] edges
+ *    Timer values captured at count successive edges
+ *
+ * @param[in] firstFalling
+ *    edges[0] is a falling edge
+ *
+ * @param[in] timerFreq
+ *    Clock frequency of the timer
+ *
+ * @return
+ *    Baud rate, or 0 if no bit time fits the edges
+ *****************************************************************************/
+uint32_t autobaudEstimate(const uint32_t *edges, uint32_t count,
+                          bool firstFalling, uint32_t timerFreq)
+{
+  uint32_t shortest = UINT32_MAX;
+  uint32_t bitTime16;                // Bit time in 1/16 timer ticks
+  uint32_t start;                    // Edge of the current start bit
+  uint32_t length;
+  uint32_t bits;
+  int64_t error;
+  uint32_t totalBits = 0;
+  uint64_t totalTicks = 0;
+  uint32_t pass;
+  uint32_t i;
+  bool low;
+
+  for (i = 1; i < count; i++) {
+    length = edges[i] - edges[i - 1];
+    if (length < shortest) {
+      shortest = length;
+    }
+  }
+  if ((shortest == 0) || (shortest > UINT32_MAX / 16)) {
+    return 0;
+  }
+  bitTime16 = shortest * 16;
+
+  for (pass = 0; pass < 3; pass++) {
+    totalBits = 0;
+    totalTicks = 0;
+    start = firstFalling ? 0 : 1;
+
+    for (i = 1; i < count; i++) {
+      length = edges[i] - edges[i - 1];
+      bits = (uint32_t)(((uint64_t)length * 16 + bitTime16 / 2) / bitTime16);
+
+      // Edges alternate, the level after a falling edge is low
+      low = (((i - 1) % 2 == 0) == firstFalling);
+
+      // A high level that ends after the last data bit holds the stop
+      // bit and maybe idle time, the falling edge after it starts the
+      // next character. Only the last pass has a bit time to tell.
+      if (!low && (pass > 0)) {
+        if ((pass == 1)
+            || ((uint64_t)(edges[i] - edges[start]) * 16
+                > (uint64_t)bitTime16 * 17 / 2)) {
+          start = i;
+          continue;
+        }
+      }
+
+      // Distance from the nearest whole number of bits, in 1/16 bit
+      error = (int64_t)length * 16 - (int64_t)bits * bitTime16;
+      if (error < 0) {
+        error = -error;
+      }
+      error = error * 16 / bitTime16;
+
+      // Levels of several bits are only counted once the guess is close
+      if ((pass == 0) && (bits > 2)) {
+        continue;
+      }
+      if ((bits == 0) || (bits > AUTOBAUD_MAX_RUN)
+          || (error > AUTOBAUD_JITTER)) {
+        if (!low) {
+          continue;
+        }
+        return 0;
+      }
+      totalBits += bits;
+      totalTicks += length;
+    }
+
+    if (totalTicks == 0) {
+      return 0;
+    }
+    bitTime16 = (uint32_t)((totalTicks * 16 + totalBits / 2) / totalBits);
+  }
+
+  return (uint32_t)(((uint64_t)timerFreq * totalBits + totalTicks / 2)
+                    / totalTicks);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Round a detected rate to a standard rate within AUTOBAUD_SNAP_PERMILLE
+ *
+ * @return
+ *    The standard rate, or baudrate if there is none close to it
+ *****************************************************************************/
+uint32_t autobaudStandardRate(uint32_t baudrate)
+{
+  uint32_t difference;
+  uint32_t i;
+
+  for (i = 0; i < sizeof(standardRates) / sizeof(standardRates[0]); i++) {
+    difference = (baudrate > standardRates[i])
+                 ? baudrate - standardRates[i]
+                 : standardRates[i] - baudrate;
+    if ((uint64_t)difference * 1000
+        <= (uint64_t)standardRates[i] * AUTOBAUD_SNAP_PERMILLE) {
+      return standardRates[i];
+    }
+  }
+  return baudrate;
+}
@@ -2,15 +2,18 @@
  * @file main.c
  * @brief This project demonstrates use of the USART with interrupts.
  *
+ * At startup, the baud rate is detected from the 'U' characters the host
+ * sends, timed by TIMER0 capturing the edges of the RX pin.
+ *
  * After initialization, the MCU goes into EM1 where the receive interrupt
  * handler buffers incoming data until the reception of 80 characters or a
  * CR (carriage return, ASCII 0x0D).
  *
  * Once the CR or 80 characters is hit, the receive data valid interrupt is
- * disabled, and the transmit buffer level interrupt, which, by default, is set
- * after power-on, is is enabled.  Each entry into the transmit interrupt
- * handler causes a character to be sent until all the characters originally
- * received have been echoed.
+ * disabled, and the received characters are queued for transmission between
+ * a header and a trailer. The LDMA sends the three fragments with one chain
+ * of linked descriptors, and interrupts once when all of them have been
+ * echoed.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -48,20 +51,38 @@
 #include "em_emu.h"
 #include "em_cmu.h"
 #include "em_gpio.h"
+#include "em_ldma.h"
+#include "em_timer.h"
 #include "em_usart.h"
+#include "autobaud.h"
+#include "usart_tx_queue.h"
 
 // Size of the buffer for received data
 #define BUFLEN  80
 
+// LDMA channels used to transmit and to capture the RX edges
+#define TX_LDMA_CHANNEL        0
+#define AUTOBAUD_LDMA_CHANNEL  1
+
 // Receive data buffer
 uint8_t buffer[BUFLEN];
 
 // Current position ins buffer
 uint32_t inpos = 0;
-uint32_t outpos = 0;
 
 // True while receiving data (waiting for CR or BUFLEN characters)
-bool receive = true;
+volatile bool receive = true;
+
+// Transmit queue
+UsartTxQueue_t txQueue;
+
+// Baud rate detection, and the rate detected
+Autobaud_t autobaud;
+uint32_t baudrate;
+
+// Sent before and after the received characters
+static const char header[] = "\r\nReceived: ";
+static const char trailer[] = "\r\n";
 
 /**************************************************************************//**
  * @brief
@@ -86,10 +107,11 @@ void initGpio(void)
  *****************************************************************************/
 void initCmu(void)
 {
-  // Enable clock to GPIO and USART1
+  // Enable clock to GPIO, USART1, LDMA and TIMER0
   CMU_ClockEnable(cmuClock_GPIO, true);
   CMU_ClockEnable(cmuClock_USART1, true);
-
+  CMU_ClockEnable(cmuClock_LDMA, true);
+  CMU_ClockEnable(cmuClock_TIMER0, true);
 }
 
 /**************************************************************************//**
@@ -113,11 +135,60 @@ void initUsart1(void)
   // Configure and enable USART1
   USART_InitAsync(USART1, &init);
 
-  // Enable NVIC USART sources
+  // Enable NVIC USART sources, transmission is done by the LDMA
   NVIC_ClearPendingIRQ(USART1_RX_IRQn);
   NVIC_EnableIRQ(USART1_RX_IRQn);
-  NVIC_ClearPendingIRQ(USART1_TX_IRQn);
-  NVIC_EnableIRQ(USART1_TX_IRQn);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    LDMA initialization
+ *****************************************************************************/
+void initLdma(void)
+{
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+
+  LDMA_Init(&init);
+
+  // Messages are written to USART1 TXDATA whenever TXBL is set
+  usartTxQueueInit(&txQueue, USART1, TX_LDMA_CHANNEL,
+                   LDMAXBAR_CH_REQSEL_SIGSEL_USART1TXBL
+                   | LDMAXBAR_CH_REQSEL_SOURCESEL_USART1);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Set the USART1 baud rate to that of the sync characters sent by the
+ *    host
+ *
+ * @details
+ *    TIMER0 captures the edges of the RX pin, which USART1 keeps receiving
+ *    from, and the LDMA stores them. Capture starts over until the edges
+ *    are those of characters.
+ *****************************************************************************/
+void detectBaudrate(void)
+{
+  // Route PA6 to the TIMER0 CC0 input as well
+  GPIO->TIMERROUTE[0].CC0ROUTE = (gpioPortA << _GPIO_TIMER_CC0ROUTE_PORT_SHIFT)
+      | (6 << _GPIO_TIMER_CC0ROUTE_PIN_SHIFT);
+
+  baudrate = 0;
+  while (baudrate == 0) {
+    autobaudStart(&autobaud, TIMER0, 0, gpioPortA, 6, AUTOBAUD_LDMA_CHANNEL,
+                  LDMAXBAR_CH_REQSEL_SIGSEL_TIMER0CC0
+                  | LDMAXBAR_CH_REQSEL_SOURCESEL_TIMER0);
+
+    // Wait in EM1 while the edges are captured
+    while (!autobaudDone(&autobaud))
+      EMU_EnterEM1();
+
+    baudrate = autobaudRate(&autobaud, CMU_ClockFreqGet(cmuClock_TIMER0));
+  }
+
+  USART_BaudrateAsyncSet(USART1, 0, baudrate, usartOVS16);
+
+  // Drop the sync characters, received at the old rate
+  USART1->CMD = USART_CMD_CLEARRX;
 }
 
 /**************************************************************************//**
@@ -129,11 +200,11 @@ void USART1_RX_IRQHandler(void)
   // Get the character just received
   buffer[inpos] = USART1->RXDATA;
 
-  // Exit loop on new line or buffer full
-  if ((buffer[inpos] != '\r') && (inpos < BUFLEN))
-    inpos++;
-  else
+  // Exit loop on new line or buffer full, the CR is not echoed
+  if (buffer[inpos] == '\r')
     receive = false;   // Stop receiving on CR
+  else if (++inpos == BUFLEN)
+    receive = false;
 
   // Clear the requesting interrupt before exiting the handler
   USART_IntClear(USART1, USART_IF_RXDATAV);
@@ -141,25 +212,23 @@ void USART1_RX_IRQHandler(void)
 
 /**************************************************************************//**
  * @brief
- *    The USART1 transmit interrupt outputs characters.
+ *    Called by the transmit queue once the echo has been sent.
  *****************************************************************************/
-void USART1_TX_IRQHandler(void)
+void echoDone(void *user)
 {
-  // Send a previously received character
-  if (outpos < inpos)
-    USART1->TXDATA = buffer[outpos++];
-  else
-  /*
-   * Need to disable the transmit buffer level interrupt in this IRQ
-   * handler when done or it will immediately trigger again upon exit
-   * even though there is no data left to send.
-   */
-  {
-    receive = true;   // Go back into receive when all is sent
-    USART_IntDisable(USART1, USART_IEN_TXBL);
-  }
-  // Clear the requesting interrupt before exiting the handler
-  USART_IntClear(USART1, USART_IF_TXBL);
+  (void)user;
+
+  receive = true;   // Go back into receive when all is sent
+}
+
+/**************************************************************************//**
+ * @brief
+ *    The LDMA interrupt completes transmitted messages.
+ *****************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  usartTxQueueIrq(&txQueue);
+  autobaudIrq(&autobaud);
 }
 
 /**************************************************************************//**
@@ -168,15 +237,20 @@ void USART1_TX_IRQHandler(void)
  *****************************************************************************/
 int main(void)
 {
+  UsartTxFragment_t echo[3];
   uint32_t i;
 
   // Chip errata
   CHIP_Init();
 
-  // Initialize GPIO and USART1
+  // Initialize GPIO, USART1 and LDMA
   initCmu();
   initGpio();
   initUsart1();
+  initLdma();
+
+  // Match the rate of the host
+  detectBaudrate();
 
   while (1)
   {
@@ -194,14 +268,23 @@ int main(void)
     // Disable receive data valid interrupt
     USART_IntDisable(USART1, USART_IEN_RXDATAV);
 
-    // Enable transmit buffer level interrupt
-    USART_IntEnable(USART1, USART_IEN_TXBL);
+    // Queue the header, the received characters and the trailer as one
+    // message, the LDMA interrupts once when all of it has been sent. The
+    // queue may be full, retry once a queued message is done.
+    echo[0].data = header;
+    echo[0].length = sizeof(header) - 1;
+    echo[1].data = buffer;
+    echo[1].length = inpos;
+    echo[2].data = trailer;
+    echo[2].length = sizeof(trailer) - 1;
+    while (!usartTxQueueWrite(&txQueue, echo, 3, echoDone, NULL))
+      EMU_EnterEM1();
 
     // Wait in EM1 while transmitting to reduce current draw
     while (!receive)
       EMU_EnterEM1();
 
-    // Reset buffer indices
-    inpos = outpos = 0;
+    // Reset buffer index
+    inpos = 0;
   }
 }
@@ -0,0 +1,254 @@
+/***************************************************************************//**
+ * @file usart_tx_queue.c
+ * @brief Queued USART transmit of scattered buffers through LDMA descriptor
+ * chains
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "em_assert.h"
+#include "em_common.h"
+#include "em_core.h"
+#include "em_ldma.h"
+#include "usart_tx_queue.h"
+
+// Largest transfer count of one LDMA descriptor
+#define LDMA_MAX_XFER_COUNT  ((_LDMA_CH_CTRL_XFERCNT_MASK                      \
+                               >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+
+/**************************************************************************//**
+ * @brief
+ *    Start the descriptor chain of a message
+ *****************************************************************************/
+static void startMessage(UsartTxQueue_t *queue, UsartTxMessage_t *message)
+{
+  LDMA_StartTransfer(queue->channel, &queue->transferConfig,
+                     &queue->descriptor[message->first]);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Initialize an empty queue
+ *
+ * @param[in] queue
+ *    Queue state
+ *
+ * @param[in] usart
+ *    USART the messages are sent by
+ *
+ * @param[in] channel
+ *    LDMA channel, must not be used by anything else
+ *
+ * @param[in] reqSel
+ *    LDMAXBAR request signal and source of the USART TXBL request
+ *
+ * @note
+ *    LDMA_Init() must have been called.
+ *****************************************************************************/
+void usartTxQueueInit(UsartTxQueue_t *queue, USART_TypeDef *usart,
+                      uint32_t channel, uint32_t reqSel)
+{
+  LDMA_TransferCfg_t transferConfig = LDMA_TRANSFER_CFG_PERIPHERAL(reqSel);
+
+  queue->usart = usart;
+  queue->channel = channel;
+  queue->transferConfig = transferConfig;
+  queue->descriptorHead = 0;
+  queue->descriptorsFree = USART_TX_QUEUE_DESCRIPTORS;
+  queue->messageHead = 0;
+  queue->messageTail = 0;
+  queue->messageCount = 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Queue a message made of several fragments
+ *
+ * @details
+ *    The fragments are sent back to back, in order, by one chain of LDMA
+ *    descriptors, one descriptor per 2048 bytes of each fragment. Empty
+ *    fragments are skipped. The message starts right away if the queue is
+ *    idle, otherwise once the messages queued before it are done. A message
+ *    without any bytes is done at once: done is called before this
+ *    function returns, ahead of the messages still queued.
+ *
+ * @param[in] fragments
+ *    Fragments of the message, only the array itself may be reused once
+ *    this function returns
+ *
+ * @param[in] count
+ *    Number of fragments
+ *
+ * @param[in] done
+ *    Called from the LDMA interrupt once the message has been sent, may be
+ *    NULL
+ *
+ * @param[in] user
+ *    Passed to done
+ *
+ * @return
+ *    false if there are not enough free descriptors or message slots, the
+ *    message is not queued. Retry once a queued message is done.
+ *****************************************************************************/
+bool usartTxQueueWrite(UsartTxQueue_t *queue,
+                       const UsartTxFragment_t *fragments, uint32_t count,
+                       UsartTxDone_t done, void *user)
+{
+  UsartTxMessage_t *message;
+  LDMA_Descriptor_t *descriptor = NULL;
+  const uint8_t *data;
+  uint32_t needed = 0;
+  uint32_t index;
+  uint32_t previous = 0;
+  uint32_t offset;
+  uint32_t length;
+  uint32_t i;
+  bool start;
+  CORE_DECLARE_IRQ_STATE;
+
+  for (i = 0; i < count; i++) {
+    needed += (fragments[i].length + LDMA_MAX_XFER_COUNT - 1)
+              / LDMA_MAX_XFER_COUNT;
+  }
+
+  // Nothing to send, there would be no descriptor to interrupt on
+  if (needed == 0) {
+    if (done != NULL) {
+      done(user);
+    }
+    return true;
+  }
+
+  CORE_ENTER_ATOMIC();
+
+  if ((needed > queue->descriptorsFree)
+      || (queue->messageCount == USART_TX_QUEUE_MESSAGES)) {
+    CORE_EXIT_ATOMIC();
+    return false;
+  }
+
+  message = &queue->message[queue->messageHead];
+  message->first = queue->descriptorHead;
+  message->count = needed;
+  message->done = done;
+  message->user = user;
+
+  // Fill the free descriptors in order, wrapping around the end of the
+  // array, and link each one to the next
+  index = queue->descriptorHead;
+  for (i = 0; i < count; i++) {
+    data = fragments[i].data;
+    for (offset = 0; offset < fragments[i].length; offset += length) {
+      length = SL_MIN(fragments[i].length - offset, LDMA_MAX_XFER_COUNT);
+
+      if (descriptor != NULL) {
+        descriptor->xfer.link = 1;
+        descriptor->xfer.linkMode = ldmaLinkModeRel;
+        descriptor->xfer.linkAddr = ((int32_t) index - (int32_t) previous)
+                                    * LDMA_DESCRIPTOR_NDWORDS;
+      }
+
+      descriptor = &queue->descriptor[index];
+      *descriptor = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(data + offset,
+                                        &queue->usart->TXDATA,
+                                        length);
+      descriptor->xfer.doneIfs = 0;
+
+      previous = index;
+      index = (index + 1) % USART_TX_QUEUE_DESCRIPTORS;
+    }
+  }
+
+  // Only the end of the message raises an interrupt
+  descriptor->xfer.doneIfs = 1;
+
+  queue->descriptorHead = index;
+  queue->descriptorsFree -= needed;
+  queue->messageHead = (queue->messageHead + 1) % USART_TX_QUEUE_MESSAGES;
+  start = (queue->messageCount == 0);
+  queue->messageCount++;
+
+  if (start) {
+    startMessage(queue, message);
+  }
+
+  CORE_EXIT_ATOMIC();
+
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Complete the message being sent, call from LDMA_IRQHandler()
+ *
+ * @details
+ *    The next message is started before done is called, so the USART only
+ *    idles for the interrupt latency between messages.
+ *****************************************************************************/
+void usartTxQueueIrq(UsartTxQueue_t *queue)
+{
+  uint32_t mask = 1UL << queue->channel;
+  UsartTxMessage_t *message;
+  UsartTxDone_t done;
+  void *user;
+
+  if (!(LDMA_IntGet() & mask)) {
+    return;
+  }
+  LDMA_IntClear(mask);
+
+  message = &queue->message[queue->messageTail];
+  done = message->done;
+  user = message->user;
+
+  queue->descriptorsFree += message->count;
+  queue->messageTail = (queue->messageTail + 1) % USART_TX_QUEUE_MESSAGES;
+  queue->messageCount--;
+
+  if (queue->messageCount) {
+    startMessage(queue, &queue->message[queue->messageTail]);
+  }
+
+  if (done != NULL) {
+    done(user);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    true when all queued messages have been sent
+ *****************************************************************************/
+bool usartTxQueueIdle(UsartTxQueue_t *queue)
+{
+  return queue->messageCount == 0;
+}
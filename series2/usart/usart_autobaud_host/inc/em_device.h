@@ -0,0 +1,59 @@
+/***************************************************************************//**
+ * @file em_device.h
+ * @brief Host build replacement for the device header, with the TIMER
+ * registers read by autobaud.c.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define __STATIC_INLINE static inline
+#define __IM  volatile const
+#define __IOM volatile
+
+// TIMER capture channel, only the capture value is used
+typedef struct
+{
+  __IM uint32_t ICF;              // Input capture FIFO
+} TIMER_CC_TypeDef;
+
+typedef struct
+{
+  TIMER_CC_TypeDef CC[3];         // Capture channels
+} TIMER_TypeDef;
+
+#endif // EM_DEVICE_H
@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ * @file em_ldma.h
+ * @brief Host build replacement for the emlib LDMA API. Only the
+ * types and calls of autobaud.c are declared, transfers are not modelled.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_LDMA_H
+#define EM_LDMA_H
+
+#include "em_device.h"
+
+typedef enum
+{
+  ldmaCtrlSizeByte = 0,
+  ldmaCtrlSizeHalf = 1,
+  ldmaCtrlSizeWord = 2
+} LDMA_CtrlSize_t;
+
+typedef union
+{
+  struct
+  {
+    uint32_t  size;
+    uint32_t  xferCnt;
+    uintptr_t srcAddr;
+    uintptr_t dstAddr;
+  } xfer;
+} LDMA_Descriptor_t;
+
+typedef struct
+{
+  uint32_t ldmaReqSel;
+} LDMA_TransferCfg_t;
+
+#define LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(src, dest, count) \
+  {                                                       \
+    .xfer =                                               \
+    {                                                     \
+      .size    = ldmaCtrlSizeByte,                        \
+      .xferCnt = (count) - 1,                             \
+      .srcAddr = (uintptr_t)(src),                        \
+      .dstAddr = (uintptr_t)(dest)                        \
+    }                                                     \
+  }
+
+#define LDMA_TRANSFER_CFG_PERIPHERAL(signal) \
+  {                                          \
+    .ldmaReqSel = (signal)                   \
+  }
+
+__STATIC_INLINE void LDMA_StartTransfer(int channel,
+                                        const LDMA_TransferCfg_t *transfer,
+                                        const LDMA_Descriptor_t *descriptor)
+{
+  (void)channel;
+  (void)transfer;
+  (void)descriptor;
+}
+
+__STATIC_INLINE uint32_t LDMA_IntGet(void)
+{
+  return 0;
+}
+
+__STATIC_INLINE void LDMA_IntClear(uint32_t flags)
+{
+  (void)flags;
+}
+
+#endif // EM_LDMA_H
@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ * @file em_timer.h
+ * @brief Host build replacement for the emlib TIMER API. Only the
+ * types and calls of autobaud.c are declared, the timer is not modelled.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EM_TIMER_H
+#define EM_TIMER_H
+
+#include "em_device.h"
+
+typedef enum
+{
+  timerPrescale1 = 0
+} TIMER_Prescale_TypeDef;
+
+typedef enum
+{
+  timerEventEveryEdge = 0
+} TIMER_Event_TypeDef;
+
+typedef enum
+{
+  timerEdgeBoth = 2
+} TIMER_Edge_TypeDef;
+
+typedef enum
+{
+  timerCCModeOff     = 0,
+  timerCCModeCapture = 1
+} TIMER_CCMode_TypeDef;
+
+typedef struct
+{
+  bool                   enable;
+  TIMER_Prescale_TypeDef prescale;
+} TIMER_Init_TypeDef;
+
+typedef struct
+{
+  TIMER_Event_TypeDef  eventCtrl;
+  TIMER_Edge_TypeDef   edge;
+  TIMER_CCMode_TypeDef mode;
+} TIMER_InitCC_TypeDef;
+
+#define TIMER_INIT_DEFAULT   { true, timerPrescale1 }
+#define TIMER_INITCC_DEFAULT { timerEventEveryEdge, timerEdgeBoth, timerCCModeOff }
+
+__STATIC_INLINE void TIMER_Init(TIMER_TypeDef *timer,
+                                const TIMER_Init_TypeDef *init)
+{
+  (void)timer;
+  (void)init;
+}
+
+__STATIC_INLINE void TIMER_InitCC(TIMER_TypeDef *timer, unsigned int ch,
+                                  const TIMER_InitCC_TypeDef *init)
+{
+  (void)timer;
+  (void)ch;
+  (void)init;
+}
+
+__STATIC_INLINE void TIMER_Enable(TIMER_TypeDef *timer, bool enable)
+{
+  (void)timer;
+  (void)enable;
+}
+
+#endif // EM_TIMER_H
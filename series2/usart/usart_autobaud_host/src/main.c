@@ -0,0 +1,225 @@
+/***************************************************************************//**
+ * @file main.c
+ * @brief Host model of the edges captured by the autobaud detection of
+ * usart_async_interrupt. Checks autobaudEstimate() against sync characters
+ * sent at every standard rate with host clock error, idle gaps and counter
+ * wrap.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "autobaud.h"
+
+// TIMER clock of usart_async_interrupt
+#define TIMER_FREQ        19000000
+
+// Characters sent in each trial, enough for AUTOBAUD_EDGES edges
+#define TRIAL_CHARS       8
+
+// Trials for each character, rate and clock error
+#define TRIALS            500
+
+// Largest error of an estimate, in parts per million of the rate sent
+#define MAX_ERROR_PPM     7000
+
+// Sync characters, each with a low level of one bit
+static const uint8_t syncChars[] = { 'U', '\r', 0x7F, 0xAA };
+
+// Rates of autobaudStandardRate()
+static const uint32_t rates[] = {
+  1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 76800,
+  115200, 230400, 460800, 921600
+};
+
+// Host clock error, in 1/1000
+static const int32_t clockErrors[] = { -10, -5, 0, 5, 10 };
+
+static uint32_t rngState = 0x2545F491;
+
+static uint32_t rng(void)
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+// Random fraction in [0, 1)
+static double rngUnit(void)
+{
+  return (double)rng() / 4294967296.0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Idle time before a character, in bits. Most characters follow each
+ *    other without a gap, as from a FIFO, others after a fraction of a bit
+ *    to a few bits, or a long pause as between keystrokes.
+ ******************************************************************************/
+static double idleBits(void)
+{
+  switch (rng() % 4) {
+    case 0:
+    case 1:
+      return 0.0;
+    case 2:
+      return rngUnit() * 4.0;
+    default:
+      return 10.0 + rngUnit() * 1000.0;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Send TRIAL_CHARS characters at bitTime and capture the edges as the
+ *    TIMER would. Capture starts at a random time while the line is idle
+ *    before the first character, as in detectBaudrate(), so the first edge
+ *    is a falling one.
+ *
+ * @return
+ *    Number of edges captured, at most AUTOBAUD_EDGES
+ ******************************************************************************/
+static uint32_t captureEdges(uint8_t character, double bitTime,
+                             uint32_t *edges)
+{
+  double time = idleBits() * bitTime;
+  double start = rngUnit() * time;
+  double phase = rngUnit();
+  uint32_t base;
+  uint32_t count = 0;
+  uint32_t level = 1;
+  uint32_t bit;
+  uint32_t frame;
+  uint32_t i;
+  uint32_t n;
+
+  // The counter wraps during the capture in half of the trials
+  if (rng() % 2) {
+    base = (uint32_t)0 - (uint32_t)(rngUnit() * 20.0 * bitTime) - 1;
+  } else {
+    base = rng();
+  }
+
+  for (n = 0; n < TRIAL_CHARS; n++) {
+    if (n > 0) {
+      time += idleBits() * bitTime;
+    }
+
+    // Start bit, 8 data bits LSB first and the stop bit
+    frame = ((uint32_t)character << 1) | (1UL << 9);
+    for (i = 0; i < 10; i++) {
+      bit = (frame >> i) & 1;
+      if (bit != level) {
+        level = bit;
+        if (count < AUTOBAUD_EDGES) {
+          edges[count++] = base + (uint32_t)(time - start + phase);
+        }
+      }
+      time += bitTime;
+    }
+  }
+  return count;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Estimate the rate of every sync character sent at baudrate with each
+ *    clock error and check it
+ *
+ * @return
+ *    true if every estimate was within MAX_ERROR_PPM and rounds to baudrate
+ ******************************************************************************/
+static bool runRate(uint32_t baudrate)
+{
+  uint32_t edges[AUTOBAUD_EDGES];
+  double sent;
+  double error;
+  double worst = 0.0;
+  double sum = 0.0;
+  uint32_t estimates = 0;
+  uint32_t failures = 0;
+  uint32_t estimate;
+  uint32_t c;
+  uint32_t e;
+  uint32_t t;
+
+  for (c = 0; c < sizeof(syncChars); c++) {
+    for (e = 0; e < sizeof(clockErrors) / sizeof(clockErrors[0]); e++) {
+      sent = baudrate * (1.0 + clockErrors[e] / 1000.0);
+      for (t = 0; t < TRIALS; t++) {
+        if (captureEdges(syncChars[c], TIMER_FREQ / sent, edges)
+            != AUTOBAUD_EDGES) {
+          printf("Too few edges for 0x%02X\n", syncChars[c]);
+          return false;
+        }
+        estimate = autobaudEstimate(edges, AUTOBAUD_EDGES, true, TIMER_FREQ);
+        error = (estimate - sent) / sent;
+        if (error < 0) {
+          error = -error;
+        }
+        if ((estimate == 0) || (error * 1e6 > MAX_ERROR_PPM)
+            || (autobaudStandardRate(estimate) != baudrate)) {
+          if (failures++ < 5) {
+            printf("%u baud, 0x%02X, clock %+d/1000: estimate %u\n",
+                   (unsigned)baudrate, syncChars[c], (int)clockErrors[e],
+                   (unsigned)estimate);
+          }
+          continue;
+        }
+        if (error > worst) {
+          worst = error;
+        }
+        sum += error;
+        estimates++;
+      }
+    }
+  }
+
+  printf("%7u baud: mean error %.3f%%, worst %.3f%%, %u failed\n",
+         (unsigned)baudrate, estimates ? 100.0 * sum / estimates : 0.0,
+         100.0 * worst, (unsigned)failures);
+  return failures == 0;
+}
+
+int main(void)
+{
+  bool passed = true;
+  uint32_t i;
+
+  for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+    passed = runRate(rates[i]) && passed;
+  }
+
+  printf(passed ? "PASSED\n" : "FAILED\n");
+  return passed ? 0 : 1;
+}
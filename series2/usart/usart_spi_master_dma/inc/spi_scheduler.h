@@ -0,0 +1,128 @@
+/***************************************************************************//**
+ * @file spi_scheduler.h
+ * @brief Batches of SPI master transactions run by LDMA descriptor chains
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef SPI_SCHEDULER_H
+#define SPI_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+#include "em_gpio.h"
+#include "em_ldma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest number of transactions in one batch
+#if !defined(SPI_SCHEDULER_TRANSACTIONS)
+#define SPI_SCHEDULER_TRANSACTIONS  4
+#endif
+
+// Number of batches that can be queued, including the one running
+#if !defined(SPI_SCHEDULER_BATCHES)
+#define SPI_SCHEDULER_BATCHES       2
+#endif
+
+// LDMA descriptors of one batch on each of the transmit and receive channels
+#define SPI_SCHEDULER_DESCRIPTORS   (3 * SPI_SCHEDULER_TRANSACTIONS)
+
+// Slave device, selected by driving its chip select pin low
+typedef struct {
+  GPIO_Port_TypeDef csPort;
+  unsigned int csPin;
+} SpiDevice_t;
+
+typedef struct SpiTransaction SpiTransaction_t;
+
+// Called from the LDMA interrupt once the whole batch of the transaction
+// has been received
+typedef void (*SpiTransactionDone_t)(SpiTransaction_t *transaction);
+
+// One full-duplex transfer of length bytes (1 to 2048) with a device.
+// tx may be NULL to send zeros, rx may be NULL to discard the received
+// bytes.
+struct SpiTransaction {
+  const SpiDevice_t *device;
+  const uint8_t *tx;
+  uint8_t *rx;
+  uint32_t length;
+  SpiTransactionDone_t done;
+  void *user;
+};
+
+typedef struct {
+  SpiTransaction_t *transactions;
+  uint32_t count;
+  LDMA_Descriptor_t txDescriptor[SPI_SCHEDULER_DESCRIPTORS];
+  LDMA_Descriptor_t rxDescriptor[SPI_SCHEDULER_DESCRIPTORS];
+} SpiBatch_t;
+
+/*
+ * Each batch of transactions is one descriptor chain on the transmit
+ * channel and one on the receive channel. The transmit channel asserts the
+ * chip select of a transaction with a WRI structure and sends its bytes.
+ * The receive channel stores the received bytes, deasserts chip select and
+ * sets a SYNC bit, which the transmit channel waits for before it selects
+ * the next device. Only the end of the batch raises an interrupt, which
+ * starts the next batch and calls the callbacks of all its transactions.
+ */
+typedef struct {
+  USART_TypeDef *usart;
+  uint32_t rxChannel;
+  uint32_t txChannel;
+  uint32_t syncBit;
+  LDMA_TransferCfg_t rxConfig;
+  LDMA_TransferCfg_t txConfig;
+  SpiBatch_t batch[SPI_SCHEDULER_BATCHES];
+  uint32_t batchHead;         // Next free batch
+  uint32_t batchTail;         // Batch running
+  volatile uint32_t batchCount;
+} SpiScheduler_t;
+
+void spiSchedulerInit(SpiScheduler_t *scheduler, USART_TypeDef *usart,
+                      uint32_t rxChannel, uint32_t rxReqSel,
+                      uint32_t txChannel, uint32_t txReqSel,
+                      uint32_t syncBit);
+bool spiSchedulerSubmit(SpiScheduler_t *scheduler,
+                        SpiTransaction_t *transactions, uint32_t count);
+void spiSchedulerIrq(SpiScheduler_t *scheduler);
+bool spiSchedulerIdle(SpiScheduler_t *scheduler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPI_SCHEDULER_H
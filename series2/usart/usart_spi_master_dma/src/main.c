@@ -1,9 +1,9 @@
 /***************************************************************************//**
  * @file main.c
  * @brief This project demonstrates DMA-driven use of the USART in synchronous
- * (SPI) master mode. The main loop starts the LDMA channels, which transmit the
- * specified number of bytes and receive the byte that is shifted in with each
- * outgoing one.
+ * (SPI) master mode. Every millisecond, a batch of transactions with three
+ * slave devices is queued and run by the LDMA, which also drives the chip
+ * select of each device.
  *
  * The pins used in this example are defined below and are described in the
  * accompanying readme.txt file.
@@ -46,6 +46,7 @@
 #include "em_gpio.h"
 #include "em_ldma.h"
 #include "em_usart.h"
+#include "spi_scheduler.h"
 
 // Ports and pins for SPI interface
 #define US0MISO_PORT  gpioPortA
@@ -54,32 +55,44 @@
 #define US0MOSI_PIN   6
 #define US0CLK_PORT   gpioPortC
 #define US0CLK_PIN    3
-#define US0CS_PORT    gpioPortC
-#define US0CS_PIN     1
 
-// LDMA channel for receive and transmit servicing
+// Chip select pins of the slave devices
+#define DEVICES       3
+
+static const SpiDevice_t devices[DEVICES] =
+{
+  { gpioPortC, 1 },
+  { gpioPortC, 0 },
+  { gpioPortC, 2 }
+};
+
+// LDMA channels for receive and transmit servicing, and the SYNC bit the
+// receive channel hands each transaction over to the transmit channel with
 #define RX_LDMA_CHANNEL 0
 #define TX_LDMA_CHANNEL 1
+#define LDMA_SYNC_BIT   0
 
-// LDMA descriptor and transfer configuration structures for USART TX channel
-LDMA_Descriptor_t ldmaTXDescriptor;
-LDMA_TransferCfg_t ldmaTXConfig;
-
-// LDMA descriptor and transfer configuration structures for USART RX channel
-LDMA_Descriptor_t ldmaRXDescriptor;
-LDMA_TransferCfg_t ldmaRXConfig;
+// Devices are polled at this rate
+#define POLL_RATE_HZ    1000
 
 // Size of the data buffers
 #define BUFLEN  10
 
 // Outgoing data
-uint8_t outbuf[BUFLEN];
+uint8_t outbuf[DEVICES][BUFLEN];
 
 // Incoming data
-uint8_t inbuf[BUFLEN];
+uint8_t inbuf[DEVICES][BUFLEN];
+
+// Completed transactions of each device
+volatile uint32_t readings[DEVICES];
 
-// Data reception complete
-bool rx_done;
+// Polls skipped because the previous batch was still running
+volatile uint32_t overruns;
+
+// One batch reads all devices
+static SpiTransaction_t transactions[DEVICES];
+static SpiScheduler_t scheduler;
 
 /**************************************************************************//**
  * @brief
@@ -87,6 +100,8 @@ bool rx_done;
  *****************************************************************************/
 void initGpio(void)
 {
+  uint32_t i;
+
   // Enable clock (not needed on xG21)
   CMU_ClockEnable(cmuClock_GPIO, true);
 
@@ -99,8 +114,11 @@ void initGpio(void)
   // Configure CLK pin as an output low (CPOL = 0)
   GPIO_PinModeSet(US0CLK_PORT, US0CLK_PIN, gpioModePushPull, 0);
 
-  // Configure CS pin as an output and drive inactive high
-  GPIO_PinModeSet(US0CS_PORT, US0CS_PIN, gpioModePushPull, 1);
+  // Configure CS pins as outputs and drive inactive high
+  for (i = 0; i < DEVICES; i++)
+  {
+    GPIO_PinModeSet(devices[i].csPort, devices[i].csPin, gpioModePushPull, 1);
+  }
 }
 
 /**************************************************************************//**
@@ -116,14 +134,11 @@ void initUsart0(void)
   USART_InitSync_TypeDef init = USART_INITSYNC_DEFAULT;
 
   init.msbf = true;           // MSB first transmission for SPI compatibility
-  init.autoCsEnable = true;   // Allow the USART to assert CS
-  init.autoCsSetup = 4;       // Insert 7 bit times of CS setup delay
-  init.autoCsHold = 4;        // Insert 7 bit times of CS hold delay
 
   /*
-   * Route USART0 RX, TX, and CLK to the specified pins.  Note that CS is
-   * not controlled by USART0 so there is no write to the corresponding
-   * USARTROUTE register to do this.
+   * Route USART0 RX, TX, and CLK to the specified pins.  The USART can only
+   * assert one chip select pin, so CS is not routed and the LDMA drives the
+   * chip select of each device through the GPIO set and clear registers.
    */
   GPIO->USARTROUTE[0].RXROUTE = (US0MISO_PORT << _GPIO_USART_RXROUTE_PORT_SHIFT)
       | (US0MISO_PIN << _GPIO_USART_RXROUTE_PIN_SHIFT);
@@ -131,40 +146,55 @@ void initUsart0(void)
       | (US0MOSI_PIN << _GPIO_USART_TXROUTE_PIN_SHIFT);
   GPIO->USARTROUTE[0].CLKROUTE = (US0CLK_PORT << _GPIO_USART_CLKROUTE_PORT_SHIFT)
       | (US0CLK_PIN << _GPIO_USART_CLKROUTE_PIN_SHIFT);
-  GPIO->USARTROUTE[0].CSROUTE = (US0CS_PORT << _GPIO_USART_CSROUTE_PORT_SHIFT)
-      | (US0CS_PIN << _GPIO_USART_CSROUTE_PIN_SHIFT);
 
   // Enable USART interface pins
   GPIO->USARTROUTE[0].ROUTEEN = GPIO_USART_ROUTEEN_RXPEN |    // MISO
                                 GPIO_USART_ROUTEEN_TXPEN |    // MOSI
-                                GPIO_USART_ROUTEEN_CLKPEN |
-                                GPIO_USART_ROUTEEN_CSPEN;
+                                GPIO_USART_ROUTEEN_CLKPEN;
 
   // Configure and enable USART0
   USART_InitSync(USART0, &init);
 }
 
+/**************************************************************************//**
+ * @brief
+ *    Count the completed transactions of a device
+ *****************************************************************************/
+static void transactionDone(SpiTransaction_t *transaction)
+{
+  readings[(uintptr_t)transaction->user]++;
+}
+
 /**************************************************************************//**
  * @brief
  *    LDMA initialization
  *****************************************************************************/
 void initLdma(void)
 {
+  uint32_t i;
+
   // First, initialize the LDMA unit itself
   LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
   LDMA_Init(&ldmaInit);
 
-  // Source is outbuf, destination is USART0_TXDATA, and length if BUFLEN
-  ldmaTXDescriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(outbuf, &(USART0->TXDATA), BUFLEN);
-
-  // Transfer a byte on free space in the USART buffer
-  ldmaTXConfig = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART0_TXBL);
-
-  // Source is USART0_RXDATA, destination is inbuf, and length if BUFLEN
-  ldmaRXDescriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(&(USART0->RXDATA), inbuf, BUFLEN);
+  // Transfer a byte on receive data valid and on free space in the USART
+  // buffer
+  spiSchedulerInit(&scheduler, USART0,
+                   RX_LDMA_CHANNEL, ldmaPeripheralSignal_USART0_RXDATAV,
+                   TX_LDMA_CHANNEL, ldmaPeripheralSignal_USART0_TXBL,
+                   LDMA_SYNC_BIT);
 
-  // Transfer a byte on receive data valid
-  ldmaRXConfig = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART0_RXDATAV);
+  // Exchange BUFLEN bytes with each device, outbuf[i] to device i and the
+  // bytes received from it to inbuf[i]
+  for (i = 0; i < DEVICES; i++)
+  {
+    transactions[i].device = &devices[i];
+    transactions[i].tx = outbuf[i];
+    transactions[i].rx = inbuf[i];
+    transactions[i].length = BUFLEN;
+    transactions[i].done = transactionDone;
+    transactions[i].user = (void *)(uintptr_t)i;
+  }
 }
 
 /**************************************************************************//**
@@ -172,61 +202,52 @@ void initLdma(void)
  *****************************************************************************/
 void LDMA_IRQHandler()
 {
-  uint32_t flags = LDMA_IntGet();
-
-  // Clear the transmit channel's done flag if set
-  if (flags & (1 << TX_LDMA_CHANNEL))
-    LDMA_IntClear(1 << TX_LDMA_CHANNEL);
-
-  /*
-   * Clear the receive channel's done flag if set and change receive
-   * state to done.
-   */
-  if (flags & (1 << RX_LDMA_CHANNEL))
-  {
-    LDMA_IntClear(1 << RX_LDMA_CHANNEL);
-    rx_done = true;
-  }
+  // Start the next batch and call the callbacks of the completed one
+  spiSchedulerIrq(&scheduler);
 
   // Stop in case there was an error
-  if (flags & LDMA_IF_ERROR)
+  if (LDMA_IntGet() & LDMA_IF_ERROR)
     __BKPT(0);
 }
 
+/**************************************************************************//**
+ * @brief SysTick IRQHandler, polls all devices
+ *****************************************************************************/
+void SysTick_Handler(void)
+{
+  // The transaction buffers are reused, skip the poll if they are busy
+  if (!spiSchedulerIdle(&scheduler)
+      || !spiSchedulerSubmit(&scheduler, transactions, DEVICES))
+    overruns++;
+}
+
 /**************************************************************************//**
  * @brief
  *    Main function
  *****************************************************************************/
 int main(void)
 {
-  uint32_t i;
+  uint32_t i, j;
 
   // Chip errata
   CHIP_Init();
 
-  // Initialize GPIO and USART0
+  // Populate outgoing data arrays, different for each device
+  for (i = 0; i < DEVICES; i++)
+  {
+    for (j = 0; j < BUFLEN; j++)
+      outbuf[i][j] = (uint8_t)((i << 4) | j);
+  }
+
+  // Initialize GPIO, USART0 and the LDMA
   initGpio();
   initUsart0();
   initLdma();
 
+  // Poll the devices at POLL_RATE_HZ
+  SysTick_Config(CMU_ClockFreqGet(cmuClock_SYSCLK) / POLL_RATE_HZ);
+
+  // The LDMA runs each batch, the CPU only wakes up once per batch
   while (1)
-  {
-    // Zero incoming buffer and populate outgoing data array
-    for (i = 0; i < BUFLEN; i++)
-    {
-      inbuf[i] = 0;
-      outbuf[i] = (uint8_t)i;
-    }
-
-    // Set the receive state to not done
-    rx_done = false;
-
-    // Start both channels
-    LDMA_StartTransfer(RX_LDMA_CHANNEL, &ldmaRXConfig, &ldmaRXDescriptor);
-    LDMA_StartTransfer(TX_LDMA_CHANNEL, &ldmaTXConfig, &ldmaTXDescriptor);
-
-    // Wait in EM1 until all data is received
-    while (!rx_done)
-      EMU_EnterEM1();
-  }
+    EMU_EnterEM1();
 }
@@ -0,0 +1,301 @@
+/***************************************************************************//**
+ * @file spi_scheduler.c
+ * @brief Batches of SPI master transactions run by LDMA descriptor chains
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "em_assert.h"
+#include "em_core.h"
+#include "em_ldma.h"
+#include "spi_scheduler.h"
+
+// Largest transfer count of one LDMA descriptor
+#define LDMA_MAX_XFER_COUNT  ((_LDMA_CH_CTRL_XFERCNT_MASK                      \
+                               >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+
+// Sent by transactions without transmit data
+static const uint8_t txFill = 0;
+
+// Received by transactions without a receive buffer
+static uint8_t rxDiscard;
+
+/**************************************************************************//**
+ * @brief
+ *    Build the transmit and receive descriptor chains of a batch
+ *
+ * @details
+ *    For each transaction the transmit chain holds
+ *      WRI  chip select low
+ *      XFER tx to TXDATA
+ *      SYNC clear syncBit and wait until it is set (not after the last)
+ *    and the receive chain holds
+ *      XFER RXDATA to rx
+ *      WRI  chip select high
+ *      SYNC set syncBit (not after the last)
+ *    The transmit channel is done with a transaction as soon as its last
+ *    byte is in the USART, so it always waits before the receive channel
+ *    sets syncBit. Only the last WRI of the receive chain raises DONE.
+ *****************************************************************************/
+static void buildBatch(SpiScheduler_t *scheduler, SpiBatch_t *batch)
+{
+  volatile uint32_t *txData = &scheduler->usart->TXDATA;
+  volatile uint32_t *rxData = &scheduler->usart->RXDATA;
+  uint32_t mask = 1UL << scheduler->syncBit;
+  LDMA_Descriptor_t *tx = batch->txDescriptor;
+  LDMA_Descriptor_t *rx = batch->rxDescriptor;
+  SpiTransaction_t *transaction;
+  volatile uint32_t *csClear;
+  volatile uint32_t *csSet;
+  uint32_t csMask;
+  uint32_t i;
+
+  for (i = 0; i < batch->count; i++) {
+    transaction = &batch->transactions[i];
+    csMask = 1UL << transaction->device->csPin;
+    csClear = &GPIO->P_CLR[transaction->device->csPort].DOUT;
+    csSet = &GPIO->P_SET[transaction->device->csPort].DOUT;
+
+    *tx = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_WRITE(csMask, csClear, 1);
+    tx++;
+    if (transaction->tx != NULL) {
+      *tx = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(transaction->tx, txData,
+                                         transaction->length, 1);
+    } else {
+      *tx = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(&txFill, txData,
+                                         transaction->length, 1);
+      tx->xfer.srcInc = ldmaCtrlSrcIncNone;
+    }
+    tx->xfer.doneIfs = 0;
+    tx++;
+
+    if (transaction->rx != NULL) {
+      *rx = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(rxData, transaction->rx,
+                                         transaction->length, 1);
+    } else {
+      *rx = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(rxData, &rxDiscard,
+                                         transaction->length, 1);
+      rx->xfer.dstInc = ldmaCtrlDstIncNone;
+    }
+    rx->xfer.doneIfs = 0;
+    rx++;
+
+    if (i + 1 < batch->count) {
+      *rx++ = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_WRITE(csMask, csSet, 1);
+      *rx++ = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_SYNC(mask, 0, 0, 0, 1);
+      *tx++ = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_LINKREL_SYNC(0, mask, mask, mask, 1);
+    } else {
+      *rx = (LDMA_Descriptor_t)
+        LDMA_DESCRIPTOR_SINGLE_WRITE(csMask, csSet);
+      // The transmit chain ends with its last transfer
+      tx[-1].xfer.link = 0;
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start the descriptor chains of a batch, receive first
+ *****************************************************************************/
+static void startBatch(SpiScheduler_t *scheduler, SpiBatch_t *batch)
+{
+  LDMA_StartTransfer(scheduler->rxChannel, &scheduler->rxConfig,
+                     batch->rxDescriptor);
+  LDMA_StartTransfer(scheduler->txChannel, &scheduler->txConfig,
+                     batch->txDescriptor);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Initialize a scheduler without queued batches
+ *
+ * @param[in] scheduler
+ *    Scheduler state
+ *
+ * @param[in] usart
+ *    USART in synchronous master mode, with automatic chip select disabled
+ *
+ * @param[in] rxChannel
+ *    LDMA channel moving RXDATA to memory, must not be used by anything else
+ *
+ * @param[in] rxReqSel
+ *    LDMA request signal of the USART RXDATAV request
+ *
+ * @param[in] txChannel
+ *    LDMA channel moving memory to TXDATA, must not be used by anything else
+ *
+ * @param[in] txReqSel
+ *    LDMA request signal of the USART TXBL request
+ *
+ * @param[in] syncBit
+ *    LDMA SYNC bit the channels hand over transactions with, must not be
+ *    used by anything else
+ *
+ * @note
+ *    LDMA_Init() must have been called and the chip select pins of all
+ *    devices must be push-pull outputs driven high.
+ *****************************************************************************/
+void spiSchedulerInit(SpiScheduler_t *scheduler, USART_TypeDef *usart,
+                      uint32_t rxChannel, uint32_t rxReqSel,
+                      uint32_t txChannel, uint32_t txReqSel,
+                      uint32_t syncBit)
+{
+  LDMA_TransferCfg_t rxConfig = LDMA_TRANSFER_CFG_PERIPHERAL(rxReqSel);
+  LDMA_TransferCfg_t txConfig = LDMA_TRANSFER_CFG_PERIPHERAL(txReqSel);
+
+  scheduler->usart = usart;
+  scheduler->rxChannel = rxChannel;
+  scheduler->txChannel = txChannel;
+  scheduler->syncBit = syncBit;
+  scheduler->rxConfig = rxConfig;
+  scheduler->txConfig = txConfig;
+  scheduler->batchHead = 0;
+  scheduler->batchTail = 0;
+  scheduler->batchCount = 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Queue a batch of transactions
+ *
+ * @details
+ *    The transactions run back to back, in order, each one framed by the
+ *    chip select of its device. The batch starts right away if the
+ *    scheduler is idle, otherwise once the batches queued before it are
+ *    done. Can be called from interrupt handlers.
+ *
+ * @param[in] transactions
+ *    Transactions of the batch, must stay valid until their callbacks have
+ *    been called
+ *
+ * @param[in] count
+ *    Number of transactions, 1 to SPI_SCHEDULER_TRANSACTIONS
+ *
+ * @return
+ *    false if SPI_SCHEDULER_BATCHES batches are already queued, the batch is
+ *    not queued. Retry once a queued batch is done.
+ *****************************************************************************/
+bool spiSchedulerSubmit(SpiScheduler_t *scheduler,
+                        SpiTransaction_t *transactions, uint32_t count)
+{
+  SpiBatch_t *batch;
+  uint32_t i;
+  bool start;
+  CORE_DECLARE_IRQ_STATE;
+
+  EFM_ASSERT((count > 0) && (count <= SPI_SCHEDULER_TRANSACTIONS));
+  for (i = 0; i < count; i++) {
+    EFM_ASSERT((transactions[i].length > 0)
+               && (transactions[i].length <= LDMA_MAX_XFER_COUNT));
+  }
+
+  CORE_ENTER_ATOMIC();
+
+  if (scheduler->batchCount == SPI_SCHEDULER_BATCHES) {
+    CORE_EXIT_ATOMIC();
+    return false;
+  }
+
+  batch = &scheduler->batch[scheduler->batchHead];
+  batch->transactions = transactions;
+  batch->count = count;
+  buildBatch(scheduler, batch);
+
+  scheduler->batchHead = (scheduler->batchHead + 1) % SPI_SCHEDULER_BATCHES;
+  start = (scheduler->batchCount == 0);
+  scheduler->batchCount++;
+
+  if (start) {
+    startBatch(scheduler, batch);
+  }
+
+  CORE_EXIT_ATOMIC();
+
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Complete the batch running, call from LDMA_IRQHandler()
+ *
+ * @details
+ *    The next batch is started before the callbacks of the completed one
+ *    are called, in the order of its transactions.
+ *****************************************************************************/
+void spiSchedulerIrq(SpiScheduler_t *scheduler)
+{
+  uint32_t mask = 1UL << scheduler->rxChannel;
+  SpiBatch_t *batch;
+  SpiTransaction_t *transactions;
+  uint32_t count;
+  uint32_t i;
+
+  if (!(LDMA_IntGet() & mask)) {
+    return;
+  }
+  LDMA_IntClear(mask);
+
+  // The slot may be reused by a batch submitted from a callback
+  batch = &scheduler->batch[scheduler->batchTail];
+  transactions = batch->transactions;
+  count = batch->count;
+
+  scheduler->batchTail = (scheduler->batchTail + 1) % SPI_SCHEDULER_BATCHES;
+  scheduler->batchCount--;
+
+  if (scheduler->batchCount) {
+    startBatch(scheduler, &scheduler->batch[scheduler->batchTail]);
+  }
+
+  for (i = 0; i < count; i++) {
+    if (transactions[i].done != NULL) {
+      transactions[i].done(&transactions[i]);
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    true when all queued batches are done
+ *****************************************************************************/
+bool spiSchedulerIdle(SpiScheduler_t *scheduler)
+{
+  return scheduler->batchCount == 0;
+}
@@ -0,0 +1,114 @@
+/***************************************************************************//**
+ * @file spi_slave_ring.h
+ * @brief SPI slave receive ring with chip select framed packets and double
+ * buffered replies
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef SPI_SLAVE_RING_H
+#define SPI_SLAVE_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "em_device.h"
+#include "em_ldma.h"
+#include "ldma_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of packet boundaries that can be queued
+#if !defined(SPI_SLAVE_PACKETS)
+#define SPI_SLAVE_PACKETS     8
+#endif
+
+// Size of each of the two reply buffers
+#if !defined(SPI_SLAVE_REPLY_SIZE)
+#define SPI_SLAVE_REPLY_SIZE  64
+#endif
+
+// Sent once the reply is exhausted, or when no reply has been committed
+#define SPI_SLAVE_FILL        0x00
+
+/*
+ * Every byte received from the master is written into rx, a two segment
+ * LDMA ring (ldma_ring.c) that never stops. The chip
+ * select deassert interrupt records the ring position as the end of a
+ * packet, so the application reads whole packets with spiSlaveRingPacket(),
+ * spiSlaveRingSpan() and spiSlaveRingConsume(). Data overwritten before it
+ * was read is counted in rx.dropped.
+ *
+ * The reply to the next packet is written into the back one of two reply
+ * buffers while the front one is sent. At chip select deassert the
+ * transmit channel is restarted on the committed reply, which it preloads
+ * into the USART before the master selects the slave again, followed by
+ * SPI_SLAVE_FILL bytes for as long as the master keeps clocking.
+ *
+ * Chip select must stay deasserted for longer than the interrupt latency,
+ * and the LDMA interrupt must be served before the LDMA has filled another
+ * half of the ring.
+ */
+typedef struct {
+  USART_TypeDef *usart;
+  LdmaRing_t rx;              // Receive ring, two halves
+  uint32_t txChannel;         // LDMA channel sending the replies
+  // Ring position at the end of each packet not read yet
+  uint32_t boundary[SPI_SLAVE_PACKETS];
+  volatile uint32_t boundaryHead;
+  uint32_t boundaryTail;
+  uint32_t boundaryOverruns;  // Packets merged with the next one
+  uint8_t reply[2][SPI_SLAVE_REPLY_SIZE];
+  uint32_t replyLength[2];
+  uint32_t replyFront;        // Reply being sent
+  volatile bool replyCommitted;
+  LDMA_TransferCfg_t txConfig;
+  LDMA_Descriptor_t rxDescriptor[2];
+  LDMA_Descriptor_t txDescriptor[2];
+} SpiSlaveRing_t;
+
+void spiSlaveRingInit(SpiSlaveRing_t *ring, USART_TypeDef *usart,
+                      uint8_t *buffer, uint32_t size,
+                      uint32_t rxChannel, uint32_t rxReqSel,
+                      uint32_t txChannel, uint32_t txReqSel);
+void spiSlaveRingCsIrq(SpiSlaveRing_t *ring);
+bool spiSlaveRingPacket(SpiSlaveRing_t *ring, uint32_t *length);
+uint32_t spiSlaveRingSpan(SpiSlaveRing_t *ring, const uint8_t **data);
+void spiSlaveRingConsume(SpiSlaveRing_t *ring, uint32_t count);
+uint8_t *spiSlaveReplyBuffer(SpiSlaveRing_t *ring);
+void spiSlaveReplyCommit(SpiSlaveRing_t *ring, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPI_SLAVE_RING_H
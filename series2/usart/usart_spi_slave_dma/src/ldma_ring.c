@@ -0,0 +1,317 @@
+/***************************************************************************//**
+ * @file ldma_ring.c
+ * @brief Zero-copy LDMA ring buffer for continuous peripheral receive. See
+ * ldma_ring.h for the producer/consumer model.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "em_device.h"
+#include "em_assert.h"
+#include "ldma_ring.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Build the looping descriptor list for a ring.
+ *
+ * @param[in] ring
+ *   Ring context.
+ *
+ * @param[in] channel
+ *   LDMA channel the ring runs on.
+ *
+ * @param[in] desc
+ *   Storage for numSegments descriptors. Must stay valid while the ring
+ *   runs.
+ *
+ * @param[in] buffer
+ *   Segment storage, numSegments * unitsPerSegment units.
+ *
+ * @param[in] numSegments
+ *   Number of segments, a power of two from 2 upwards.
+ *
+ * @param[in] unitsPerSegment
+ *   LDMA units per segment, 1 to 2048.
+ *
+ * @param[in] unitSize
+ *   Size of each unit read from srcAddr.
+ *
+ * @param[in] srcAddr
+ *   Peripheral data register the ring reads from.
+ ******************************************************************************/
+void ldmaRingInit(LdmaRing_t *ring,
+                  int channel,
+                  LDMA_Descriptor_t *desc,
+                  void *buffer,
+                  uint32_t numSegments,
+                  uint32_t unitsPerSegment,
+                  LDMA_CtrlSize_t unitSize,
+                  volatile const void *srcAddr)
+{
+  uint32_t i;
+
+  EFM_ASSERT((numSegments >= 2) && ((numSegments & (numSegments - 1)) == 0));
+  EFM_ASSERT((unitsPerSegment >= 1) && (unitsPerSegment <= 2048));
+
+  ring->desc = desc;
+  ring->buffer = (uint8_t *)buffer;
+  ring->segmentBytes = unitsPerSegment << unitSize;
+  ring->unitSize = unitSize;
+  ring->numSegments = numSegments;
+  ring->channel = channel;
+  ring->head = 0;
+  ring->tail = 0;
+  ring->overruns = 0;
+  ring->readTotal = 0;
+  ring->dropped = 0;
+
+  // Each descriptor fills one segment, raises DONE and links to the next
+  for (i = 0; i < numSegments; i++)
+  {
+    desc[i] = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(srcAddr,
+                                       ring->buffer + i * ring->segmentBytes,
+                                       unitsPerSegment, 1);
+    desc[i].xfer.size = unitSize;
+    desc[i].xfer.doneIfs = 1;
+  }
+
+  // The last descriptor links back to the first
+  desc[numSegments - 1].xfer.linkAddr =
+    -(int32_t)(numSegments - 1) * LDMA_DESCRIPTOR_NDWORDS;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start receiving into the ring.
+ ******************************************************************************/
+void ldmaRingStart(LdmaRing_t *ring, const LDMA_TransferCfg_t *transfer)
+{
+  ring->head = 0;
+  ring->tail = 0;
+  ring->readTotal = 0;
+  LDMA_StartTransfer(ring->channel, (void*)transfer, (void*)ring->desc);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Stop receiving. Completed segments can still be consumed.
+ ******************************************************************************/
+void ldmaRingStop(LdmaRing_t *ring)
+{
+  LDMA_StopTransfer(ring->channel);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Advance the producer index. Call from LDMA_IRQHandler() with the
+ *   pending interrupt flags.
+ *
+ * @details
+ *   The producer index is derived from the channel's DST register rather
+ *   than by counting interrupts, so segments completed while the interrupt
+ *   was held off are not lost.
+ *
+ * @return
+ *   True if the ring's channel had completed a segment.
+ ******************************************************************************/
+bool ldmaRingIrqHandler(LdmaRing_t *ring, uint32_t pending)
+{
+  uint32_t mask = ring->numSegments - 1;
+  uint32_t writing;
+
+  if (!(pending & (1UL << ring->channel)))
+  {
+    return false;
+  }
+
+  // The segment being written is the one after the last completed one
+  writing = (LDMA->CH[ring->channel].DST - (uint32_t)(uintptr_t)ring->buffer)
+            / ring->segmentBytes;
+  ring->head += (writing - ring->head) & mask;
+
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Number of completed segments waiting to be consumed.
+ ******************************************************************************/
+uint32_t ldmaRingCount(LdmaRing_t *ring)
+{
+  uint32_t count = ring->head - ring->tail;
+
+  if (count >= ring->numSegments)
+  {
+    count = ring->numSegments - 1;
+  }
+  return count;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get the oldest completed segment without copying it.
+ *
+ * @details
+ *   If the LDMA has lapped the consumer, the overwritten segments are
+ *   counted in ring->overruns and skipped.
+ *
+ * @return
+ *   Pointer to the segment, or NULL if none is complete. The segment stays
+ *   owned by the application until ldmaRingRelease().
+ ******************************************************************************/
+void *ldmaRingPeek(LdmaRing_t *ring)
+{
+  uint32_t head = ring->head;
+
+  if (head - ring->tail >= ring->numSegments)
+  {
+    ring->overruns += head - ring->tail - (ring->numSegments - 1);
+    ring->tail = head - (ring->numSegments - 1);
+  }
+
+  if (head == ring->tail)
+  {
+    return NULL;
+  }
+
+  return ring->buffer
+         + (ring->tail & (ring->numSegments - 1)) * ring->segmentBytes;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Hand the segment returned by ldmaRingPeek() back to the LDMA.
+ *
+ * @return
+ *   False if the LDMA overwrote the segment while it was being consumed.
+ ******************************************************************************/
+bool ldmaRingRelease(LdmaRing_t *ring)
+{
+  bool intact = (ring->head - ring->tail) < ring->numSegments;
+
+  ring->tail++;
+  return intact;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Units written into the ring by the LDMA since ldmaRingStart().
+ *
+ * @details
+ *   head counts the completed segments and DST gives the position in the
+ *   segment being written. If DST is past a segment whose interrupt is
+ *   still pending, that segment is counted here as well. head is read
+ *   again to make sure the LDMA IRQ handler did not run in between, so
+ *   this can also be called from other interrupt handlers, e.g. to mark
+ *   the end of a packet.
+ ******************************************************************************/
+uint32_t ldmaRingWritten(LdmaRing_t *ring)
+{
+  uint32_t mask = ring->numSegments - 1;
+  uint32_t head;
+  uint32_t offset;
+  uint32_t writing;
+
+  do
+  {
+    head = ring->head;
+    offset = LDMA->CH[ring->channel].DST - (uint32_t)(uintptr_t)ring->buffer;
+  } while (head != ring->head);
+
+  // DST is at the end of the buffer until the first descriptor is reloaded
+  writing = offset / ring->segmentBytes;
+  head += (writing - head) & mask;
+
+  return head * (ring->segmentBytes >> ring->unitSize)
+         + ((offset - writing * ring->segmentBytes) >> ring->unitSize);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Number of units received and not consumed yet.
+ *
+ * @details
+ *   If the LDMA has overwritten data that was not consumed, all data in the
+ *   ring is dropped, as it is a mix of old and new units.
+ ******************************************************************************/
+uint32_t ldmaRingAvailable(LdmaRing_t *ring)
+{
+  uint32_t size = ring->numSegments * (ring->segmentBytes >> ring->unitSize);
+  uint32_t available = ldmaRingWritten(ring) - ring->readTotal;
+
+  if (available > size)
+  {
+    ring->readTotal += available;
+    ring->dropped += available;
+    available = 0;
+  }
+  return available;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get the oldest units received without copying them.
+ *
+ * @param[out] data
+ *   Set to the first unit not consumed yet.
+ *
+ * @return
+ *   Number of units that can be read from data. This is less than
+ *   ldmaRingAvailable() when the data wraps around the end of the ring; the
+ *   rest follows from the start of the ring after ldmaRingConsume().
+ *
+ * @note
+ *   The ring size in units must be a power of two for the position to
+ *   follow readTotal when it wraps.
+ ******************************************************************************/
+uint32_t ldmaRingSpan(LdmaRing_t *ring, const void **data)
+{
+  uint32_t size = ring->numSegments * (ring->segmentBytes >> ring->unitSize);
+  uint32_t available = ldmaRingAvailable(ring);
+  uint32_t start;
+
+  EFM_ASSERT((size & (size - 1)) == 0);
+
+  start = ring->readTotal & (size - 1);
+  *data = ring->buffer + (start << ring->unitSize);
+  return (available < size - start) ? available : size - start;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Release units returned by ldmaRingSpan().
+ ******************************************************************************/
+void ldmaRingConsume(LdmaRing_t *ring, uint32_t count)
+{
+  ring->readTotal += count;
+}
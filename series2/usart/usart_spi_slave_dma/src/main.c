@@ -1,9 +1,9 @@
 /***************************************************************************//**
  * @file main.c
  * @brief This project demonstrates DMA-driven use of the USART in synchronous
- * (SPI) The main loop starts the LDMA channels, which transmit the specified
- * number of bytes and receive the byte that is shifted in with each outgoing
- * one.
+ * (SPI) slave mode. The LDMA receives continuously into a ring buffer, the end
+ * of each packet is recorded when chip select is deasserted, and the reply to
+ * the next packet is preloaded from a double buffer.
  *
  * The pins used in this example are defined below and are described in the
  * accompanying readme.txt file.
@@ -39,13 +39,16 @@
  * at the sole discretion of Silicon Labs.
  ******************************************************************************/
 
+#include <string.h>
 #include "em_device.h"
+#include "em_common.h"
 #include "em_chip.h"
 #include "em_emu.h"
 #include "em_gpio.h"
 #include "em_ldma.h"
 #include "em_usart.h"
 #include "em_cmu.h"
+#include "spi_slave_ring.h"
 
 // Ports and pins for SPI interface
 #define US0MISO_PORT  gpioPortA
@@ -61,25 +64,22 @@
 #define RX_LDMA_CHANNEL 0
 #define TX_LDMA_CHANNEL 1
 
-// LDMA descriptor and transfer configuration structures for USART TX channel
-LDMA_Descriptor_t ldmaTXDescriptor;
-LDMA_TransferCfg_t ldmaTXConfig;
+// Size of the receive ring, a power of two
+#define RING_SIZE  256
 
-// LDMA descriptor and transfer configuration structures for USART RX channel
-LDMA_Descriptor_t ldmaRXDescriptor;
-LDMA_TransferCfg_t ldmaRXConfig;
+// Largest packet kept in packet[]
+#define BUFLEN  64
 
-// Size of the data buffers
-#define BUFLEN  10
+// Receive ring and its state
+static uint8_t ringBuffer[RING_SIZE];
+static SpiSlaveRing_t ring;
 
-// Outgoing data
-uint8_t outbuf[BUFLEN];
+// Last packet received and its length
+uint8_t packet[BUFLEN];
+uint32_t packetLength;
 
-// Incoming data
-uint8_t inbuf[BUFLEN];
-
-// Data reception complete
-bool rx_done;
+// Number of packets received
+uint32_t packets;
 
 /**************************************************************************//**
  * @brief
@@ -102,8 +102,9 @@ void initGpio(void)
   // Configure CS pin as an input pulled high
   GPIO_PinModeSet(US0CS_PORT, US0CS_PIN, gpioModeInputPull, 1);
 
-  // Generate an interrupt on a CS pin high-to-low transition.
-  GPIO_ExtIntConfig(US0CS_PORT, US0CS_PIN, US0CS_PIN, false, true, false);
+  // Generate an interrupt on a CS pin low-to-high transition, which ends a
+  // packet
+  GPIO_ExtIntConfig(US0CS_PORT, US0CS_PIN, US0CS_PIN, true, false, false);
 
   // Enable NVIC GPIO interrupt
 #if (US0CS_PIN & 1)
@@ -163,17 +164,14 @@ void initLdma(void)
   LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
   LDMA_Init(&ldmaInit);
 
-  // Source is outbuf, destination is USART0_TXDATA, and length if BUFLEN
-  ldmaTXDescriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(outbuf, &(USART0->TXDATA), BUFLEN);
-
-  // Transfer a byte on free space in the USART buffer
-  ldmaTXConfig = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART0_TXBL);
-
-  // Source is USART0_RXDATA, destination is inbuf, and length if BUFLEN
-  ldmaRXDescriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(&(USART0->RXDATA), inbuf, BUFLEN);
-
-  // Transfer a byte on receive data valid
-  ldmaRXConfig = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART0_RXDATAV);
+  /*
+   * Move each byte from USART0_RXDATA into the ring on receive data valid,
+   * and the reply to USART0_TXDATA on free space in the USART buffer.  Both
+   * channels run from here on.
+   */
+  spiSlaveRingInit(&ring, USART0, ringBuffer, RING_SIZE,
+                   RX_LDMA_CHANNEL, ldmaPeripheralSignal_USART0_RXDATAV,
+                   TX_LDMA_CHANNEL, ldmaPeripheralSignal_USART0_TXBL);
 }
 
 /**************************************************************************//**
@@ -181,25 +179,16 @@ void initLdma(void)
  *****************************************************************************/
 void LDMA_IRQHandler()
 {
-  uint32_t flags = LDMA_IntGet();
-
-  // Clear the transmit channel's done flag if set
-  if (flags & (1 << TX_LDMA_CHANNEL))
-    LDMA_IntClear(1 << TX_LDMA_CHANNEL);
+  uint32_t pending = LDMA_IntGet();
 
-  /*
-   * Clear the receive channel's done flag if set and change receive
-   * state to done.
-   */
-  if (flags & (1 << RX_LDMA_CHANNEL))
-  {
-    LDMA_IntClear(1 << RX_LDMA_CHANNEL);
-    rx_done = true;
-  }
+  LDMA_IntClear(pending);
 
   // Stop in case there was an error
-  if (flags & LDMA_IF_ERROR)
+  if (pending & LDMA_IF_ERROR)
     __BKPT(0);
+
+  // Advance the ring past the halves filled by the receive channel
+  ldmaRingIrqHandler(&ring.rx, pending);
 }
 
 /**************************************************************************//**
@@ -211,8 +200,48 @@ void GPIO_ODD_IRQHandler(void)
 void GPIO_EVEN_IRQHandler(void)
 #endif
 {
-  // Clear the falling edge interrupt flag
+  // Clear the rising edge interrupt flag
   GPIO_IntClear(1 << US0CS_PIN);
+
+  // End the packet and preload the reply to the next one
+  spiSlaveRingCsIrq(&ring);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Copy the next complete packet to packet[]
+ *
+ * @return
+ *    false if chip select has not been deasserted after any new data
+ *****************************************************************************/
+static bool readPacket(void)
+{
+  const uint8_t *data;
+  uint32_t length;
+  uint32_t span;
+
+  if (!spiSlaveRingPacket(&ring, &length))
+    return false;
+
+  // The packet may wrap around the end of the ring, bytes beyond BUFLEN
+  // are dropped
+  packetLength = 0;
+  while (length > 0)
+  {
+    span = spiSlaveRingSpan(&ring, &data);
+
+    // The rest of the packet has been overwritten by an overrun
+    if (span == 0)
+      break;
+    if (packetLength < BUFLEN)
+      memcpy(&packet[packetLength], data, SL_MIN(span, BUFLEN - packetLength));
+    packetLength += span;
+    spiSlaveRingConsume(&ring, span);
+    length -= span;
+  }
+  packetLength = SL_MIN(packetLength, BUFLEN);
+
+  return true;
 }
 
 /**************************************************************************//**
@@ -221,43 +250,39 @@ void GPIO_EVEN_IRQHandler(void)
  *****************************************************************************/
 int main(void)
 {
-  uint32_t i;
+  uint8_t *reply;
 
   // Chip errata
   CHIP_Init();
 
-  // Initialize GPIO and USART0
+  // Initialize GPIO, USART0 and the LDMA
   initGpio();
   initUsart0();
   initLdma();
 
+  // The ring is running, enable the rising edge interrupt on US0CS_PIN
+  GPIO_IntClear(1 << US0CS_PIN);
+  GPIO_IntEnable(1 << US0CS_PIN);
+
   while (1)
   {
-    // Zero incoming buffer and populate outgoing data array
-    for (i = 0; i < BUFLEN; i++)
-    {
-      inbuf[i] = 0;
-      outbuf[i] = (uint8_t)i;
-    }
-
-    // Set the receive state to not done
-    rx_done = false;
-
-    // Now enable the falling edge interrupt on the US0CS_PIN
-    GPIO_IntEnable(1 << US0CS_PIN);
-
-    // Wait for falling edge on US0CS_PIN
+    // Wait in EM1 for the end of a packet
     EMU_EnterEM1();
 
-    // Clear any garbage in the receive FIFO
-    USART0->CMD = USART_CMD_CLEARRX;
-
-    // Start both channels
-    LDMA_StartTransfer(RX_LDMA_CHANNEL, &ldmaRXConfig, &ldmaRXDescriptor);
-    LDMA_StartTransfer(TX_LDMA_CHANNEL, &ldmaTXConfig, &ldmaTXDescriptor);
-
-    // Wait in EM1 until all data is received
-    while (!rx_done)
-      EMU_EnterEM1();
+    /*
+     * Echo each packet in the next one.  The reply is sent in the packet
+     * after the next chip select deassertion, so if it is not written
+     * before then, it is sent one packet later.
+     */
+    while (readPacket())
+    {
+      packets++;
+      reply = spiSlaveReplyBuffer(&ring);
+      if (reply != NULL)
+      {
+        memcpy(reply, packet, SL_MIN(packetLength, SPI_SLAVE_REPLY_SIZE));
+        spiSlaveReplyCommit(&ring, SL_MIN(packetLength, SPI_SLAVE_REPLY_SIZE));
+      }
+    }
   }
 }
@@ -0,0 +1,293 @@
+/***************************************************************************//**
+ * @file spi_slave_ring.c
+ * @brief SPI slave receive ring with chip select framed packets and double
+ * buffered replies
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "em_assert.h"
+#include "em_common.h"
+#include "em_ldma.h"
+#include "spi_slave_ring.h"
+
+// Largest transfer count of one LDMA descriptor
+#define LDMA_MAX_XFER_COUNT  ((_LDMA_CH_CTRL_XFERCNT_MASK                      \
+                               >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+
+// Status polls for the last byte of a packet to leave the receive buffer
+#define RX_DRAIN_POLLS  32
+
+// Sent after the reply
+static const uint8_t txFill = SPI_SLAVE_FILL;
+
+/**************************************************************************//**
+ * @brief
+ *    Restart the transmit channel on the front reply, or on the fill bytes
+ *    if length is 0
+ *****************************************************************************/
+static void startReply(SpiSlaveRing_t *ring, uint32_t length)
+{
+  LDMA_Descriptor_t *first = &ring->txDescriptor[1];
+
+  // Drop what is left of the previous reply in the USART
+  LDMA_StopTransfer(ring->txChannel);
+  ring->usart->CMD = USART_CMD_CLEARTX;
+
+  if (length > 0) {
+    ring->txDescriptor[0] = (LDMA_Descriptor_t)
+      LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(ring->reply[ring->replyFront],
+                                       &ring->usart->TXDATA, length, 1);
+    ring->txDescriptor[0].xfer.doneIfs = 0;
+    first = &ring->txDescriptor[0];
+  }
+
+  LDMA_StartTransfer(ring->txChannel, &ring->txConfig, first);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Start receiving into the ring and sending fill bytes
+ *
+ * @param[in] ring
+ *    Ring state
+ *
+ * @param[in] usart
+ *    USART in synchronous slave mode with chip select routed
+ *
+ * @param[in] buffer
+ *    Ring storage
+ *
+ * @param[in] size
+ *    Size of the ring in bytes, a power of two
+ *
+ * @param[in] rxChannel
+ *    LDMA channel writing the ring, must not be used by anything else
+ *
+ * @param[in] rxReqSel
+ *    LDMA request signal of the USART RXDATAV request
+ *
+ * @param[in] txChannel
+ *    LDMA channel sending the replies, must not be used by anything else
+ *
+ * @param[in] txReqSel
+ *    LDMA request signal of the USART TXBL request
+ *
+ * @note
+ *    LDMA_Init() must have been called. The ring is never stopped, so the
+ *    LDMA, the USART and the ring state must stay valid from here on.
+ *    LDMA_IRQHandler() must pass the pending flags to
+ *    ldmaRingIrqHandler() with &ring->rx.
+ *****************************************************************************/
+void spiSlaveRingInit(SpiSlaveRing_t *ring, USART_TypeDef *usart,
+                      uint8_t *buffer, uint32_t size,
+                      uint32_t rxChannel, uint32_t rxReqSel,
+                      uint32_t txChannel, uint32_t txReqSel)
+{
+  LDMA_TransferCfg_t rxConfig = LDMA_TRANSFER_CFG_PERIPHERAL(rxReqSel);
+  LDMA_TransferCfg_t txConfig = LDMA_TRANSFER_CFG_PERIPHERAL(txReqSel);
+
+  // Power of two so that the byte counts can wrap
+  EFM_ASSERT((size >= 2) && ((size & (size - 1)) == 0));
+
+  ring->usart = usart;
+  ring->txChannel = txChannel;
+  ring->boundaryHead = 0;
+  ring->boundaryTail = 0;
+  ring->boundaryOverruns = 0;
+  ring->replyLength[0] = 0;
+  ring->replyLength[1] = 0;
+  ring->replyFront = 0;
+  ring->replyCommitted = false;
+  ring->txConfig = txConfig;
+
+  // Two halves of one descriptor each
+  ldmaRingInit(&ring->rx, rxChannel, ring->rxDescriptor, buffer, 2,
+               size / 2, ldmaCtrlSizeByte, &usart->RXDATA);
+
+  // Fill bytes, linked to itself so that the transmit channel never ends
+  LDMA_Descriptor_t fill =
+    LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(&txFill, &usart->TXDATA,
+                                     LDMA_MAX_XFER_COUNT, 0);
+  fill.xfer.srcInc = ldmaCtrlSrcIncNone;
+  fill.xfer.doneIfs = 0;
+  ring->txDescriptor[1] = fill;
+
+  usart->CMD = USART_CMD_CLEARRX;
+  ldmaRingStart(&ring->rx, &rxConfig);
+  startReply(ring, 0);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    End the packet and preload the next reply, call from the GPIO
+ *    interrupt on the rising edge of chip select
+ *
+ * @details
+ *    The last byte of the packet may still be in the receive FIFO, so the
+ *    LDMA is given the few cycles it needs to move it before the position
+ *    is recorded. The wait is bounded: if the receive channel is stalled,
+ *    the byte is counted in the next packet instead of hanging here. The
+ *    committed reply, if any, becomes the front reply and is sent in the
+ *    next packet. Otherwise the next packet only gets fill bytes.
+ *****************************************************************************/
+void spiSlaveRingCsIrq(SpiSlaveRing_t *ring)
+{
+  uint32_t head = ring->boundaryHead;
+  uint32_t next = (head + 1) % SPI_SLAVE_PACKETS;
+  uint32_t length = 0;
+  uint32_t polls = 0;
+
+  while ((ring->usart->STATUS & USART_STATUS_RXDATAV)
+         && (polls < RX_DRAIN_POLLS)) {
+    polls++;
+  }
+
+  // A full queue merges this packet with the next one
+  if (next != ring->boundaryTail) {
+    ring->boundary[head] = ldmaRingWritten(&ring->rx);
+    ring->boundaryHead = next;
+  } else {
+    ring->boundaryOverruns++;
+  }
+
+  if (ring->replyCommitted) {
+    ring->replyFront ^= 1;
+    ring->replyCommitted = false;
+    length = ring->replyLength[ring->replyFront];
+  }
+  startReply(ring, length);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Get the length of the oldest complete packet not consumed yet
+ *
+ * @details
+ *    Packets without data, e.g. when chip select toggled without clocks,
+ *    are skipped.
+ *
+ * @param[out] length
+ *    Bytes of the packet left to consume
+ *
+ * @return
+ *    true if chip select has been deasserted after the packet
+ *****************************************************************************/
+bool spiSlaveRingPacket(SpiSlaveRing_t *ring, uint32_t *length)
+{
+  // Drop the ends of packets consumed already, or dropped by an overrun
+  ldmaRingAvailable(&ring->rx);
+  while ((ring->boundaryTail != ring->boundaryHead)
+         && ((int32_t)(ring->boundary[ring->boundaryTail]
+                       - ring->rx.readTotal) <= 0)) {
+    ring->boundaryTail = (ring->boundaryTail + 1) % SPI_SLAVE_PACKETS;
+  }
+
+  if (ring->boundaryTail == ring->boundaryHead) {
+    return false;
+  }
+
+  *length = ring->boundary[ring->boundaryTail] - ring->rx.readTotal;
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Get the oldest received bytes without copying them
+ *
+ * @param[out] data
+ *    Set to the first byte not consumed yet
+ *
+ * @return
+ *    Number of bytes that can be read from data, up to the end of the
+ *    oldest complete packet, 0 if no packet is complete. This is less than
+ *    the rest of the packet when it wraps around the end of the ring; the
+ *    rest follows from the start of the ring after spiSlaveRingConsume().
+ *****************************************************************************/
+uint32_t spiSlaveRingSpan(SpiSlaveRing_t *ring, const uint8_t **data)
+{
+  const void *span;
+  uint32_t available = ldmaRingSpan(&ring->rx, &span);
+  uint32_t length;
+
+  // Bytes of a packet still being received are not returned
+  if (!spiSlaveRingPacket(ring, &length)) {
+    length = 0;
+  }
+
+  *data = span;
+  return SL_MIN(available, length);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Release bytes returned by spiSlaveRingSpan()
+ *
+ * @details
+ *    Once all bytes of a packet are consumed, spiSlaveRingPacket() moves on
+ *    to the next packet.
+ *****************************************************************************/
+void spiSlaveRingConsume(SpiSlaveRing_t *ring, uint32_t count)
+{
+  ldmaRingConsume(&ring->rx, count);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Get the reply buffer to write the reply to the next packet into
+ *
+ * @return
+ *    SPI_SLAVE_REPLY_SIZE bytes, or NULL while the previous reply has been
+ *    committed but not sent yet
+ *****************************************************************************/
+uint8_t *spiSlaveReplyBuffer(SpiSlaveRing_t *ring)
+{
+  if (ring->replyCommitted) {
+    return NULL;
+  }
+  return ring->reply[ring->replyFront ^ 1];
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Send the reply written into spiSlaveReplyBuffer() in the next packet
+ *
+ * @param[in] length
+ *    Bytes of the reply, at most SPI_SLAVE_REPLY_SIZE
+ *****************************************************************************/
+void spiSlaveReplyCommit(SpiSlaveRing_t *ring, uint32_t length)
+{
+  EFM_ASSERT(length <= SPI_SLAVE_REPLY_SIZE);
+
+  ring->replyLength[ring->replyFront ^ 1] = length;
+  ring->replyCommitted = true;
+}